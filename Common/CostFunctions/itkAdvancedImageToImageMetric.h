@@ -23,6 +23,7 @@
 #include "itkImageSamplerBase.h"
 #include "itkGradientImageFilter.h"
 #include "itkBSplineInterpolateImageFunction.h"
+#include "itkAdvancedBSplineInterpolateImageFunction.h"
 #include "itkReducedDimensionBSplineInterpolateImageFunction.h"
 #include "itkAdvancedLinearInterpolateImageFunction.h"
 #include "itkLimiterFunctionBase.h"
@@ -37,6 +38,7 @@
 #include "itkAdvancedCombinationTransform.h"
 
 #include "itkPlatformMultiThreader.h"
+#include "itkWorkStealingThreadPool.h"
 
 #include <memory> // For unique_ptr.
 
@@ -144,6 +146,7 @@ public:
   using ImageSamplerPointer = typename ImageSamplerType::Pointer;
   using ImageSampleContainerType = typename ImageSamplerType::OutputVectorContainerType;
   using ImageSampleContainerPointer = typename ImageSamplerType::OutputVectorContainerPointer;
+  using ImageSampleType = typename ImageSamplerType::ImageSampleType;
 
   /** Typedefs for Limiter support. */
   using FixedImageLimiterType = LimiterFunctionBase<RealType, FixedImageDimension>;
@@ -211,6 +214,32 @@ public:
    * This method allows the user to inspect this setting. */
   itkGetConstMacro(UseImageSampler, bool);
 
+  /** Set/Get whether the metric loops over blocks of image samples, instead of over
+   * the samples one by one. The points and values of each block are gathered from the
+   * image sample container into small arrays, so that the block can be transformed and
+   * interpolated at once, and its sums can be vectorized. Only supported by some
+   * metrics; others ignore it. Default: false. */
+  itkSetMacro(UseStructureOfArraysSamples, bool);
+  itkGetConstMacro(UseStructureOfArraysSamples, bool);
+  itkBooleanMacro(UseStructureOfArraysSamples);
+
+  /** Set/Get whether each thread accumulates its derivative in single precision.
+   * Only the per-thread derivative is float: the samples, image gradients and Jacobian
+   * products remain double, and the final reduction over the threads is done in double
+   * precision. Only supported by some metrics; others ignore it. Default: false. */
+  itkSetMacro(UseSinglePrecisionDerivativeAccumulation, bool);
+  itkGetConstMacro(UseSinglePrecisionDerivativeAccumulation, bool);
+  itkBooleanMacro(UseSinglePrecisionDerivativeAccumulation);
+
+  /** Set/Get whether the transform precomputes the data that only depends on
+   * the sample positions, like the B-spline support region and weights, once
+   * for every new set of samples. This pays off when the samples do not change
+   * between iterations, as with the grid and full samplers. The cache is only
+   * created by transforms that support it. Default: false. */
+  itkSetMacro(UseTransformSampleCache, bool);
+  itkGetConstMacro(UseTransformSampleCache, bool);
+  itkBooleanMacro(UseTransformSampleCache);
+
   /** Set/Get the required ratio of valid samples; default 0.25.
    * When less than this ratio*numberOfSamplesTried samples map
    * inside the moving image buffer, an exception will be thrown. */
@@ -288,6 +317,13 @@ public:
   itkGetConstReferenceMacro(UseMultiThread, bool);
   itkBooleanMacro(UseMultiThread);
 
+  /** Select the use of the persistent work-stealing thread pool, instead of
+   * launching new threads on each call to GetValue(AndDerivative). Only has
+   * effect when UseMultiThread is true. Default: false. */
+  itkSetMacro(UseWorkStealingThreadPool, bool);
+  itkGetConstReferenceMacro(UseWorkStealingThreadPool, bool);
+  itkBooleanMacro(UseWorkStealingThreadPool);
+
   /** Contains calls from GetValueAndDerivative that are thread-unsafe,
    * together with preparation for multi-threading.
    * Note that the only reason why this function is not protected, is
@@ -324,6 +360,12 @@ protected:
   using BSplineInterpolatorFloatType =
     BSplineInterpolateImageFunction<MovingImageType, CoordinateRepresentationType, float>;
   using BSplineInterpolatorFloatPointer = typename BSplineInterpolatorFloatType::Pointer;
+  using AdvancedBSplineInterpolatorType =
+    AdvancedBSplineInterpolateImageFunction<MovingImageType, CoordinateRepresentationType, double>;
+  using AdvancedBSplineInterpolatorPointer = typename AdvancedBSplineInterpolatorType::Pointer;
+  using AdvancedBSplineInterpolatorFloatType =
+    AdvancedBSplineInterpolateImageFunction<MovingImageType, CoordinateRepresentationType, float>;
+  using AdvancedBSplineInterpolatorFloatPointer = typename AdvancedBSplineInterpolatorFloatType::Pointer;
   using ReducedBSplineInterpolatorType =
     ReducedDimensionBSplineInterpolateImageFunction<MovingImageType, CoordinateRepresentationType, double>;
   using ReducedBSplineInterpolatorPointer = typename ReducedBSplineInterpolatorType::Pointer;
@@ -336,22 +378,63 @@ protected:
   /** Typedefs for support of sparse Jacobians and compact support of transformations. */
   using NonZeroJacobianIndicesType = typename AdvancedTransformType::NonZeroJacobianIndicesType;
 
+  /** Typedef for the per-thread derivative in single precision derivative accumulation. */
+  using SinglePrecisionDerivativeValueType = float;
+  using SinglePrecisionDerivativeType = Array<SinglePrecisionDerivativeValueType>;
+
   /** Protected Variables **************/
 
+  /** The number of samples that metrics process at once, when looping over blocks
+   * of samples. Small enough to keep the block in L1 cache. */
+  itkStaticConstMacro(SampleBlockSize, unsigned int, 64);
+
+  /** A block of valid samples of one thread. The inner products of the transform Jacobian
+   * and the moving image gradient of all its samples are evaluated by one call to the
+   * transform, see EvaluateSampleJacobianBlock(). */
+  struct SampleJacobianBlockType
+  {
+    SizeValueType                           m_Size{ 0 };
+    SizeValueType                           m_SampleIndices[SampleBlockSize];
+    FixedImagePointType                     m_FixedPoints[SampleBlockSize];
+    RealType                                m_FixedImageValues[SampleBlockSize];
+    RealType                                m_MovingImageValues[SampleBlockSize];
+    MovingImageDerivativeType               m_MovingImageDerivatives[SampleBlockSize];
+    std::vector<DerivativeType>             m_ImageJacobians;
+    std::vector<NonZeroJacobianIndicesType> m_NonZeroJacobianIndices;
+
+    /** Add a sample; returns true when the block is full. */
+    bool
+    Add(const SizeValueType               sampleIndex,
+        const FixedImagePointType &       fixedPoint,
+        const RealType                    fixedImageValue,
+        const RealType                    movingImageValue,
+        const MovingImageDerivativeType & movingImageDerivative)
+    {
+      m_SampleIndices[m_Size] = sampleIndex;
+      m_FixedPoints[m_Size] = fixedPoint;
+      m_FixedImageValues[m_Size] = fixedImageValue;
+      m_MovingImageValues[m_Size] = movingImageValue;
+      m_MovingImageDerivatives[m_Size] = movingImageDerivative;
+      return ++m_Size == SampleBlockSize;
+    }
+  };
+
   /** Variables for ImageSampler support. m_ImageSampler is mutable,
    * because it is changed in the GetValue(), etc, which are const functions.
    */
   mutable ImageSamplerPointer m_ImageSampler{ nullptr };
 
   /** Variables for image derivative computation. */
-  bool                              m_InterpolatorIsLinear{ false };
-  bool                              m_InterpolatorIsBSpline{ false };
-  bool                              m_InterpolatorIsBSplineFloat{ false };
-  bool                              m_InterpolatorIsReducedBSpline{ false };
-  LinearInterpolatorPointer         m_LinearInterpolator{ nullptr };
-  BSplineInterpolatorPointer        m_BSplineInterpolator{ nullptr };
-  BSplineInterpolatorFloatPointer   m_BSplineInterpolatorFloat{ nullptr };
-  ReducedBSplineInterpolatorPointer m_ReducedBSplineInterpolator{ nullptr };
+  bool                                    m_InterpolatorIsLinear{ false };
+  bool                                    m_InterpolatorIsBSpline{ false };
+  bool                                    m_InterpolatorIsBSplineFloat{ false };
+  bool                                    m_InterpolatorIsReducedBSpline{ false };
+  LinearInterpolatorPointer               m_LinearInterpolator{ nullptr };
+  BSplineInterpolatorPointer              m_BSplineInterpolator{ nullptr };
+  BSplineInterpolatorFloatPointer         m_BSplineInterpolatorFloat{ nullptr };
+  AdvancedBSplineInterpolatorPointer      m_AdvancedBSplineInterpolator{ nullptr };
+  AdvancedBSplineInterpolatorFloatPointer m_AdvancedBSplineInterpolatorFloat{ nullptr };
+  ReducedBSplineInterpolatorPointer       m_ReducedBSplineInterpolator{ nullptr };
 
   CentralDifferenceGradientFilterPointer m_CentralDifferenceGradientFilter{ nullptr };
 
@@ -414,9 +497,22 @@ protected:
   static ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
   AccumulateDerivativesThreaderCallback(void * arg);
 
+  /** Launch MultiThread AccumulateDerivatives. The st_DerivativePointer and
+   * st_NormalizationFactor of m_ThreaderMetricParameters should be set before. */
+  void
+  LaunchAccumulateDerivativesThreaderCallback() const;
+
+  /** Accumulate the per-thread derivatives into st_DerivativePointer, for the
+   * parameter range [ jmin, jmax [. Additionally, the per-thread derivatives are reset.
+   * With single precision derivative accumulation, the float per-thread derivatives are summed
+   * in double precision. */
+  void
+  AccumulateDerivatives(NumberOfParametersType jmin, NumberOfParametersType jmax) const;
+
   /** Variables for multi-threading. */
   bool m_UseMetricSingleThreaded{ true };
   bool m_UseMultiThread{ false };
+  bool m_UseWorkStealingThreadPool{ false };
   bool m_UseOpenMP;
 
   /** Helper structs that multi-threads the computation of
@@ -455,9 +551,10 @@ protected:
   // test per thread struct with padding and alignment
   struct GetValueAndDerivativePerThreadStruct
   {
-    SizeValueType  st_NumberOfPixelsCounted;
-    MeasureType    st_Value;
-    DerivativeType st_Derivative;
+    SizeValueType                 st_NumberOfPixelsCounted;
+    MeasureType                   st_Value;
+    DerivativeType                st_Derivative;
+    SinglePrecisionDerivativeType st_SinglePrecisionDerivative;
   };
   itkPadStruct(ITK_CACHE_LINE_ALIGNMENT,
                GetValueAndDerivativePerThreadStruct,
@@ -525,6 +622,22 @@ protected:
     return EvaluateMovingImageValueAndDerivativeWithOptionalThreadId(mappedPoint, movingImageValue, gradient, threadId);
   }
 
+  /** A batched version of `FastEvaluateMovingImageValueAndDerivative`, for a block of mapped points.
+   * On input, sampleOk tells which points should be evaluated (for example those inside the moving
+   * mask), on output whether they are also inside the moving image buffer. When an
+   * AdvancedLinearInterpolateImageFunction or an AdvancedBSplineInterpolateImageFunction is used,
+   * the valid points are evaluated at once by its batched kernel. Other interpolators, precomputed
+   * gradient images and moving image derivative scales are handled point by point. If no gradients
+   * are wanted, set the gradients argument to nullptr.
+   */
+  void
+  FastEvaluateMovingImageValuesAndDerivatives(const MovingImagePointType * mappedPoints,
+                                              RealType *                   movingImageValues,
+                                              MovingImageDerivativeType *  gradients,
+                                              bool *                       sampleOk,
+                                              SizeValueType                numberOfPoints,
+                                              const ThreadIdType           threadId) const;
+
   /** Computes the inner product of transform Jacobian with moving image gradient.
    * The results are stored in imageJacobian, which is supposed
    * to have the right size (same length as Jacobian's number of columns).
@@ -551,6 +664,61 @@ protected:
   MovingImagePointType
   TransformPoint(const FixedImagePointType & fixedImagePoint) const;
 
+  /** Transform a batch of points from FixedImage domain to MovingImage domain.
+   * Calls the batched TransformPoints of an advanced transform, which avoids
+   * a virtual function call per point.
+   */
+  void
+  TransformPoints(const FixedImagePointType * fixedImagePoints,
+                  MovingImagePointType *      mappedPoints,
+                  SizeValueType               numberOfPoints) const;
+
+  /** Create the sample cache of the transform, when UseTransformSampleCache is
+   * true and the samples have changed since the cache was created. Called by
+   * BeforeThreadedGetValueAndDerivative(), after the sampler has been updated. */
+  void
+  UpdateTransformSampleCache() const;
+
+  /** Whether the transform has created a sample cache for the current samples. */
+  bool
+  HasTransformSampleCache() const
+  {
+    return this->m_TransformSampleCache != nullptr;
+  }
+
+  /** Transform the sample with index sampleIndex of the sample container, at
+   * fixedImagePoint. Uses the sample cache of the transform, when present. */
+  MovingImagePointType
+  TransformSamplePoint(SizeValueType sampleIndex, const FixedImagePointType & fixedImagePoint) const;
+
+  /** Compute the inner product of the transform Jacobian and the moving image
+   * gradient for the sample with index sampleIndex, at fixedImagePoint. Uses
+   * the sample cache of the transform, when present. */
+  void
+  EvaluateSampleJacobianWithImageGradientProduct(SizeValueType                     sampleIndex,
+                                                 const FixedImagePointType &       fixedImagePoint,
+                                                 const MovingImageDerivativeType & movingImageGradient,
+                                                 DerivativeType &                  imageJacobian,
+                                                 NonZeroJacobianIndicesType &      nzji) const;
+
+  /** Allocate the image Jacobians and the nonzero Jacobian indices of a block of samples. */
+  void
+  InitializeSampleJacobianBlock(SampleJacobianBlockType & block) const;
+
+  /** Compute the inner products of the transform Jacobian and the moving image gradient
+   * of all samples of the block, by one call to the transform. Uses the sample cache of
+   * the transform, when present. */
+  void
+  EvaluateSampleJacobianBlock(SampleJacobianBlockType & block) const;
+
+  /** EvaluateTransformJacobian() for the sample with index sampleIndex, at
+   * fixedImagePoint. Uses the sample cache of the transform, when present. */
+  bool
+  EvaluateSampleTransformJacobian(SizeValueType                sampleIndex,
+                                  const FixedImagePointType &  fixedImagePoint,
+                                  TransformJacobianType &      jacobian,
+                                  NonZeroJacobianIndicesType & nzji) const;
+
   /** This function returns a reference to the transform Jacobians.
    * This is either a reference to the full TransformJacobian or
    * a reference to a sparse Jacobians.
@@ -589,6 +757,9 @@ private:
 
   /** Private member variables. */
   bool   m_UseImageSampler{ false };
+  bool   m_UseStructureOfArraysSamples{ false };
+  bool   m_UseSinglePrecisionDerivativeAccumulation{ false };
+  bool   m_UseTransformSampleCache{ false };
   bool   m_UseFixedImageLimiter{ false };
   bool   m_UseMovingImageLimiter{ false };
   double m_RequiredRatioOfValidSamples{ 0.25 };
@@ -596,6 +767,12 @@ private:
   bool   m_ScaleGradientWithRespectToMovingImageOrientation{ false };
 
   MovingImageDerivativeScalesType m_MovingImageDerivativeScales{ MovingImageDerivativeScalesType::Filled(1.0) };
+
+  /** The sample cache of the transform, and the sample container it was created for. */
+  mutable typename AdvancedTransformType::SampleCacheConstPointer m_TransformSampleCache{ nullptr };
+  mutable SizeValueType                                           m_TransformSampleCacheSize{ 0 };
+  mutable const ImageSampleContainerType *                        m_TransformSampleCacheContainer{ nullptr };
+  mutable ModifiedTimeType                                        m_TransformSampleCacheMTime{ 0 };
 };
 
 } // end namespace itk
@@ -108,6 +108,10 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::Initialize()
   /** Check if the transform is a B-spline transform. */
   this->CheckForBSplineTransform();
 
+  /** The grid of the transform may have changed, so the sample cache is created again. */
+  this->m_TransformSampleCache.reset();
+  this->m_TransformSampleCacheContainer = nullptr;
+
   /** Initialize some threading related parameters. */
   if (this->m_UseMultiThread)
   {
@@ -172,6 +176,13 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::InitializeThreadingParame
     this->m_GetValueAndDerivativePerThreadVariables[i].st_Derivative.SetSize(this->GetNumberOfParameters());
     this->m_GetValueAndDerivativePerThreadVariables[i].st_Derivative.Fill(
       NumericTraits<DerivativeValueType>::ZeroValue());
+
+    /** The single precision derivatives are only allocated when they are used. */
+    const NumberOfParametersType singlePrecisionSize =
+      this->m_UseSinglePrecisionDerivativeAccumulation ? this->GetNumberOfParameters() : 0;
+    this->m_GetValueAndDerivativePerThreadVariables[i].st_SinglePrecisionDerivative.SetSize(singlePrecisionSize);
+    this->m_GetValueAndDerivativePerThreadVariables[i].st_SinglePrecisionDerivative.Fill(
+      NumericTraits<SinglePrecisionDerivativeValueType>::ZeroValue());
   }
 
 } // end InitializeThreadingParameters()
@@ -365,6 +376,12 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::CheckForBSplineInterpolat
     itkDebugMacro("Interpolator is not BSplineFloat");
   }
 
+  /** The B-spline interpolators that also offer a batched evaluation. */
+  this->m_AdvancedBSplineInterpolator =
+    dynamic_cast<AdvancedBSplineInterpolatorType *>(this->m_Interpolator.GetPointer());
+  this->m_AdvancedBSplineInterpolatorFloat =
+    dynamic_cast<AdvancedBSplineInterpolatorFloatType *>(this->m_Interpolator.GetPointer());
+
   this->m_InterpolatorIsReducedBSpline = false;
   ReducedBSplineInterpolatorType * testPtr3 =
     dynamic_cast<ReducedBSplineInterpolatorType *>(this->m_Interpolator.GetPointer());
@@ -621,6 +638,93 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::EvaluateMovingImageValueA
 } // end EvaluateMovingImageValueAndDerivativeWithOptionalThreadId()
 
 
+/**
+ * ******************* FastEvaluateMovingImageValuesAndDerivatives ******************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::FastEvaluateMovingImageValuesAndDerivatives(
+  const MovingImagePointType * mappedPoints,
+  RealType *                   movingImageValues,
+  MovingImageDerivativeType *  gradients,
+  bool *                       sampleOk,
+  SizeValueType                numberOfPoints,
+  const ThreadIdType           threadId) const
+{
+  /** The batched kernels of the interpolators do not apply the derivative scales. */
+  const bool interpolatorIsBatched = this->m_InterpolatorIsLinear || this->m_AdvancedBSplineInterpolator.IsNotNull() ||
+                                     this->m_AdvancedBSplineInterpolatorFloat.IsNotNull();
+  if (!interpolatorIsBatched || this->GetComputeGradient() || this->m_UseMovingImageDerivativeScales)
+  {
+    for (SizeValueType i = 0; i < numberOfPoints; ++i)
+    {
+      if (sampleOk[i])
+      {
+        sampleOk[i] = this->FastEvaluateMovingImageValueAndDerivative(
+          mappedPoints[i], movingImageValues[i], gradients ? &gradients[i] : nullptr, threadId);
+      }
+    }
+    return;
+  }
+
+  /** Collect the points that are inside the buffer. Using thread-local storage,
+   * so that the allocation only occurs once per thread. */
+  thread_local std::vector<MovingImageContinuousIndexType> cindices;
+  thread_local std::vector<SizeValueType>                  positions;
+  thread_local std::vector<RealType>                       values;
+  thread_local std::vector<MovingImageDerivativeType>      derivatives;
+  cindices.resize(numberOfPoints);
+  positions.resize(numberOfPoints);
+
+  SizeValueType numberOfValidPoints = 0;
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    if (sampleOk[i])
+    {
+      MovingImageContinuousIndexType & cindex = cindices[numberOfValidPoints];
+      this->m_Interpolator->ConvertPointToContinuousIndex(mappedPoints[i], cindex);
+      sampleOk[i] = this->m_Interpolator->IsInsideBuffer(cindex);
+      if (sampleOk[i])
+      {
+        positions[numberOfValidPoints] = i;
+        ++numberOfValidPoints;
+      }
+    }
+  }
+
+  /** Evaluate the valid points at once, and scatter the results. */
+  values.resize(numberOfValidPoints);
+  derivatives.resize(gradients ? numberOfValidPoints : 0);
+  MovingImageDerivativeType * const derivativesPointer = gradients ? derivatives.data() : nullptr;
+  if (this->m_AdvancedBSplineInterpolator)
+  {
+    this->m_AdvancedBSplineInterpolator->EvaluateValuesAndDerivativesAtContinuousIndices(
+      cindices.data(), values.data(), derivativesPointer, numberOfValidPoints, threadId);
+  }
+  else if (this->m_AdvancedBSplineInterpolatorFloat)
+  {
+    this->m_AdvancedBSplineInterpolatorFloat->EvaluateValuesAndDerivativesAtContinuousIndices(
+      cindices.data(), values.data(), derivativesPointer, numberOfValidPoints, threadId);
+  }
+  else
+  {
+    this->m_LinearInterpolator->EvaluateValuesAndDerivativesAtContinuousIndices(
+      cindices.data(), values.data(), derivativesPointer, numberOfValidPoints);
+  }
+
+  for (SizeValueType n = 0; n < numberOfValidPoints; ++n)
+  {
+    movingImageValues[positions[n]] = values[n];
+    if (gradients)
+    {
+      gradients[positions[n]] = derivatives[n];
+    }
+  }
+
+} // end FastEvaluateMovingImageValuesAndDerivatives()
+
+
 /**
  * *************** EvaluateTransformJacobianInnerProduct ****************
  */
@@ -692,6 +796,186 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::TransformPoint(const Fixe
 } // end TransformPoint()
 
 
+/**
+ * ************************ TransformPoints *************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::TransformPoints(const FixedImagePointType * fixedImagePoints,
+                                                                       MovingImagePointType *      mappedPoints,
+                                                                       SizeValueType               numberOfPoints) const
+{
+  if (this->m_TransformIsAdvanced)
+  {
+    this->m_AdvancedTransform->TransformPoints(fixedImagePoints, mappedPoints, numberOfPoints);
+    return;
+  }
+
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    mappedPoints[i] = Superclass::m_Transform->TransformPoint(fixedImagePoints[i]);
+  }
+
+} // end TransformPoints()
+
+
+/**
+ * *************** UpdateTransformSampleCache ****************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::UpdateTransformSampleCache() const
+{
+  if (!this->m_UseTransformSampleCache || !this->m_TransformIsAdvanced || !this->m_UseImageSampler)
+  {
+    this->m_TransformSampleCache.reset();
+    return;
+  }
+
+  /** Nothing to do when the sampler did not produce new samples. */
+  const ImageSampleContainerType * sampleContainer = this->GetImageSampler()->GetOutput();
+  if (sampleContainer == this->m_TransformSampleCacheContainer &&
+      sampleContainer->GetMTime() == this->m_TransformSampleCacheMTime)
+  {
+    return;
+  }
+
+  const SizeValueType              numberOfSamples = sampleContainer->Size();
+  std::vector<FixedImagePointType> fixedImagePoints(numberOfSamples);
+  for (SizeValueType i = 0; i < numberOfSamples; ++i)
+  {
+    fixedImagePoints[i] = sampleContainer->ElementAt(i).m_ImageCoordinates;
+  }
+
+  /** The transform returns a null pointer when it does not support the cache. */
+  this->m_TransformSampleCache = this->m_AdvancedTransform->CreateSampleCache(fixedImagePoints.data(), numberOfSamples);
+  this->m_TransformSampleCacheSize = numberOfSamples;
+  this->m_TransformSampleCacheContainer = sampleContainer;
+  this->m_TransformSampleCacheMTime = sampleContainer->GetMTime();
+
+} // end UpdateTransformSampleCache()
+
+
+/**
+ * *************** TransformSamplePoint ****************
+ */
+
+template <class TFixedImage, class TMovingImage>
+auto
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::TransformSamplePoint(
+  const SizeValueType         sampleIndex,
+  const FixedImagePointType & fixedImagePoint) const -> MovingImagePointType
+{
+  if (this->m_TransformSampleCache && sampleIndex < this->m_TransformSampleCacheSize)
+  {
+    return this->m_AdvancedTransform->TransformPointUsingSampleCache(*this->m_TransformSampleCache, sampleIndex);
+  }
+  return this->TransformPoint(fixedImagePoint);
+
+} // end TransformSamplePoint()
+
+
+/**
+ * *************** EvaluateSampleJacobianWithImageGradientProduct ****************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::EvaluateSampleJacobianWithImageGradientProduct(
+  const SizeValueType               sampleIndex,
+  const FixedImagePointType &       fixedImagePoint,
+  const MovingImageDerivativeType & movingImageGradient,
+  DerivativeType &                  imageJacobian,
+  NonZeroJacobianIndicesType &      nzji) const
+{
+  if (this->m_TransformSampleCache && sampleIndex < this->m_TransformSampleCacheSize)
+  {
+    this->m_AdvancedTransform->EvaluateJacobianWithImageGradientProductUsingSampleCache(
+      *this->m_TransformSampleCache, sampleIndex, movingImageGradient, imageJacobian, nzji);
+    return;
+  }
+  this->m_AdvancedTransform->EvaluateJacobianWithImageGradientProduct(
+    fixedImagePoint, movingImageGradient, imageJacobian, nzji);
+
+} // end EvaluateSampleJacobianWithImageGradientProduct()
+
+
+/**
+ * *************** InitializeSampleJacobianBlock ****************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::InitializeSampleJacobianBlock(
+  SampleJacobianBlockType & block) const
+{
+  const NumberOfParametersType nnzji = this->m_AdvancedTransform->GetNumberOfNonZeroJacobianIndices();
+  block.m_Size = 0;
+  block.m_ImageJacobians.assign(Self::SampleBlockSize, DerivativeType(nnzji));
+  block.m_NonZeroJacobianIndices.assign(Self::SampleBlockSize, NonZeroJacobianIndicesType(nnzji));
+
+} // end InitializeSampleJacobianBlock()
+
+
+/**
+ * *************** EvaluateSampleJacobianBlock ****************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::EvaluateSampleJacobianBlock(
+  SampleJacobianBlockType & block) const
+{
+  if (block.m_Size == 0)
+  {
+    return;
+  }
+
+  /** The sample indices of a block increase, so the last one is the largest. */
+  if (this->m_TransformSampleCache && block.m_SampleIndices[block.m_Size - 1] < this->m_TransformSampleCacheSize)
+  {
+    this->m_AdvancedTransform->EvaluateJacobianWithImageGradientProductsUsingSampleCache(
+      *this->m_TransformSampleCache,
+      block.m_SampleIndices,
+      block.m_MovingImageDerivatives,
+      block.m_ImageJacobians.data(),
+      block.m_NonZeroJacobianIndices.data(),
+      block.m_Size);
+    return;
+  }
+  this->m_AdvancedTransform->EvaluateJacobianWithImageGradientProducts(block.m_FixedPoints,
+                                                                       block.m_MovingImageDerivatives,
+                                                                       block.m_ImageJacobians.data(),
+                                                                       block.m_NonZeroJacobianIndices.data(),
+                                                                       block.m_Size);
+
+} // end EvaluateSampleJacobianBlock()
+
+
+/**
+ * *************** EvaluateSampleTransformJacobian ****************
+ */
+
+template <class TFixedImage, class TMovingImage>
+bool
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::EvaluateSampleTransformJacobian(
+  const SizeValueType          sampleIndex,
+  const FixedImagePointType &  fixedImagePoint,
+  TransformJacobianType &      jacobian,
+  NonZeroJacobianIndicesType & nzji) const
+{
+  if (this->m_TransformSampleCache && sampleIndex < this->m_TransformSampleCacheSize)
+  {
+    this->m_AdvancedTransform->GetJacobianUsingSampleCache(*this->m_TransformSampleCache, sampleIndex, jacobian, nzji);
+    return true;
+  }
+  return this->EvaluateTransformJacobian(fixedImagePoint, jacobian, nzji);
+
+} // end EvaluateSampleTransformJacobian()
+
+
 /**
  * *************** EvaluateTransformJacobian ****************
  */
@@ -776,6 +1060,7 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::BeforeThreadedGetValueAnd
     {
       this->GetImageSampler()->Update();
     }
+    this->UpdateTransformSampleCache();
   }
 
 } // end BeforeThreadedGetValueAndDerivative()
@@ -809,6 +1094,21 @@ template <class TFixedImage, class TMovingImage>
 void
 AdvancedImageToImageMetric<TFixedImage, TMovingImage>::LaunchGetValueThreaderCallback() const
 {
+  /** Let the persistent thread pool execute the work units. */
+  if (this->m_UseWorkStealingThreadPool)
+  {
+    const ThreadIdType numberOfWorkUnits = Self::GetNumberOfWorkUnits();
+    Self * const       metric = this->m_ThreaderMetricParameters.st_Metric;
+    WorkStealingThreadPool::GetInstance()->ParallelFor(
+      0, numberOfWorkUnits, 1, numberOfWorkUnits, [metric](SizeValueType first, SizeValueType last, ThreadIdType) {
+        for (SizeValueType threadID = first; threadID < last; ++threadID)
+        {
+          metric->ThreadedGetValue(static_cast<ThreadIdType>(threadID));
+        }
+      });
+    return;
+  }
+
   /** Setup threader. */
   this->m_Threader->SetSingleMethod(this->GetValueThreaderCallback,
                                     const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)));
@@ -847,6 +1147,21 @@ template <class TFixedImage, class TMovingImage>
 void
 AdvancedImageToImageMetric<TFixedImage, TMovingImage>::LaunchGetValueAndDerivativeThreaderCallback() const
 {
+  /** Let the persistent thread pool execute the work units. */
+  if (this->m_UseWorkStealingThreadPool)
+  {
+    const ThreadIdType numberOfWorkUnits = Self::GetNumberOfWorkUnits();
+    Self * const       metric = this->m_ThreaderMetricParameters.st_Metric;
+    WorkStealingThreadPool::GetInstance()->ParallelFor(
+      0, numberOfWorkUnits, 1, numberOfWorkUnits, [metric](SizeValueType first, SizeValueType last, ThreadIdType) {
+        for (SizeValueType threadID = first; threadID < last; ++threadID)
+        {
+          metric->ThreadedGetValueAndDerivative(static_cast<ThreadIdType>(threadID));
+        }
+      });
+    return;
+  }
+
   /** Setup threader. */
   this->m_Threader->SetSingleMethod(this->GetValueAndDerivativeThreaderCallback,
                                     const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)));
@@ -871,34 +1186,104 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::AccumulateDerivativesThre
 
   MultiThreaderParameterType * temp = static_cast<MultiThreaderParameterType *>(infoStruct->UserData);
 
-  const unsigned int numPar = temp->st_Metric->GetNumberOfParameters();
-  const unsigned int subSize =
-    static_cast<unsigned int>(std::ceil(static_cast<double>(numPar) / static_cast<double>(nrOfThreads)));
-  const unsigned int jmin = threadID * subSize;
-  unsigned int       jmax = (threadID + 1) * subSize;
-  jmax = (jmax > numPar) ? numPar : jmax;
+  const NumberOfParametersType numPar = temp->st_Metric->GetNumberOfParameters();
+  const NumberOfParametersType subSize = (numPar + nrOfThreads - 1) / nrOfThreads;
+  const NumberOfParametersType jmin = std::min<NumberOfParametersType>(threadID * subSize, numPar);
+  const NumberOfParametersType jmax = std::min<NumberOfParametersType>((threadID + 1) * subSize, numPar);
+
+  temp->st_Metric->AccumulateDerivatives(jmin, jmax);
+
+  return itk::ITK_THREAD_RETURN_DEFAULT_VALUE;
+
+} // end AccumulateDerivativesThreaderCallback()
+
+
+/**
+ *********** LaunchAccumulateDerivativesThreaderCallback *************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::LaunchAccumulateDerivativesThreaderCallback() const
+{
+  /** Let the persistent thread pool accumulate chunks of the parameter range.
+   * Each worker gets several chunks, so that idle workers can steal some.
+   */
+  if (this->m_UseWorkStealingThreadPool)
+  {
+    const ThreadIdType           numberOfWorkUnits = Self::GetNumberOfWorkUnits();
+    const NumberOfParametersType numPar = this->GetNumberOfParameters();
+    const SizeValueType          grainSize = std::max<SizeValueType>(256, numPar / (4 * numberOfWorkUnits));
+    const Self * const           metric = this;
+    WorkStealingThreadPool::GetInstance()->ParallelFor(
+      0, numPar, grainSize, numberOfWorkUnits, [metric](SizeValueType jmin, SizeValueType jmax, ThreadIdType) {
+        metric->AccumulateDerivatives(jmin, jmax);
+      });
+    return;
+  }
+
+  /** Setup threader and launch. */
+  this->m_Threader->SetSingleMethod(this->AccumulateDerivativesThreaderCallback,
+                                    const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)));
+  this->m_Threader->SingleMethodExecute();
 
-  /** This thread accumulates all sub-derivatives into a single one, for the
+} // end LaunchAccumulateDerivativesThreaderCallback()
+
+
+/**
+ *********** AccumulateDerivatives *************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedImageToImageMetric<TFixedImage, TMovingImage>::AccumulateDerivatives(const NumberOfParametersType jmin,
+                                                                             const NumberOfParametersType jmax) const
+{
+  /** Accumulate all sub-derivatives into a single one, for the
    * range [ jmin, jmax [. Additionally, the sub-derivatives are reset.
    */
+  const ThreadIdType        numberOfWorkUnits = Self::GetNumberOfWorkUnits();
   const DerivativeValueType zero = NumericTraits<DerivativeValueType>::Zero;
-  const DerivativeValueType normalization = 1.0 / temp->st_NormalizationFactor;
-  for (unsigned int j = jmin; j < jmax; ++j)
+  const DerivativeValueType normalization = 1.0 / this->m_ThreaderMetricParameters.st_NormalizationFactor;
+  DerivativeValueType *     derivative = this->m_ThreaderMetricParameters.st_DerivativePointer;
+
+  if (this->m_UseSinglePrecisionDerivativeAccumulation)
+  {
+    /** Both the double and the float per-thread derivatives may have been used,
+     * depending on the code path of the metric, so both are summed. */
+    const SinglePrecisionDerivativeValueType zeroFloat = NumericTraits<SinglePrecisionDerivativeValueType>::Zero;
+    for (NumberOfParametersType j = jmin; j < jmax; ++j)
+    {
+      DerivativeValueType tmp = zero;
+      for (ThreadIdType i = 0; i < numberOfWorkUnits; ++i)
+      {
+        tmp += this->m_GetValueAndDerivativePerThreadVariables[i].st_Derivative[j];
+        tmp += static_cast<DerivativeValueType>(
+          this->m_GetValueAndDerivativePerThreadVariables[i].st_SinglePrecisionDerivative[j]);
+
+        /** Reset these variables for the next iteration. */
+        this->m_GetValueAndDerivativePerThreadVariables[i].st_Derivative[j] = zero;
+        this->m_GetValueAndDerivativePerThreadVariables[i].st_SinglePrecisionDerivative[j] = zeroFloat;
+      }
+      derivative[j] = tmp * normalization;
+    }
+    return;
+  }
+
+  for (NumberOfParametersType j = jmin; j < jmax; ++j)
   {
     DerivativeValueType tmp = zero;
-    for (ThreadIdType i = 0; i < nrOfThreads; ++i)
+    for (ThreadIdType i = 0; i < numberOfWorkUnits; ++i)
     {
-      tmp += temp->st_Metric->m_GetValueAndDerivativePerThreadVariables[i].st_Derivative[j];
+      tmp += this->m_GetValueAndDerivativePerThreadVariables[i].st_Derivative[j];
 
       /** Reset this variable for the next iteration. */
-      temp->st_Metric->m_GetValueAndDerivativePerThreadVariables[i].st_Derivative[j] = zero;
+      this->m_GetValueAndDerivativePerThreadVariables[i].st_Derivative[j] = zero;
     }
-    temp->st_DerivativePointer[j] = tmp * normalization;
+    derivative[j] = tmp * normalization;
   }
 
-  return itk::ITK_THREAD_RETURN_DEFAULT_VALUE;
-
-} // end AccumulateDerivativesThreaderCallback()
+} // end AccumulateDerivatives()
 
 
 /**
@@ -933,6 +1318,11 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::PrintSelf(std::ostream &
   os << indent << "Variables related to the Sampler: " << std::endl;
   os << indent.GetNextIndent() << "ImageSampler: " << this->m_ImageSampler.GetPointer() << std::endl;
   os << indent.GetNextIndent() << "UseImageSampler: " << this->m_UseImageSampler << std::endl;
+  os << indent.GetNextIndent() << "UseStructureOfArraysSamples: " << this->m_UseStructureOfArraysSamples << std::endl;
+  os << indent.GetNextIndent()
+     << "UseSinglePrecisionDerivativeAccumulation: " << this->m_UseSinglePrecisionDerivativeAccumulation
+     << std::endl;
+  os << indent.GetNextIndent() << "UseTransformSampleCache: " << this->m_UseTransformSampleCache << std::endl;
 
   /** Variables for the Limiters. */
   os << indent << "Variables related to the Limiters: " << std::endl;
@@ -972,6 +1362,8 @@ AdvancedImageToImageMetric<TFixedImage, TMovingImage>::PrintSelf(std::ostream &
   os << indent.GetNextIndent() << "UseMovingImageDerivativeScales: " << this->m_UseMovingImageDerivativeScales
      << std::endl;
   os << indent.GetNextIndent() << "MovingImageDerivativeScales: " << this->m_MovingImageDerivativeScales << std::endl;
+  os << indent.GetNextIndent() << "UseMultiThread: " << this->m_UseMultiThread << std::endl;
+  os << indent.GetNextIndent() << "UseWorkStealingThreadPool: " << this->m_UseWorkStealingThreadPool << std::endl;
 
 } // end PrintSelf()
 
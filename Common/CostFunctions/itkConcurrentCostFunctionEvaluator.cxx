@@ -0,0 +1,84 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkConcurrentCostFunctionEvaluator.h"
+#include "itkWorkStealingThreadPool.h"
+
+namespace itk
+{
+
+/**
+ * ********************* GetValues *****************************
+ */
+
+void
+ConcurrentCostFunctionEvaluator::GetValues(const CostFunctionContainerType & costFunctions,
+                                           const ParametersContainerType &   positions,
+                                           MeasureContainerType &            values,
+                                           ExceptionContainerType &          exceptions)
+{
+  if (costFunctions.empty())
+  {
+    itkGenericExceptionMacro(<< "ERROR: no cost function to evaluate.");
+  }
+
+  values.assign(positions.size(), MeasureType{});
+  exceptions.assign(positions.size(), nullptr);
+
+  WorkStealingThreadPool::GetInstance()->ParallelFor(
+    0,
+    positions.size(),
+    1,
+    static_cast<ThreadIdType>(costFunctions.size()),
+    [&costFunctions, &positions, &values, &exceptions](
+      const SizeValueType begin, const SizeValueType end, const ThreadIdType workerId) {
+      const CostFunctionType & costFunction = *costFunctions[workerId];
+      for (SizeValueType i = begin; i < end; ++i)
+      {
+        try
+        {
+          values[i] = costFunction.GetValue(positions[i]);
+        }
+        catch (...)
+        {
+          exceptions[i] = std::current_exception();
+        }
+      }
+    });
+
+} // end GetValues()
+
+
+/**
+ * ********************* RethrowFirstException *****************************
+ */
+
+void
+ConcurrentCostFunctionEvaluator::RethrowFirstException(const ExceptionContainerType & exceptions)
+{
+  for (const auto & exception : exceptions)
+  {
+    if (exception)
+    {
+      std::rethrow_exception(exception);
+    }
+  }
+
+} // end RethrowFirstException()
+
+
+} // end namespace itk
@@ -0,0 +1,89 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkConcurrentCostFunctionEvaluator_h
+#define itkConcurrentCostFunctionEvaluator_h
+
+#include "itkSingleValuedCostFunction.h"
+
+#include <exception>
+#include <vector>
+
+namespace itk
+{
+
+/** \class ConcurrentCostFunctionEvaluator
+ *
+ * \brief Evaluates the value of a cost function at a number of positions in parallel.
+ *
+ * The positions are distributed over the workers of the WorkStealingThreadPool.
+ * Each worker uses its own cost function: a copy of the cost function with its
+ * own state (transform, sampler), so that the cost functions can be evaluated at
+ * the same time. Worker k uses costFunctions[k], so there are at most as many
+ * workers as cost functions. With a single cost function, the positions are
+ * evaluated serially, in the calling thread.
+ *
+ * The value at a position does not depend on the number of cost functions, or on
+ * the order in which the positions are evaluated. This makes it suitable for
+ * optimizers that need several values before they take a step, such as finite
+ * difference gradient estimation and population-based optimizers.
+ *
+ * The optimizers that use this class take their cost functions as "concurrent cost
+ * functions", by SetConcurrentCostFunctions(). These are copies of the cost function
+ * of the optimizer, each with its own transform and sampler, so that they can be
+ * evaluated at the same time as the cost function and as each other. They are empty
+ * by default, in which case the optimizers evaluate their positions one by one.
+ *
+ * Concurrent evaluation is only available through the ITK optimizer API. No elastix
+ * component calls SetConcurrentCostFunctions(): that would need a copy of the metric
+ * per worker, with its own transform, interpolator and image sampler, and elastix does
+ * not create such copies. Within an elastix registration, the FiniteDifferenceGradientDescent,
+ * SimultaneousPerturbation, FullSearch, CMAEvolutionStrategy, Simplex and Powell optimizers
+ * therefore evaluate their positions one by one, and only the multi-threading inside the
+ * metric applies.
+ *
+ * \ingroup Optimizers
+ */
+
+class ConcurrentCostFunctionEvaluator
+{
+public:
+  using CostFunctionType = SingleValuedCostFunction;
+  using ParametersType = CostFunctionType::ParametersType;
+  using MeasureType = CostFunctionType::MeasureType;
+  using CostFunctionContainerType = std::vector<const CostFunctionType *>;
+  using ParametersContainerType = std::vector<ParametersType>;
+  using MeasureContainerType = std::vector<MeasureType>;
+  using ExceptionContainerType = std::vector<std::exception_ptr>;
+
+  /** Evaluate the cost function at the positions. An exception thrown by the evaluation
+   * of a position is not passed to the caller, but stored in the corresponding element
+   * of exceptions, which is empty for positions that succeeded. */
+  static void
+  GetValues(const CostFunctionContainerType & costFunctions,
+            const ParametersContainerType &   positions,
+            MeasureContainerType &            values,
+            ExceptionContainerType &          exceptions);
+
+  /** Rethrow the first exception stored by GetValues(), if any. */
+  static void
+  RethrowFirstException(const ExceptionContainerType & exceptions);
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkConcurrentCostFunctionEvaluator_h
@@ -20,6 +20,9 @@
 
 #include "itkAdvancedImageToImageMetric.h"
 #include "itkKernelFunctionBase2.h"
+#include <atomic>
+#include <cstdint> // For int64_t.
+#include <memory>  // For unique_ptr.
 #include <vector>
 
 
@@ -215,6 +218,15 @@ public:
   itkSetMacro(FiniteDifferencePerturbation, double);
   itkGetConstMacro(FiniteDifferencePerturbation, double);
 
+  /** The number of joint histograms that are shared by the threads in the
+   * multi-threaded ComputePDFs(), for example one per NUMA domain. The threads
+   * add their contributions atomically, in a fixed-point representation.
+   * The default, 0, gives each thread its own private joint histogram, which
+   * is also used when the number is not smaller than the number of threads.
+   */
+  itkSetMacro(NumberOfSharedJointPDFs, ThreadIdType);
+  itkGetConstMacro(NumberOfSharedJointPDFs, ThreadIdType);
+
 protected:
   /** The constructor. */
   ParzenWindowHistogramImageToImageMetric();
@@ -305,7 +317,7 @@ protected:
   void
   ThreadedComputePDFs(ThreadIdType threadId);
 
-  /** Single-threadedly accumulate results. */
+  /** Accumulate the results of the threads. */
   void
   AfterThreadedComputePDFs() const;
 
@@ -317,6 +329,20 @@ protected:
   void
   LaunchComputePDFsThreaderCallback() const;
 
+  /** Sum the private (or shared) joint histograms into m_JointPDF, for the
+   * bins [ begin, end [ of its buffer. Afterwards the shared histograms are reset.
+   */
+  void
+  ReduceJointPDFs(SizeValueType begin, SizeValueType end) const;
+
+  /** Helper function to reduce the joint histograms multi-threaded. */
+  static ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
+  ReduceJointPDFsThreaderCallback(void * arg);
+
+  /** Helper function to launch the threads that reduce the joint histograms. */
+  void
+  LaunchReduceJointPDFsThreaderCallback() const;
+
   /** Compute the Parzen values given an image value and a starting histogram index
    * Compute the values at (parzenWindowIndex - parzenWindowTerm + k) for
    * k = 0 ... kernelsize-1
@@ -476,6 +502,25 @@ private:
   /** Threading related parameters. */
   mutable std::vector<JointPDFPointer> m_ThreaderJointPDFs;
 
+  /** The shared joint histograms, in fixed-point: SharedJointPDFScale represents 1.0. */
+  using SharedJointPDFValueType = std::atomic<std::int64_t>;
+  static constexpr double                                          SharedJointPDFScale = 4294967296.0;
+  mutable std::vector<std::unique_ptr<SharedJointPDFValueType[]>> m_SharedJointPDFs;
+  mutable SizeValueType                                            m_SharedJointPDFSize{ 0 };
+
+  /** Whether the multi-threaded ComputePDFs() uses the shared joint histograms. */
+  bool
+  UseSharedJointPDFs() const
+  {
+    return this->m_NumberOfSharedJointPDFs > 0 && this->m_NumberOfSharedJointPDFs < Self::GetNumberOfWorkUnits();
+  }
+
+  /** Add the contribution of a sample to a shared joint histogram. */
+  void
+  AddToSharedJointPDF(const RealType            fixedImageValue,
+                      const RealType            movingImageValue,
+                      SharedJointPDFValueType * sharedJointPDF) const;
+
   /** Helper structs that multi-threads the computation of
    * the metric derivative using ITK threads.
    */
@@ -508,6 +553,7 @@ private:
   bool          m_UseExplicitPDFDerivatives;
   bool          m_UseFiniteDifferenceDerivative;
   double        m_FiniteDifferencePerturbation;
+  ThreadIdType  m_NumberOfSharedJointPDFs{ 0 };
 };
 
 } // end namespace itk
@@ -26,6 +26,9 @@
 #include "itkImageScanlineIterator.h"
 #include <vnl/vnl_math.h>
 
+#include <algorithm> // For copy, fill and min.
+#include <cmath>     // For ceil, floor and llround.
+
 namespace itk
 {
 
@@ -445,10 +448,36 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::InitializeTh
   /** Only resize the array of structs when needed. */
   m_ParzenWindowHistogramGetValueAndDerivativePerThreadVariables.resize(numberOfThreads);
 
+  /** The shared joint histograms replace the private ones. They are zero-initialized
+   * here once, and reset during each reduction. */
+  const bool useSharedJointPDFs = this->UseSharedJointPDFs();
+  if (useSharedJointPDFs)
+  {
+    const SizeValueType sharedJointPDFSize = jointPDFRegion.GetNumberOfPixels();
+    if (this->m_SharedJointPDFs.size() != this->m_NumberOfSharedJointPDFs ||
+        this->m_SharedJointPDFSize != sharedJointPDFSize)
+    {
+      this->m_SharedJointPDFs.resize(this->m_NumberOfSharedJointPDFs);
+      for (auto & sharedJointPDF : this->m_SharedJointPDFs)
+      {
+        sharedJointPDF.reset(new SharedJointPDFValueType[sharedJointPDFSize]);
+        for (SizeValueType i = 0; i < sharedJointPDFSize; ++i)
+        {
+          sharedJointPDF[i].store(0, std::memory_order_relaxed);
+        }
+      }
+      this->m_SharedJointPDFSize = sharedJointPDFSize;
+    }
+  }
+
   /** Some initialization. */
   for (auto & perThreadVariable : m_ParzenWindowHistogramGetValueAndDerivativePerThreadVariables)
   {
     perThreadVariable.st_NumberOfPixelsCounted = NumericTraits<SizeValueType>::Zero;
+    if (useSharedJointPDFs)
+    {
+      continue;
+    }
 
     // Initialize the joint pdf
     JointPDFPointer & jointPDF = perThreadVariable.st_JointPDF;
@@ -1108,7 +1137,15 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::ThreadedComp
    */
   JointPDFPointer & jointPDF =
     this->m_ParzenWindowHistogramGetValueAndDerivativePerThreadVariables[threadId].st_JointPDF;
-  jointPDF->FillBuffer(NumericTraits<PDFValueType>::ZeroValue());
+  SharedJointPDFValueType * sharedJointPDF = nullptr;
+  if (this->UseSharedJointPDFs())
+  {
+    sharedJointPDF = this->m_SharedJointPDFs[threadId % this->m_NumberOfSharedJointPDFs].get();
+  }
+  else
+  {
+    jointPDF->FillBuffer(NumericTraits<PDFValueType>::ZeroValue());
+  }
 
   /** Get a handle to the sample container. */
   ImageSampleContainerPointer sampleContainer = this->GetImageSampler()->GetOutput();
@@ -1134,14 +1171,15 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::ThreadedComp
   unsigned long numberOfPixelsCounted = 0;
 
   /** Loop over sample container and compute contribution of each sample to pdfs. */
-  for (fiter = fbegin; fiter != fend; ++fiter)
+  unsigned long sampleIndex = pos_begin;
+  for (fiter = fbegin; fiter != fend; ++fiter, ++sampleIndex)
   {
     /** Read fixed coordinates and initialize some variables. */
     const FixedImagePointType & fixedPoint = fiter->Value().m_ImageCoordinates;
     RealType                    movingImageValue;
 
     /** Transform point. */
-    const MovingImagePointType mappedPoint = this->TransformPoint(fixedPoint);
+    const MovingImagePointType mappedPoint = this->TransformSamplePoint(sampleIndex, fixedPoint);
 
     /** Check if the point is inside the moving mask. */
     bool sampleOk = this->IsInsideMovingMask(mappedPoint);
@@ -1166,7 +1204,14 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::ThreadedComp
       movingImageValue = this->GetMovingImageLimiter()->Evaluate(movingImageValue);
 
       /** Compute this sample's contribution to the joint distributions. */
-      this->UpdateJointPDFAndDerivatives(fixedImageValue, movingImageValue, nullptr, nullptr, jointPDF.GetPointer());
+      if (sharedJointPDF)
+      {
+        this->AddToSharedJointPDF(fixedImageValue, movingImageValue, sharedJointPDF);
+      }
+      else
+      {
+        this->UpdateJointPDFAndDerivatives(fixedImageValue, movingImageValue, nullptr, nullptr, jointPDF.GetPointer());
+      }
     }
   } // end iterating over fixed image spatial sample container for loop
 
@@ -1199,6 +1244,10 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::AfterThreade
     this->m_ParzenWindowHistogramGetValueAndDerivativePerThreadVariables[i].st_NumberOfPixelsCounted = 0;
   }
 
+  /** Accumulate joint histogram. This is done before checking the number of samples,
+   * because the reduction also resets the shared joint histograms for the next evaluation. */
+  this->LaunchReduceJointPDFsThreaderCallback();
+
   /** Check if enough samples were valid. */
   ImageSampleContainerPointer sampleContainer = this->GetImageSampler()->GetOutput();
   this->CheckNumberOfSamples(sampleContainer->Size(), this->m_NumberOfPixelsCounted);
@@ -1206,38 +1255,6 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::AfterThreade
   /** Compute alpha. */
   this->m_Alpha = 1.0 / static_cast<double>(this->m_NumberOfPixelsCounted);
 
-  /** Accumulate joint histogram. */
-  // could be multi-threaded too, by each thread updating only a part of the JointPDF.
-  using JointPDFIteratorType = ImageScanlineIterator<JointPDFType>;
-  JointPDFIteratorType              it(this->m_JointPDF, this->m_JointPDF->GetBufferedRegion());
-  std::vector<JointPDFIteratorType> itT(numberOfThreads);
-  for (ThreadIdType i = 0; i < numberOfThreads; ++i)
-  {
-    itT[i] = JointPDFIteratorType(this->m_ParzenWindowHistogramGetValueAndDerivativePerThreadVariables[i].st_JointPDF,
-                                  this->m_JointPDF->GetBufferedRegion());
-  }
-
-  PDFValueType sum;
-  while (!it.IsAtEnd())
-  {
-    while (!it.IsAtEndOfLine())
-    {
-      sum = NumericTraits<PDFValueType>::Zero;
-      for (ThreadIdType i = 0; i < numberOfThreads; ++i)
-      {
-        sum += itT[i].Value();
-        ++itT[i];
-      }
-      it.Set(sum);
-      ++it;
-    }
-    it.NextLine();
-    for (ThreadIdType i = 0; i < numberOfThreads; ++i)
-    {
-      itT[i].NextLine();
-    }
-  }
-
 } // end AfterThreadedComputePDFs()
 
 
@@ -1281,6 +1298,174 @@ ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::LaunchComput
 } // end LaunchComputePDFsThreaderCallback()
 
 
+/**
+ * ******************* ReduceJointPDFs *******************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::ReduceJointPDFs(const SizeValueType begin,
+                                                                                    const SizeValueType end) const
+{
+  /** The bins are processed in blocks that fit in the L1 cache, so that each
+   * output block stays in cache while the histograms are added to it one by one.
+   * This gives contiguous, vectorizable loops, instead of gathering one bin of
+   * all histograms at a time.
+   */
+  constexpr SizeValueType blockSize = 1024;
+  PDFValueType * const    jointPDF = this->m_JointPDF->GetBufferPointer();
+
+  for (SizeValueType blockBegin = begin; blockBegin < end; blockBegin += blockSize)
+  {
+    const SizeValueType blockEnd = std::min(blockBegin + blockSize, end);
+
+    if (this->UseSharedJointPDFs())
+    {
+      std::fill(jointPDF + blockBegin, jointPDF + blockEnd, NumericTraits<PDFValueType>::ZeroValue());
+      for (const auto & sharedJointPDF : this->m_SharedJointPDFs)
+      {
+        for (SizeValueType i = blockBegin; i < blockEnd; ++i)
+        {
+          /** Read and reset the shared histogram for the next iteration. */
+          const std::int64_t fixedPointValue = sharedJointPDF[i].exchange(0, std::memory_order_relaxed);
+          jointPDF[i] += static_cast<PDFValueType>(fixedPointValue / SharedJointPDFScale);
+        }
+      }
+    }
+    else
+    {
+      const ThreadIdType numberOfThreads = Self::GetNumberOfWorkUnits();
+      const auto &       perThreadVariables = this->m_ParzenWindowHistogramGetValueAndDerivativePerThreadVariables;
+
+      const PDFValueType * const firstJointPDF = perThreadVariables[0].st_JointPDF->GetBufferPointer();
+      std::copy(firstJointPDF + blockBegin, firstJointPDF + blockEnd, jointPDF + blockBegin);
+      for (ThreadIdType t = 1; t < numberOfThreads; ++t)
+      {
+        const PDFValueType * const threadJointPDF = perThreadVariables[t].st_JointPDF->GetBufferPointer();
+        for (SizeValueType i = blockBegin; i < blockEnd; ++i)
+        {
+          jointPDF[i] += threadJointPDF[i];
+        }
+      }
+    }
+  }
+
+} // end ReduceJointPDFs()
+
+
+/**
+ * **************** ReduceJointPDFsThreaderCallback *******
+ */
+
+template <class TFixedImage, class TMovingImage>
+ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
+ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::ReduceJointPDFsThreaderCallback(void * arg)
+{
+  ThreadInfoType * infoStruct = static_cast<ThreadInfoType *>(arg);
+  ThreadIdType     threadId = infoStruct->WorkUnitID;
+
+  ParzenWindowHistogramMultiThreaderParameterType * temp =
+    static_cast<ParzenWindowHistogramMultiThreaderParameterType *>(infoStruct->UserData);
+
+  /** Each thread reduces a contiguous part of the joint histogram. */
+  const SizeValueType numberOfBins = temp->m_Metric->m_JointPDF->GetBufferedRegion().GetNumberOfPixels();
+  const SizeValueType numberOfBinsPerThread = static_cast<SizeValueType>(
+    std::ceil(static_cast<double>(numberOfBins) / static_cast<double>(temp->m_Metric->GetNumberOfWorkUnits())));
+
+  const SizeValueType begin = std::min(numberOfBinsPerThread * threadId, numberOfBins);
+  const SizeValueType end = std::min(numberOfBinsPerThread * (threadId + 1), numberOfBins);
+  temp->m_Metric->ReduceJointPDFs(begin, end);
+
+  return itk::ITK_THREAD_RETURN_DEFAULT_VALUE;
+
+} // end ReduceJointPDFsThreaderCallback()
+
+
+/**
+ * *********************** LaunchReduceJointPDFsThreaderCallback***************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::LaunchReduceJointPDFsThreaderCallback() const
+{
+  const SizeValueType numberOfBins = this->m_JointPDF->GetBufferedRegion().GetNumberOfPixels();
+  const ThreadIdType  numberOfWorkUnits = Self::GetNumberOfWorkUnits();
+
+  /** Small histograms are not worth the threading overhead. */
+  if (numberOfWorkUnits == 1 || numberOfBins < 4096)
+  {
+    this->ReduceJointPDFs(0, numberOfBins);
+    return;
+  }
+
+  if (this->GetUseWorkStealingThreadPool())
+  {
+    const Self * const metric = this;
+    WorkStealingThreadPool::GetInstance()->ParallelFor(
+      0, numberOfBins, 1024, numberOfWorkUnits, [metric](SizeValueType begin, SizeValueType end, ThreadIdType) {
+        metric->ReduceJointPDFs(begin, end);
+      });
+    return;
+  }
+
+  /** Setup threader and launch. */
+  this->m_Threader->SetSingleMethod(
+    this->ReduceJointPDFsThreaderCallback,
+    const_cast<void *>(static_cast<const void *>(&this->m_ParzenWindowHistogramThreaderParameters)));
+  this->m_Threader->SingleMethodExecute();
+
+} // end LaunchReduceJointPDFsThreaderCallback()
+
+
+/**
+ * ******************* AddToSharedJointPDF *******************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+ParzenWindowHistogramImageToImageMetric<TFixedImage, TMovingImage>::AddToSharedJointPDF(
+  const RealType            fixedImageValue,
+  const RealType            movingImageValue,
+  SharedJointPDFValueType * sharedJointPDF) const
+{
+  /** Determine Parzen window arguments, as in UpdateJointPDFAndDerivatives(). */
+  const double fixedImageParzenWindowTerm =
+    fixedImageValue / this->m_FixedImageBinSize - this->m_FixedImageNormalizedMin;
+  const double movingImageParzenWindowTerm =
+    movingImageValue / this->m_MovingImageBinSize - this->m_MovingImageNormalizedMin;
+
+  /** The lowest bin numbers affected by this pixel: */
+  const OffsetValueType fixedImageParzenWindowIndex =
+    static_cast<OffsetValueType>(std::floor(fixedImageParzenWindowTerm + this->m_FixedParzenTermToIndexOffset));
+  const OffsetValueType movingImageParzenWindowIndex =
+    static_cast<OffsetValueType>(std::floor(movingImageParzenWindowTerm + this->m_MovingParzenTermToIndexOffset));
+
+  /** The Parzen values. */
+  ParzenValueContainerType fixedParzenValues(this->m_JointPDFWindow.GetSize()[1]);
+  ParzenValueContainerType movingParzenValues(this->m_JointPDFWindow.GetSize()[0]);
+  this->EvaluateParzenValues(
+    fixedImageParzenWindowTerm, fixedImageParzenWindowIndex, this->m_FixedKernel, fixedParzenValues);
+  this->EvaluateParzenValues(
+    movingImageParzenWindowTerm, movingImageParzenWindowIndex, this->m_MovingKernel, movingParzenValues);
+
+  /** Loop over the Parzen window region and increment the values. The joint
+   * histogram is stored with the moving bins along the rows. */
+  const SizeValueType rowLength = this->m_NumberOfMovingHistogramBins;
+  for (unsigned int f = 0; f < fixedParzenValues.GetSize(); ++f)
+  {
+    const double              fv = fixedParzenValues[f];
+    SharedJointPDFValueType * row =
+      sharedJointPDF + (fixedImageParzenWindowIndex + f) * rowLength + movingImageParzenWindowIndex;
+    for (unsigned int m = 0; m < movingParzenValues.GetSize(); ++m)
+    {
+      row[m].fetch_add(std::llround(fv * movingParzenValues[m] * SharedJointPDFScale), std::memory_order_relaxed);
+    }
+  }
+
+} // end AddToSharedJointPDF()
+
+
 /**
  * ************************ ComputePDFsAndPDFDerivatives *******************
  */
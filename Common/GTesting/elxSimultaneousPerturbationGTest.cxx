@@ -0,0 +1,135 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "SimultaneousPerturbation/elxSimultaneousPerturbation.h"
+
+#include "elxElastixTemplate.h"
+#include "../Core/Main/GTesting/elxCoreMainGTestUtilities.h"
+
+#include <itkImage.h>
+#include <itkMersenneTwisterRandomVariateGenerator.h>
+#include <itkSingleValuedCostFunction.h>
+
+#include <gtest/gtest.h>
+
+#include <cmath> // For sin.
+#include <vector>
+
+
+using elx::CoreMainGTestUtilities::CheckNew;
+
+
+namespace
+{
+using ElastixType = elx::ElastixTemplate<itk::Image<float, 2>, itk::Image<float, 2>>;
+using OptimizerType = elx::SimultaneousPerturbation<ElastixType>;
+
+
+// A cost function that, like an image metric, first sets the parameters of its own "transform", and
+// then computes the value from the state of that transform. Evaluating a single instance from several
+// threads at once would therefore mix up the parameters of the positions.
+class TransformStateCostFunction : public itk::SingleValuedCostFunction
+{
+public:
+  using Self = TransformStateCostFunction;
+  using Pointer = itk::SmartPointer<Self>;
+  itkNewMacro(Self);
+
+  unsigned int
+  GetNumberOfParameters() const override
+  {
+    return 4;
+  }
+
+  MeasureType
+  GetValue(const ParametersType & parameters) const override
+  {
+    m_TransformParameters = parameters;
+
+    MeasureType value = 0.0;
+    for (unsigned int i = 0; i < m_TransformParameters.GetSize(); ++i)
+    {
+      const double difference = m_TransformParameters[i] - 0.5 * (i + 1);
+      value += (i + 1) * difference * difference + 0.1 * std::sin(3.0 * m_TransformParameters[i]);
+    }
+    return value;
+  }
+
+  void
+  GetDerivative(const ParametersType &, DerivativeType &) const override
+  {}
+
+private:
+  mutable ParametersType m_TransformParameters;
+};
+
+
+// Runs the optimizer with the specified number of concurrent cost functions, and returns the
+// position after each iteration.
+std::vector<OptimizerType::ParametersType>
+RunSimultaneousPerturbation(const unsigned int numberOfConcurrentCostFunctions)
+{
+  /** The perturbations are drawn from the global random generator. */
+  itk::Statistics::MersenneTwisterRandomVariateGenerator::GetInstance()->SetSeed(121212);
+
+  const auto optimizer = CheckNew<OptimizerType>();
+  optimizer->SetCostFunction(TransformStateCostFunction::New());
+  OptimizerType::CostFunctionContainerType concurrentCostFunctions;
+  for (unsigned int i = 0; i < numberOfConcurrentCostFunctions; ++i)
+  {
+    concurrentCostFunctions.push_back(TransformStateCostFunction::New().GetPointer());
+  }
+  optimizer->SetConcurrentCostFunctions(concurrentCostFunctions);
+
+  OptimizerType::ParametersType initialPosition(4);
+  initialPosition.Fill(0.0);
+  optimizer->SetInitialPosition(initialPosition);
+  optimizer->SetNumberOfPerturbations(5);
+  optimizer->SetMaximumNumberOfIterations(25);
+  optimizer->Seta(0.05);
+  optimizer->Setc(0.1);
+  optimizer->SetTolerance(0.0);
+
+  std::vector<OptimizerType::ParametersType> positions;
+  const auto                                 command = itk::CStyleCommand::New();
+  command->SetClientData(&positions);
+  command->SetConstCallback([](const itk::Object * object, const itk::EventObject &, void * positionsPointer) {
+    static_cast<std::vector<OptimizerType::ParametersType> *>(positionsPointer)
+      ->push_back(static_cast<const OptimizerType *>(object)->GetCurrentPosition());
+  });
+  optimizer->AddObserver(itk::IterationEvent(), command);
+
+  optimizer->StartOptimization();
+  return positions;
+}
+
+} // namespace
+
+
+// The concurrent evaluation of the perturbations must follow exactly the same path as the serial one.
+GTEST_TEST(SimultaneousPerturbation, ConcurrentEvaluationEqualsSerialEvaluation)
+{
+  const auto serialPositions = RunSimultaneousPerturbation(0);
+  ASSERT_EQ(serialPositions.size(), 25u);
+
+  for (const unsigned int numberOfConcurrentCostFunctions : { 1u, 3u, 9u })
+  {
+    EXPECT_EQ(RunSimultaneousPerturbation(numberOfConcurrentCostFunctions), serialPositions);
+  }
+}
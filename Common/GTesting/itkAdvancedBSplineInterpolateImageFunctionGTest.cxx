@@ -0,0 +1,150 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkAdvancedBSplineInterpolateImageFunction.h"
+
+#include <itkImage.h>
+#include <itkImageRegionIteratorWithIndex.h>
+
+#include <gtest/gtest.h>
+
+#include <algorithm> // For max.
+#include <cmath>     // For abs, cos and sin.
+#include <random>
+#include <vector>
+
+
+namespace
+{
+
+// Creates a small image with non-unit spacing and a rotated direction, so that the
+// mirror boundary conditions, the spacing and the direction cosines are all exercised.
+template <class TImage>
+typename TImage::Pointer
+CreateImage()
+{
+  constexpr auto imageDimension = TImage::ImageDimension;
+
+  const auto image = TImage::New();
+  image->SetRegions(typename TImage::RegionType(typename TImage::IndexType::Filled(-2),
+                                                typename TImage::SizeType::Filled(7)));
+
+  typename TImage::SpacingType spacing;
+  for (unsigned int i = 0; i < imageDimension; ++i)
+  {
+    spacing[i] = 0.8 + 0.3 * i;
+  }
+  image->SetSpacing(spacing);
+
+  typename TImage::DirectionType direction;
+  direction.SetIdentity();
+  const double angle = 0.4;
+  direction[0][0] = std::cos(angle);
+  direction[0][1] = -std::sin(angle);
+  direction[1][0] = std::sin(angle);
+  direction[1][1] = std::cos(angle);
+  image->SetDirection(direction);
+
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<TImage> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const auto & index = it.GetIndex();
+    double       value = 0.0;
+    for (unsigned int i = 0; i < imageDimension; ++i)
+    {
+      value += std::sin(0.9 * index[i] + i) + 0.1 * index[i] * index[i];
+    }
+    it.Set(static_cast<typename TImage::PixelType>(value));
+  }
+  return image;
+}
+
+
+// Expects that the batched evaluation yields the same values and derivatives as the per-point evaluation,
+// at random continuous indices inside the buffer, including those near the border.
+template <unsigned int NDimension, class TCoefficient>
+void
+Test_BatchedEvaluationEqualsPerPointEvaluation(const unsigned int splineOrder)
+{
+  SCOPED_TRACE("Dimension = " + std::to_string(NDimension) + ", spline order = " + std::to_string(splineOrder));
+
+  using ImageType = itk::Image<float, NDimension>;
+  using InterpolatorType = itk::AdvancedBSplineInterpolateImageFunction<ImageType, double, TCoefficient>;
+  using ContinuousIndexType = typename InterpolatorType::ContinuousIndexType;
+  using CovariantVectorType = typename InterpolatorType::CovariantVectorType;
+
+  const auto image = CreateImage<ImageType>();
+  const auto interpolator = InterpolatorType::New();
+  interpolator->SetSplineOrder(splineOrder);
+  interpolator->SetInputImage(image);
+
+  /** More indices than a single group of the batched kernel. */
+  std::mt19937                           randomNumberEngine;
+  std::uniform_real_distribution<double> distribution(-2.5, 4.5);
+  std::vector<ContinuousIndexType>       cindices;
+  while (cindices.size() < 150)
+  {
+    ContinuousIndexType cindex;
+    for (unsigned int i = 0; i < NDimension; ++i)
+    {
+      cindex[i] = distribution(randomNumberEngine);
+    }
+    if (interpolator->IsInsideBuffer(cindex))
+    {
+      cindices.push_back(cindex);
+    }
+  }
+
+  const auto numberOfIndices = cindices.size();
+  std::vector<double>              values(numberOfIndices);
+  std::vector<double>              valuesOnly(numberOfIndices);
+  std::vector<CovariantVectorType> derivatives(numberOfIndices);
+  interpolator->EvaluateValuesAndDerivativesAtContinuousIndices(
+    cindices.data(), values.data(), derivatives.data(), numberOfIndices, 0);
+  interpolator->EvaluateValuesAndDerivativesAtContinuousIndices(
+    cindices.data(), valuesOnly.data(), nullptr, numberOfIndices, 0);
+
+  for (std::size_t n = 0; n < numberOfIndices; ++n)
+  {
+    double              expectedValue;
+    CovariantVectorType expectedDerivative;
+    interpolator->EvaluateValueAndDerivativeAtContinuousIndex(cindices[n], expectedValue, expectedDerivative);
+
+    const double tolerance = 1e-10 * std::max(1.0, std::abs(expectedValue));
+    EXPECT_NEAR(values[n], expectedValue, tolerance);
+    EXPECT_NEAR(valuesOnly[n], expectedValue, tolerance);
+    for (unsigned int i = 0; i < NDimension; ++i)
+    {
+      EXPECT_NEAR(derivatives[n][i], expectedDerivative[i], 1e-10 * std::max(1.0, std::abs(expectedDerivative[i])));
+    }
+  }
+}
+
+} // namespace
+
+
+GTEST_TEST(AdvancedBSplineInterpolateImageFunction, BatchedEvaluationEqualsPerPointEvaluation)
+{
+  for (unsigned int splineOrder = 1; splineOrder <= 3; ++splineOrder)
+  {
+    Test_BatchedEvaluationEqualsPerPointEvaluation<2, double>(splineOrder);
+    Test_BatchedEvaluationEqualsPerPointEvaluation<3, double>(splineOrder);
+    Test_BatchedEvaluationEqualsPerPointEvaluation<3, float>(splineOrder);
+  }
+}
@@ -0,0 +1,318 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header files to be tested:
+#include "AdvancedMeanSquares/itkAdvancedMeanSquaresImageToImageMetric.h"
+#include "AdvancedNormalizedCorrelation/itkAdvancedNormalizedCorrelationImageToImageMetric.h"
+#include "AdvancedMattesMutualInformation/itkParzenWindowMutualInformationImageToImageMetric.h"
+
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkAdvancedBSplineInterpolateImageFunction.h"
+#include "itkAdvancedCombinationTransform.h"
+#include "itkAdvancedLinearInterpolateImageFunction.h"
+#include "itkImageFullSampler.h"
+#include "itkImageRandomSampler.h"
+#include "itkRecursiveBSplineTransform.h"
+
+// ITK header files:
+#include <itkBSplineInterpolateImageFunction.h>
+#include <itkImage.h>
+#include <itkImageRegionIteratorWithIndex.h>
+
+// GoogleTest header file:
+#include <gtest/gtest.h>
+
+#include <algorithm> // For max.
+#include <cmath>     // For abs, exp and sin.
+
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<float, Dimension>;
+using CombinationTransformType = itk::AdvancedCombinationTransform<double, Dimension>;
+using BSplineTransformType = itk::AdvancedBSplineDeformableTransform<double, Dimension, 3>;
+using RecursiveBSplineTransformType = itk::RecursiveBSplineTransform<double, Dimension, 3>;
+using InterpolatorType = itk::InterpolateImageFunction<ImageType, double>;
+using LinearInterpolatorType = itk::AdvancedLinearInterpolateImageFunction<ImageType, double>;
+using BSplineInterpolatorType = itk::BSplineInterpolateImageFunction<ImageType, double, double>;
+using AdvancedBSplineInterpolatorType = itk::AdvancedBSplineInterpolateImageFunction<ImageType, double, double>;
+using SamplerType = itk::ImageSamplerBase<ImageType>;
+using MeanSquaresMetricType = itk::AdvancedMeanSquaresImageToImageMetric<ImageType, ImageType>;
+using NormalizedCorrelationMetricType = itk::AdvancedNormalizedCorrelationImageToImageMetric<ImageType, ImageType>;
+using MutualInformationMetricType = itk::ParzenWindowMutualInformationImageToImageMetric<ImageType, ImageType>;
+
+
+// Creates an image of a smooth blob with some ripples, whose center is shifted along the first axis.
+ImageType::Pointer
+CreateSmoothImage(const double shift)
+{
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(20));
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const auto & index = it.GetIndex();
+    double       squaredDistance = 0.0;
+    for (unsigned int i = 0; i < Dimension; ++i)
+    {
+      const double x = index[i] - 9.5 - (i == 0 ? shift : 0.0);
+      squaredDistance += x * x;
+    }
+    it.Set(static_cast<float>(100.0 * std::exp(-squaredDistance / 50.0) + 5.0 * std::sin(0.7 * index[1])));
+  }
+  return image;
+}
+
+
+// Creates a B-spline transform, in a combination transform, with a grid that covers the images.
+template <class TBSplineTransform = BSplineTransformType>
+CombinationTransformType::Pointer
+CreateBSplineCombinationTransform()
+{
+  const auto bspline = TBSplineTransform::New();
+  bspline->SetGridRegion(typename TBSplineTransform::RegionType(TBSplineTransform::SizeType::Filled(9)));
+  bspline->SetGridSpacing(typename TBSplineTransform::SpacingType(4.0));
+  bspline->SetGridOrigin(typename TBSplineTransform::OriginType(-6.0));
+
+  const auto combination = CombinationTransformType::New();
+  combination->SetCurrentTransform(bspline);
+  return combination;
+}
+
+
+// Returns the transform parameters at which the metrics are evaluated: a smooth, nonzero deformation.
+CombinationTransformType::ParametersType
+CreateTransformParameters(const CombinationTransformType & transform)
+{
+  CombinationTransformType::ParametersType parameters(transform.GetNumberOfParameters());
+  for (unsigned int i = 0; i < parameters.GetSize(); ++i)
+  {
+    parameters[i] = 0.8 * std::sin(0.37 * i);
+  }
+  return parameters;
+}
+
+
+// The fixed and moving image, the transform, and the parameters, shared by the metrics of a test.
+struct MetricInput
+{
+  ImageType::Pointer                       FixedImage{ CreateSmoothImage(0.0) };
+  ImageType::Pointer                       MovingImage{ CreateSmoothImage(1.3) };
+  CombinationTransformType::Pointer        Transform{ CreateBSplineCombinationTransform<>() };
+  CombinationTransformType::ParametersType Parameters{ CreateTransformParameters(*Transform) };
+};
+
+
+// Connects the metric to the input, with its own interpolator and sampler, and initializes it.
+template <class TMetric>
+void
+InitializeMetric(TMetric & metric, const MetricInput & input, InterpolatorType & interpolator, SamplerType & sampler)
+{
+  metric.SetFixedImage(input.FixedImage);
+  metric.SetMovingImage(input.MovingImage);
+  metric.SetFixedImageRegion(input.FixedImage->GetBufferedRegion());
+  metric.SetTransform(input.Transform);
+  metric.SetInterpolator(&interpolator);
+  metric.SetImageSampler(&sampler);
+  metric.SetUseMultiThread(true);
+  metric.Initialize();
+}
+
+
+// The value and derivative of a metric.
+struct MetricResult
+{
+  double             Value{};
+  itk::Array<double> Derivative{};
+};
+
+
+template <class TMetric>
+MetricResult
+GetValueAndDerivative(const TMetric & metric, const MetricInput & input)
+{
+  MetricResult                     result;
+  typename TMetric::DerivativeType derivative;
+  metric.GetValueAndDerivative(input.Parameters, result.Value, derivative);
+  result.Derivative = derivative;
+  return result;
+}
+
+
+// Expects the values and derivatives to be equal, up to relativeTolerance times the largest element.
+void
+ExpectNearlyEqual(const MetricResult & expected, const MetricResult & actual, const double relativeTolerance)
+{
+  EXPECT_NEAR(actual.Value, expected.Value, relativeTolerance * std::abs(expected.Value));
+
+  ASSERT_EQ(actual.Derivative.GetSize(), expected.Derivative.GetSize());
+  double maximumMagnitude = 0.0;
+  double maximumDifference = 0.0;
+  for (unsigned int i = 0; i < expected.Derivative.GetSize(); ++i)
+  {
+    maximumMagnitude = std::max(maximumMagnitude, std::abs(expected.Derivative[i]));
+    maximumDifference = std::max(maximumDifference, std::abs(actual.Derivative[i] - expected.Derivative[i]));
+  }
+  EXPECT_GT(maximumMagnitude, 0.0);
+  EXPECT_LE(maximumDifference, relativeTolerance * maximumMagnitude);
+}
+
+
+// Evaluates the metric with the specified interpolator, after configuring it by the specified function.
+template <class TMetric, class TInterpolator, class TConfigureFunction>
+MetricResult
+EvaluateMetric(const MetricInput & input, const TConfigureFunction & configure)
+{
+  const auto metric = TMetric::New();
+  const auto interpolator = TInterpolator::New();
+  const auto sampler = itk::ImageFullSampler<ImageType>::New();
+  configure(*metric);
+  InitializeMetric(*metric, input, *interpolator, *sampler);
+  return GetValueAndDerivative(*metric, input);
+}
+
+
+template <class TMetric, class TInterpolator>
+void
+Test_StructureOfArraysSamplesDoNotChangeValueAndDerivative()
+{
+  const MetricInput input;
+
+  const auto expected = EvaluateMetric<TMetric, TInterpolator>(
+    input, [](TMetric & metric) { metric.SetUseStructureOfArraysSamples(false); });
+  const auto actual = EvaluateMetric<TMetric, TInterpolator>(
+    input, [](TMetric & metric) { metric.SetUseStructureOfArraysSamples(true); });
+
+  ExpectNearlyEqual(expected, actual, 1e-10);
+}
+
+
+// Single precision derivative accumulation trades accuracy for speed. The value and the derivative must stay within a
+// relative bound of those of double precision.
+template <class TInterpolator>
+void
+Test_SinglePrecisionDerivativeAccumulationStaysCloseToDoublePrecision()
+{
+  const MetricInput input;
+
+  const auto expected = EvaluateMetric<MeanSquaresMetricType, TInterpolator>(
+    input, [](MeanSquaresMetricType & metric) { metric.SetUseSinglePrecisionDerivativeAccumulation(false); });
+  const auto actual = EvaluateMetric<MeanSquaresMetricType, TInterpolator>(
+    input, [](MeanSquaresMetricType & metric) { metric.SetUseSinglePrecisionDerivativeAccumulation(true); });
+
+  ExpectNearlyEqual(expected, actual, 1e-4);
+}
+
+} // namespace
+
+
+GTEST_TEST(AdvancedImageToImageMetric, StructureOfArraysSamplesDoNotChangeValueAndDerivative)
+{
+  Test_StructureOfArraysSamplesDoNotChangeValueAndDerivative<MeanSquaresMetricType, LinearInterpolatorType>();
+  Test_StructureOfArraysSamplesDoNotChangeValueAndDerivative<MeanSquaresMetricType, BSplineInterpolatorType>();
+  Test_StructureOfArraysSamplesDoNotChangeValueAndDerivative<NormalizedCorrelationMetricType,
+                                                             LinearInterpolatorType>();
+  Test_StructureOfArraysSamplesDoNotChangeValueAndDerivative<NormalizedCorrelationMetricType,
+                                                             BSplineInterpolatorType>();
+}
+
+
+// The block path evaluates the moving image by the batched kernel of the
+// AdvancedBSplineInterpolateImageFunction, the other path evaluates it point by point.
+GTEST_TEST(AdvancedImageToImageMetric, BatchedBSplineInterpolationDoesNotChangeValueAndDerivative)
+{
+  Test_StructureOfArraysSamplesDoNotChangeValueAndDerivative<MeanSquaresMetricType, AdvancedBSplineInterpolatorType>();
+  Test_StructureOfArraysSamplesDoNotChangeValueAndDerivative<NormalizedCorrelationMetricType,
+                                                             AdvancedBSplineInterpolatorType>();
+}
+
+
+// A failed evaluation (too few valid samples) must not leave counts in the shared joint histograms,
+// that would otherwise be added to the histogram of the next evaluation.
+GTEST_TEST(AdvancedImageToImageMetric, SharedJointHistogramsAreResetAfterFailedEvaluation)
+{
+  const MetricInput input;
+
+  const auto configure = [](MutualInformationMetricType & metric) {
+    metric.SetNumberOfWorkUnits(4);
+    metric.SetNumberOfSharedJointPDFs(2);
+  };
+
+  const auto freshMetric = MutualInformationMetricType::New();
+  const auto freshInterpolator = LinearInterpolatorType::New();
+  const auto freshSampler = itk::ImageFullSampler<ImageType>::New();
+  configure(*freshMetric);
+  InitializeMetric(*freshMetric, input, *freshInterpolator, *freshSampler);
+  const double expectedValue = freshMetric->GetValue(input.Parameters);
+
+  const auto metric = MutualInformationMetricType::New();
+  const auto interpolator = LinearInterpolatorType::New();
+  const auto sampler = itk::ImageFullSampler<ImageType>::New();
+  configure(*metric);
+  InitializeMetric(*metric, input, *interpolator, *sampler);
+
+  /** Shift the moving image so far along the first axis, that only a fifth of the samples remains
+   * valid, which is less than the required ratio of valid samples. */
+  auto shiftedParameters = input.Parameters;
+  for (unsigned int i = 0; i < shiftedParameters.GetSize() / Dimension; ++i)
+  {
+    shiftedParameters[i] = 16.0;
+  }
+  EXPECT_THROW(metric->GetValue(shiftedParameters), itk::ExceptionObject);
+
+  EXPECT_DOUBLE_EQ(metric->GetValue(input.Parameters), expectedValue);
+}
+
+
+GTEST_TEST(AdvancedImageToImageMetric, SinglePrecisionDerivativeAccumulationStaysCloseToDoublePrecision)
+{
+  Test_SinglePrecisionDerivativeAccumulationStaysCloseToDoublePrecision<LinearInterpolatorType>();
+  Test_SinglePrecisionDerivativeAccumulationStaysCloseToDoublePrecision<BSplineInterpolatorType>();
+}
+
+
+// When the sampler selects new samples every iteration, the transform sample cache of the metric must be
+// rebuilt, instead of transforming the points of the previous samples.
+GTEST_TEST(AdvancedImageToImageMetric, TransformSampleCacheFollowsNewSamples)
+{
+  MetricInput input;
+  input.Transform = CreateBSplineCombinationTransform<RecursiveBSplineTransformType>();
+  input.Parameters = CreateTransformParameters(*input.Transform);
+
+  /** Both metrics share the sampler, so that they evaluate the same samples. */
+  const auto sampler = itk::ImageRandomSampler<ImageType>::New();
+  sampler->SetNumberOfSamples(500);
+
+  const auto cachedMetric = MeanSquaresMetricType::New();
+  const auto cachedInterpolator = LinearInterpolatorType::New();
+  cachedMetric->SetUseTransformSampleCache(true);
+  InitializeMetric(*cachedMetric, input, *cachedInterpolator, *sampler);
+
+  const auto metric = MeanSquaresMetricType::New();
+  const auto interpolator = LinearInterpolatorType::New();
+  InitializeMetric(*metric, input, *interpolator, *sampler);
+
+  for (unsigned int iteration = 0; iteration < 3; ++iteration)
+  {
+    sampler->SelectNewSamplesOnUpdate();
+    const auto expected = GetValueAndDerivative(*cachedMetric, input);
+    const auto actual = GetValueAndDerivative(*metric, input);
+    ExpectNearlyEqual(expected, actual, 1e-10);
+  }
+}
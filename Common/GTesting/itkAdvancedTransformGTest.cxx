@@ -0,0 +1,238 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkAdvancedTransform.h"
+
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkAdvancedCombinationTransform.h"
+#include "itkAdvancedMatrixOffsetTransformBase.h"
+#include "itkRecursiveBSplineTransform.h"
+#include "elxGTestUtilities.h"
+
+#include <gtest/gtest.h>
+
+#include <utility> // For pair.
+#include <vector>
+
+
+// Using-declarations:
+using elx::GTestUtilities::GeneratePseudoRandomParameters;
+
+
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using AdvancedTransformType = itk::AdvancedTransform<double, Dimension, Dimension>;
+using CombinationTransformType = itk::AdvancedCombinationTransform<double, Dimension>;
+using MatrixOffsetTransformType = itk::AdvancedMatrixOffsetTransformBase<double, Dimension, Dimension>;
+using BSplineTransformType = itk::AdvancedBSplineDeformableTransform<double, Dimension, 3>;
+using RecursiveBSplineTransformType = itk::RecursiveBSplineTransform<double, Dimension, 3>;
+using InputPointType = AdvancedTransformType::InputPointType;
+using InputVectorType = AdvancedTransformType::InputVectorType;
+using OutputPointType = AdvancedTransformType::OutputPointType;
+using MovingImageGradientType = AdvancedTransformType::MovingImageGradientType;
+using DerivativeType = AdvancedTransformType::DerivativeType;
+using NonZeroJacobianIndicesType = AdvancedTransformType::NonZeroJacobianIndicesType;
+
+
+MatrixOffsetTransformType::Pointer
+CreateAffineTransform()
+{
+  const auto                            transform = MatrixOffsetTransformType::New();
+  MatrixOffsetTransformType::MatrixType matrix;
+  matrix(0, 0) = 1.1;
+  matrix(0, 1) = 0.2;
+  matrix(1, 0) = -0.15;
+  matrix(1, 1) = 0.9;
+  transform->SetMatrix(matrix);
+  MatrixOffsetTransformType::OutputVectorType translation;
+  translation[0] = 3.5;
+  translation[1] = -2.25;
+  transform->SetTranslation(translation);
+  return transform;
+}
+
+
+// Creates a B-spline transform with a 10x10 grid with spacing 4, over [-6, 30]^2.
+template <typename TBSplineTransform = BSplineTransformType>
+typename TBSplineTransform::Pointer
+CreateBSplineTransform(const double maximumCoefficient)
+{
+  const auto transform = TBSplineTransform::New();
+  transform->SetGridRegion(typename TBSplineTransform::RegionType(TBSplineTransform::SizeType::Filled(10)));
+  transform->SetGridSpacing(typename TBSplineTransform::SpacingType(4.0));
+  transform->SetGridOrigin(typename TBSplineTransform::OriginType(-6.0));
+  transform->SetParametersByValue(
+    GeneratePseudoRandomParameters(transform->GetNumberOfParameters(), -maximumCoefficient, maximumCoefficient));
+  return transform;
+}
+
+
+CombinationTransformType::Pointer
+CreateCombinationTransform(CombinationTransformType::CurrentTransformType * currentTransform,
+                           CombinationTransformType::InitialTransformType * initialTransform,
+                           const bool                                       useAddition)
+{
+  const auto transform = CombinationTransformType::New();
+  transform->SetCurrentTransform(currentTransform);
+  transform->SetInitialTransform(initialTransform);
+  transform->SetUseAddition(useAddition);
+  return transform;
+}
+
+
+// Expects that TransformPointsAlongLine() maps the rows like TransformPoint() maps their points, for rows that
+// lie inside the B-spline grid, partly outside of it, and along a rotated direction.
+void
+Expect_TransformPointsAlongLine_equals_TransformPoint(const AdvancedTransformType & transform,
+                                                      const double                  tolerance)
+{
+  const std::vector<std::pair<InputPointType, InputVectorType>> rows = {
+    { itk::MakePoint(0.0, 1.0), itk::MakeVector(0.5, 0.0) },
+    { itk::MakePoint(-10.0, 7.25), itk::MakeVector(1.0, 0.0) },
+    { itk::MakePoint(2.0, 3.0), itk::MakeVector(0.4, 0.3) },
+    { itk::MakePoint(25.0, 20.0), itk::MakeVector(0.0, -0.75) }
+  };
+  constexpr itk::SizeValueType numberOfPoints = 37;
+
+  for (const auto & row : rows)
+  {
+    std::vector<OutputPointType> outputPoints(numberOfPoints);
+    transform.TransformPointsAlongLine(row.first, row.second, numberOfPoints, outputPoints.data());
+
+    for (itk::SizeValueType k = 0; k < numberOfPoints; ++k)
+    {
+      const InputPointType  point = row.first + row.second * static_cast<double>(k);
+      const OutputPointType expectedPoint = transform.TransformPoint(point);
+      for (unsigned int d = 0; d < Dimension; ++d)
+      {
+        EXPECT_NEAR(outputPoints[k][d], expectedPoint[d], tolerance) << " point = " << point << "; k = " << k;
+      }
+    }
+  }
+}
+
+
+// Expects that the batched EvaluateJacobianWithImageGradientProducts(), with and without the sample cache of the
+// transform, yields the same products and nonzero Jacobian indices as EvaluateJacobianWithImageGradientProduct().
+// The points include points whose support region lies partly outside of the B-spline grid.
+void
+Expect_JacobianWithImageGradientProducts_equal_JacobianWithImageGradientProduct(
+  const AdvancedTransformType & transform)
+{
+  constexpr itk::SizeValueType numberOfPoints = 41;
+  const auto                   nnzji = transform.GetNumberOfNonZeroJacobianIndices();
+
+  std::vector<InputPointType>          points(numberOfPoints);
+  std::vector<MovingImageGradientType> gradients(numberOfPoints);
+  std::vector<itk::SizeValueType>      sampleIndices(numberOfPoints);
+  for (itk::SizeValueType n = 0; n < numberOfPoints; ++n)
+  {
+    points[n] = itk::MakePoint(-8.0 + 0.9 * n, 30.0 - 0.7 * n);
+    gradients[n][0] = 1.0 + 0.1 * n;
+    gradients[n][1] = -0.5 + 0.05 * n;
+    sampleIndices[n] = n;
+  }
+
+  std::vector<DerivativeType>             expectedImageJacobians(numberOfPoints, DerivativeType(nnzji));
+  std::vector<NonZeroJacobianIndicesType> expectedIndices(numberOfPoints, NonZeroJacobianIndicesType(nnzji));
+  for (itk::SizeValueType n = 0; n < numberOfPoints; ++n)
+  {
+    expectedImageJacobians[n].Fill(0.0);
+    transform.EvaluateJacobianWithImageGradientProduct(
+      points[n], gradients[n], expectedImageJacobians[n], expectedIndices[n]);
+  }
+
+  // Fill with a nonzero value, to check that the products of points outside the grid are zeroed.
+  std::vector<DerivativeType>             imageJacobians(numberOfPoints, DerivativeType(nnzji));
+  std::vector<NonZeroJacobianIndicesType> indices(numberOfPoints, NonZeroJacobianIndicesType(nnzji));
+  for (auto & imageJacobian : imageJacobians)
+  {
+    imageJacobian.Fill(1.0);
+  }
+  transform.EvaluateJacobianWithImageGradientProducts(
+    points.data(), gradients.data(), imageJacobians.data(), indices.data(), numberOfPoints);
+  EXPECT_EQ(imageJacobians, expectedImageJacobians);
+  EXPECT_EQ(indices, expectedIndices);
+
+  const auto sampleCache = transform.CreateSampleCache(points.data(), numberOfPoints);
+  if (sampleCache != nullptr)
+  {
+    for (auto & imageJacobian : imageJacobians)
+    {
+      imageJacobian.Fill(1.0);
+    }
+    transform.EvaluateJacobianWithImageGradientProductsUsingSampleCache(
+      *sampleCache, sampleIndices.data(), gradients.data(), imageJacobians.data(), indices.data(), numberOfPoints);
+    EXPECT_EQ(imageJacobians, expectedImageJacobians);
+    EXPECT_EQ(indices, expectedIndices);
+  }
+}
+
+} // namespace
+
+
+GTEST_TEST(AdvancedTransform, TransformPointsAlongLineByDefault)
+{
+  // AdvancedMatrixOffsetTransformBase does not override TransformPointsAlongLine, so the row is passed to
+  // TransformPoints(), which yields exactly the same points as TransformPoint().
+  Expect_TransformPointsAlongLine_equals_TransformPoint(*CreateAffineTransform(), 0.0);
+}
+
+
+GTEST_TEST(AdvancedTransform, TransformPointsAlongLineOfBSpline)
+{
+  Expect_TransformPointsAlongLine_equals_TransformPoint(*CreateBSplineTransform(2.0), 1e-10);
+}
+
+
+GTEST_TEST(AdvancedTransform, TransformPointsAlongLineOfCombination)
+{
+  const auto bspline = CreateBSplineTransform(2.0);
+  const auto affine = CreateAffineTransform();
+
+  // The B-spline stage of a multi-stage registration, as a nonlinear initial transform.
+  const auto nonlinearInitialTransform = CreateCombinationTransform(CreateBSplineTransform(1.0), nullptr, false);
+
+  for (const bool useAddition : { false, true })
+  {
+    // Without an initial transform, with a linear one, and with a nonlinear one.
+    Expect_TransformPointsAlongLine_equals_TransformPoint(*CreateCombinationTransform(bspline, nullptr, useAddition),
+                                                          1e-10);
+    Expect_TransformPointsAlongLine_equals_TransformPoint(*CreateCombinationTransform(bspline, affine, useAddition),
+                                                          1e-10);
+    Expect_TransformPointsAlongLine_equals_TransformPoint(
+      *CreateCombinationTransform(bspline, nonlinearInitialTransform, useAddition), 1e-10);
+  }
+}
+
+
+GTEST_TEST(AdvancedTransform, JacobianWithImageGradientProducts)
+{
+  const auto bspline = CreateBSplineTransform<RecursiveBSplineTransformType>(2.0);
+
+  Expect_JacobianWithImageGradientProducts_equal_JacobianWithImageGradientProduct(*CreateAffineTransform());
+  Expect_JacobianWithImageGradientProducts_equal_JacobianWithImageGradientProduct(*bspline);
+
+  for (const bool useAddition : { false, true })
+  {
+    Expect_JacobianWithImageGradientProducts_equal_JacobianWithImageGradientProduct(
+      *CreateCombinationTransform(bspline, CreateAffineTransform(), useAddition));
+  }
+}
@@ -0,0 +1,103 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkComputeJacobianTerms.h"
+
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkAdvancedCombinationTransform.h"
+#include "itkWorkStealingThreadPool.h"
+
+#include <itkImage.h>
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath> // For sin.
+
+
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image<float, Dimension>;
+using CombinationTransformType = itk::AdvancedCombinationTransform<double, Dimension>;
+using BSplineTransformType = itk::AdvancedBSplineDeformableTransform<double, Dimension, 3>;
+using ComputeJacobianTermsType = itk::ComputeJacobianTerms<ImageType, CombinationTransformType>;
+
+
+// Computes the Jacobian terms TrC, TrCC, maxJJ and maxJCJ, using the specified number of threads.
+std::array<double, 4>
+ComputeJacobianTermsUsingThreads(const itk::ThreadIdType numberOfThreads, const bool useScales)
+{
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(32));
+  image->Allocate(true);
+
+  const auto bspline = BSplineTransformType::New();
+  bspline->SetGridRegion(BSplineTransformType::RegionType(BSplineTransformType::SizeType::Filled(8)));
+  bspline->SetGridSpacing(BSplineTransformType::SpacingType(6.0));
+  bspline->SetGridOrigin(BSplineTransformType::OriginType(-7.0));
+  const auto transform = CombinationTransformType::New();
+  transform->SetCurrentTransform(bspline);
+
+  const auto computeJacobianTerms = ComputeJacobianTermsType::New();
+  computeJacobianTerms->SetFixedImage(image);
+  computeJacobianTerms->SetFixedImageRegion(image->GetBufferedRegion());
+  computeJacobianTerms->SetTransform(transform);
+  computeJacobianTerms->SetMaxBandCovSize(192);
+  computeJacobianTerms->SetNumberOfBandStructureSamples(10);
+  computeJacobianTerms->SetNumberOfJacobianMeasurements(700);
+  if (useScales)
+  {
+    ComputeJacobianTermsType::ScalesType scales(transform->GetNumberOfParameters());
+    for (unsigned int i = 0; i < scales.GetSize(); ++i)
+    {
+      scales[i] = 1.0 + 0.5 * std::sin(0.3 * i);
+    }
+    computeJacobianTerms->SetScales(scales);
+  }
+  computeJacobianTerms->SetUseScales(useScales);
+
+  const auto               threadPool = itk::WorkStealingThreadPool::GetInstance();
+  const itk::ThreadIdType  originalNumberOfThreads = threadPool->GetNumberOfThreads();
+  threadPool->SetNumberOfThreads(numberOfThreads);
+
+  std::array<double, 4> terms{};
+  computeJacobianTerms->Compute(terms[0], terms[1], terms[2], terms[3]);
+
+  threadPool->SetNumberOfThreads(originalNumberOfThreads);
+  return terms;
+}
+
+} // namespace
+
+
+// The parallel computation of the Jacobian terms must give exactly the same result as the serial one.
+GTEST_TEST(ComputeJacobianTerms, ParallelComputationEqualsSerialComputation)
+{
+  for (const bool useScales : { false, true })
+  {
+    const auto serialTerms = ComputeJacobianTermsUsingThreads(1, useScales);
+    EXPECT_GT(serialTerms[0], 0.0);
+
+    for (const itk::ThreadIdType numberOfThreads : { 2u, 3u, 8u })
+    {
+      EXPECT_EQ(ComputeJacobianTermsUsingThreads(numberOfThreads, useScales), serialTerms);
+    }
+  }
+}
@@ -0,0 +1,136 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// First include the header file to be tested:
+#include "itkMultiResolutionImageRegistrationMethod2.h"
+
+#include "AdvancedMeanSquares/itkAdvancedMeanSquaresImageToImageMetric.h"
+#include "itkAdvancedTranslationTransform.h"
+#include "itkImageFullSampler.h"
+
+// ITK header files:
+#include <itkBSplineInterpolateImageFunction.h>
+#include <itkImage.h>
+#include <itkImageRegionIteratorWithIndex.h>
+#include <itkRegularStepGradientDescentOptimizer.h>
+
+// GoogleTest header file:
+#include <gtest/gtest.h>
+
+#include <cmath> // For exp.
+#include <vector>
+
+
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image<float, Dimension>;
+using RegistrationType = itk::MultiResolutionImageRegistrationMethod2<ImageType, ImageType>;
+using ParametersType = RegistrationType::ParametersType;
+using MetricType = itk::AdvancedMeanSquaresImageToImageMetric<ImageType, ImageType>;
+using TransformType = itk::AdvancedTranslationTransform<double, Dimension>;
+using InterpolatorType = itk::BSplineInterpolateImageFunction<ImageType, double, double>;
+using SamplerType = itk::ImageFullSampler<ImageType>;
+using OptimizerType = itk::RegularStepGradientDescentOptimizer;
+
+
+// Creates an image of a smooth blob, whose center is shifted by (shiftX, shiftY) from the center of the image.
+ImageType::Pointer
+CreateBlobImage(const double shiftX, const double shiftY)
+{
+  const auto image = ImageType::New();
+  image->SetRegions(ImageType::SizeType::Filled(64));
+  image->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const auto & index = it.GetIndex();
+    const double x = index[0] - 31.5 - shiftX;
+    const double y = index[1] - 31.5 - shiftY;
+    it.Set(static_cast<float>(100.0 * std::exp(-(x * x + y * y) / 50.0)));
+  }
+  return image;
+}
+
+
+ParametersType
+MakeTranslationParameters(const double x, const double y)
+{
+  ParametersType parameters(Dimension);
+  parameters[0] = x;
+  parameters[1] = y;
+  return parameters;
+}
+
+} // namespace
+
+
+// Tests that a generated start beats a bad initial start, and that the result of its run is kept as the result of the
+// level, without optimizing it again.
+GTEST_TEST(MultiResolutionImageRegistrationMethod2, BestStartIsKeptWithoutOptimizingItAgain)
+{
+  // The optimal translation is (3, -2).
+  const auto fixedImage = CreateBlobImage(0.0, 0.0);
+  const auto movingImage = CreateBlobImage(3.0, -2.0);
+
+  const auto metric = MetricType::New();
+  metric->SetImageSampler(SamplerType::New());
+
+  // The optimizer can move at most 10 mm, so it cannot reach the optimum from the initial start.
+  const auto optimizer = OptimizerType::New();
+  optimizer->SetMaximumStepLength(1.0);
+  optimizer->SetMinimumStepLength(0.01);
+  optimizer->SetNumberOfIterations(10);
+  optimizer->SetScales(OptimizerType::ScalesType(Dimension, 1.0));
+
+  const auto registration = RegistrationType::New();
+  registration->SetFixedImage(fixedImage);
+  registration->SetMovingImage(movingImage);
+  registration->SetFixedImageRegion(fixedImage->GetBufferedRegion());
+  registration->SetMetric(metric);
+  registration->SetOptimizer(optimizer);
+  registration->SetTransform(TransformType::New());
+  registration->SetInterpolator(InterpolatorType::New());
+  registration->SetInitialTransformParameters(MakeTranslationParameters(20.0, 20.0));
+  registration->SetMultiStartTransformParameters({ MakeTranslationParameters(2.0, -1.0) });
+
+  unsigned int                numberOfRuns = 0;
+  std::vector<ParametersType> resultsOfRuns;
+  optimizer->AddObserver(itk::StartEvent(), [&numberOfRuns](const itk::EventObject &) { ++numberOfRuns; });
+  optimizer->AddObserver(itk::EndEvent(), [&registration, &optimizer, &resultsOfRuns](const itk::EventObject &) {
+    if (registration->GetIsOptimizingMultiStarts())
+    {
+      resultsOfRuns.push_back(optimizer->GetCurrentPosition());
+    }
+  });
+
+  registration->Update();
+
+  // The optimizer has run once from each start.
+  EXPECT_EQ(numberOfRuns, 2U);
+  ASSERT_EQ(resultsOfRuns.size(), 2U);
+
+  // The generated start is ranked first, and the result of its run is the result of the registration.
+  const auto & values = registration->GetMultiStartValues();
+  ASSERT_EQ(values.size(), 2U);
+  EXPECT_LT(values[0], values[1]);
+  EXPECT_EQ(registration->GetNumberOfActiveMultiStarts(), 1U);
+  EXPECT_EQ(registration->GetLastTransformParameters(), resultsOfRuns[1]);
+  EXPECT_EQ(registration->GetTransform()->GetParameters(), resultsOfRuns[1]);
+  EXPECT_NEAR(resultsOfRuns[1][0], 3.0, 0.25);
+  EXPECT_NEAR(resultsOfRuns[1][1], -2.0, 0.25);
+}
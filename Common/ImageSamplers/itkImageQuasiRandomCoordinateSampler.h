@@ -0,0 +1,163 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageQuasiRandomCoordinateSampler_h
+#define itkImageQuasiRandomCoordinateSampler_h
+
+#include "itkImageRandomCoordinateSampler.h"
+
+#include <vector>
+
+namespace itk
+{
+
+/** \class ImageQuasiRandomCoordinateSampler
+ *
+ * \brief Samples an image at the physical coordinates of a scrambled Halton sequence.
+ *
+ * This sampler works like the ImageRandomCoordinateSampler, but the coordinates
+ * are taken from a low-discrepancy (quasi-random) sequence instead of being
+ * drawn independently. The points of a Halton sequence fill the sample region
+ * more evenly than independent random points, which reduces the variance of
+ * the metric value and derivative for a given number of samples.
+ *
+ * Every time new samples are generated, the sequence is scrambled with new
+ * random digit permutations (one permutation per dimension and per digit),
+ * and restarted. The samples are therefore different in every iteration, but
+ * each set of samples is still a low-discrepancy point set. The permutations
+ * are drawn from the random generator of the ImageRandomCoordinateSampler, so
+ * the samples are reproducible for a fixed random seed. Masks and random
+ * sample regions are handled as in the ImageRandomCoordinateSampler.
+ *
+ * The sequence is generated serially, so UseCounterBasedRandomNumbers is not
+ * supported by this sampler.
+ *
+ * \ingroup ImageSamplers
+ */
+
+template <class TInputImage>
+class ITK_TEMPLATE_EXPORT ImageQuasiRandomCoordinateSampler : public ImageRandomCoordinateSampler<TInputImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(ImageQuasiRandomCoordinateSampler);
+
+  /** Standard ITK-stuff. */
+  using Self = ImageQuasiRandomCoordinateSampler;
+  using Superclass = ImageRandomCoordinateSampler<TInputImage>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageQuasiRandomCoordinateSampler, ImageRandomCoordinateSampler);
+
+  /** Typedefs inherited from the superclass. */
+  using typename Superclass::DataObjectPointer;
+  using typename Superclass::OutputVectorContainerType;
+  using typename Superclass::OutputVectorContainerPointer;
+  using typename Superclass::InputImageType;
+  using typename Superclass::InputImagePointer;
+  using typename Superclass::InputImageConstPointer;
+  using typename Superclass::InputImageRegionType;
+  using typename Superclass::InputImagePixelType;
+  using typename Superclass::ImageSampleType;
+  using typename Superclass::ImageSampleContainerType;
+  using typename Superclass::ImageSampleContainerPointer;
+  using typename Superclass::MaskType;
+  using typename Superclass::InputImageSizeType;
+  using typename Superclass::InputImageSpacingType;
+  using typename Superclass::InputImageIndexType;
+  using typename Superclass::InputImagePointType;
+  using typename Superclass::InputImagePointValueType;
+  using typename Superclass::ImageSampleValueType;
+  using typename Superclass::CoordRepType;
+  using typename Superclass::InterpolatorType;
+  using typename Superclass::InterpolatorPointer;
+  using typename Superclass::DefaultInterpolatorType;
+  using typename Superclass::RandomGeneratorType;
+  using typename Superclass::RandomGeneratorPointer;
+
+  /** The input image dimension. */
+  itkStaticConstMacro(InputImageDimension, unsigned int, Superclass::InputImageDimension);
+
+  /** Set/Get whether the sequence is scrambled and restarted every time new samples
+   * are generated. Without scrambling, the plain Halton sequence is used, and it
+   * continues where the previous set of samples ended. Default: true. */
+  itkSetMacro(UseScrambling, bool);
+  itkGetConstMacro(UseScrambling, bool);
+  itkBooleanMacro(UseScrambling);
+
+protected:
+  using typename Superclass::InputImageContinuousIndexType;
+
+  /** The constructor. */
+  ImageQuasiRandomCoordinateSampler() = default;
+
+  /** The destructor. Waits for the background sample generation, which uses the members. */
+  ~ImageQuasiRandomCoordinateSampler() override { this->WaitForBackgroundSampleGeneration(); }
+
+  /** PrintSelf. */
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** Function that does the work. Scrambles the sequence, and calls the superclass. */
+  void
+  GenerateData() override;
+
+  /** Generate the next point of the sequence in a bounding box. */
+  void
+  GenerateRandomCoordinate(const InputImageContinuousIndexType & smallestContIndex,
+                           const InputImageContinuousIndexType & largestContIndex,
+                           InputImageContinuousIndexType &       randomContIndex) override;
+
+  /** Generate the corners of a sampling region. The region itself is chosen randomly,
+   * so that it does not consume points of the sequence. */
+  void
+  GenerateSampleRegion(const InputImageContinuousIndexType & smallestImageContIndex,
+                       const InputImageContinuousIndexType & largestImageContIndex,
+                       InputImageContinuousIndexType &       smallestContIndex,
+                       InputImageContinuousIndexType &       largestContIndex) override;
+
+  /** Draw new digit permutations, or identity permutations when UseScrambling is false. */
+  void
+  ScrambleSequence();
+
+  /** Get coordinate dim of point index of the (scrambled) Halton sequence, in [0, 1). */
+  double
+  GetSequenceValue(unsigned int dim, SizeValueType index) const;
+
+private:
+  bool          m_UseScrambling{ true };
+  bool          m_IsGeneratingSampleRegion{ false };
+  SizeValueType m_SequenceIndex{ 0 };
+
+  /** Per dimension: the base, the number of digits, and the digit permutations,
+   * stored as one permutation of [0, base) per digit. */
+  unsigned int              m_Bases[InputImageDimension]{};
+  unsigned int              m_NumberOfDigits[InputImageDimension]{};
+  std::vector<unsigned int> m_DigitPermutations[InputImageDimension];
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkImageQuasiRandomCoordinateSampler.hxx"
+#endif
+
+#endif // end #ifndef itkImageQuasiRandomCoordinateSampler_h
@@ -0,0 +1,188 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageQuasiRandomCoordinateSampler_hxx
+#define itkImageQuasiRandomCoordinateSampler_hxx
+
+#include "itkImageQuasiRandomCoordinateSampler.h"
+
+#include <cmath>
+#include <numeric> // For iota.
+#include <utility> // For swap.
+
+namespace itk
+{
+
+/**
+ * ******************* GenerateData *******************
+ */
+
+template <class TInputImage>
+void
+ImageQuasiRandomCoordinateSampler<TInputImage>::GenerateData()
+{
+  /** Sanity check. */
+  if (this->m_UseCounterBasedRandomNumbers)
+  {
+    itkExceptionMacro(<< "ERROR: the quasi-random sequence is generated serially, "
+                      << "UseCounterBasedRandomNumbers is not supported.");
+  }
+
+  /** Scramble and restart the sequence for every new set of samples.
+   * Without scrambling, the sequence just continues. */
+  if (this->m_UseScrambling || this->m_DigitPermutations[0].empty())
+  {
+    this->ScrambleSequence();
+    this->m_SequenceIndex = 0;
+  }
+
+  /** The superclass generates the samples, using GenerateRandomCoordinate(). */
+  Superclass::GenerateData();
+
+} // end GenerateData()
+
+
+/**
+ * ******************* GenerateRandomCoordinate *******************
+ */
+
+template <class TInputImage>
+void
+ImageQuasiRandomCoordinateSampler<TInputImage>::GenerateRandomCoordinate(
+  const InputImageContinuousIndexType & smallestContIndex,
+  const InputImageContinuousIndexType & largestContIndex,
+  InputImageContinuousIndexType &       randomContIndex)
+{
+  if (this->m_IsGeneratingSampleRegion)
+  {
+    Superclass::GenerateRandomCoordinate(smallestContIndex, largestContIndex, randomContIndex);
+    return;
+  }
+
+  for (unsigned int i = 0; i < InputImageDimension; ++i)
+  {
+    const double value = this->GetSequenceValue(i, this->m_SequenceIndex);
+    randomContIndex[i] = static_cast<InputImagePointValueType>(
+      smallestContIndex[i] + value * (largestContIndex[i] - smallestContIndex[i]));
+  }
+  ++this->m_SequenceIndex;
+
+} // end GenerateRandomCoordinate()
+
+
+/**
+ * ******************* GenerateSampleRegion *******************
+ */
+
+template <class TInputImage>
+void
+ImageQuasiRandomCoordinateSampler<TInputImage>::GenerateSampleRegion(
+  const InputImageContinuousIndexType & smallestImageContIndex,
+  const InputImageContinuousIndexType & largestImageContIndex,
+  InputImageContinuousIndexType &       smallestContIndex,
+  InputImageContinuousIndexType &       largestContIndex)
+{
+  this->m_IsGeneratingSampleRegion = true;
+  Superclass::GenerateSampleRegion(smallestImageContIndex, largestImageContIndex, smallestContIndex, largestContIndex);
+  this->m_IsGeneratingSampleRegion = false;
+
+} // end GenerateSampleRegion()
+
+
+/**
+ * ******************* ScrambleSequence *******************
+ */
+
+template <class TInputImage>
+void
+ImageQuasiRandomCoordinateSampler<TInputImage>::ScrambleSequence()
+{
+  /** The bases of the Halton sequence: the first primes. */
+  constexpr unsigned int primes[] = { 2, 3, 5, 7, 11, 13, 17, 19 };
+  static_assert(InputImageDimension <= sizeof(primes) / sizeof(primes[0]), "Too many dimensions.");
+
+  for (unsigned int i = 0; i < InputImageDimension; ++i)
+  {
+    /** Use enough digits to fill the mantissa of a double. */
+    const unsigned int base = primes[i];
+    this->m_Bases[i] = base;
+    this->m_NumberOfDigits[i] = static_cast<unsigned int>(std::ceil(53.0 / std::log2(static_cast<double>(base))));
+
+    std::vector<unsigned int> & permutations = this->m_DigitPermutations[i];
+    permutations.resize(this->m_NumberOfDigits[i] * base);
+    for (unsigned int digit = 0; digit < this->m_NumberOfDigits[i]; ++digit)
+    {
+      unsigned int * permutation = permutations.data() + digit * base;
+      std::iota(permutation, permutation + base, 0u);
+
+      /** Fisher-Yates shuffle. */
+      if (this->m_UseScrambling)
+      {
+        for (unsigned int j = base - 1; j > 0; --j)
+        {
+          std::swap(permutation[j], permutation[this->m_RandomGenerator->GetIntegerVariate(j)]);
+        }
+      }
+    }
+  }
+
+} // end ScrambleSequence()
+
+
+/**
+ * ******************* GetSequenceValue *******************
+ */
+
+template <class TInputImage>
+double
+ImageQuasiRandomCoordinateSampler<TInputImage>::GetSequenceValue(const unsigned int dim, SizeValueType index) const
+{
+  /** Compute the radical inverse of the index, permuting each digit. */
+  const unsigned int   base = this->m_Bases[dim];
+  const unsigned int * permutation = this->m_DigitPermutations[dim].data();
+  double               factor = 1.0 / base;
+  double               value = 0.0;
+  for (unsigned int digit = 0; digit < this->m_NumberOfDigits[dim]; ++digit, permutation += base)
+  {
+    value += permutation[index % base] * factor;
+    index /= base;
+    factor /= base;
+  }
+  return value;
+
+} // end GetSequenceValue()
+
+
+/**
+ * ******************* PrintSelf *******************
+ */
+
+template <class TInputImage>
+void
+ImageQuasiRandomCoordinateSampler<TInputImage>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "UseScrambling: " << this->m_UseScrambling << std::endl;
+  os << indent << "SequenceIndex: " << this->m_SequenceIndex << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef itkImageQuasiRandomCoordinateSampler_hxx
@@ -33,6 +33,10 @@ namespace itk
  * This image sampler generates not only samples that correspond with
  * pixel locations, but selects points in physical space.
  *
+ * The samples can be generated in the background (UseBackgroundSampleGeneration).
+ * The sampler then draws its random coordinates from its own random generator,
+ * which is seeded from the global one at the first background generation.
+ *
  * \ingroup ImageSamplers
  */
 
@@ -102,14 +106,22 @@ public:
   itkGetConstMacro(UseRandomSampleRegion, bool);
   itkSetMacro(UseRandomSampleRegion, bool);
 
+  /** Returns true: the samples can be generated in the background. */
+  bool
+  BackgroundSampleGenerationSupported() const override
+  {
+    return true;
+  }
+
+
 protected:
   using InputImageContinuousIndexType = typename InterpolatorType::ContinuousIndexType;
 
   /** The constructor. */
   ImageRandomCoordinateSampler() = default;
 
-  /** The destructor. */
-  ~ImageRandomCoordinateSampler() override = default;
+  /** The destructor. Waits for the background sample generation, which uses the members. */
+  ~ImageRandomCoordinateSampler() override { this->WaitForBackgroundSampleGeneration(); }
 
   /** PrintSelf. */
   void
@@ -126,6 +138,10 @@ protected:
   void
   ThreadedGenerateData(const InputImageRegionType & inputRegionForThread, ThreadIdType threadId) override;
 
+  /** Gives the sampler its own random generator, before the first background sample generation. */
+  void
+  BeforeBackgroundSampleGeneration() override;
+
   /** Generate a point randomly in a bounding box. */
   virtual void
   GenerateRandomCoordinate(const InputImageContinuousIndexType & smallestContIndex,
@@ -152,6 +168,10 @@ protected:
                        InputImageContinuousIndexType &       smallestContIndex,
                        InputImageContinuousIndexType &       largestContIndex);
 
+  /** The corners of the sampling region, used by the threads. */
+  InputImageContinuousIndexType m_ThreaderSmallestContIndex;
+  InputImageContinuousIndexType m_ThreaderLargestContIndex;
+
 private:
   bool m_UseRandomSampleRegion{ false };
 };
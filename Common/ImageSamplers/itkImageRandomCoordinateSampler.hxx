@@ -42,7 +42,7 @@ ImageRandomCoordinateSampler<TInputImage>::GenerateData()
 
   /** Get handles to the input image, output sample container, and interpolator. */
   InputImageConstPointer                     inputImage = this->GetInput();
-  typename ImageSampleContainerType::Pointer sampleContainer = this->GetOutput();
+  typename ImageSampleContainerType::Pointer sampleContainer = this->GetSampleContainerToGenerate();
   typename InterpolatorType::Pointer         interpolator = this->GetModifiableInterpolator();
 
   /** Set up the interpolator. */
@@ -90,8 +90,8 @@ ImageRandomCoordinateSampler<TInputImage>::GenerateData()
   }   // end if no mask
   else
   {
-    /** Update the mask. */
-    if (mask->GetSource())
+    /** Update the mask. In the background, it has already been updated by the calling thread. */
+    if (!this->IsGeneratingInBackground() && mask->GetSource())
     {
       mask->GetSource()->Update();
     }
@@ -152,7 +152,6 @@ ImageRandomCoordinateSampler<TInputImage>::BeforeThreadedGenerateData()
 
   /** Clear the random number list. */
   this->m_RandomNumberList.resize(0);
-  this->m_RandomNumberList.reserve(this->m_NumberOfSamples * InputImageDimension);
 
   /** Convert inputImageRegion to bounding box in physical space. */
   InputImageSizeType unitSize;
@@ -161,16 +160,25 @@ ImageRandomCoordinateSampler<TInputImage>::BeforeThreadedGenerateData()
   InputImageIndexType           largestIndex = smallestIndex + this->GetCroppedInputImageRegion().GetSize() - unitSize;
   InputImageContinuousIndexType smallestImageCIndex(smallestIndex);
   InputImageContinuousIndexType largestImageCIndex(largestIndex);
-  InputImageContinuousIndexType smallestCIndex, largestCIndex, randomCIndex;
-  this->GenerateSampleRegion(smallestImageCIndex, largestImageCIndex, smallestCIndex, largestCIndex);
+  InputImageContinuousIndexType randomCIndex;
+  this->GenerateSampleRegion(
+    smallestImageCIndex, largestImageCIndex, this->m_ThreaderSmallestContIndex, this->m_ThreaderLargestContIndex);
 
-  /** Fill the list with random numbers. */
-  for (unsigned long i = 0; i < this->m_NumberOfSamples; ++i)
+  /** Fill the list with random numbers, unless the threads compute their own. */
+  if (this->m_UseCounterBasedRandomNumbers)
   {
-    this->GenerateRandomCoordinate(smallestCIndex, largestCIndex, randomCIndex);
-    for (unsigned int j = 0; j < InputImageDimension; ++j)
+    this->InitializeCounterBasedRandomNumbers();
+  }
+  else
+  {
+    this->m_RandomNumberList.reserve(this->m_NumberOfSamples * InputImageDimension);
+    for (unsigned long i = 0; i < this->m_NumberOfSamples; ++i)
     {
-      this->m_RandomNumberList.push_back(randomCIndex[j]);
+      this->GenerateRandomCoordinate(this->m_ThreaderSmallestContIndex, this->m_ThreaderLargestContIndex, randomCIndex);
+      for (unsigned int j = 0; j < InputImageDimension; ++j)
+      {
+        this->m_RandomNumberList.push_back(randomCIndex[j]);
+      }
     }
   }
 
@@ -223,12 +231,25 @@ ImageRandomCoordinateSampler<TInputImage>::ThreadedGenerateData(const InputImage
   /** Fill the local sample container. */
   InputImageContinuousIndexType sampleCIndex;
   unsigned long                 sampleId = sampleStart;
+  double                        randomNumbers[InputImageDimension];
   for (iter = sampleContainerThisThread->Begin(); iter != end; ++iter)
   {
     /** Create a random point out of InputImageDimension random numbers. */
-    for (unsigned int j = 0; j < InputImageDimension; ++j, sampleId++)
+    if (this->m_UseCounterBasedRandomNumbers)
+    {
+      this->GetCounterBasedUniformVariates(sampleId / InputImageDimension, randomNumbers, InputImageDimension);
+      for (unsigned int j = 0; j < InputImageDimension; ++j, sampleId++)
+      {
+        const double smallest = this->m_ThreaderSmallestContIndex[j];
+        sampleCIndex[j] = smallest + randomNumbers[j] * (this->m_ThreaderLargestContIndex[j] - smallest);
+      }
+    }
+    else
     {
-      sampleCIndex[j] = this->m_RandomNumberList[sampleId];
+      for (unsigned int j = 0; j < InputImageDimension; ++j, sampleId++)
+      {
+        sampleCIndex[j] = this->m_RandomNumberList[sampleId];
+      }
     }
 
     /** Make a reference to the current sample in the container. */
@@ -246,6 +267,28 @@ ImageRandomCoordinateSampler<TInputImage>::ThreadedGenerateData(const InputImage
 } // end ThreadedGenerateData()
 
 
+/**
+ * ******************* BeforeBackgroundSampleGeneration *******************
+ */
+
+template <class TInputImage>
+void
+ImageRandomCoordinateSampler<TInputImage>::BeforeBackgroundSampleGeneration()
+{
+  Superclass::BeforeBackgroundSampleGeneration();
+
+  /** The background thread may not share the global generator with the rest of the
+   * program. Its own generator is seeded from the global one, for reproducibility. */
+  const RandomGeneratorPointer globalGenerator = RandomGeneratorType::GetInstance();
+  if (this->m_RandomGenerator == globalGenerator)
+  {
+    this->m_RandomGenerator = RandomGeneratorType::New();
+    this->m_RandomGenerator->SetSeed(globalGenerator->GetIntegerVariate());
+  }
+
+} // end BeforeBackgroundSampleGeneration()
+
+
 /**
  * ******************* GenerateRandomCoordinate *******************
  */
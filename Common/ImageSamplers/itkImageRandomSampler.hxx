@@ -168,9 +168,20 @@ ImageRandomSampler<TInputImage>::ThreadedGenerateData(const InputImageRegionType
   unsigned long       sampleId = sampleStart;
   InputImageSizeType  regionSize = this->GetCroppedInputImageRegion().GetSize();
   InputImageIndexType regionIndex = this->GetCroppedInputImageRegion().GetIndex();
+  const double        numPixels = static_cast<double>(this->GetCroppedInputImageRegion().GetNumberOfPixels());
   for (iter = sampleContainerThisThread->Begin(); iter != end; ++iter, sampleId++)
   {
-    unsigned long randomPosition = static_cast<unsigned long>(this->m_RandomNumberList[sampleId]);
+    double randomNumber;
+    if (this->m_UseCounterBasedRandomNumbers)
+    {
+      this->GetCounterBasedUniformVariates(sampleId, &randomNumber, 1);
+      randomNumber *= numPixels - 0.5;
+    }
+    else
+    {
+      randomNumber = this->m_RandomNumberList[sampleId];
+    }
+    unsigned long randomPosition = static_cast<unsigned long>(randomNumber);
 
     /** Translate randomPosition to an index, copied from ImageRandomConstIteratorWithIndex. */
     unsigned long       residual;
@@ -19,6 +19,7 @@
 #define itkImageRandomSamplerBase_h
 
 #include "itkImageSamplerBase.h"
+#include "itkPhiloxRandomNumberGenerator.h"
 
 namespace itk
 {
@@ -29,6 +30,17 @@ namespace itk
  *
  * It adds the Set/GetNumberOfSamples function.
  *
+ * By default the random numbers of all samples are drawn serially from the
+ * global Mersenne Twister, before the threads start. When
+ * UseCounterBasedRandomNumbers is set, the random numbers of a sample are
+ * instead computed by a counter-based generator, as a function of a seed,
+ * the generation number and the sample number. The threads can then draw
+ * their own random numbers, and the samples do not depend on the number of
+ * threads. The seed is drawn once from the global Mersenne Twister, so the
+ * samples are still reproducible for a fixed random seed. The generator is
+ * part of the sampler, and the seed is always drawn in the calling thread,
+ * also when the samples are generated in the background.
+ *
  * \ingroup ImageSamplers
  */
 
@@ -67,6 +79,12 @@ public:
   /** The input image dimension. */
   itkStaticConstMacro(InputImageDimension, unsigned int, Superclass::InputImageDimension);
 
+  /** Set/Get whether the random numbers are generated by a counter-based generator,
+   * inside the threads. Only affects the multi-threaded version, see SetUseMultiThread. Default: false. */
+  itkSetMacro(UseCounterBasedRandomNumbers, bool);
+  itkGetConstMacro(UseCounterBasedRandomNumbers, bool);
+  itkBooleanMacro(UseCounterBasedRandomNumbers);
+
 protected:
   /** The constructor. */
   ImageRandomSamplerBase();
@@ -82,8 +100,33 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Start a new generation of counter-based random numbers. On the first call,
+   * the seed is drawn from the global Mersenne Twister. */
+  void
+  InitializeCounterBasedRandomNumbers();
+
+  /** Draws the seed of the counter-based generator, if not done yet, so that the
+   * background sample generation does not use the global Mersenne Twister. */
+  void
+  BeforeBackgroundSampleGeneration() override;
+
+  /** Get numberOfValues uniform variates in [0, 1) for sample sampleId of the
+   * current generation. Thread-safe. */
+  void
+  GetCounterBasedUniformVariates(const unsigned long sampleId, double * values, const unsigned int numberOfValues) const
+  {
+    this->m_CounterBasedGenerator.GetUniformVariates(this->m_CounterBasedGeneration, sampleId, values, numberOfValues);
+  }
+
   /** Member variable used when threading. */
   std::vector<double> m_RandomNumberList;
+
+  bool m_UseCounterBasedRandomNumbers{ false };
+
+private:
+  PhiloxRandomNumberGenerator m_CounterBasedGenerator;
+  std::uint32_t               m_CounterBasedGeneration{ 0 };
+  bool                        m_CounterBasedGeneratorIsSeeded{ false };
 };
 
 } // end namespace itk
@@ -46,6 +46,15 @@ template <class TInputImage>
 void
 ImageRandomSamplerBase<TInputImage>::BeforeThreadedGenerateData()
 {
+  /** The threads compute their own random numbers. */
+  if (this->m_UseCounterBasedRandomNumbers)
+  {
+    this->InitializeCounterBasedRandomNumbers();
+    this->m_RandomNumberList.clear();
+    Superclass::BeforeThreadedGenerateData();
+    return;
+  }
+
   /** Create a random number generator. Also used in the ImageRandomConstIteratorWithIndex. */
   using GeneratorPointer = typename Statistics::MersenneTwisterRandomVariateGenerator::Pointer;
   GeneratorPointer localGenerator = Statistics::MersenneTwisterRandomVariateGenerator::GetInstance();
@@ -71,6 +80,53 @@ ImageRandomSamplerBase<TInputImage>::BeforeThreadedGenerateData()
 } // end BeforeThreadedGenerateData()
 
 
+/**
+ * ******************* InitializeCounterBasedRandomNumbers *******************
+ */
+
+template <class TInputImage>
+void
+ImageRandomSamplerBase<TInputImage>::InitializeCounterBasedRandomNumbers()
+{
+  if (!this->m_CounterBasedGeneratorIsSeeded)
+  {
+    /** Draw the seed from the global generator, so that it follows the elastix random seed. */
+    const auto          generator = Statistics::MersenneTwisterRandomVariateGenerator::GetInstance();
+    const std::uint64_t low = generator->GetIntegerVariate();
+    const std::uint64_t high = generator->GetIntegerVariate();
+    this->m_CounterBasedGenerator = PhiloxRandomNumberGenerator((high << 32) | low);
+    this->m_CounterBasedGeneration = 0;
+    this->m_CounterBasedGeneratorIsSeeded = true;
+  }
+  else
+  {
+    /** Each generation uses its own stream, so new samples are drawn every time. */
+    ++this->m_CounterBasedGeneration;
+  }
+
+} // end InitializeCounterBasedRandomNumbers()
+
+
+/**
+ * ******************* BeforeBackgroundSampleGeneration *******************
+ */
+
+template <class TInputImage>
+void
+ImageRandomSamplerBase<TInputImage>::BeforeBackgroundSampleGeneration()
+{
+  Superclass::BeforeBackgroundSampleGeneration();
+
+  /** Seed the generator here, in the calling thread. The background generation
+   * then only starts a new generation of random numbers. */
+  if (this->m_UseCounterBasedRandomNumbers && !this->m_CounterBasedGeneratorIsSeeded)
+  {
+    this->InitializeCounterBasedRandomNumbers();
+  }
+
+} // end BeforeBackgroundSampleGeneration()
+
+
 /**
  * ******************* PrintSelf *******************
  */
@@ -82,6 +138,7 @@ ImageRandomSamplerBase<TInputImage>::PrintSelf(std::ostream & os, Indent indent)
   Superclass::PrintSelf(os, indent);
 
   os << indent << "NumberOfSamples: " << this->m_NumberOfSamples << std::endl;
+  os << indent << "UseCounterBasedRandomNumbers: " << this->m_UseCounterBasedRandomNumbers << std::endl;
 
 } // end PrintSelf()
 
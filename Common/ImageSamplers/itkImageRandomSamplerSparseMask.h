@@ -20,7 +20,8 @@
 
 #include "itkImageRandomSamplerBase.h"
 #include "itkMersenneTwisterRandomVariateGenerator.h"
-#include "itkImageFullSampler.h"
+
+#include <vector>
 
 namespace itk
 {
@@ -31,6 +32,13 @@ namespace itk
  * This version takes into account that the mask may be very small.
  * Also, it may be more efficient when very many different sample sets
  * of the same input image are required, because it does some precomputation.
+ *
+ * The precomputation is a compact list of the voxels inside the mask: for each
+ * run of consecutive valid voxels along the first image axis, only its linear
+ * offset in the input image region and the number of valid voxels before it
+ * are stored. The list is built in parallel, and only rebuilt when the input
+ * image, the mask, or the input image region changes. The point and the value
+ * of a voxel are only computed when it is drawn.
  * \ingroup ImageSamplers
  */
 
@@ -65,6 +73,8 @@ public:
   using typename Superclass::ImageSampleContainerType;
   using typename Superclass::ImageSampleContainerPointer;
   using typename Superclass::MaskType;
+  using typename Superclass::InputImageSizeType;
+  using typename Superclass::ImageSampleValueType;
 
   /** The input image dimension. */
   itkStaticConstMacro(InputImageDimension, unsigned int, Superclass::InputImageDimension);
@@ -78,9 +88,6 @@ public:
   using RandomGeneratorPointer = typename RandomGeneratorType::Pointer;
 
 protected:
-  using InternalFullSamplerType = itk::ImageFullSampler<InputImageType>;
-  using InternalFullSamplerPointer = typename InternalFullSamplerType::Pointer;
-
   /** The constructor. */
   ImageRandomSamplerSparseMask() = default;
   /** The destructor. */
@@ -101,8 +108,36 @@ protected:
   void
   ThreadedGenerateData(const InputImageRegionType & inputRegionForThread, ThreadIdType threadId) override;
 
-  RandomGeneratorPointer     m_RandomGenerator{ RandomGeneratorType::GetInstance() };
-  InternalFullSamplerPointer m_InternalFullSampler{ InternalFullSamplerType::New() };
+  /** Build the list of voxels inside the mask, if the input has changed. */
+  void
+  UpdateValidVoxelList();
+
+  /** Get the number of voxels inside the mask. */
+  SizeValueType
+  GetNumberOfValidVoxels() const
+  {
+    return this->m_NumberOfValidVoxels;
+  }
+
+  /** Compute the sample of the valid voxel with the given number, in raster order. */
+  void
+  ComputeValidVoxelSample(SizeValueType validVoxelNumber, ImageSampleType & sample) const;
+
+  RandomGeneratorPointer m_RandomGenerator{ RandomGeneratorType::GetInstance() };
+
+private:
+  /** The runs of valid voxels: the linear offset of the first voxel of each run,
+   * within the input image region, and the number of valid voxels before it. */
+  std::vector<SizeValueType> m_RunOffsets;
+  std::vector<SizeValueType> m_RunFirstValidVoxels;
+  SizeValueType              m_NumberOfValidVoxels{ 0 };
+
+  /** The input for which the list was built. */
+  const InputImageType * m_ValidVoxelListImage{ nullptr };
+  ModifiedTimeType       m_ValidVoxelListImageMTime{ 0 };
+  const MaskType *       m_ValidVoxelListMask{ nullptr };
+  ModifiedTimeType       m_ValidVoxelListMaskMTime{ 0 };
+  InputImageRegionType   m_ValidVoxelListRegion;
 };
 
 } // end namespace itk
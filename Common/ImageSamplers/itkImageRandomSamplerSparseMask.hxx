@@ -19,6 +19,9 @@
 #define itkImageRandomSamplerSparseMask_hxx
 
 #include "itkImageRandomSamplerSparseMask.h"
+#include "itkWorkStealingThreadPool.h"
+
+#include <algorithm> // For sort and upper_bound.
 
 namespace itk
 {
@@ -40,42 +43,17 @@ ImageRandomSamplerSparseMask<TInputImage>::GenerateData()
     itkExceptionMacro(<< "ERROR: do not call this function when no mask is supplied.");
   }
 
-  /** Get handles to the input image and output sample container. */
-  InputImageConstPointer      inputImage = this->GetInput();
+  /** Get a handle to the output sample container. */
   ImageSampleContainerPointer sampleContainer = this->GetOutput();
 
   /** Clear the container. */
   sampleContainer->Initialize();
 
-  /** Make sure the internal full sampler is up-to-date. */
-  this->m_InternalFullSampler->SetInput(inputImage);
-  this->m_InternalFullSampler->SetMask(mask);
-  this->m_InternalFullSampler->SetInputImageRegion(this->GetCroppedInputImageRegion());
-
-  /** Use try/catch, since the full sampler may crash, due to insufficient memory. */
-  try
+  /** Make sure the list of voxels inside the mask is up-to-date. */
+  this->UpdateValidVoxelList();
+  if (this->m_NumberOfValidVoxels == 0)
   {
-    this->m_InternalFullSampler->Update();
-  }
-  catch (ExceptionObject & err)
-  {
-    std::string message = "ERROR: This ImageSampler internally uses the "
-                          "ImageFullSampler. Updating of this internal sampler raised the "
-                          "exception:\n";
-    message += err.GetDescription();
-
-    std::string            fullSamplerMessage = err.GetDescription();
-    std::string::size_type loc =
-      fullSamplerMessage.find("ERROR: failed to allocate memory for the sample container", 0);
-    if (loc != std::string::npos && this->GetMask() == nullptr)
-    {
-      message += "\nYou are using the ImageRandomSamplerSparseMask sampler, "
-                 "but you did not set a mask. The internal ImageFullSampler therefore "
-                 "requires a lot of memory. Consider using the ImageRandomSampler "
-                 "instead.";
-    }
-    const char * message2 = message.c_str();
-    itkExceptionMacro(<< message2);
+    itkExceptionMacro(<< "ERROR: the mask does not contain any voxel of the input image region.");
   }
 
   /** If desired we exercise a multi-threaded version. */
@@ -85,15 +63,12 @@ ImageRandomSamplerSparseMask<TInputImage>::GenerateData()
     return Superclass::GenerateData();
   }
 
-  /** Get a handle to the full sampler output. */
-  typename ImageSampleContainerType::Pointer allValidSamples = this->m_InternalFullSampler->GetOutput();
-  unsigned long                              numberOfValidSamples = allValidSamples->Size();
-
-  /** Take random samples from the allValidSamples-container. */
-  for (unsigned int i = 0; i < this->GetNumberOfSamples(); ++i)
+  /** Take random samples from the voxels inside the mask. */
+  sampleContainer->Reserve(this->GetNumberOfSamples());
+  for (auto & sample : *sampleContainer)
   {
-    unsigned long randomIndex = this->m_RandomGenerator->GetIntegerVariate(numberOfValidSamples - 1);
-    sampleContainer->push_back(allValidSamples->ElementAt(randomIndex));
+    unsigned long randomIndex = this->m_RandomGenerator->GetIntegerVariate(this->m_NumberOfValidVoxels - 1);
+    this->ComputeValidVoxelSample(randomIndex, sample);
   }
 
 } // end GenerateData()
@@ -109,16 +84,23 @@ ImageRandomSamplerSparseMask<TInputImage>::BeforeThreadedGenerateData()
 {
   /** Clear the random number list. */
   this->m_RandomNumberList.resize(0);
-  this->m_RandomNumberList.reserve(this->m_NumberOfSamples);
 
-  /** Get a handle to the full sampler output size. */
-  const unsigned long numberOfValidSamples = this->m_InternalFullSampler->GetOutput()->Size();
+  /** Get the number of voxels inside the mask. */
+  const unsigned long numberOfValidSamples = this->m_NumberOfValidVoxels;
 
-  /** Fill the list with random numbers. */
-  for (unsigned int i = 0; i < this->GetNumberOfSamples(); ++i)
+  /** Fill the list with random numbers, unless the threads compute their own. */
+  if (this->m_UseCounterBasedRandomNumbers)
   {
-    unsigned long randomIndex = this->m_RandomGenerator->GetIntegerVariate(numberOfValidSamples - 1);
-    this->m_RandomNumberList.push_back(randomIndex);
+    this->InitializeCounterBasedRandomNumbers();
+  }
+  else
+  {
+    this->m_RandomNumberList.reserve(this->m_NumberOfSamples);
+    for (unsigned int i = 0; i < this->GetNumberOfSamples(); ++i)
+    {
+      unsigned long randomIndex = this->m_RandomGenerator->GetIntegerVariate(numberOfValidSamples - 1);
+      this->m_RandomNumberList.push_back(randomIndex);
+    }
   }
 
   /** Initialize variables needed for threads. */
@@ -140,9 +122,6 @@ template <class TInputImage>
 void
 ImageRandomSamplerSparseMask<TInputImage>::ThreadedGenerateData(const InputImageRegionType &, ThreadIdType threadId)
 {
-  /** Get a handle to the full sampler output. */
-  typename ImageSampleContainerType::Pointer allValidSamples = this->m_InternalFullSampler->GetOutput();
-
   /** Figure out which samples to process. */
   unsigned long chunkSize = this->GetNumberOfSamples() / this->GetNumberOfWorkUnits();
   unsigned long sampleStart = threadId * chunkSize;
@@ -159,17 +138,192 @@ ImageRandomSamplerSparseMask<TInputImage>::ThreadedGenerateData(const InputImage
   typename ImageSampleContainerType::Iterator      iter;
   typename ImageSampleContainerType::ConstIterator end = sampleContainerThisThread->End();
 
-  /** Take random samples from the allValidSamples-container. */
-  unsigned long sampleId = sampleStart;
+  /** Take random samples from the voxels inside the mask. */
+  const unsigned long numberOfValidSamples = this->m_NumberOfValidVoxels;
+  unsigned long       sampleId = sampleStart;
   for (iter = sampleContainerThisThread->Begin(); iter != end; ++iter, sampleId++)
   {
-    unsigned long randomIndex = static_cast<unsigned long>(this->m_RandomNumberList[sampleId]);
-    iter->Value() = allValidSamples->ElementAt(randomIndex);
+    unsigned long randomIndex;
+    if (this->m_UseCounterBasedRandomNumbers)
+    {
+      double randomNumber;
+      this->GetCounterBasedUniformVariates(sampleId, &randomNumber, 1);
+      randomIndex = std::min(static_cast<unsigned long>(randomNumber * numberOfValidSamples), numberOfValidSamples - 1);
+    }
+    else
+    {
+      randomIndex = static_cast<unsigned long>(this->m_RandomNumberList[sampleId]);
+    }
+    this->ComputeValidVoxelSample(randomIndex, iter->Value());
   }
 
 } // end ThreadedGenerateData()
 
 
+/**
+ * ******************* UpdateValidVoxelList *******************
+ */
+
+template <class TInputImage>
+void
+ImageRandomSamplerSparseMask<TInputImage>::UpdateValidVoxelList()
+{
+  const InputImageType *     inputImage = this->GetInput();
+  const MaskType *           mask = this->GetMask();
+  const InputImageRegionType region = this->GetCroppedInputImageRegion();
+
+  /** Update the mask. */
+  if (mask->GetSource())
+  {
+    mask->GetSource()->Update();
+  }
+
+  /** Only rebuild the list when the input has changed, typically once per resolution. */
+  if (inputImage == this->m_ValidVoxelListImage && inputImage->GetMTime() == this->m_ValidVoxelListImageMTime &&
+      mask == this->m_ValidVoxelListMask && mask->GetMTime() == this->m_ValidVoxelListMaskMTime &&
+      region == this->m_ValidVoxelListRegion)
+  {
+    return;
+  }
+
+  /** The runs found in a chunk of lines along the first axis. */
+  struct ChunkRunsType
+  {
+    SizeValueType              m_FirstLine;
+    std::vector<SizeValueType> m_Offsets;
+    std::vector<SizeValueType> m_Sizes;
+  };
+
+  /** Scan the lines of the region in parallel. Each worker collects the runs of its own chunks. */
+  const SizeValueType lineLength = region.GetSize(0);
+  const SizeValueType numberOfLines = lineLength > 0 ? region.GetNumberOfPixels() / lineLength : 0;
+  const auto          threadPool = WorkStealingThreadPool::GetInstance();
+  std::vector<std::vector<ChunkRunsType>> chunksPerWorker(threadPool->GetNumberOfThreads());
+
+  threadPool->ParallelFor(
+    0,
+    numberOfLines,
+    16,
+    this->GetNumberOfWorkUnits(),
+    [&](const SizeValueType lineBegin, const SizeValueType lineEnd, const ThreadIdType workerId) {
+      ChunkRunsType chunk;
+      chunk.m_FirstLine = lineBegin;
+
+      InputImageIndexType index;
+      InputImagePointType point;
+      for (SizeValueType line = lineBegin; line < lineEnd; ++line)
+      {
+        /** Compute the index of the first voxel of the line. */
+        SizeValueType lineNumber = line;
+        for (unsigned int d = 1; d < InputImageDimension; ++d)
+        {
+          index[d] = region.GetIndex(d) + static_cast<IndexValueType>(lineNumber % region.GetSize(d));
+          lineNumber /= region.GetSize(d);
+        }
+
+        /** Check which points of the line fall within the mask. */
+        bool insideRun = false;
+        for (SizeValueType x = 0; x < lineLength; ++x)
+        {
+          index[0] = region.GetIndex(0) + static_cast<IndexValueType>(x);
+          inputImage->TransformIndexToPhysicalPoint(index, point);
+          if (mask->IsInsideInWorldSpace(point))
+          {
+            if (!insideRun)
+            {
+              chunk.m_Offsets.push_back(line * lineLength + x);
+              chunk.m_Sizes.push_back(0);
+              insideRun = true;
+            }
+            ++chunk.m_Sizes.back();
+          }
+          else
+          {
+            insideRun = false;
+          }
+        }
+      }
+
+      chunksPerWorker[workerId].push_back(std::move(chunk));
+    });
+
+  /** Gather the chunks in raster order. */
+  std::vector<ChunkRunsType *> chunks;
+  for (auto & workerChunks : chunksPerWorker)
+  {
+    for (auto & chunk : workerChunks)
+    {
+      chunks.push_back(&chunk);
+    }
+  }
+  std::sort(chunks.begin(), chunks.end(), [](const ChunkRunsType * a, const ChunkRunsType * b) {
+    return a->m_FirstLine < b->m_FirstLine;
+  });
+
+  /** Concatenate the runs, merging runs that continue on the next line. */
+  this->m_RunOffsets.clear();
+  this->m_RunFirstValidVoxels.clear();
+  SizeValueType numberOfValidVoxels = 0;
+  SizeValueType previousRunEnd = 0;
+  for (const ChunkRunsType * chunk : chunks)
+  {
+    for (std::size_t i = 0; i < chunk->m_Offsets.size(); ++i)
+    {
+      if (this->m_RunOffsets.empty() || chunk->m_Offsets[i] != previousRunEnd)
+      {
+        this->m_RunOffsets.push_back(chunk->m_Offsets[i]);
+        this->m_RunFirstValidVoxels.push_back(numberOfValidVoxels);
+      }
+      numberOfValidVoxels += chunk->m_Sizes[i];
+      previousRunEnd = chunk->m_Offsets[i] + chunk->m_Sizes[i];
+    }
+  }
+  this->m_RunOffsets.shrink_to_fit();
+  this->m_RunFirstValidVoxels.shrink_to_fit();
+  this->m_NumberOfValidVoxels = numberOfValidVoxels;
+
+  /** Remember the input for which the list was built. */
+  this->m_ValidVoxelListImage = inputImage;
+  this->m_ValidVoxelListImageMTime = inputImage->GetMTime();
+  this->m_ValidVoxelListMask = mask;
+  this->m_ValidVoxelListMaskMTime = mask->GetMTime();
+  this->m_ValidVoxelListRegion = region;
+
+} // end UpdateValidVoxelList()
+
+
+/**
+ * ******************* ComputeValidVoxelSample *******************
+ */
+
+template <class TInputImage>
+void
+ImageRandomSamplerSparseMask<TInputImage>::ComputeValidVoxelSample(const SizeValueType validVoxelNumber,
+                                                                   ImageSampleType &   sample) const
+{
+  /** Find the run that contains the voxel, and its linear offset in the region. */
+  const auto runIterator =
+    std::upper_bound(this->m_RunFirstValidVoxels.cbegin(), this->m_RunFirstValidVoxels.cend(), validVoxelNumber) - 1;
+  const std::size_t run = runIterator - this->m_RunFirstValidVoxels.cbegin();
+  SizeValueType     offset = this->m_RunOffsets[run] + (validVoxelNumber - *runIterator);
+
+  /** Translate the offset to an index. */
+  const InputImageRegionType & region = this->m_ValidVoxelListRegion;
+  InputImageIndexType          index;
+  for (unsigned int d = 0; d < InputImageDimension; ++d)
+  {
+    index[d] = region.GetIndex(d) + static_cast<IndexValueType>(offset % region.GetSize(d));
+    offset /= region.GetSize(d);
+  }
+
+  /** Compute the point and the value. */
+  const InputImageType * inputImage = this->GetInput();
+  inputImage->TransformIndexToPhysicalPoint(index, sample.m_ImageCoordinates);
+  sample.m_ImageValue = static_cast<ImageSampleValueType>(inputImage->GetPixel(index));
+
+} // end ComputeValidVoxelSample()
+
+
 /**
  * ******************* PrintSelf *******************
  */
@@ -180,7 +334,8 @@ ImageRandomSamplerSparseMask<TInputImage>::PrintSelf(std::ostream & os, Indent i
 {
   Superclass::PrintSelf(os, indent);
 
-  os << indent << "InternalFullSampler: " << this->m_InternalFullSampler.GetPointer() << std::endl;
+  os << indent << "NumberOfValidVoxels: " << this->m_NumberOfValidVoxels << std::endl;
+  os << indent << "NumberOfRuns: " << this->m_RunOffsets.size() << std::endl;
   os << indent << "RandomGenerator: " << this->m_RandomGenerator.GetPointer() << std::endl;
 
 } // end PrintSelf()
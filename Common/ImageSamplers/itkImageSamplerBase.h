@@ -23,6 +23,8 @@
 #include "itkVectorDataContainer.h"
 #include "itkSpatialObject.h"
 
+#include <future>
+
 namespace itk
 {
 /** \class ImageSamplerBase
@@ -35,6 +37,20 @@ namespace itk
  *    example: <tt>(ImageSampler "Random")</tt> \n
  *    The default is Random.
  *
+ * Samplers that support it can generate their next set of samples in the
+ * background (UseBackgroundSampleGeneration). After each update, the next set
+ * is generated into a second sample container, while the current output is
+ * being used, for example while a metric computes its derivative. When new
+ * samples are selected (SelectNewSamplesOnUpdate()), the next update just
+ * swaps the two containers. When the sampler has been modified otherwise since
+ * the background generation started, its samples are discarded, and the next
+ * update generates new ones.
+ *
+ * The background generation reads the settings of the sampler. SetNumberOfSamples()
+ * waits for it when the number changes; any other setting may only be changed after
+ * WaitForBackgroundSampleGeneration(). The elastix sampler components call it at the
+ * start of each resolution.
+ *
  * \ingroup ImageSamplers
  */
 
@@ -171,16 +187,47 @@ public:
   }
 
 
+  /** Set/Get whether the next set of samples is generated in the background, after
+   * each update. Only has effect when BackgroundSampleGenerationSupported() is true,
+   * and only pays off when new samples are selected every iteration. Default: false. */
+  itkSetMacro(UseBackgroundSampleGeneration, bool);
+  itkGetConstMacro(UseBackgroundSampleGeneration, bool);
+  itkBooleanMacro(UseBackgroundSampleGeneration);
+
+  /** Returns whether the sampler supports UseBackgroundSampleGeneration. Subclasses
+   * that do, must not use the shared random generator in GenerateData(), must fill
+   * GetSampleContainerToGenerate() instead of the output, and must call
+   * WaitForBackgroundSampleGeneration() in their destructor. */
+  virtual bool
+  BackgroundSampleGenerationSupported() const
+  {
+    return false;
+  }
+
+
+  /** Wait until the samples that are generated in the background are ready. */
+  void
+  WaitForBackgroundSampleGeneration() const;
+
+
   /** Get a handle to the cropped InputImageregion. */
   itkGetConstReferenceMacro(CroppedInputImageRegion, InputImageRegionType);
 
-  /** Set/Get the number of samples. */
-  itkSetClampMacro(NumberOfSamples, unsigned long, 1, NumericTraits<unsigned long>::max());
+  /** Set/Get the number of samples. A new number waits for the background sample
+   * generation, and discards its samples. The same number keeps them. */
+  virtual void
+  SetNumberOfSamples(unsigned long _arg);
   itkGetConstMacro(NumberOfSamples, unsigned long);
 
   /** \todo: Temporary, should think about interface. */
   itkSetMacro(UseMultiThread, bool);
 
+  /** Generates the output, or takes the samples that were generated in the background.
+   * Overridden here, so that it works for all samplers, whatever way they
+   * generate their output. */
+  void
+  UpdateOutputData(DataObject * output) override;
+
 protected:
   /** The constructor. */
   ImageSamplerBase() = default;
@@ -221,6 +268,25 @@ protected:
   void
   AfterThreadedGenerateData() override;
 
+  /** Get the sample container that GenerateData() should fill: the output, or
+   * the second container when the samples are generated in the background. */
+  ImageSampleContainerType *
+  GetSampleContainerToGenerate();
+
+  /** Returns whether GenerateData() is currently called in the background. It may then
+   * not update the masks, which have already been updated in the calling thread. */
+  bool
+  IsGeneratingInBackground() const
+  {
+    return this->m_IsGeneratingInBackground;
+  }
+
+  /** Called in the calling thread, before each background sample generation.
+   * Subclasses may, for example, give the sampler its own random generator. */
+  virtual void
+  BeforeBackgroundSampleGeneration()
+  {}
+
   /***/
   unsigned long                            m_NumberOfSamples{ 0 };
   std::vector<ImageSampleContainerPointer> m_ThreaderSampleContainer;
@@ -239,6 +305,17 @@ private:
 
   InputImageRegionType m_CroppedInputImageRegion;
   InputImageRegionType m_DummyInputImageRegion;
+
+  /** The second sample container, and the generation of samples into it. The modification
+   * times tell whether the sampler has been modified since the generation started, and
+   * since SelectNewSamplesOnUpdate() requested its samples. */
+  bool                        m_UseBackgroundSampleGeneration{ false };
+  bool                        m_IsGeneratingInBackground{ false };
+  bool                        m_BackgroundSamplesRequested{ false };
+  ModifiedTimeType            m_BackgroundSampleGenerationMTime{ 0 };
+  ModifiedTimeType            m_BackgroundSamplesRequestedMTime{ 0 };
+  ImageSampleContainerPointer m_BackgroundSampleContainer{ ImageSampleContainerType::New() };
+  std::future<void>           m_BackgroundSampleGeneration;
 };
 
 } // end namespace itk
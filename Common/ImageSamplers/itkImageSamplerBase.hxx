@@ -20,6 +20,8 @@
 
 #include "itkImageSamplerBase.h"
 
+#include <algorithm> // For max.
+
 namespace itk
 {
 
@@ -158,6 +160,9 @@ template <class TInputImage>
 void
 ImageSamplerBase<TInputImage>::GenerateInputRequestedRegion()
 {
+  /** The regions that are set here are read by the background sample generation. */
+  this->WaitForBackgroundSampleGeneration();
+
   /** Check if input image was set. */
   if (this->GetNumberOfInputs() == 0)
   {
@@ -221,12 +226,53 @@ ImageSamplerBase<TInputImage>::SelectNewSamplesOnUpdate()
    * Return true to indicate that indeed new samples will be selected.
    * Inheriting subclasses may just return false and do nothing.
    */
+  /** The samples that are generated in the background are such a new sample set,
+   * unless the sampler has been modified since their generation started. */
+  this->m_BackgroundSamplesRequested = this->m_BackgroundSampleGeneration.valid() &&
+                                       this->GetMTime() == this->m_BackgroundSampleGenerationMTime;
   this->Modified();
+  this->m_BackgroundSamplesRequestedMTime = this->GetMTime();
   return true;
 
 } // end SelectNewSamplesOnUpdate()
 
 
+/**
+ * ******************* WaitForBackgroundSampleGeneration *******************
+ */
+
+template <class TInputImage>
+void
+ImageSamplerBase<TInputImage>::WaitForBackgroundSampleGeneration() const
+{
+  if (this->m_BackgroundSampleGeneration.valid())
+  {
+    this->m_BackgroundSampleGeneration.wait();
+  }
+
+} // end WaitForBackgroundSampleGeneration()
+
+
+/**
+ * ******************* SetNumberOfSamples *******************
+ */
+
+template <class TInputImage>
+void
+ImageSamplerBase<TInputImage>::SetNumberOfSamples(const unsigned long _arg)
+{
+  const unsigned long numberOfSamples = std::max(_arg, 1ul);
+  if (this->m_NumberOfSamples != numberOfSamples)
+  {
+    /** The background generation reads the number of samples. */
+    this->WaitForBackgroundSampleGeneration();
+    this->m_NumberOfSamples = numberOfSamples;
+    this->Modified();
+  }
+
+} // end SetNumberOfSamples()
+
+
 /**
  * ******************* IsInsideAllMasks *******************
  */
@@ -402,7 +448,7 @@ ImageSamplerBase<TInputImage>::AfterThreadedGenerateData()
   }
 
   /** Get handle to the output sample container. */
-  typename ImageSampleContainerType::Pointer sampleContainer = this->GetOutput();
+  ImageSampleContainerType * sampleContainer = this->GetSampleContainerToGenerate();
   sampleContainer->clear();
   sampleContainer->reserve(this->m_NumberOfSamples);
 
@@ -416,6 +462,93 @@ ImageSamplerBase<TInputImage>::AfterThreadedGenerateData()
 } // end AfterThreadedGenerateData()
 
 
+/**
+ * ******************* UpdateOutputData *******************
+ */
+
+template <class TInputImage>
+void
+ImageSamplerBase<TInputImage>::UpdateOutputData(DataObject * output)
+{
+  const bool useBackgroundSampleGeneration =
+    this->m_UseBackgroundSampleGeneration && this->BackgroundSampleGenerationSupported();
+
+  if (this->m_BackgroundSampleGeneration.valid())
+  {
+    /** Finish the background generation. Its errors are only relevant when its samples are used. */
+    std::future<void> backgroundSampleGeneration = std::move(this->m_BackgroundSampleGeneration);
+    backgroundSampleGeneration.wait();
+    this->m_IsGeneratingInBackground = false;
+
+    if (this->m_BackgroundSamplesRequested && useBackgroundSampleGeneration &&
+        this->GetMTime() == this->m_BackgroundSamplesRequestedMTime)
+    {
+      backgroundSampleGeneration.get();
+
+      /** Swap the buffers, instead of generating the samples now. */
+      this->InvokeEvent(StartEvent());
+      this->GetOutput()->swap(*this->m_BackgroundSampleContainer);
+      output->DataHasBeenGenerated();
+      this->InvokeEvent(EndEvent());
+    }
+    else
+    {
+      Superclass::UpdateOutputData(output);
+    }
+  }
+  else
+  {
+    Superclass::UpdateOutputData(output);
+  }
+  this->m_BackgroundSamplesRequested = false;
+
+  /** Neither GenerateData nor the swap modifies the output container itself. Its modification
+   * time tells users of the samples, like the transform sample cache of the metric, that
+   * the samples have changed. */
+  this->GetOutput()->Modified();
+
+  /** Start generating the next set of samples, while the current set is being used. */
+  if (useBackgroundSampleGeneration)
+  {
+    /** The masks are updated here, in the calling thread. The background generation
+     * only reads them, so that it does not run their pipeline concurrently with the
+     * threads that use the samples. */
+    for (unsigned int i = 0; i < this->m_NumberOfMasks; ++i)
+    {
+      const MaskType * mask = this->GetMask(i);
+      if (mask != nullptr && mask->GetSource())
+      {
+        mask->GetSource()->Update();
+      }
+    }
+
+    this->BeforeBackgroundSampleGeneration();
+    this->m_BackgroundSampleContainer->Initialize();
+    this->m_IsGeneratingInBackground = true;
+    this->m_BackgroundSampleGenerationMTime = this->GetMTime();
+    this->m_BackgroundSampleGeneration = std::async(std::launch::async, [this] { this->GenerateData(); });
+  }
+
+} // end UpdateOutputData()
+
+
+/**
+ * ******************* GetSampleContainerToGenerate *******************
+ */
+
+template <class TInputImage>
+auto
+ImageSamplerBase<TInputImage>::GetSampleContainerToGenerate() -> ImageSampleContainerType *
+{
+  if (this->m_IsGeneratingInBackground)
+  {
+    return this->m_BackgroundSampleContainer.GetPointer();
+  }
+  return this->GetOutput();
+
+} // end GetSampleContainerToGenerate()
+
+
 /**
  * ******************* PrintSelf *******************
  */
@@ -433,6 +566,7 @@ ImageSamplerBase<TInputImage>::PrintSelf(std::ostream & os, Indent indent) const
   {
     os << indent.GetNextIndent() << this->m_MaskVector[i].GetPointer() << std::endl;
   }
+  os << indent << "UseBackgroundSampleGeneration: " << this->m_UseBackgroundSampleGeneration << std::endl;
 
   os << indent << "NumberOfInputImageRegions" << this->m_NumberOfInputImageRegions << std::endl;
   os << indent << "InputImageRegion: " << this->m_InputImageRegion << std::endl;
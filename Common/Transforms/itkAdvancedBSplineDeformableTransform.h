@@ -178,6 +178,8 @@ public:
   using typename Superclass::InternalMatrixType;
   using typename Superclass::MovingImageGradientType;
   using typename Superclass::MovingImageGradientValueType;
+  using typename Superclass::SampleCacheBase;
+  using typename Superclass::SampleCacheConstPointer;
 
   /** Parameters as SpaceDimension number of images. */
   using typename Superclass::PixelType;
@@ -202,6 +204,17 @@ public:
   OutputPointType
   TransformPoint(const InputPointType & point) const override;
 
+  /** Compute the displacements along a row of points that is aligned with an axis of the B-spline grid.
+   * The weights of the other grid axes are constant along such a row, so the coefficients are first
+   * collapsed onto a single grid line, after which every point only needs the 1D weights of its own axis.
+   * Returns false when the row is not aligned with a grid axis.
+   */
+  bool
+  ComputeDisplacementsAlongLine(const InputPointType &  firstPoint,
+                                const InputVectorType & step,
+                                const SizeValueType     numberOfPoints,
+                                OutputVectorType *      displacements) const override;
+
   /** Interpolation weights function type. */
   using WeightsFunctionType = BSplineInterpolationWeightFunction2<ScalarType, Self::SpaceDimension, VSplineOrder>;
   using WeightsFunctionPointer = typename WeightsFunctionType::Pointer;
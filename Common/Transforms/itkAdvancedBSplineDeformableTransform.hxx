@@ -278,6 +278,152 @@ AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::Tran
 }
 
 
+/**
+ * ********************* ComputeDisplacementsAlongLine ****************************
+ */
+
+template <class TScalarType, unsigned int NDimensions, unsigned int VSplineOrder>
+bool
+AdvancedBSplineDeformableTransform<TScalarType, NDimensions, VSplineOrder>::ComputeDisplacementsAlongLine(
+  const InputPointType &  firstPoint,
+  const InputVectorType & step,
+  const SizeValueType     numberOfPoints,
+  OutputVectorType *      displacements) const
+{
+  constexpr unsigned int supportSize = VSplineOrder + 1;
+  using KernelType = BSplineKernelFunction2<VSplineOrder>;
+
+  /** Without coefficients, TransformPoint() returns the input point. */
+  if (!this->m_CoefficientImages[0])
+  {
+    std::fill_n(displacements, numberOfPoints, OutputVectorType(NumericTraits<ScalarType>::ZeroValue()));
+    return true;
+  }
+
+  /** The continuous grid index moves along the row with a constant increment. Find the grid axis along
+   * which it moves, and check that it stays (numerically) constant along all other axes.
+   */
+  const ContinuousIndexType      firstIndex = this->TransformPointToContinuousGridIndex(firstPoint);
+  Vector<double, SpaceDimension> physicalStep;
+  for (unsigned int j = 0; j < SpaceDimension; ++j)
+  {
+    physicalStep[j] = step[j];
+  }
+  const Vector<double, SpaceDimension> indexStep = this->m_PointToIndexMatrix * physicalStep;
+  unsigned int                         lineAxis = 0;
+  for (unsigned int j = 1; j < SpaceDimension; ++j)
+  {
+    if (std::abs(indexStep[j]) > std::abs(indexStep[lineAxis]))
+    {
+      lineAxis = j;
+    }
+  }
+  const double lineLength = static_cast<double>(numberOfPoints > 0 ? numberOfPoints - 1 : 0);
+  for (unsigned int j = 0; j < SpaceDimension; ++j)
+  {
+    if (j != lineAxis && std::abs(indexStep[j]) * lineLength > 1e-6)
+    {
+      return false;
+    }
+  }
+
+  /** Outside the valid region along any of the other axes, the whole row has zero displacement. */
+  for (unsigned int j = 0; j < SpaceDimension; ++j)
+  {
+    if (j != lineAxis &&
+        (firstIndex[j] < this->m_ValidRegionBegin[j] || firstIndex[j] >= this->m_ValidRegionEnd[j]))
+    {
+      std::fill_n(displacements, numberOfPoints, OutputVectorType(NumericTraits<ScalarType>::ZeroValue()));
+      return true;
+    }
+  }
+
+  /** Compute the 1D weights and the support start of the other axes once for the whole row. */
+  const auto &    offsetTable = this->m_CoefficientImages[0]->GetOffsetTable();
+  const auto      gridIndex = this->m_GridRegion.GetIndex();
+  const auto      gridSize = this->m_GridRegion.GetSize();
+  double          weights1D[SpaceDimension][supportSize];
+  OffsetValueType rowOffset = 0;
+  for (unsigned int j = 0; j < SpaceDimension; ++j)
+  {
+    if (j != lineAxis)
+    {
+      const auto start = static_cast<OffsetValueType>(std::floor(firstIndex[j] - (supportSize - 2.0) / 2.0));
+      KernelType::FastEvaluate(firstIndex[j] - static_cast<double>(start), weights1D[j]);
+      rowOffset += (start - gridIndex[j]) * offsetTable[j];
+    }
+  }
+
+  /** Collapse the coefficients of the support along the other axes onto a single grid line:
+   * lineCoefficients[d][i] = sum over the support of the weights times the coefficients of node i.
+   */
+  const SizeValueType lineSize = gridSize[lineAxis];
+  std::vector<double> lineCoefficients(SpaceDimension * lineSize, 0.0);
+  SizeValueType       numberOfSupportPoints = 1;
+  for (unsigned int j = 0; j < SpaceDimension - 1; ++j)
+  {
+    numberOfSupportPoints *= supportSize;
+  }
+  for (SizeValueType s = 0; s < numberOfSupportPoints; ++s)
+  {
+    double          weight = 1.0;
+    OffsetValueType offset = rowOffset;
+    SizeValueType   remainder = s;
+    for (unsigned int j = 0; j < SpaceDimension; ++j)
+    {
+      if (j != lineAxis)
+      {
+        const unsigned int k = remainder % supportSize;
+        remainder /= supportSize;
+        weight *= weights1D[j][k];
+        offset += k * offsetTable[j];
+      }
+    }
+    for (unsigned int d = 0; d < SpaceDimension; ++d)
+    {
+      const PixelType * coefficients = this->m_CoefficientImages[d]->GetBufferPointer() + offset;
+      double *          line = lineCoefficients.data() + d * lineSize;
+      for (SizeValueType i = 0; i < lineSize; ++i)
+      {
+        line[i] += weight * coefficients[i * offsetTable[lineAxis]];
+      }
+    }
+  }
+
+  /** Sweep along the row, which only requires the 1D weights of the line axis per point. */
+  for (SizeValueType k = 0; k < numberOfPoints; ++k)
+  {
+    OutputVectorType & displacement = displacements[k];
+    displacement.Fill(NumericTraits<ScalarType>::ZeroValue());
+
+    const double index = firstIndex[lineAxis] + static_cast<double>(k) * indexStep[lineAxis];
+    if (index < this->m_ValidRegionBegin[lineAxis] || index >= this->m_ValidRegionEnd[lineAxis])
+    {
+      continue;
+    }
+
+    const auto start = static_cast<OffsetValueType>(std::floor(index - (supportSize - 2.0) / 2.0));
+    double     weights[supportSize];
+    KernelType::FastEvaluate(index - static_cast<double>(start), weights);
+
+    const SizeValueType first = static_cast<SizeValueType>(start - gridIndex[lineAxis]);
+    for (unsigned int d = 0; d < SpaceDimension; ++d)
+    {
+      const double * line = lineCoefficients.data() + d * lineSize + first;
+      double         value = 0.0;
+      for (unsigned int m = 0; m < supportSize; ++m)
+      {
+        value += weights[m] * line[m];
+      }
+      displacement[d] = static_cast<ScalarType>(value);
+    }
+  }
+
+  return true;
+
+} // end ComputeDisplacementsAlongLine()
+
+
 /**
  * ********************* GetNumberOfAffectedWeights ****************************
  */
@@ -85,6 +85,8 @@ public:
   using typename Superclass::InternalMatrixType;
   using typename Superclass::MovingImageGradientType;
   using typename Superclass::MovingImageGradientValueType;
+  using typename Superclass::SampleCacheBase;
+  using typename Superclass::SampleCacheConstPointer;
 
   /* Creates a `BSplineDeformableTransform` of the specified derived type and spline order. */
   template <template <class, unsigned, unsigned> class TBSplineDeformableTransform>
@@ -257,6 +259,27 @@ public:
   /** Parameter index array type. */
   using ParameterIndexArrayType = Array<unsigned long>;
 
+  /** Compute the displacements T(x) - x of the equidistant points x = firstPoint + k * step,
+   * for k = 0, ..., numberOfPoints - 1, and store them in the displacements array.
+   * Returns false, without computing anything, when the transform cannot evaluate such a
+   * row of points in one sweep. The caller should then call TransformPoint() per point.
+   */
+  virtual bool
+  ComputeDisplacementsAlongLine(const InputPointType &,
+                                const InputVectorType &,
+                                const SizeValueType,
+                                OutputVectorType *) const
+  {
+    return false;
+  }
+
+  /** Transform a row of equidistant points, using ComputeDisplacementsAlongLine() when possible. */
+  void
+  TransformPointsAlongLine(const InputPointType &  firstPoint,
+                           const InputVectorType & step,
+                           SizeValueType           numberOfPoints,
+                           OutputPointType *       outputPoints) const override;
+
   /** Method to transform a vector -
    *  not applicable for this type of transform.
    */
@@ -22,6 +22,7 @@
 #include "itkContinuousIndex.h"
 #include "itkIdentityTransform.h"
 #include <vnl/vnl_math.h>
+#include <vector>
 
 namespace itk
 {
@@ -550,6 +551,28 @@ AdvancedBSplineDeformableTransformBase<TScalarType, NDimensions>::InsideValidReg
 }
 
 
+template <class TScalarType, unsigned int NDimensions>
+void
+AdvancedBSplineDeformableTransformBase<TScalarType, NDimensions>::TransformPointsAlongLine(
+  const InputPointType &  firstPoint,
+  const InputVectorType & step,
+  SizeValueType           numberOfPoints,
+  OutputPointType *       outputPoints) const
+{
+  std::vector<OutputVectorType> displacements(numberOfPoints);
+  if (!this->ComputeDisplacementsAlongLine(firstPoint, step, numberOfPoints, displacements.data()))
+  {
+    Superclass::TransformPointsAlongLine(firstPoint, step, numberOfPoints, outputPoints);
+    return;
+  }
+
+  for (SizeValueType k = 0; k < numberOfPoints; ++k)
+  {
+    outputPoints[k] = firstPoint + step * static_cast<ScalarType>(k) + displacements[k];
+  }
+}
+
+
 template <class TScalarType, unsigned int NDimensions>
 auto
 AdvancedBSplineDeformableTransformBase<TScalarType, NDimensions>::TransformPointToContinuousGridIndex(
@@ -18,7 +18,9 @@
 #ifndef itkAdvancedCombinationTransform_h
 #define itkAdvancedCombinationTransform_h
 
+#include "itkAdvancedMatrixOffsetTransformBase.h"
 #include "itkAdvancedTransform.h"
+#include "itkDisplacementGridCacheTransform.h"
 #include "itkMacro.h"
 
 namespace itk
@@ -49,6 +51,12 @@ namespace itk
  * Note: It is mandatory to set a current transform. An initial transform
  * is not mandatory.
  *
+ * A multi-stage registration nests combination transforms: the initial
+ * transform of each stage is the combination transform of the previous stage.
+ * FlattenInitialTransform() and BakeInitialTransform() replace such a chain,
+ * for the evaluation only, by a transform whose cost does not depend on the
+ * number of stages.
+ *
  * \ingroup Transforms
  */
 
@@ -100,6 +108,8 @@ public:
   using typename Superclass::TransformCategoryEnum;
   using typename Superclass::MovingImageGradientType;
   using typename Superclass::MovingImageGradientValueType;
+  using typename Superclass::SampleCacheBase;
+  using typename Superclass::SampleCacheConstPointer;
 
   /** Transform typedefs for the from Superclass. */
   using TransformType = typename Superclass::TransformType;
@@ -120,12 +130,51 @@ public:
   using CurrentTransformInverseTransformBaseType = typename CurrentTransformType::InverseTransformBaseType;
   using CurrentTransformInverseTransformBasePointer = typename CurrentTransformType::InverseTransformBasePointer;
 
+  /** Typedefs for the transforms that replace the initial transform for the evaluation. */
+  using FlattenedInitialTransformType = AdvancedMatrixOffsetTransformBase<TScalarType, NDimensions, NDimensions>;
+  using InitialTransformGridType = DisplacementGridCacheTransform<TScalarType, NDimensions>;
+  using GridOriginType = typename InitialTransformGridType::OriginType;
+  using GridSpacingType = typename InitialTransformGridType::SpacingType;
+  using GridSizeType = typename InitialTransformGridType::SizeType;
+  using GridDirectionType = typename InitialTransformGridType::DirectionType;
+
   /** Set/Get a pointer to the InitialTransform. */
   void
   SetInitialTransform(InitialTransformType * _arg);
 
   itkGetModifiableObjectMacro(InitialTransform, InitialTransformType);
 
+  /** Replace, for the evaluation only, the initial transform by an equivalent one
+   * that is faster to evaluate. A linear initial transform, like a chain of linear
+   * combination transforms, is replaced by a single matrix and offset. Otherwise,
+   * when the initial transform is itself a combination transform, it is replaced by
+   * a copy of which the initial transform is flattened, recursively, so that
+   * consecutive linear stages collapse. The initial transform itself is not modified,
+   * so it may be shared by other chains. GetInitialTransform() keeps returning the
+   * original initial transform, which is assumed to be fixed: flatten again after it
+   * has changed.
+   */
+  void
+  FlattenInitialTransform();
+
+  /** Replace, for the evaluation only, the initial transform by a dense grid of its
+   * displacements, sampled at the nodes of the given grid, see the
+   * DisplacementGridCacheTransform. Outside the grid, the initial transform itself is
+   * evaluated. Like FlattenInitialTransform(), but for any frozen initial transform.
+   */
+  void
+  BakeInitialTransform(const GridOriginType &    gridOrigin,
+                       const GridSpacingType &   gridSpacing,
+                       const GridSizeType &      gridSize,
+                       const GridDirectionType & gridDirection);
+
+  /** Evaluate the original initial transform again. Setting an initial transform does this as well. */
+  void
+  RestoreInitialTransform();
+
+  /** Get the transform that replaces the initial transform for the evaluation; null when there is none. */
+  itkGetConstObjectMacro(FlattenedInitialTransform, InitialTransformType);
+
   /** Set/Get a pointer to the CurrentTransform.
    * Make sure to set the CurrentTransform before calling functions like
    * TransformPoint(), GetJacobian(), SetParameters() etc.
@@ -162,6 +211,23 @@ public:
   OutputPointType
   TransformPoint(const InputPointType & point) const override;
 
+  /** Method to transform a batch of points. Forwards the batch to the
+   * TransformPoints() of the initial and current transforms. */
+  void
+  TransformPoints(const InputPointType * inputPoints,
+                  OutputPointType *      outputPoints,
+                  SizeValueType          numberOfPoints) const override;
+
+  /** Method to transform a row of equidistant points. Forwards the row to the
+   * TransformPointsAlongLine() of the current transform, when there is no initial
+   * transform, when it is added, or when it is linear, which maps the row onto
+   * another row of equidistant points. */
+  void
+  TransformPointsAlongLine(const InputPointType &  firstPoint,
+                           const InputVectorType & step,
+                           SizeValueType           numberOfPoints,
+                           OutputPointType *       outputPoints) const override;
+
   /** ITK4 change:
    * The following pure virtual functions must be overloaded.
    * For now just throw an exception, since these are not used in elastix.
@@ -265,6 +331,48 @@ public:
                                            DerivativeType &                imageJacobian,
                                            NonZeroJacobianIndicesType &    nonZeroJacobianIndices) const override;
 
+  /** Compute the inner products of the Jacobian with the moving image gradient
+   * for a batch of points, by forwarding the batch to the current transform. */
+  void
+  EvaluateJacobianWithImageGradientProducts(const InputPointType *          inputPoints,
+                                            const MovingImageGradientType * movingImageGradients,
+                                            DerivativeType *                imageJacobians,
+                                            NonZeroJacobianIndicesType *    nonZeroJacobianIndices,
+                                            SizeValueType                   numberOfPoints) const override;
+
+  /** Create the sample cache of the current transform. With composition, the
+   * cache is created for the points mapped by the initial transform, which
+   * is fixed during a registration. Not supported when using addition. */
+  SampleCacheConstPointer
+  CreateSampleCache(const InputPointType * inputPoints, SizeValueType numberOfPoints) const override;
+
+  /** The functions that use the sample cache forward to the current transform. */
+  OutputPointType
+  TransformPointUsingSampleCache(const SampleCacheBase & sampleCache, SizeValueType sampleIndex) const override;
+
+  void
+  GetJacobianUsingSampleCache(const SampleCacheBase &      sampleCache,
+                              SizeValueType                sampleIndex,
+                              JacobianType &               j,
+                              NonZeroJacobianIndicesType & nonZeroJacobianIndices) const override;
+
+  void
+  EvaluateJacobianWithImageGradientProductUsingSampleCache(
+    const SampleCacheBase &         sampleCache,
+    SizeValueType                   sampleIndex,
+    const MovingImageGradientType & movingImageGradient,
+    DerivativeType &                imageJacobian,
+    NonZeroJacobianIndicesType &    nonZeroJacobianIndices) const override;
+
+  void
+  EvaluateJacobianWithImageGradientProductsUsingSampleCache(
+    const SampleCacheBase &         sampleCache,
+    const SizeValueType *           sampleIndices,
+    const MovingImageGradientType * movingImageGradients,
+    DerivativeType *                imageJacobians,
+    NonZeroJacobianIndicesType *    nonZeroJacobianIndices,
+    SizeValueType                   numberOfSamples) const override;
+
   /** Compute the spatial Jacobian of the transformation. */
   void
   GetSpatialJacobian(const InputPointType & inputPoint, SpatialJacobianType & sj) const override;
@@ -554,6 +662,11 @@ private:
   InitialTransformPointer m_InitialTransform{ nullptr };
   CurrentTransformPointer m_CurrentTransform{ nullptr };
 
+  /** The flattened or baked initial transform, and the initial transform that is evaluated:
+   * either the flattened one, or the original one. */
+  InitialTransformPointer      m_FlattenedInitialTransform{ nullptr };
+  const InitialTransformType * m_InitialTransformForEvaluation{ nullptr };
+
   /** Typedefs for function pointers. */
   using TransformPointFunctionPointer = OutputPointType (Self::*)(const InputPointType &) const;
   using GetSparseJacobianFunctionPointer = void (Self::*)(const InputPointType &,
@@ -414,7 +414,7 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::GetHasNonZeroSpatialHess
   }
   else
   {
-    bool dummy = this->m_InitialTransform->GetHasNonZeroSpatialHessian() ||
+    bool dummy = this->m_InitialTransformForEvaluation->GetHasNonZeroSpatialHessian() ||
                  this->m_CurrentTransform->GetHasNonZeroSpatialHessian();
     return dummy;
   }
@@ -443,7 +443,7 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::HasNonZeroJacobianOfSpat
   }
   else
   {
-    bool dummy = this->m_InitialTransform->GetHasNonZeroJacobianOfSpatialHessian() ||
+    bool dummy = this->m_InitialTransformForEvaluation->GetHasNonZeroJacobianOfSpatialHessian() ||
                  this->m_CurrentTransform->GetHasNonZeroJacobianOfSpatialHessian();
     return dummy;
   }
@@ -473,6 +473,8 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::SetInitialTransform(Init
   if (this->m_InitialTransform != _arg)
   {
     this->m_InitialTransform = _arg;
+    this->m_FlattenedInitialTransform = nullptr;
+    this->m_InitialTransformForEvaluation = _arg;
     this->Modified();
     this->UpdateCombinationMethod();
   }
@@ -480,6 +482,102 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::SetInitialTransform(Init
 } // end SetInitialTransform()
 
 
+/**
+ * ******************* FlattenInitialTransform **********************
+ */
+
+template <typename TScalarType, unsigned int NDimensions>
+void
+AdvancedCombinationTransform<TScalarType, NDimensions>::FlattenInitialTransform()
+{
+  this->RestoreInitialTransform();
+  if (this->m_InitialTransform.IsNull())
+  {
+    return;
+  }
+
+  if (this->m_InitialTransform->IsLinear())
+  {
+    /** An affine transform is T(x) = A x + T(0), where A is its spatial Jacobian. */
+    InputPointType origin;
+    origin.Fill(0.0);
+    SpatialJacobianType matrix;
+    this->m_InitialTransform->GetSpatialJacobian(origin, matrix);
+    const OutputPointType translation = this->m_InitialTransform->TransformPoint(origin);
+
+    const auto flattenedInitialTransform = FlattenedInitialTransformType::New();
+    flattenedInitialTransform->SetMatrix(matrix);
+    flattenedInitialTransform->SetTranslation(translation.GetVectorFromOrigin());
+
+    this->m_FlattenedInitialTransform = flattenedInitialTransform;
+    this->m_InitialTransformForEvaluation = flattenedInitialTransform;
+  }
+  else if (const auto initialCombinationTransform =
+             dynamic_cast<const Self *>(this->m_InitialTransform.GetPointer()))
+  {
+    /** Collapse the linear stages further down the chain, in a private copy of the initial
+     * combination transform, as the initial transform itself may be shared. */
+    const auto flattenedInitialTransform = Self::New();
+    flattenedInitialTransform->SetCurrentTransform(initialCombinationTransform->m_CurrentTransform);
+    flattenedInitialTransform->SetInitialTransform(initialCombinationTransform->m_InitialTransform);
+    flattenedInitialTransform->SetUseAddition(initialCombinationTransform->m_UseAddition);
+    flattenedInitialTransform->FlattenInitialTransform();
+
+    if (flattenedInitialTransform->m_FlattenedInitialTransform.IsNotNull())
+    {
+      this->m_FlattenedInitialTransform = flattenedInitialTransform;
+      this->m_InitialTransformForEvaluation = flattenedInitialTransform;
+    }
+  }
+
+} // end FlattenInitialTransform()
+
+
+/**
+ * ******************* BakeInitialTransform **********************
+ */
+
+template <typename TScalarType, unsigned int NDimensions>
+void
+AdvancedCombinationTransform<TScalarType, NDimensions>::BakeInitialTransform(const GridOriginType &    gridOrigin,
+                                                                             const GridSpacingType &   gridSpacing,
+                                                                             const GridSizeType &      gridSize,
+                                                                             const GridDirectionType & gridDirection)
+{
+  this->RestoreInitialTransform();
+  if (this->m_InitialTransform.IsNull())
+  {
+    return;
+  }
+
+  const auto initialTransformGrid = InitialTransformGridType::New();
+  initialTransformGrid->SetGridOrigin(gridOrigin);
+  initialTransformGrid->SetGridSpacing(gridSpacing);
+  initialTransformGrid->SetGridDirection(gridDirection);
+  initialTransformGrid->SetGridRegion(typename InitialTransformGridType::RegionType(gridSize));
+  initialTransformGrid->SetSourceTransform(this->m_InitialTransform);
+  initialTransformGrid->UpdateDisplacementGrid();
+
+  this->m_FlattenedInitialTransform = initialTransformGrid;
+  this->m_InitialTransformForEvaluation = initialTransformGrid;
+
+} // end BakeInitialTransform()
+
+
+/**
+ * ******************* RestoreInitialTransform **********************
+ */
+
+template <typename TScalarType, unsigned int NDimensions>
+void
+AdvancedCombinationTransform<TScalarType, NDimensions>::RestoreInitialTransform()
+{
+  this->m_FlattenedInitialTransform = nullptr;
+  this->m_InitialTransformForEvaluation = this->m_InitialTransform;
+
+} // end RestoreInitialTransform()
+
+
 /**
  * ******************* SetCurrentTransform **********************
  */
@@ -645,7 +743,7 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::TransformPointUseAdditio
   -> OutputPointType
 {
   /** The Initial transform. */
-  OutputPointType out0 = this->m_InitialTransform->TransformPoint(point);
+  OutputPointType out0 = this->m_InitialTransformForEvaluation->TransformPoint(point);
 
   /** The Current transform. */
   OutputPointType out = this->m_CurrentTransform->TransformPoint(point);
@@ -670,7 +768,7 @@ auto
 AdvancedCombinationTransform<TScalarType, NDimensions>::TransformPointUseComposition(const InputPointType & point) const
   -> OutputPointType
 {
-  return this->m_CurrentTransform->TransformPoint(this->m_InitialTransform->TransformPoint(point));
+  return this->m_CurrentTransform->TransformPoint(this->m_InitialTransformForEvaluation->TransformPoint(point));
 
 } // end TransformPointUseComposition()
 
@@ -732,7 +830,7 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::GetJacobianUseCompositio
   NonZeroJacobianIndicesType & nonZeroJacobianIndices) const
 {
   this->m_CurrentTransform->GetJacobian(
-    this->m_InitialTransform->TransformPoint(inputPoint), j, nonZeroJacobianIndices);
+    this->m_InitialTransformForEvaluation->TransformPoint(inputPoint), j, nonZeroJacobianIndices);
 
 } // end GetJacobianUseComposition()
 
@@ -801,7 +899,10 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::EvaluateJacobianWithImag
   NonZeroJacobianIndicesType &    nonZeroJacobianIndices) const
 {
   this->m_CurrentTransform->EvaluateJacobianWithImageGradientProduct(
-    this->m_InitialTransform->TransformPoint(inputPoint), movingImageGradient, imageJacobian, nonZeroJacobianIndices);
+    this->m_InitialTransformForEvaluation->TransformPoint(inputPoint),
+    movingImageGradient,
+    imageJacobian,
+    nonZeroJacobianIndices);
 
 } // end EvaluateJacobianWithImageGradientProductUseComposition()
 
@@ -852,7 +953,7 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::GetSpatialJacobianUseAdd
                                                                                       SpatialJacobianType &  sj) const
 {
   SpatialJacobianType sj0, sj1;
-  this->m_InitialTransform->GetSpatialJacobian(inputPoint, sj0);
+  this->m_InitialTransformForEvaluation->GetSpatialJacobian(inputPoint, sj0);
   this->m_CurrentTransform->GetSpatialJacobian(inputPoint, sj1);
   sj = sj0 + sj1 - SpatialJacobianType::GetIdentity();
 
@@ -870,8 +971,8 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::GetSpatialJacobianUseCom
   SpatialJacobianType &  sj) const
 {
   SpatialJacobianType sj0, sj1;
-  this->m_InitialTransform->GetSpatialJacobian(inputPoint, sj0);
-  this->m_CurrentTransform->GetSpatialJacobian(this->m_InitialTransform->TransformPoint(inputPoint), sj1);
+  this->m_InitialTransformForEvaluation->GetSpatialJacobian(inputPoint, sj0);
+  this->m_CurrentTransform->GetSpatialJacobian(this->m_InitialTransformForEvaluation->TransformPoint(inputPoint), sj1);
 
   sj = sj1 * sj0;
 
@@ -919,7 +1020,7 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::GetSpatialHessianUseAddi
                                                                                      SpatialHessianType &   sh) const
 {
   SpatialHessianType sh0, sh1;
-  this->m_InitialTransform->GetSpatialHessian(inputPoint, sh0);
+  this->m_InitialTransformForEvaluation->GetSpatialHessian(inputPoint, sh0);
   this->m_CurrentTransform->GetSpatialHessian(inputPoint, sh1);
 
   for (unsigned int i = 0; i < SpaceDimension; ++i)
@@ -946,14 +1047,14 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::GetSpatialHessianUseComp
 
   /** Transform the input point. */
   // \todo this has already been computed and it is expensive.
-  InputPointType transformedPoint = this->m_InitialTransform->TransformPoint(inputPoint);
+  InputPointType transformedPoint = this->m_InitialTransformForEvaluation->TransformPoint(inputPoint);
 
   /** Compute the (Jacobian of the) spatial Jacobian / Hessian of the
    * internal transforms.
    */
-  this->m_InitialTransform->GetSpatialJacobian(inputPoint, sj0);
+  this->m_InitialTransformForEvaluation->GetSpatialJacobian(inputPoint, sj0);
   this->m_CurrentTransform->GetSpatialJacobian(transformedPoint, sj1);
-  this->m_InitialTransform->GetSpatialHessian(inputPoint, sh0);
+  this->m_InitialTransformForEvaluation->GetSpatialHessian(inputPoint, sh0);
   this->m_CurrentTransform->GetSpatialHessian(transformedPoint, sh1);
 
   typename SpatialJacobianType::InternalMatrixType sj0tvnl = sj0.GetTranspose();
@@ -1050,9 +1151,9 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::GetJacobianOfSpatialJaco
 {
   SpatialJacobianType           sj0;
   JacobianOfSpatialJacobianType jsj1;
-  this->m_InitialTransform->GetSpatialJacobian(inputPoint, sj0);
+  this->m_InitialTransformForEvaluation->GetSpatialJacobian(inputPoint, sj0);
   this->m_CurrentTransform->GetJacobianOfSpatialJacobian(
-    this->m_InitialTransform->TransformPoint(inputPoint), jsj1, nonZeroJacobianIndices);
+    this->m_InitialTransformForEvaluation->TransformPoint(inputPoint), jsj1, nonZeroJacobianIndices);
 
   jsj.resize(nonZeroJacobianIndices.size());
   for (unsigned int mu = 0; mu < nonZeroJacobianIndices.size(); ++mu)
@@ -1077,9 +1178,9 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::GetJacobianOfSpatialJaco
 {
   SpatialJacobianType           sj0, sj1;
   JacobianOfSpatialJacobianType jsj1;
-  this->m_InitialTransform->GetSpatialJacobian(inputPoint, sj0);
+  this->m_InitialTransformForEvaluation->GetSpatialJacobian(inputPoint, sj0);
   this->m_CurrentTransform->GetJacobianOfSpatialJacobian(
-    this->m_InitialTransform->TransformPoint(inputPoint), sj1, jsj1, nonZeroJacobianIndices);
+    this->m_InitialTransformForEvaluation->TransformPoint(inputPoint), sj1, jsj1, nonZeroJacobianIndices);
 
   sj = sj1 * sj0;
   jsj.resize(nonZeroJacobianIndices.size());
@@ -1211,12 +1312,12 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::GetJacobianOfSpatialHess
 
   /** Transform the input point. */
   // \todo: this has already been computed and it is expensive.
-  InputPointType transformedPoint = this->m_InitialTransform->TransformPoint(inputPoint);
+  InputPointType transformedPoint = this->m_InitialTransformForEvaluation->TransformPoint(inputPoint);
 
   /** Compute the (Jacobian of the) spatial Jacobian / Hessian of the
    * internal transforms. */
-  this->m_InitialTransform->GetSpatialJacobian(inputPoint, sj0);
-  this->m_InitialTransform->GetSpatialHessian(inputPoint, sh0);
+  this->m_InitialTransformForEvaluation->GetSpatialJacobian(inputPoint, sj0);
+  this->m_InitialTransformForEvaluation->GetSpatialHessian(inputPoint, sh0);
 
   /** Assume/demand that GetJacobianOfSpatialJacobian returns
    * the same nonZeroJacobianIndices as the GetJacobianOfSpatialHessian. */
@@ -1237,7 +1338,7 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::GetJacobianOfSpatialHess
     }
   }
 
-  if (this->m_InitialTransform->GetHasNonZeroSpatialHessian())
+  if (this->m_InitialTransformForEvaluation->GetHasNonZeroSpatialHessian())
   {
     for (unsigned int mu = 0; mu < nonZeroJacobianIndices.size(); ++mu)
     {
@@ -1274,13 +1375,13 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::GetJacobianOfSpatialHess
 
   /** Transform the input point. */
   // \todo this has already been computed and it is expensive.
-  InputPointType transformedPoint = this->m_InitialTransform->TransformPoint(inputPoint);
+  InputPointType transformedPoint = this->m_InitialTransformForEvaluation->TransformPoint(inputPoint);
 
   /** Compute the (Jacobian of the) spatial Jacobian / Hessian of the
    * internal transforms.
    */
-  this->m_InitialTransform->GetSpatialJacobian(inputPoint, sj0);
-  this->m_InitialTransform->GetSpatialHessian(inputPoint, sh0);
+  this->m_InitialTransformForEvaluation->GetSpatialJacobian(inputPoint, sj0);
+  this->m_InitialTransformForEvaluation->GetSpatialHessian(inputPoint, sh0);
 
   /** Assume/demand that GetJacobianOfSpatialJacobian returns the same
    * nonZeroJacobianIndices as the GetJacobianOfSpatialHessian.
@@ -1301,7 +1402,7 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::GetJacobianOfSpatialHess
     }
   }
 
-  if (this->m_InitialTransform->GetHasNonZeroSpatialHessian())
+  if (this->m_InitialTransformForEvaluation->GetHasNonZeroSpatialHessian())
   {
     for (unsigned int mu = 0; mu < nonZeroJacobianIndices.size(); ++mu)
     {
@@ -1321,7 +1422,7 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::GetJacobianOfSpatialHess
     sh[dim] = sj0t * (sh1[dim] * sj0);
   }
 
-  if (this->m_InitialTransform->GetHasNonZeroSpatialHessian())
+  if (this->m_InitialTransformForEvaluation->GetHasNonZeroSpatialHessian())
   {
     for (unsigned int dim = 0; dim < SpaceDimension; ++dim)
     {
@@ -1427,6 +1528,87 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::TransformPoint(const Inp
 } // end TransformPoint()
 
 
+/**
+ * ****************** TransformPoints ****************************
+ */
+
+template <typename TScalarType, unsigned int NDimensions>
+void
+AdvancedCombinationTransform<TScalarType, NDimensions>::TransformPoints(const InputPointType * inputPoints,
+                                                                        OutputPointType *      outputPoints,
+                                                                        SizeValueType          numberOfPoints) const
+{
+  if (this->m_CurrentTransform.IsNull())
+  {
+    itkExceptionMacro(<< NoCurrentTransformSet);
+  }
+
+  if (this->m_InitialTransform.IsNull())
+  {
+    this->m_CurrentTransform->TransformPoints(inputPoints, outputPoints, numberOfPoints);
+  }
+  else if (this->m_UseAddition)
+  {
+    /** The addition needs both intermediate results, so it is done point by point. */
+    Superclass::TransformPoints(inputPoints, outputPoints, numberOfPoints);
+  }
+  else
+  {
+    /** Composition: the output of the initial transform is transformed in-place. */
+    this->m_InitialTransformForEvaluation->TransformPoints(inputPoints, outputPoints, numberOfPoints);
+    this->m_CurrentTransform->TransformPoints(outputPoints, outputPoints, numberOfPoints);
+  }
+
+} // end TransformPoints()
+
+
+/**
+ * ****************** TransformPointsAlongLine ****************************
+ */
+
+template <typename TScalarType, unsigned int NDimensions>
+void
+AdvancedCombinationTransform<TScalarType, NDimensions>::TransformPointsAlongLine(
+  const InputPointType &  firstPoint,
+  const InputVectorType & step,
+  SizeValueType           numberOfPoints,
+  OutputPointType *       outputPoints) const
+{
+  if (this->m_CurrentTransform.IsNull())
+  {
+    itkExceptionMacro(<< NoCurrentTransformSet);
+  }
+
+  if (this->m_InitialTransform.IsNull())
+  {
+    this->m_CurrentTransform->TransformPointsAlongLine(firstPoint, step, numberOfPoints, outputPoints);
+  }
+  else if (this->m_UseAddition)
+  {
+    /** T(x) = T_1(x) + T_0(x) - x, where only T_1 is evaluated along the row. */
+    this->m_CurrentTransform->TransformPointsAlongLine(firstPoint, step, numberOfPoints, outputPoints);
+    for (SizeValueType k = 0; k < numberOfPoints; ++k)
+    {
+      const InputPointType point = firstPoint + step * static_cast<ScalarType>(k);
+      outputPoints[k] += this->m_InitialTransformForEvaluation->TransformPoint(point) - point;
+    }
+  }
+  else if (this->m_InitialTransformForEvaluation->IsLinear())
+  {
+    /** Composition with a linear T_0: the row is mapped onto another row of equidistant points. */
+    const OutputPointType  firstInitialPoint = this->m_InitialTransformForEvaluation->TransformPoint(firstPoint);
+    const OutputVectorType initialStep =
+      this->m_InitialTransformForEvaluation->TransformPoint(firstPoint + step) - firstInitialPoint;
+    this->m_CurrentTransform->TransformPointsAlongLine(firstInitialPoint, initialStep, numberOfPoints, outputPoints);
+  }
+  else
+  {
+    Superclass::TransformPointsAlongLine(firstPoint, step, numberOfPoints, outputPoints);
+  }
+
+} // end TransformPointsAlongLine()
+
+
 /**
  * ****************** GetJacobian ****************************
  */
@@ -1463,6 +1645,147 @@ AdvancedCombinationTransform<TScalarType, NDimensions>::EvaluateJacobianWithImag
 } // end EvaluateJacobianWithImageGradientProduct()
 
 
+/**
+ * ****************** EvaluateJacobianWithImageGradientProducts ****************************
+ */
+
+template <typename TScalarType, unsigned int NDimensions>
+void
+AdvancedCombinationTransform<TScalarType, NDimensions>::EvaluateJacobianWithImageGradientProducts(
+  const InputPointType *          inputPoints,
+  const MovingImageGradientType * movingImageGradients,
+  DerivativeType *                imageJacobians,
+  NonZeroJacobianIndicesType *    nonZeroJacobianIndices,
+  SizeValueType                   numberOfPoints) const
+{
+  if (this->m_CurrentTransform.IsNull())
+  {
+    itkExceptionMacro(<< NoCurrentTransformSet);
+  }
+
+  if (this->m_InitialTransform.IsNull() || this->m_UseAddition)
+  {
+    this->m_CurrentTransform->EvaluateJacobianWithImageGradientProducts(
+      inputPoints, movingImageGradients, imageJacobians, nonZeroJacobianIndices, numberOfPoints);
+  }
+  else
+  {
+    /** Composition: the Jacobian of the current transform is evaluated at T_0(x).
+     * The intermediate points are stored in thread-local storage, to avoid reallocation. */
+    thread_local std::vector<InputPointType> intermediatePoints;
+    intermediatePoints.resize(numberOfPoints);
+    this->m_InitialTransformForEvaluation->TransformPoints(inputPoints, intermediatePoints.data(), numberOfPoints);
+    this->m_CurrentTransform->EvaluateJacobianWithImageGradientProducts(
+      intermediatePoints.data(), movingImageGradients, imageJacobians, nonZeroJacobianIndices, numberOfPoints);
+  }
+
+} // end EvaluateJacobianWithImageGradientProducts()
+
+
+/**
+ * ****************** CreateSampleCache ****************************
+ */
+
+template <typename TScalarType, unsigned int NDimensions>
+auto
+AdvancedCombinationTransform<TScalarType, NDimensions>::CreateSampleCache(const InputPointType * inputPoints,
+                                                                          SizeValueType numberOfPoints) const
+  -> SampleCacheConstPointer
+{
+  if (this->m_CurrentTransform.IsNull())
+  {
+    itkExceptionMacro(<< NoCurrentTransformSet);
+  }
+
+  if (this->m_InitialTransform.IsNull())
+  {
+    return this->m_CurrentTransform->CreateSampleCache(inputPoints, numberOfPoints);
+  }
+  if (this->m_UseAddition)
+  {
+    /** The addition needs the initial transform at every sample, so there is little to gain. */
+    return nullptr;
+  }
+
+  /** Composition: the current transform is evaluated at T_0(x). */
+  std::vector<InputPointType> intermediatePoints(numberOfPoints);
+  this->m_InitialTransformForEvaluation->TransformPoints(inputPoints, intermediatePoints.data(), numberOfPoints);
+  return this->m_CurrentTransform->CreateSampleCache(intermediatePoints.data(), numberOfPoints);
+
+} // end CreateSampleCache()
+
+
+/**
+ * ****************** TransformPointUsingSampleCache ****************************
+ */
+
+template <typename TScalarType, unsigned int NDimensions>
+auto
+AdvancedCombinationTransform<TScalarType, NDimensions>::TransformPointUsingSampleCache(
+  const SampleCacheBase & sampleCache,
+  SizeValueType           sampleIndex) const -> OutputPointType
+{
+  return this->m_CurrentTransform->TransformPointUsingSampleCache(sampleCache, sampleIndex);
+
+} // end TransformPointUsingSampleCache()
+
+
+/**
+ * ****************** GetJacobianUsingSampleCache ****************************
+ */
+
+template <typename TScalarType, unsigned int NDimensions>
+void
+AdvancedCombinationTransform<TScalarType, NDimensions>::GetJacobianUsingSampleCache(
+  const SampleCacheBase &      sampleCache,
+  SizeValueType                sampleIndex,
+  JacobianType &               j,
+  NonZeroJacobianIndicesType & nonZeroJacobianIndices) const
+{
+  this->m_CurrentTransform->GetJacobianUsingSampleCache(sampleCache, sampleIndex, j, nonZeroJacobianIndices);
+
+} // end GetJacobianUsingSampleCache()
+
+
+/**
+ * ****************** EvaluateJacobianWithImageGradientProductUsingSampleCache ****************************
+ */
+
+template <typename TScalarType, unsigned int NDimensions>
+void
+AdvancedCombinationTransform<TScalarType, NDimensions>::EvaluateJacobianWithImageGradientProductUsingSampleCache(
+  const SampleCacheBase &         sampleCache,
+  SizeValueType                   sampleIndex,
+  const MovingImageGradientType & movingImageGradient,
+  DerivativeType &                imageJacobian,
+  NonZeroJacobianIndicesType &    nonZeroJacobianIndices) const
+{
+  this->m_CurrentTransform->EvaluateJacobianWithImageGradientProductUsingSampleCache(
+    sampleCache, sampleIndex, movingImageGradient, imageJacobian, nonZeroJacobianIndices);
+
+} // end EvaluateJacobianWithImageGradientProductUsingSampleCache()
+
+
+/**
+ * ****************** EvaluateJacobianWithImageGradientProductsUsingSampleCache ****************************
+ */
+
+template <typename TScalarType, unsigned int NDimensions>
+void
+AdvancedCombinationTransform<TScalarType, NDimensions>::EvaluateJacobianWithImageGradientProductsUsingSampleCache(
+  const SampleCacheBase &         sampleCache,
+  const SizeValueType *           sampleIndices,
+  const MovingImageGradientType * movingImageGradients,
+  DerivativeType *                imageJacobians,
+  NonZeroJacobianIndicesType *    nonZeroJacobianIndices,
+  SizeValueType                   numberOfSamples) const
+{
+  this->m_CurrentTransform->EvaluateJacobianWithImageGradientProductsUsingSampleCache(
+    sampleCache, sampleIndices, movingImageGradients, imageJacobians, nonZeroJacobianIndices, numberOfSamples);
+
+} // end EvaluateJacobianWithImageGradientProductsUsingSampleCache()
+
+
 /**
  * ****************** GetSpatialJacobian ****************************
  */
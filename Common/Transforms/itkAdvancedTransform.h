@@ -38,6 +38,8 @@
 #include "itkMatrix.h"
 #include "itkFixedArray.h"
 
+#include <memory> // For unique_ptr.
+
 namespace itk
 {
 
@@ -147,6 +149,17 @@ public:
   using MovingImageGradientType = OutputCovariantVectorType;
   using MovingImageGradientValueType = typename MovingImageGradientType::ValueType;
 
+  /** Base class of the data that a transform precomputes for a fixed set of
+   * sample points, see CreateSampleCache(). Each transform that supports the
+   * sample cache derives its own cache type from this class.
+   */
+  class SampleCacheBase
+  {
+  public:
+    virtual ~SampleCacheBase() = default;
+  };
+  using SampleCacheConstPointer = std::unique_ptr<const SampleCacheBase>;
+
   /** Get the number of nonzero Jacobian indices. By default all. */
   virtual NumberOfParametersType
   GetNumberOfNonZeroJacobianIndices() const;
@@ -195,6 +208,79 @@ public:
                                            DerivativeType &                imageJacobian,
                                            NonZeroJacobianIndicesType &    nonZeroJacobianIndices) const;
 
+  /** Compute the inner products of the Jacobian with the moving image gradient
+   * for a batch of points. By default EvaluateJacobianWithImageGradientProduct()
+   * is called for each point. All arrays should hold numberOfPoints elements.
+   */
+  virtual void
+  EvaluateJacobianWithImageGradientProducts(const InputPointType *          inputPoints,
+                                            const MovingImageGradientType * movingImageGradients,
+                                            DerivativeType *                imageJacobians,
+                                            NonZeroJacobianIndicesType *    nonZeroJacobianIndices,
+                                            SizeValueType                   numberOfPoints) const;
+
+  /** Transform a batch of points. By default TransformPoint() is called for
+   * each point; transforms that can evaluate multiple points at once, like the
+   * RecursiveBSplineTransform, override this function. The inputPoints and the
+   * outputPoints arrays should both hold numberOfPoints elements, and may be
+   * the same array.
+   */
+  virtual void
+  TransformPoints(const InputPointType * inputPoints,
+                  OutputPointType *      outputPoints,
+                  SizeValueType          numberOfPoints) const;
+
+  /** Transform the equidistant points firstPoint + k * step, for k = 0, ..., numberOfPoints - 1,
+   * like a row of voxels. By default the points are passed to TransformPoints(); transforms that
+   * can exploit the regular spacing of the points, like the B-spline transforms, override this function.
+   */
+  virtual void
+  TransformPointsAlongLine(const InputPointType &  firstPoint,
+                           const InputVectorType & step,
+                           SizeValueType           numberOfPoints,
+                           OutputPointType *       outputPoints) const;
+
+  /** Precompute the data that only depends on the input points, like the
+   * B-spline support region and weights, for a fixed set of sample points.
+   * The returned cache can be passed to the ...UsingSampleCache() functions
+   * below, together with the index of a sample, as long as the grid of the
+   * transform does not change. Returns a null pointer when the transform does
+   * not support a sample cache, which is the default.
+   */
+  virtual SampleCacheConstPointer
+  CreateSampleCache(const InputPointType * inputPoints, SizeValueType numberOfPoints) const;
+
+  /** TransformPoint() for the sample with index sampleIndex of the cache. */
+  virtual OutputPointType
+  TransformPointUsingSampleCache(const SampleCacheBase & sampleCache, SizeValueType sampleIndex) const;
+
+  /** GetJacobian() for the sample with index sampleIndex of the cache. */
+  virtual void
+  GetJacobianUsingSampleCache(const SampleCacheBase &      sampleCache,
+                              SizeValueType                sampleIndex,
+                              JacobianType &               j,
+                              NonZeroJacobianIndicesType & nonZeroJacobianIndices) const;
+
+  /** EvaluateJacobianWithImageGradientProduct() for the sample with index sampleIndex of the cache. */
+  virtual void
+  EvaluateJacobianWithImageGradientProductUsingSampleCache(
+    const SampleCacheBase &         sampleCache,
+    SizeValueType                   sampleIndex,
+    const MovingImageGradientType & movingImageGradient,
+    DerivativeType &                imageJacobian,
+    NonZeroJacobianIndicesType &    nonZeroJacobianIndices) const;
+
+  /** EvaluateJacobianWithImageGradientProducts() for the samples of the cache with the given indices.
+   * By default EvaluateJacobianWithImageGradientProductUsingSampleCache() is called for each sample. */
+  virtual void
+  EvaluateJacobianWithImageGradientProductsUsingSampleCache(
+    const SampleCacheBase &         sampleCache,
+    const SizeValueType *           sampleIndices,
+    const MovingImageGradientType * movingImageGradients,
+    DerivativeType *                imageJacobians,
+    NonZeroJacobianIndicesType *    nonZeroJacobianIndices,
+    SizeValueType                   numberOfSamples) const;
+
   /** Compute the spatial Jacobian of the transformation.
    *
    * The spatial Jacobian is expressed as a vector of partial derivatives of the
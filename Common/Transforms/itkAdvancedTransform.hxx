@@ -35,6 +35,7 @@
 #define _itkAdvancedTransform_hxx
 
 #include "itkAdvancedTransform.h"
+#include <vector>
 
 namespace itk
 {
@@ -103,6 +104,159 @@ AdvancedTransform<TScalarType, NInputDimensions, NOutputDimensions>::EvaluateJac
 } // end EvaluateJacobianWithImageGradientProduct()
 
 
+/**
+ * ********************* TransformPoints ****************************
+ */
+
+template <class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+AdvancedTransform<TScalarType, NInputDimensions, NOutputDimensions>::TransformPoints(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  SizeValueType          numberOfPoints) const
+{
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    outputPoints[i] = this->TransformPoint(inputPoints[i]);
+  }
+
+} // end TransformPoints()
+
+
+/**
+ * ********************* TransformPointsAlongLine ****************************
+ */
+
+template <class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+AdvancedTransform<TScalarType, NInputDimensions, NOutputDimensions>::TransformPointsAlongLine(
+  const InputPointType &  firstPoint,
+  const InputVectorType & step,
+  SizeValueType           numberOfPoints,
+  OutputPointType *       outputPoints) const
+{
+  std::vector<InputPointType> inputPoints(numberOfPoints);
+  for (SizeValueType k = 0; k < numberOfPoints; ++k)
+  {
+    inputPoints[k] = firstPoint + step * static_cast<ScalarType>(k);
+  }
+  this->TransformPoints(inputPoints.data(), outputPoints, numberOfPoints);
+
+} // end TransformPointsAlongLine()
+
+
+/**
+ * ********************* EvaluateJacobianWithImageGradientProducts ****************************
+ */
+
+template <class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+AdvancedTransform<TScalarType, NInputDimensions, NOutputDimensions>::EvaluateJacobianWithImageGradientProducts(
+  const InputPointType *          inputPoints,
+  const MovingImageGradientType * movingImageGradients,
+  DerivativeType *                imageJacobians,
+  NonZeroJacobianIndicesType *    nonZeroJacobianIndices,
+  SizeValueType                   numberOfPoints) const
+{
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    this->EvaluateJacobianWithImageGradientProduct(
+      inputPoints[i], movingImageGradients[i], imageJacobians[i], nonZeroJacobianIndices[i]);
+  }
+
+} // end EvaluateJacobianWithImageGradientProducts()
+
+
+/**
+ * ********************* CreateSampleCache ****************************
+ */
+
+template <class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+auto
+AdvancedTransform<TScalarType, NInputDimensions, NOutputDimensions>::CreateSampleCache(
+  const InputPointType * itkNotUsed(inputPoints),
+  SizeValueType          itkNotUsed(numberOfPoints)) const -> SampleCacheConstPointer
+{
+  /** By default the sample cache is not supported. */
+  return nullptr;
+
+} // end CreateSampleCache()
+
+
+/**
+ * ********************* TransformPointUsingSampleCache ****************************
+ */
+
+template <class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+auto
+AdvancedTransform<TScalarType, NInputDimensions, NOutputDimensions>::TransformPointUsingSampleCache(
+  const SampleCacheBase & itkNotUsed(sampleCache),
+  SizeValueType           itkNotUsed(sampleIndex)) const -> OutputPointType
+{
+  itkExceptionMacro(<< "The sample cache is not supported by " << this->GetNameOfClass());
+
+} // end TransformPointUsingSampleCache()
+
+
+/**
+ * ********************* GetJacobianUsingSampleCache ****************************
+ */
+
+template <class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+AdvancedTransform<TScalarType, NInputDimensions, NOutputDimensions>::GetJacobianUsingSampleCache(
+  const SampleCacheBase &      itkNotUsed(sampleCache),
+  SizeValueType                itkNotUsed(sampleIndex),
+  JacobianType &               itkNotUsed(j),
+  NonZeroJacobianIndicesType & itkNotUsed(nonZeroJacobianIndices)) const
+{
+  itkExceptionMacro(<< "The sample cache is not supported by " << this->GetNameOfClass());
+
+} // end GetJacobianUsingSampleCache()
+
+
+/**
+ * ********************* EvaluateJacobianWithImageGradientProductUsingSampleCache ****************************
+ */
+
+template <class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+AdvancedTransform<TScalarType, NInputDimensions, NOutputDimensions>::
+  EvaluateJacobianWithImageGradientProductUsingSampleCache(
+    const SampleCacheBase &         itkNotUsed(sampleCache),
+    SizeValueType                   itkNotUsed(sampleIndex),
+    const MovingImageGradientType & itkNotUsed(movingImageGradient),
+    DerivativeType &                itkNotUsed(imageJacobian),
+    NonZeroJacobianIndicesType &    itkNotUsed(nonZeroJacobianIndices)) const
+{
+  itkExceptionMacro(<< "The sample cache is not supported by " << this->GetNameOfClass());
+
+} // end EvaluateJacobianWithImageGradientProductUsingSampleCache()
+
+
+/**
+ * ********************* EvaluateJacobianWithImageGradientProductsUsingSampleCache ****************************
+ */
+
+template <class TScalarType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+AdvancedTransform<TScalarType, NInputDimensions, NOutputDimensions>::
+  EvaluateJacobianWithImageGradientProductsUsingSampleCache(const SampleCacheBase &         sampleCache,
+                                                            const SizeValueType *           sampleIndices,
+                                                            const MovingImageGradientType * movingImageGradients,
+                                                            DerivativeType *                imageJacobians,
+                                                            NonZeroJacobianIndicesType *    nonZeroJacobianIndices,
+                                                            SizeValueType                   numberOfSamples) const
+{
+  for (SizeValueType i = 0; i < numberOfSamples; ++i)
+  {
+    this->EvaluateJacobianWithImageGradientProductUsingSampleCache(
+      sampleCache, sampleIndices[i], movingImageGradients[i], imageJacobians[i], nonZeroJacobianIndices[i]);
+  }
+
+} // end EvaluateJacobianWithImageGradientProductsUsingSampleCache()
+
+
 /**
  * ********************* GetNumberOfNonZeroJacobianIndices ****************************
  */
@@ -89,6 +89,8 @@ public:
   using GridOffsetType = typename RegionType::IndexType;
   using typename Superclass::InputPointType;
   using typename Superclass::OutputPointType;
+  using typename Superclass::InputVectorType;
+  using typename Superclass::OutputVectorType;
   using typename Superclass::WeightsType;
   using typename Superclass::ParameterIndexArrayType;
   using typename Superclass::ContinuousIndexType;
@@ -108,6 +110,16 @@ public:
   OutputPointType
   TransformPoint(const InputPointType & point) const override;
 
+  /** The cyclic grid wraps around the last dimension, so rows are evaluated point by point. */
+  bool
+  ComputeDisplacementsAlongLine(const InputPointType &,
+                                const InputVectorType &,
+                                const SizeValueType,
+                                OutputVectorType *) const override
+  {
+    return false;
+  }
+
   /** Compute the Jacobian of the transformation. */
   virtual void
   GetJacobian(const InputPointType & inputPoint, WeightsType & weights, ParameterIndexArrayType & indices) const;
@@ -0,0 +1,137 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkDisplacementGridCacheTransform_h
+#define itkDisplacementGridCacheTransform_h
+
+#include "itkAdvancedBSplineDeformableTransform.h"
+
+namespace itk
+{
+
+/**
+ * \class DisplacementGridCacheTransform
+ * \brief A cache of a fixed transform, as a dense grid of displacements.
+ *
+ * The displacements of a source transform are sampled at the nodes of a grid,
+ * by UpdateDisplacementGrid(), and linearly interpolated in between: the grid is
+ * a first order B-spline, whose coefficients are the sampled displacements.
+ * Evaluating the cache costs the same for any source transform, which makes it
+ * suited for long, frozen transform chains, like the initial transform of a
+ * multi-stage registration.
+ *
+ * Outside the grid, the source transform itself is evaluated. Inside the grid,
+ * the spatial Hessian is zero, as it is for any piecewise linear function.
+ *
+ * The source transform is assumed not to change: call UpdateDisplacementGrid()
+ * again after it has changed.
+ *
+ * \ingroup Transforms
+ */
+
+template <class TScalarType, unsigned int NDimensions = 3>
+class ITK_TEMPLATE_EXPORT DisplacementGridCacheTransform
+  : public AdvancedBSplineDeformableTransform<TScalarType, NDimensions, 1>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(DisplacementGridCacheTransform);
+
+  /** Standard class typedefs. */
+  using Self = DisplacementGridCacheTransform;
+  using Superclass = AdvancedBSplineDeformableTransform<TScalarType, NDimensions, 1>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** New macro for creation of through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(DisplacementGridCacheTransform, AdvancedBSplineDeformableTransform);
+
+  /** Dimension of the domain space. */
+  itkStaticConstMacro(SpaceDimension, unsigned int, NDimensions);
+
+  /** Typedefs from the Superclass. */
+  using typename Superclass::ParametersType;
+  using typename Superclass::InputPointType;
+  using typename Superclass::OutputPointType;
+  using typename Superclass::InputVectorType;
+  using typename Superclass::OutputVectorType;
+  using typename Superclass::SpatialJacobianType;
+  using typename Superclass::SpatialHessianType;
+  using typename Superclass::ContinuousIndexType;
+  using typename Superclass::RegionType;
+  using typename Superclass::IndexType;
+  using typename Superclass::SizeType;
+
+  /** The type of the transform that is cached. */
+  using SourceTransformType = AdvancedTransform<TScalarType, NDimensions, NDimensions>;
+  using SourceTransformConstPointer = typename SourceTransformType::ConstPointer;
+
+  /** Set/Get the transform that is cached. */
+  itkSetConstObjectMacro(SourceTransform, SourceTransformType);
+  itkGetConstObjectMacro(SourceTransform, SourceTransformType);
+
+  /** Sample the displacements of the source transform at the nodes of the grid,
+   * in parallel. Call this function after setting the grid and the source transform. */
+  void
+  UpdateDisplacementGrid();
+
+  /** Transform a point: interpolate the grid, or evaluate the source transform outside the grid. */
+  OutputPointType
+  TransformPoint(const InputPointType & point) const override;
+
+  /** Rows may leave the grid, where the source transform takes over, so they are evaluated point by point. */
+  bool
+  ComputeDisplacementsAlongLine(const InputPointType &,
+                                const InputVectorType &,
+                                const SizeValueType,
+                                OutputVectorType *) const override
+  {
+    return false;
+  }
+
+  /** Compute the spatial Jacobian of the interpolated grid, or of the source transform outside the grid. */
+  void
+  GetSpatialJacobian(const InputPointType & inputPoint, SpatialJacobianType & sj) const override;
+
+  /** Compute the spatial Hessian: zero inside the grid, that of the source transform outside the grid. */
+  void
+  GetSpatialHessian(const InputPointType & inputPoint, SpatialHessianType & sh) const override;
+
+protected:
+  DisplacementGridCacheTransform() = default;
+  ~DisplacementGridCacheTransform() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** Whether the point lies inside the grid, where it can be interpolated. */
+  bool
+  IsInsideGrid(const InputPointType & point) const;
+
+  SourceTransformConstPointer m_SourceTransform{ nullptr };
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkDisplacementGridCacheTransform.hxx"
+#endif
+
+#endif // end #ifndef itkDisplacementGridCacheTransform_h
@@ -0,0 +1,180 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkDisplacementGridCacheTransform_hxx
+#define itkDisplacementGridCacheTransform_hxx
+
+#include "itkDisplacementGridCacheTransform.h"
+#include "itkWorkStealingThreadPool.h"
+
+namespace itk
+{
+
+/**
+ * ********************* UpdateDisplacementGrid ****************************
+ */
+
+template <class TScalarType, unsigned int NDimensions>
+void
+DisplacementGridCacheTransform<TScalarType, NDimensions>::UpdateDisplacementGrid()
+{
+  if (this->m_SourceTransform.IsNull())
+  {
+    itkExceptionMacro(<< "No source transform set in the DisplacementGridCacheTransform");
+  }
+
+  const RegionType &  region = this->GetGridRegion();
+  const IndexType &   gridIndex = region.GetIndex();
+  const SizeType &    gridSize = region.GetSize();
+  const SizeValueType numberOfNodes = region.GetNumberOfPixels();
+
+  /** The coefficients of a B-spline are stored per dimension: first the displacements
+   * along the first axis of all nodes, then along the second axis, and so on. */
+  ParametersType displacements(SpaceDimension * numberOfNodes);
+
+  const auto threadPool = WorkStealingThreadPool::GetInstance();
+  threadPool->ParallelFor(
+    0,
+    numberOfNodes,
+    1024,
+    threadPool->GetNumberOfThreads(),
+    [&](const SizeValueType nodeBegin, const SizeValueType nodeEnd, const ThreadIdType) {
+      for (SizeValueType node = nodeBegin; node < nodeEnd; ++node)
+      {
+        /** The physical position of the node: origin + direction * spacing * index. */
+        SizeValueType remainder = node;
+        IndexType     index;
+        for (unsigned int d = 0; d < SpaceDimension; ++d)
+        {
+          index[d] = gridIndex[d] + static_cast<typename IndexType::IndexValueType>(remainder % gridSize[d]);
+          remainder /= gridSize[d];
+        }
+        InputPointType point = this->m_GridOrigin;
+        for (unsigned int i = 0; i < SpaceDimension; ++i)
+        {
+          for (unsigned int j = 0; j < SpaceDimension; ++j)
+          {
+            point[i] += this->m_GridDirection[i][j] * this->m_GridSpacing[j] * index[j];
+          }
+        }
+
+        const OutputPointType mappedPoint = this->m_SourceTransform->TransformPoint(point);
+        for (unsigned int d = 0; d < SpaceDimension; ++d)
+        {
+          displacements[d * numberOfNodes + node] = mappedPoint[d] - point[d];
+        }
+      }
+    });
+
+  this->SetParametersByValue(displacements);
+  this->m_HasNonZeroSpatialHessian = this->m_SourceTransform->GetHasNonZeroSpatialHessian();
+
+} // end UpdateDisplacementGrid()
+
+
+/**
+ * ********************* IsInsideGrid ****************************
+ */
+
+template <class TScalarType, unsigned int NDimensions>
+bool
+DisplacementGridCacheTransform<TScalarType, NDimensions>::IsInsideGrid(const InputPointType & point) const
+{
+  return this->InsideValidRegion(this->TransformPointToContinuousGridIndex(point));
+
+} // end IsInsideGrid()
+
+
+/**
+ * ********************* TransformPoint ****************************
+ */
+
+template <class TScalarType, unsigned int NDimensions>
+auto
+DisplacementGridCacheTransform<TScalarType, NDimensions>::TransformPoint(const InputPointType & point) const
+  -> OutputPointType
+{
+  if (this->m_SourceTransform.IsNotNull() && !this->IsInsideGrid(point))
+  {
+    return this->m_SourceTransform->TransformPoint(point);
+  }
+  return this->Superclass::TransformPoint(point);
+
+} // end TransformPoint()
+
+
+/**
+ * ********************* GetSpatialJacobian ****************************
+ */
+
+template <class TScalarType, unsigned int NDimensions>
+void
+DisplacementGridCacheTransform<TScalarType, NDimensions>::GetSpatialJacobian(const InputPointType & inputPoint,
+                                                                             SpatialJacobianType &  sj) const
+{
+  if (this->m_SourceTransform.IsNotNull() && !this->IsInsideGrid(inputPoint))
+  {
+    this->m_SourceTransform->GetSpatialJacobian(inputPoint, sj);
+    return;
+  }
+  this->Superclass::GetSpatialJacobian(inputPoint, sj);
+
+} // end GetSpatialJacobian()
+
+
+/**
+ * ********************* GetSpatialHessian ****************************
+ */
+
+template <class TScalarType, unsigned int NDimensions>
+void
+DisplacementGridCacheTransform<TScalarType, NDimensions>::GetSpatialHessian(const InputPointType & inputPoint,
+                                                                            SpatialHessianType &   sh) const
+{
+  if (this->m_SourceTransform.IsNotNull() && !this->IsInsideGrid(inputPoint))
+  {
+    this->m_SourceTransform->GetSpatialHessian(inputPoint, sh);
+    return;
+  }
+
+  /** The first order B-spline is piecewise linear. */
+  for (unsigned int d = 0; d < SpaceDimension; ++d)
+  {
+    sh[d].Fill(0.0);
+  }
+
+} // end GetSpatialHessian()
+
+
+/**
+ * ********************* PrintSelf ****************************
+ */
+
+template <class TScalarType, unsigned int NDimensions>
+void
+DisplacementGridCacheTransform<TScalarType, NDimensions>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "SourceTransform: " << this->m_SourceTransform.GetPointer() << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
+
+#endif // end #ifndef itkDisplacementGridCacheTransform_hxx
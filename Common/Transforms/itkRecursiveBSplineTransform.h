@@ -24,6 +24,8 @@
 #include "itkRecursiveBSplineTransformImplementation.h"
 #include "elxDefaultConstruct.h"
 
+#include <vector>
+
 namespace itk
 {
 /** \class RecursiveBSplineTransform
@@ -100,6 +102,8 @@ public:
   using typename Superclass::InternalMatrixType;
   using typename Superclass::MovingImageGradientType;
   using typename Superclass::MovingImageGradientValueType;
+  using typename Superclass::SampleCacheBase;
+  using typename Superclass::SampleCacheConstPointer;
 
   /** Interpolation weights function type. */
   using typename Superclass::WeightsFunctionType;
@@ -121,6 +125,15 @@ public:
   OutputPointType
   TransformPoint(const InputPointType & point) const override;
 
+  /** Compute the transformation of a batch of points. Points inside the valid
+   * region are gathered in groups of NumberOfLanes, which are evaluated together
+   * by RecursiveBSplineTransformImplementation::TransformPoints.
+   */
+  void
+  TransformPoints(const InputPointType * inputPoints,
+                  OutputPointType *      outputPoints,
+                  SizeValueType          numberOfPoints) const override;
+
   /** Compute the Jacobian of the transformation. */
   void
   GetJacobian(const InputPointType &       inputPoint,
@@ -136,6 +149,54 @@ public:
                                            DerivativeType &                imageJacobian,
                                            NonZeroJacobianIndicesType &    nonZeroJacobianIndices) const override;
 
+  /** Compute the inner products of the Jacobian with the moving image gradient
+   * for a batch of points, without a virtual function call per point.
+   */
+  void
+  EvaluateJacobianWithImageGradientProducts(const InputPointType *          inputPoints,
+                                            const MovingImageGradientType * movingImageGradients,
+                                            DerivativeType *                imageJacobians,
+                                            NonZeroJacobianIndicesType *    nonZeroJacobianIndices,
+                                            SizeValueType                   numberOfPoints) const override;
+
+  /** Precompute the support index, the 1D B-spline weights and the nonzero Jacobian indices
+   * of a fixed set of sample points. The cache remains valid as long as the grid is unchanged;
+   * the coefficients may change.
+   */
+  SampleCacheConstPointer
+  CreateSampleCache(const InputPointType * inputPoints, SizeValueType numberOfPoints) const override;
+
+  /** Compute the point transformation, using the cached weights. */
+  OutputPointType
+  TransformPointUsingSampleCache(const SampleCacheBase & sampleCache, SizeValueType sampleIndex) const override;
+
+  /** Compute the Jacobian of the transformation, using the cached weights. */
+  void
+  GetJacobianUsingSampleCache(const SampleCacheBase &      sampleCache,
+                              SizeValueType                sampleIndex,
+                              JacobianType &               j,
+                              NonZeroJacobianIndicesType & nonZeroJacobianIndices) const override;
+
+  /** Compute the inner product of the Jacobian with the moving image gradient, using the cached weights. */
+  void
+  EvaluateJacobianWithImageGradientProductUsingSampleCache(
+    const SampleCacheBase &         sampleCache,
+    SizeValueType                   sampleIndex,
+    const MovingImageGradientType & movingImageGradient,
+    DerivativeType &                imageJacobian,
+    NonZeroJacobianIndicesType &    nonZeroJacobianIndices) const override;
+
+  /** Compute the inner products of the Jacobian with the moving image gradient for a batch of
+   * samples, using the cached weights, without a virtual function call per sample. */
+  void
+  EvaluateJacobianWithImageGradientProductsUsingSampleCache(
+    const SampleCacheBase &         sampleCache,
+    const SizeValueType *           sampleIndices,
+    const MovingImageGradientType * movingImageGradients,
+    DerivativeType *                imageJacobians,
+    NonZeroJacobianIndicesType *    nonZeroJacobianIndices,
+    SizeValueType                   numberOfSamples) const override;
+
   /** Compute the spatial Jacobian of the transformation. */
   void
   GetSpatialJacobian(const InputPointType & inputPoint, SpatialJacobianType & sj) const override;
@@ -193,6 +254,64 @@ private:
   using RecursiveBSplineWeightFunctionType =
     itk::RecursiveBSplineInterpolationWeightFunction<TScalarType, NDimensions, VSplineOrder>;
 
+  /** The number of points that TransformPoints evaluates at once: one
+   * 256-bit register of coordinates, so 4 for double and 8 for float. */
+  itkStaticConstMacro(NumberOfLanes, unsigned int, 32 / sizeof(TScalarType));
+
+  /** The number of 1D B-spline weights per point. */
+  itkStaticConstMacro(NumberOfWeights, unsigned int, NDimensions * (VSplineOrder + 1));
+
+  /** The number of B-spline coefficients per dimension in the support of a point. */
+  itkStaticConstMacro(NumberOfIndices, unsigned int, RecursiveBSplineWeightFunctionType::NumberOfIndices);
+
+  /** The sample cache: per sample the point, its support index, whether the
+   * support lies inside the grid, the 1D weights, and the nonzero Jacobian indices
+   * of the first dimension. Those of dimension j follow by adding j times the
+   * number of parameters per dimension. */
+  struct SampleCacheEntryType
+  {
+    InputPointType m_Point;
+    IndexType      m_SupportIndex;
+    bool           m_IsInside;
+    double         m_Weights[NumberOfWeights];
+    unsigned long  m_NonZeroJacobianIndices[NumberOfIndices];
+  };
+
+  class SampleCacheType : public SampleCacheBase
+  {
+  public:
+    std::vector<SampleCacheEntryType> m_Entries;
+  };
+
+  /** Get the nonzero Jacobian indices of a cached sample that lies inside the grid. */
+  void
+  GetNonZeroJacobianIndicesUsingSampleCache(const SampleCacheEntryType & entry,
+                                            NonZeroJacobianIndicesType & nonZeroJacobianIndices) const
+  {
+    const unsigned long parametersPerDim = this->GetNumberOfParametersPerDimension();
+    nonZeroJacobianIndices.resize(this->GetNumberOfNonZeroJacobianIndices());
+    for (unsigned int j = 0; j < SpaceDimension; ++j)
+    {
+      for (unsigned int i = 0; i < NumberOfIndices; ++i)
+      {
+        nonZeroJacobianIndices[j * NumberOfIndices + i] = entry.m_NonZeroJacobianIndices[i] + j * parametersPerDim;
+      }
+    }
+  }
+
+  /** Get the offset of the support index in the coefficient images. */
+  OffsetValueType
+  GetTotalOffsetToSupportIndex(const IndexType & supportIndex) const
+  {
+    const OffsetValueType * bsplineOffsetTable = this->m_CoefficientImages[0]->GetOffsetTable();
+    OffsetValueType         totalOffsetToSupportIndex = 0;
+    for (unsigned int j = 0; j < SpaceDimension; ++j)
+    {
+      totalOffsetToSupportIndex += supportIndex[j] * bsplineOffsetTable[j];
+    }
+    return totalOffsetToSupportIndex;
+  }
+
   elastix::DefaultConstruct<RecursiveBSplineWeightFunctionType> m_RecursiveBSplineWeightFunction;
 };
 
@@ -90,6 +90,119 @@ RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::TransformPoint(co
 } // end TransformPoint()
 
 
+/**
+ * ********************* TransformPoints ****************************
+ */
+
+template <typename TScalar, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::TransformPoints(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  SizeValueType          numberOfPoints) const
+{
+  /** Check if the coefficient image has been set. */
+  if (!this->m_CoefficientImages[0])
+  {
+    itkWarningMacro(<< "B-spline coefficients have not been set");
+    std::copy_n(inputPoints, numberOfPoints, outputPoints);
+    return;
+  }
+
+  const OffsetValueType * bsplineOffsetTable = this->m_CoefficientImages[0]->GetOffsetTable();
+
+  /** The lane-interleaved input of the implementation: the mu pointers and the
+   * weights of each lane, together with the point and its position in the batch.
+   */
+  const ScalarType * mu[SpaceDimension * NumberOfLanes];
+  double             weights[NumberOfWeights * NumberOfLanes];
+  InputPointType     lanePoints[NumberOfLanes];
+  SizeValueType      laneIndices[NumberOfLanes];
+  unsigned int       numberOfFilledLanes = 0;
+
+  /** Evaluates the filled lanes at once. Unused lanes repeat the first lane. */
+  const auto evaluateLanes = [&] {
+    for (unsigned int lane = numberOfFilledLanes; lane < NumberOfLanes; ++lane)
+    {
+      for (unsigned int j = 0; j < SpaceDimension; ++j)
+      {
+        mu[j * NumberOfLanes + lane] = mu[j * NumberOfLanes];
+      }
+      for (unsigned int i = 0; i < NumberOfWeights; ++i)
+      {
+        weights[i * NumberOfLanes + lane] = weights[i * NumberOfLanes];
+      }
+    }
+
+    ScalarType displacements[SpaceDimension * NumberOfLanes];
+    ImplementationType::template TransformPoints<NumberOfLanes>(displacements, mu, bsplineOffsetTable, weights);
+
+    // The output point is the start point + displacement.
+    for (unsigned int lane = 0; lane < numberOfFilledLanes; ++lane)
+    {
+      OutputPointType & outputPoint = outputPoints[laneIndices[lane]];
+      for (unsigned int j = 0; j < SpaceDimension; ++j)
+      {
+        outputPoint[j] = displacements[j * NumberOfLanes + lane] + lanePoints[lane][j];
+      }
+    }
+    numberOfFilledLanes = 0;
+  };
+
+  for (SizeValueType n = 0; n < numberOfPoints; ++n)
+  {
+    /** Copy the input point, as the input and output arrays may be the same. */
+    const InputPointType point = inputPoints[n];
+
+    /** Convert to continuous index. */
+    const ContinuousIndexType cindex = this->TransformPointToContinuousGridIndex(point);
+
+    // NOTE: if the support region does not lie totally within the grid
+    // we assume zero displacement and return the input point
+    if (!this->InsideValidRegion(cindex))
+    {
+      outputPoints[n] = point;
+      continue;
+    }
+
+    // Compute interpolation weighs and store them in the next lane
+    IndexType         supportIndex;
+    const WeightsType weights1D = this->m_RecursiveBSplineWeightFunction.Evaluate(cindex, supportIndex);
+    for (unsigned int i = 0; i < NumberOfWeights; ++i)
+    {
+      weights[i * NumberOfLanes + numberOfFilledLanes] = weights1D[i];
+    }
+
+    OffsetValueType totalOffsetToSupportIndex = 0;
+    for (unsigned int j = 0; j < SpaceDimension; ++j)
+    {
+      totalOffsetToSupportIndex += supportIndex[j] * bsplineOffsetTable[j];
+    }
+    for (unsigned int j = 0; j < SpaceDimension; ++j)
+    {
+      mu[j * NumberOfLanes + numberOfFilledLanes] =
+        this->m_CoefficientImages[j]->GetBufferPointer() + totalOffsetToSupportIndex;
+    }
+
+    lanePoints[numberOfFilledLanes] = point;
+    laneIndices[numberOfFilledLanes] = n;
+    ++numberOfFilledLanes;
+
+    if (numberOfFilledLanes == NumberOfLanes)
+    {
+      evaluateLanes();
+    }
+  }
+
+  /** The remaining, partially filled group. */
+  if (numberOfFilledLanes > 0)
+  {
+    evaluateLanes();
+  }
+
+} // end TransformPoints()
+
+
 /**
  * ********************* GetJacobian ****************************
  */
@@ -178,6 +291,7 @@ RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::EvaluateJacobianW
     {
       nonZeroJacobianIndices[i] = i;
     }
+    imageJacobian.Fill(0.0);
     return;
   }
 
@@ -211,6 +325,226 @@ RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::EvaluateJacobianW
 } // end EvaluateJacobianWithImageGradientProduct()
 
 
+/**
+ * ********************* EvaluateJacobianWithImageGradientProducts ****************************
+ */
+
+template <class TScalar, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::EvaluateJacobianWithImageGradientProducts(
+  const InputPointType *          inputPoints,
+  const MovingImageGradientType * movingImageGradients,
+  DerivativeType *                imageJacobians,
+  NonZeroJacobianIndicesType *    nonZeroJacobianIndices,
+  SizeValueType                   numberOfPoints) const
+{
+  /** Qualified calls, so without virtual dispatch per point. */
+  for (SizeValueType n = 0; n < numberOfPoints; ++n)
+  {
+    Self::EvaluateJacobianWithImageGradientProduct(
+      inputPoints[n], movingImageGradients[n], imageJacobians[n], nonZeroJacobianIndices[n]);
+  }
+
+} // end EvaluateJacobianWithImageGradientProducts()
+
+
+/**
+ * ********************* CreateSampleCache ****************************
+ */
+
+template <class TScalar, unsigned int NDimensions, unsigned int VSplineOrder>
+auto
+RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::CreateSampleCache(const InputPointType * inputPoints,
+                                                                                 SizeValueType numberOfPoints) const
+  -> SampleCacheConstPointer
+{
+  auto sampleCache = std::make_unique<SampleCacheType>();
+  sampleCache->m_Entries.resize(numberOfPoints);
+  NonZeroJacobianIndicesType nonZeroJacobianIndices;
+
+  for (SizeValueType n = 0; n < numberOfPoints; ++n)
+  {
+    SampleCacheEntryType & entry = sampleCache->m_Entries[n];
+    entry.m_Point = inputPoints[n];
+
+    /** Convert to continuous index, and check if the support region lies inside the grid. */
+    const ContinuousIndexType cindex = this->TransformPointToContinuousGridIndex(entry.m_Point);
+    entry.m_IsInside = this->InsideValidRegion(cindex);
+    if (!entry.m_IsInside)
+    {
+      continue;
+    }
+
+    /** Compute and store the support index and the 1D interpolation weights. */
+    const WeightsType weights1D = this->m_RecursiveBSplineWeightFunction.Evaluate(cindex, entry.m_SupportIndex);
+    std::copy_n(weights1D.data(), NumberOfWeights, entry.m_Weights);
+
+    /** Store the nonzero Jacobian indices of the first dimension. */
+    const RegionType supportRegion(entry.m_SupportIndex, Superclass::m_SupportSize);
+    this->ComputeNonZeroJacobianIndices(nonZeroJacobianIndices, supportRegion);
+    std::copy_n(nonZeroJacobianIndices.data(), NumberOfIndices, entry.m_NonZeroJacobianIndices);
+  }
+
+  return SampleCacheConstPointer(std::move(sampleCache));
+
+} // end CreateSampleCache()
+
+
+/**
+ * ********************* TransformPointUsingSampleCache ****************************
+ */
+
+template <class TScalar, unsigned int NDimensions, unsigned int VSplineOrder>
+auto
+RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::TransformPointUsingSampleCache(
+  const SampleCacheBase & sampleCache,
+  SizeValueType           sampleIndex) const -> OutputPointType
+{
+  const SampleCacheEntryType & entry = static_cast<const SampleCacheType &>(sampleCache).m_Entries[sampleIndex];
+
+  /** Outside the valid region, or without coefficients, the displacement is zero. */
+  OutputPointType outputPoint = entry.m_Point;
+  if (!entry.m_IsInside || !this->m_CoefficientImages[0])
+  {
+    return outputPoint;
+  }
+
+  /** Get handles to the mu's. */
+  const OffsetValueType totalOffsetToSupportIndex = this->GetTotalOffsetToSupportIndex(entry.m_SupportIndex);
+  ScalarType *          mu[SpaceDimension];
+  for (unsigned int j = 0; j < SpaceDimension; ++j)
+  {
+    mu[j] = this->m_CoefficientImages[j]->GetBufferPointer() + totalOffsetToSupportIndex;
+  }
+
+  /** Call the recursive TransformPoint function, with the cached weights. */
+  ScalarType displacement[SpaceDimension];
+  ImplementationType::TransformPoint(
+    displacement, mu, this->m_CoefficientImages[0]->GetOffsetTable(), entry.m_Weights);
+
+  for (unsigned int j = 0; j < SpaceDimension; ++j)
+  {
+    outputPoint[j] += displacement[j];
+  }
+  return outputPoint;
+
+} // end TransformPointUsingSampleCache()
+
+
+/**
+ * ********************* GetJacobianUsingSampleCache ****************************
+ */
+
+template <class TScalar, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::GetJacobianUsingSampleCache(
+  const SampleCacheBase &      sampleCache,
+  SizeValueType                sampleIndex,
+  JacobianType &               jacobian,
+  NonZeroJacobianIndicesType & nonZeroJacobianIndices) const
+{
+  const SampleCacheEntryType & entry = static_cast<const SampleCacheType &>(sampleCache).m_Entries[sampleIndex];
+
+  /** Initialize. */
+  const NumberOfParametersType nnzji = this->GetNumberOfNonZeroJacobianIndices();
+  if ((jacobian.cols() != nnzji) || (jacobian.rows() != SpaceDimension))
+  {
+    jacobian.SetSize(SpaceDimension, nnzji);
+    jacobian.Fill(0.0);
+  }
+
+  /** NOTE: if the support region does not lie totally within the grid
+   * we assume zero displacement and zero Jacobian.
+   */
+  if (!entry.m_IsInside)
+  {
+    nonZeroJacobianIndices.resize(nnzji);
+    for (NumberOfParametersType i = 0; i < nnzji; ++i)
+    {
+      nonZeroJacobianIndices[i] = i;
+    }
+    return;
+  }
+
+  /** Recursively compute the first numberOfIndices entries of the Jacobian, with the cached weights. */
+  ParametersValueType * jacobianPointer = jacobian.data_block();
+  ImplementationType::GetJacobian(jacobianPointer, entry.m_Weights, 1.0);
+
+  /** Get the cached nonzero Jacobian indices. */
+  this->GetNonZeroJacobianIndicesUsingSampleCache(entry, nonZeroJacobianIndices);
+
+} // end GetJacobianUsingSampleCache()
+
+
+/**
+ * ********************* EvaluateJacobianWithImageGradientProductUsingSampleCache ****************************
+ */
+
+template <class TScalar, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::EvaluateJacobianWithImageGradientProductUsingSampleCache(
+  const SampleCacheBase &         sampleCache,
+  SizeValueType                   sampleIndex,
+  const MovingImageGradientType & movingImageGradient,
+  DerivativeType &                imageJacobian,
+  NonZeroJacobianIndicesType &    nonZeroJacobianIndices) const
+{
+  const SampleCacheEntryType & entry = static_cast<const SampleCacheType &>(sampleCache).m_Entries[sampleIndex];
+
+  /** NOTE: if the support region does not lie totally within the grid
+   * we assume zero displacement and zero Jacobian.
+   */
+  if (!entry.m_IsInside)
+  {
+    const NumberOfParametersType nnzji = this->GetNumberOfNonZeroJacobianIndices();
+    nonZeroJacobianIndices.resize(nnzji);
+    for (NumberOfParametersType i = 0; i < nnzji; ++i)
+    {
+      nonZeroJacobianIndices[i] = i;
+    }
+    imageJacobian.Fill(0.0);
+    return;
+  }
+
+  /** Recursively compute the inner product of the Jacobian and the moving image gradient. */
+  double migArray[SpaceDimension];
+  for (unsigned int j = 0; j < SpaceDimension; ++j)
+  {
+    migArray[j] = movingImageGradient[j];
+  }
+  ParametersValueType * imageJacobianPointer = imageJacobian.data_block();
+  ImplementationType::EvaluateJacobianWithImageGradientProduct(imageJacobianPointer, migArray, entry.m_Weights, 1.0);
+
+  /** Get the cached nonzero Jacobian indices. */
+  this->GetNonZeroJacobianIndicesUsingSampleCache(entry, nonZeroJacobianIndices);
+
+} // end EvaluateJacobianWithImageGradientProductUsingSampleCache()
+
+
+/**
+ * ********************* EvaluateJacobianWithImageGradientProductsUsingSampleCache ****************************
+ */
+
+template <class TScalar, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+RecursiveBSplineTransform<TScalar, NDimensions, VSplineOrder>::EvaluateJacobianWithImageGradientProductsUsingSampleCache(
+  const SampleCacheBase &         sampleCache,
+  const SizeValueType *           sampleIndices,
+  const MovingImageGradientType * movingImageGradients,
+  DerivativeType *                imageJacobians,
+  NonZeroJacobianIndicesType *    nonZeroJacobianIndices,
+  SizeValueType                   numberOfSamples) const
+{
+  /** Qualified calls, so without virtual dispatch per sample. */
+  for (SizeValueType n = 0; n < numberOfSamples; ++n)
+  {
+    Self::EvaluateJacobianWithImageGradientProductUsingSampleCache(
+      sampleCache, sampleIndices[n], movingImageGradients[n], imageJacobians[n], nonZeroJacobianIndices[n]);
+  }
+
+} // end EvaluateJacobianWithImageGradientProductsUsingSampleCache()
+
+
 /**
  * ********************* GetSpatialJacobian ****************************
  */
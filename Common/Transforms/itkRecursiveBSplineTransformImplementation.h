@@ -90,6 +90,52 @@ public:
   } // end TransformPoint()
 
 
+  /** TransformPoints recursive implementation, for VNumberOfLanes points at once.
+   * All arrays are interleaved over the lanes: opp[ j * VNumberOfLanes + lane ],
+   * mu[ j * VNumberOfLanes + lane ] and weights1D[ i * VNumberOfLanes + lane ],
+   * so that the innermost loops run over the lanes, and can be vectorized.
+   */
+  template <unsigned int VNumberOfLanes>
+  static void
+  TransformPoints(TScalar * const               opp,
+                  const TScalar * const * const mu,
+                  const OffsetValueType * const gridOffsetTable,
+                  const double * const          weights1D)
+  {
+    /** Make a copy of the pointers to mu. The pointer will move later. */
+    const TScalar * tmp_mu[OutputDimension * VNumberOfLanes];
+    std::copy_n(mu, OutputDimension * VNumberOfLanes, tmp_mu);
+
+    /** Create a temporary opp and initialize the original. */
+    TScalar tmp_opp[OutputDimension * VNumberOfLanes];
+    std::fill_n(opp, OutputDimension * VNumberOfLanes, 0.0);
+
+    const OffsetValueType bot = gridOffsetTable[SpaceDimension - 1];
+    for (unsigned int k = 0; k <= SplineOrder; ++k)
+    {
+      /** Recurse. */
+      RecursiveBSplineTransformImplementation<OutputDimension, SpaceDimension - 1, SplineOrder, TScalar>::
+        template TransformPoints<VNumberOfLanes>(tmp_opp, tmp_mu, gridOffsetTable, weights1D);
+
+      /** Accumulate the weights. */
+      const double * const weights = weights1D + (k + HelperConstVariable) * VNumberOfLanes;
+      for (unsigned int j = 0; j < OutputDimension; ++j)
+      {
+        for (unsigned int lane = 0; lane < VNumberOfLanes; ++lane)
+        {
+          opp[j * VNumberOfLanes + lane] += tmp_opp[j * VNumberOfLanes + lane] * weights[lane];
+        }
+      }
+
+      // move to the next mu
+      for (unsigned int n = 0; n < OutputDimension * VNumberOfLanes; ++n)
+      {
+        tmp_mu[n] += bot;
+      }
+    }
+  } // end TransformPoints()
+
+
   /** GetJacobian recursive implementation. */
   static void
   GetJacobian(TScalar *& jacobians, const double * const weights1D, const double value)
@@ -378,6 +424,21 @@ public:
   } // end TransformPoint()
 
 
+  /** TransformPoints recursive implementation. */
+  template <unsigned int VNumberOfLanes>
+  static void
+  TransformPoints(TScalar * const               opp,
+                  const TScalar * const * const mu,
+                  const OffsetValueType * const gridOffsetTable,
+                  const double * const          weights1D)
+  {
+    for (unsigned int n = 0; n < OutputDimension * VNumberOfLanes; ++n)
+    {
+      opp[n] = *(mu[n]);
+    }
+  } // end TransformPoints()
+
+
   /** GetJacobian recursive implementation. */
   static void
   GetJacobian(TScalar *& jacobians, const double * const weights1D, const double value)
@@ -0,0 +1,170 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTransformToDisplacementFieldSource_h
+#define itkTransformToDisplacementFieldSource_h
+
+#include "itkAdvancedTransform.h"
+#include "itkImageSource.h"
+
+namespace itk
+{
+
+/** \class TransformToDisplacementFieldSource
+ * \brief Generate the displacement field T(x) - x of a coordinate transform
+ *
+ * The output image should have a vector pixel type, e.g. itk::Vector<float, ImageDimension>.
+ * Output information (size, start index, spacing, origin and direction) should be set, like
+ * for the TransformToSpatialJacobianSource.
+ *
+ * The field is generated row by row, i.e. per line of voxels along the first image axis, by
+ * AdvancedTransform::TransformPointsAlongLine(). B-spline transforms, also inside an
+ * AdvancedCombinationTransform, evaluate such a row in one sweep: for a row that is aligned
+ * with a B-spline grid axis, the weights of the other axes are computed once, instead of the
+ * full tensor product per voxel. When UseScanlineEvaluation is false, TransformPoint() is
+ * called per voxel instead.
+ *
+ * The rows are distributed over the threads of the WorkStealingThreadPool.
+ *
+ * \ingroup GeometricTransforms
+ */
+
+template <class TOutputImage, class TTransformPrecisionType = double>
+class ITK_TEMPLATE_EXPORT TransformToDisplacementFieldSource : public ImageSource<TOutputImage>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(TransformToDisplacementFieldSource);
+
+  /** Standard class typedefs. */
+  using Self = TransformToDisplacementFieldSource;
+  using Superclass = ImageSource<TOutputImage>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  using OutputImageType = TOutputImage;
+  using OutputImagePointer = typename OutputImageType::Pointer;
+  using OutputImageRegionType = typename OutputImageType::RegionType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(TransformToDisplacementFieldSource, ImageSource);
+
+  /** Number of dimensions. */
+  itkStaticConstMacro(ImageDimension, unsigned int, TOutputImage::ImageDimension);
+
+  /** Typedefs for transform. */
+  using TransformType = AdvancedTransform<TTransformPrecisionType, Self::ImageDimension, Self::ImageDimension>;
+  using TransformPointerType = typename TransformType::ConstPointer;
+  using InputPointType = typename TransformType::InputPointType;
+  using InputVectorType = typename TransformType::InputVectorType;
+  using OutputPointType = typename TransformType::OutputPointType;
+
+  /** Typedefs for output image. */
+  using PixelType = typename OutputImageType::PixelType;
+  using RegionType = typename OutputImageType::RegionType;
+  using SizeType = typename RegionType::SizeType;
+  using IndexType = typename OutputImageType::IndexType;
+  using PointType = typename OutputImageType::PointType;
+  using SpacingType = typename OutputImageType::SpacingType;
+  using OriginType = typename OutputImageType::PointType;
+  using DirectionType = typename OutputImageType::DirectionType;
+
+  /** Typedefs for base image. */
+  using ImageBaseType = ImageBase<Self::ImageDimension>;
+
+  /** Set the coordinate transformation: the output-to-input transform. */
+  itkSetConstObjectMacro(Transform, TransformType);
+
+  /** Get a pointer to the coordinate transform. */
+  itkGetConstObjectMacro(Transform, TransformType);
+
+  /** Set/Get the size of the output image. */
+  virtual void
+  SetOutputSize(const SizeType & size);
+
+  virtual const SizeType &
+  GetOutputSize();
+
+  /** Set/Get the start index of the output largest possible region. The default is an index of all zeros. */
+  virtual void
+  SetOutputIndex(const IndexType & index);
+
+  virtual const IndexType &
+  GetOutputIndex();
+
+  /** Set/Get the region of the output image. */
+  itkSetMacro(OutputRegion, OutputImageRegionType);
+  itkGetConstReferenceMacro(OutputRegion, OutputImageRegionType);
+
+  /** Set/Get the output image spacing. */
+  itkSetMacro(OutputSpacing, SpacingType);
+  itkGetConstReferenceMacro(OutputSpacing, SpacingType);
+
+  /** Set/Get the output image origin. */
+  itkSetMacro(OutputOrigin, OriginType);
+  itkGetConstReferenceMacro(OutputOrigin, OriginType);
+
+  /** Set/Get the output direction cosine matrix. */
+  itkSetMacro(OutputDirection, DirectionType);
+  itkGetConstReferenceMacro(OutputDirection, DirectionType);
+
+  /** Helper method to set the output parameters based on this image. */
+  void
+  SetOutputParametersFromImage(const ImageBaseType * image);
+
+  /** Whether the transform is evaluated per row, by TransformPointsAlongLine(). Default: true. */
+  itkSetMacro(UseScanlineEvaluation, bool);
+  itkGetConstMacro(UseScanlineEvaluation, bool);
+  itkBooleanMacro(UseScanlineEvaluation);
+
+  /** Set the output information. */
+  void
+  GenerateOutputInformation() override;
+
+  /** Compute the Modified Time based on changes to the components. */
+  ModifiedTimeType
+  GetMTime() const override;
+
+protected:
+  TransformToDisplacementFieldSource() = default;
+  ~TransformToDisplacementFieldSource() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** Generate the field, row by row, in parallel. */
+  void
+  GenerateData() override;
+
+private:
+  OutputImageRegionType m_OutputRegion{};
+  SpacingType           m_OutputSpacing{ 1.0 };
+  OriginType            m_OutputOrigin{};
+  DirectionType         m_OutputDirection{ DirectionType::GetIdentity() };
+  TransformPointerType  m_Transform{};
+  bool                  m_UseScanlineEvaluation{ true };
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkTransformToDisplacementFieldSource.hxx"
+#endif
+
+#endif // end #ifndef itkTransformToDisplacementFieldSource_h
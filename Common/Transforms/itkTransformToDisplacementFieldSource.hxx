@@ -0,0 +1,270 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTransformToDisplacementFieldSource_hxx
+#define itkTransformToDisplacementFieldSource_hxx
+
+#include "itkTransformToDisplacementFieldSource.h"
+
+#include "itkAdvancedCombinationTransform.h"
+#include "itkWorkStealingThreadPool.h"
+#include <algorithm> // For max.
+#include <atomic>
+#include <vector>
+
+namespace itk
+{
+
+/**
+ * ********************* PrintSelf ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::PrintSelf(std::ostream & os,
+                                                                                     Indent         indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "OutputRegion: " << this->m_OutputRegion << std::endl;
+  os << indent << "OutputSpacing: " << this->m_OutputSpacing << std::endl;
+  os << indent << "OutputOrigin: " << this->m_OutputOrigin << std::endl;
+  os << indent << "OutputDirection: " << this->m_OutputDirection << std::endl;
+  os << indent << "Transform: " << this->m_Transform.GetPointer() << std::endl;
+  os << indent << "UseScanlineEvaluation: " << this->m_UseScanlineEvaluation << std::endl;
+
+} // end PrintSelf()
+
+
+/**
+ * ********************* SetOutputSize ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::SetOutputSize(const SizeType & size)
+{
+  this->m_OutputRegion.SetSize(size);
+  this->Modified();
+
+} // end SetOutputSize()
+
+
+/**
+ * ********************* GetOutputSize ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+auto
+TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::GetOutputSize() -> const SizeType &
+{
+  return this->m_OutputRegion.GetSize();
+
+} // end GetOutputSize()
+
+
+/**
+ * ********************* SetOutputIndex ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::SetOutputIndex(const IndexType & index)
+{
+  this->m_OutputRegion.SetIndex(index);
+  this->Modified();
+
+} // end SetOutputIndex()
+
+
+/**
+ * ********************* GetOutputIndex ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+auto
+TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::GetOutputIndex() -> const IndexType &
+{
+  return this->m_OutputRegion.GetIndex();
+
+} // end GetOutputIndex()
+
+
+/**
+ * ********************* SetOutputParametersFromImage ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::SetOutputParametersFromImage(
+  const ImageBaseType * image)
+{
+  if (!image)
+  {
+    itkExceptionMacro(<< "Cannot use a null image reference");
+  }
+
+  this->SetOutputOrigin(image->GetOrigin());
+  this->SetOutputSpacing(image->GetSpacing());
+  this->SetOutputDirection(image->GetDirection());
+  this->SetOutputRegion(image->GetLargestPossibleRegion());
+
+} // end SetOutputParametersFromImage()
+
+
+/**
+ * ********************* GenerateOutputInformation ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+
+  OutputImageType * outputPtr = this->GetOutput();
+  if (!outputPtr)
+  {
+    return;
+  }
+
+  outputPtr->SetLargestPossibleRegion(this->m_OutputRegion);
+  outputPtr->SetSpacing(this->m_OutputSpacing);
+  outputPtr->SetOrigin(this->m_OutputOrigin);
+  outputPtr->SetDirection(this->m_OutputDirection);
+
+} // end GenerateOutputInformation()
+
+
+/**
+ * ********************* GenerateData ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+void
+TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::GenerateData()
+{
+  if (!this->m_Transform)
+  {
+    itkExceptionMacro(<< "Transform not set");
+  }
+
+  this->AllocateOutputs();
+  OutputImageType * const     outputPtr = this->GetOutput();
+  const OutputImageRegionType region = outputPtr->GetRequestedRegion();
+  const SizeType              size = region.GetSize();
+  const SizeValueType         rowLength = size[0];
+  if (rowLength == 0)
+  {
+    return;
+  }
+  const SizeValueType numberOfRows = region.GetNumberOfPixels() / rowLength;
+
+  /** All rows run along the first image axis. */
+  const DirectionType & direction = outputPtr->GetDirection();
+  const SpacingType &   spacing = outputPtr->GetSpacing();
+  InputVectorType       step;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    step[i] = direction[i][0] * spacing[0];
+  }
+
+  PixelType * const buffer = outputPtr->GetBufferPointer();
+
+  std::atomic<SizeValueType> numberOfFinishedRows(0);
+  const auto                 threadPool = WorkStealingThreadPool::GetInstance();
+  threadPool->ParallelFor(
+    0,
+    numberOfRows,
+    16,
+    threadPool->GetNumberOfThreads(),
+    [&](const SizeValueType rowBegin, const SizeValueType rowEnd, const ThreadIdType threadId) {
+      std::vector<OutputPointType> mappedPoints(rowLength);
+      for (SizeValueType row = rowBegin; row < rowEnd; ++row)
+      {
+        /** The index of the first voxel of the row. */
+        IndexType     index = region.GetIndex();
+        SizeValueType remainder = row;
+        for (unsigned int i = 1; i < ImageDimension; ++i)
+        {
+          index[i] += static_cast<typename IndexType::IndexValueType>(remainder % size[i]);
+          remainder /= size[i];
+        }
+
+        PointType point;
+        outputPtr->TransformIndexToPhysicalPoint(index, point);
+        InputPointType firstPoint;
+        firstPoint.CastFrom(point);
+
+        if (this->m_UseScanlineEvaluation)
+        {
+          this->m_Transform->TransformPointsAlongLine(firstPoint, step, rowLength, mappedPoints.data());
+        }
+        else
+        {
+          for (SizeValueType k = 0; k < rowLength; ++k)
+          {
+            mappedPoints[k] = this->m_Transform->TransformPoint(firstPoint + step * static_cast<double>(k));
+          }
+        }
+
+        /** Store the displacements T(x) - x. */
+        PixelType * const pixels = buffer + outputPtr->ComputeOffset(index);
+        for (SizeValueType k = 0; k < rowLength; ++k)
+        {
+          const InputPointType inputPoint = firstPoint + step * static_cast<double>(k);
+          for (unsigned int d = 0; d < ImageDimension; ++d)
+          {
+            pixels[k][d] = static_cast<typename PixelType::ValueType>(mappedPoints[k][d] - inputPoint[d]);
+          }
+        }
+      }
+
+      /** Only the calling thread, which is worker 0, reports progress. */
+      numberOfFinishedRows += rowEnd - rowBegin;
+      if (threadId == 0)
+      {
+        this->UpdateProgress(static_cast<float>(numberOfFinishedRows) / static_cast<float>(numberOfRows));
+      }
+    });
+
+} // end GenerateData()
+
+
+/**
+ * ********************* GetMTime ****************************
+ */
+
+template <class TOutputImage, class TTransformPrecisionType>
+ModifiedTimeType
+TransformToDisplacementFieldSource<TOutputImage, TTransformPrecisionType>::GetMTime() const
+{
+  ModifiedTimeType latestTime = Object::GetMTime();
+
+  if (this->m_Transform)
+  {
+    latestTime = std::max(latestTime, this->m_Transform->GetMTime());
+  }
+
+  return latestTime;
+
+} // end GetMTime()
+
+
+} // end namespace itk
+
+#endif // end #ifndef itkTransformToDisplacementFieldSource_hxx
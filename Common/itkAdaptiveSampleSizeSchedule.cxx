@@ -0,0 +1,125 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkAdaptiveSampleSizeSchedule.h"
+
+#include <vnl/vnl_math.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace itk
+{
+
+/**
+ * ********************* Initialize *****************************
+ */
+
+void
+AdaptiveSampleSizeSchedule::Initialize(const SizeValueType numberOfSamples)
+{
+  this->m_NumberOfSamples = numberOfSamples;
+  this->m_TotalNumberOfSamples = 0;
+  this->m_NumberOfEstimates = 0;
+  this->m_SampleVarianceEstimate = 0.0;
+  this->m_SquaredGradientMagnitudeEstimate = 0.0;
+  this->m_PreviousGradient.SetSize(0);
+
+} // end Initialize()
+
+
+/**
+ * ********************* Update *****************************
+ */
+
+bool
+AdaptiveSampleSizeSchedule::Update(const DerivativeType & gradient)
+{
+  this->m_TotalNumberOfSamples += this->m_NumberOfSamples;
+
+  /** Estimate V and |G|^2 from the inner products of this and the previous gradient. */
+  if (this->m_PreviousGradient.GetSize() == gradient.GetSize() && gradient.GetSize() > 0)
+  {
+    const double innerProduct = inner_product(gradient, this->m_PreviousGradient);
+    const double sampleVariance = this->m_NumberOfSamples * (gradient.squared_magnitude() - innerProduct);
+
+    const double weight = (this->m_NumberOfEstimates == 0) ? 0.0 : this->m_SmoothingFactor;
+    this->m_SampleVarianceEstimate = weight * this->m_SampleVarianceEstimate + (1.0 - weight) * sampleVariance;
+    this->m_SquaredGradientMagnitudeEstimate =
+      weight * this->m_SquaredGradientMagnitudeEstimate + (1.0 - weight) * innerProduct;
+    ++this->m_NumberOfEstimates;
+  }
+  this->m_PreviousGradient = gradient;
+
+  /** Compute the number of samples for which the noise has the desired magnitude.
+   * If the exact gradient seems to vanish, the noise dominates, and more samples are needed. */
+  double numberOfSamples = static_cast<double>(this->m_NumberOfSamples);
+  if (this->m_NumberOfEstimates > 0)
+  {
+    const double signal = vnl_math::sqr(this->m_NoiseToSignalRatio) * this->m_SquaredGradientMagnitudeEstimate;
+    const double desiredNumberOfSamples = (signal > 0.0) ? std::max(0.0, this->m_SampleVarianceEstimate) / signal
+                                                         : std::numeric_limits<double>::max();
+    numberOfSamples = std::min(std::max(desiredNumberOfSamples, numberOfSamples / this->m_MaximumGrowthFactor),
+                               numberOfSamples * this->m_MaximumGrowthFactor);
+  }
+  numberOfSamples = std::min(std::max(numberOfSamples, static_cast<double>(this->m_MinimumNumberOfSamples)),
+                             static_cast<double>(this->m_MaximumNumberOfSamples));
+
+  /** Stay within the budget. */
+  if (this->m_MaximumTotalNumberOfSamples > 0)
+  {
+    const SizeValueType remaining = (this->m_TotalNumberOfSamples < this->m_MaximumTotalNumberOfSamples)
+                                      ? this->m_MaximumTotalNumberOfSamples - this->m_TotalNumberOfSamples
+                                      : 0;
+    if (remaining == 0 || remaining < this->m_MinimumNumberOfSamples)
+    {
+      return false;
+    }
+    numberOfSamples = std::min(numberOfSamples, static_cast<double>(remaining));
+  }
+
+  this->m_NumberOfSamples = std::max<SizeValueType>(1, static_cast<SizeValueType>(std::round(numberOfSamples)));
+  return true;
+
+} // end Update()
+
+
+/**
+ * ********************* PrintSelf *****************************
+ */
+
+void
+AdaptiveSampleSizeSchedule::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "MinimumNumberOfSamples: " << this->m_MinimumNumberOfSamples << std::endl;
+  os << indent << "MaximumNumberOfSamples: " << this->m_MaximumNumberOfSamples << std::endl;
+  os << indent << "MaximumTotalNumberOfSamples: " << this->m_MaximumTotalNumberOfSamples << std::endl;
+  os << indent << "NoiseToSignalRatio: " << this->m_NoiseToSignalRatio << std::endl;
+  os << indent << "MaximumGrowthFactor: " << this->m_MaximumGrowthFactor << std::endl;
+  os << indent << "SmoothingFactor: " << this->m_SmoothingFactor << std::endl;
+  os << indent << "NumberOfSamples: " << this->m_NumberOfSamples << std::endl;
+  os << indent << "TotalNumberOfSamples: " << this->m_TotalNumberOfSamples << std::endl;
+  os << indent << "SampleVarianceEstimate: " << this->m_SampleVarianceEstimate << std::endl;
+  os << indent << "SquaredGradientMagnitudeEstimate: " << this->m_SquaredGradientMagnitudeEstimate << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
@@ -0,0 +1,147 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkAdaptiveSampleSizeSchedule_h
+#define itkAdaptiveSampleSizeSchedule_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkArray.h"
+
+namespace itk
+{
+
+/** \class AdaptiveSampleSizeSchedule
+ *
+ * \brief Adapts the number of image samples of a stochastic optimizer to the noise in its gradients.
+ *
+ * A stochastic optimizer that selects new samples every iteration gets gradients
+ * g_k, which are unbiased, but noisy, estimates of the exact gradient. With N_k
+ * samples, E[ |g_k|^2 ] = |G|^2 + V / N_k, with G the exact gradient and V the
+ * variance of the contribution of a single sample. Since the samples of two
+ * iterations are independent, and the exact gradient changes slowly,
+ * E[ g_k . g_(k-1) ] is approximately |G|^2. From these inner products, V and
+ * |G|^2 are estimated, smoothed over the iterations by exponential moving averages.
+ *
+ * The number of samples for the next iteration is chosen such that the variance
+ * of the gradient is NoiseToSignalRatio^2 times the squared magnitude of the exact
+ * gradient: N = V / ( NoiseToSignalRatio^2 |G|^2 ). Far from the optimum, where the
+ * exact gradient is large, few samples are needed; near the optimum, the number of
+ * samples increases. The number of samples changes by at most a factor
+ * MaximumGrowthFactor per iteration, and stays within [ MinimumNumberOfSamples,
+ * MaximumNumberOfSamples ]. When a MaximumTotalNumberOfSamples is given, the total
+ * number of samples of all iterations stays within this budget.
+ *
+ * Usage: call Initialize() with the number of samples of the first iteration, and
+ * after each iteration call Update() with its gradient. If it returns false, the
+ * budget is exhausted, otherwise GetNumberOfSamples() returns the number of samples
+ * for the next iteration.
+ *
+ * \ingroup Optimizers
+ */
+
+class AdaptiveSampleSizeSchedule : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(AdaptiveSampleSizeSchedule);
+
+  /** Standard ITK.*/
+  using Self = AdaptiveSampleSizeSchedule;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(AdaptiveSampleSizeSchedule, Object);
+
+  using DerivativeType = Array<double>;
+
+  /** Set/Get the range of the number of samples per iteration. Defaults: 1000 and 100000. */
+  itkSetMacro(MinimumNumberOfSamples, SizeValueType);
+  itkGetConstMacro(MinimumNumberOfSamples, SizeValueType);
+  itkSetMacro(MaximumNumberOfSamples, SizeValueType);
+  itkGetConstMacro(MaximumNumberOfSamples, SizeValueType);
+
+  /** Set/Get the budget: the maximum total number of samples of all iterations.
+   * Zero means no budget. Default: 0. */
+  itkSetMacro(MaximumTotalNumberOfSamples, SizeValueType);
+  itkGetConstMacro(MaximumTotalNumberOfSamples, SizeValueType);
+
+  /** Set/Get the desired ratio of the standard deviation of the gradient noise, and the
+   * magnitude of the exact gradient. Larger values give fewer samples. Default: 1.0. */
+  itkSetMacro(NoiseToSignalRatio, double);
+  itkGetConstMacro(NoiseToSignalRatio, double);
+
+  /** Set/Get the maximum factor by which the number of samples changes per iteration. Default: 2.0. */
+  itkSetMacro(MaximumGrowthFactor, double);
+  itkGetConstMacro(MaximumGrowthFactor, double);
+
+  /** Set/Get the weight of the previous estimates, in the exponential moving averages. Default: 0.8. */
+  itkSetClampMacro(SmoothingFactor, double, 0.0, 1.0);
+  itkGetConstMacro(SmoothingFactor, double);
+
+  /** Start a new schedule, of which the first iteration uses numberOfSamples samples. */
+  void
+  Initialize(SizeValueType numberOfSamples);
+
+  /** Account for an iteration with GetNumberOfSamples() samples, that resulted in
+   * the given gradient, and compute the number of samples for the next iteration.
+   * Returns false when the budget does not allow another iteration. */
+  bool
+  Update(const DerivativeType & gradient);
+
+  /** Get the number of samples for the next iteration. */
+  itkGetConstMacro(NumberOfSamples, SizeValueType);
+
+  /** Get the total number of samples used so far. */
+  itkGetConstMacro(TotalNumberOfSamples, SizeValueType);
+
+  /** Get the current estimates of the variance of a single sample, and of the
+   * squared magnitude of the exact gradient. */
+  itkGetConstMacro(SampleVarianceEstimate, double);
+  itkGetConstMacro(SquaredGradientMagnitudeEstimate, double);
+
+protected:
+  AdaptiveSampleSizeSchedule() = default;
+  ~AdaptiveSampleSizeSchedule() override = default;
+
+  /** PrintSelf. */
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  SizeValueType m_MinimumNumberOfSamples{ 1000 };
+  SizeValueType m_MaximumNumberOfSamples{ 100000 };
+  SizeValueType m_MaximumTotalNumberOfSamples{ 0 };
+  double        m_NoiseToSignalRatio{ 1.0 };
+  double        m_MaximumGrowthFactor{ 2.0 };
+  double        m_SmoothingFactor{ 0.8 };
+
+  SizeValueType  m_NumberOfSamples{ 0 };
+  SizeValueType  m_TotalNumberOfSamples{ 0 };
+  SizeValueType  m_NumberOfEstimates{ 0 };
+  double         m_SampleVarianceEstimate{ 0.0 };
+  double         m_SquaredGradientMagnitudeEstimate{ 0.0 };
+  DerivativeType m_PreviousGradient;
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkAdaptiveSampleSizeSchedule_h
@@ -0,0 +1,111 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkAdvancedBSplineInterpolateImageFunction_h
+#define itkAdvancedBSplineInterpolateImageFunction_h
+
+#include "itkBSplineInterpolateImageFunction.h"
+
+namespace itk
+{
+/** \class AdvancedBSplineInterpolateImageFunction
+ * \brief B-spline interpolation of an image, with a batched evaluation of values and derivatives.
+ *
+ * This class extends the BSplineInterpolateImageFunction with
+ * EvaluateValuesAndDerivativesAtContinuousIndices, which evaluates a batch of
+ * continuous indices at once. For third order B-splines, the interpolation weights and
+ * the (mirrored) coefficient offsets of a group of indices are computed first, after
+ * which the coefficients are gathered directly from the coefficient buffer, and the
+ * value and the derivative are accumulated in a single pass over the support region.
+ * Other spline orders are evaluated point by point, by the superclass.
+ *
+ * \sa AdvancedLinearInterpolateImageFunction
+ *
+ * \ingroup ImageFunctions ImageInterpolators
+ */
+template <class TImageType, class TCoordRep = double, class TCoefficientType = double>
+class ITK_TEMPLATE_EXPORT AdvancedBSplineInterpolateImageFunction
+  : public BSplineInterpolateImageFunction<TImageType, TCoordRep, TCoefficientType>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(AdvancedBSplineInterpolateImageFunction);
+
+  /** Standard class typedefs. */
+  using Self = AdvancedBSplineInterpolateImageFunction;
+  using Superclass = BSplineInterpolateImageFunction<TImageType, TCoordRep, TCoefficientType>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(AdvancedBSplineInterpolateImageFunction, BSplineInterpolateImageFunction);
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Dimension underlying input image. */
+  itkStaticConstMacro(ImageDimension, unsigned int, Superclass::ImageDimension);
+
+  /** Typedefs inherited from the superclass. */
+  using typename Superclass::OutputType;
+  using typename Superclass::InputImageType;
+  using typename Superclass::IndexType;
+  using typename Superclass::ContinuousIndexType;
+  using typename Superclass::CoefficientDataType;
+  using typename Superclass::CoefficientImageType;
+  using typename Superclass::CovariantVectorType;
+
+  /** Method to compute both the values and the derivatives at a batch of
+   * continuous indices, which should all be inside the buffer. If deriv is
+   * a nullptr, only the values are computed. The results are equal to those of
+   * EvaluateValueAndDerivativeAtContinuousIndex, up to round-off. The threadId
+   * selects the work arrays of the superclass, for the spline orders that are
+   * evaluated point by point.
+   */
+  void
+  EvaluateValuesAndDerivativesAtContinuousIndices(const ContinuousIndexType * x,
+                                                  OutputType *                value,
+                                                  CovariantVectorType *       deriv,
+                                                  SizeValueType               numberOfIndices,
+                                                  ThreadIdType                threadId) const;
+
+protected:
+  AdvancedBSplineInterpolateImageFunction() = default;
+  ~AdvancedBSplineInterpolateImageFunction() override = default;
+
+private:
+  /** The number of indices that are processed together by EvaluateValuesAndDerivativesAtContinuousIndices. */
+  itkStaticConstMacro(BatchGroupSize, unsigned int, 64);
+
+  /** The spline order of the batched kernel, and the corresponding support size. */
+  itkStaticConstMacro(BatchedSplineOrder, unsigned int, 3);
+  itkStaticConstMacro(BatchedSupportSize, unsigned int, BatchedSplineOrder + 1);
+
+  /** The batched kernel for third order B-splines. */
+  void
+  EvaluateCubicValuesAndDerivatives(const ContinuousIndexType * x,
+                                    OutputType *                value,
+                                    CovariantVectorType *       deriv,
+                                    SizeValueType               numberOfIndices) const;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkAdvancedBSplineInterpolateImageFunction.hxx"
+#endif
+
+#endif
@@ -0,0 +1,225 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkAdvancedBSplineInterpolateImageFunction_hxx
+#define itkAdvancedBSplineInterpolateImageFunction_hxx
+
+#include "itkAdvancedBSplineInterpolateImageFunction.h"
+
+#include <algorithm> // For min.
+#include <cstdlib>   // For abs.
+
+namespace itk
+{
+
+/**
+ * ***************** EvaluateValuesAndDerivativesAtContinuousIndices ***********************
+ */
+
+template <class TImageType, class TCoordRep, class TCoefficientType>
+void
+AdvancedBSplineInterpolateImageFunction<TImageType, TCoordRep, TCoefficientType>::
+  EvaluateValuesAndDerivativesAtContinuousIndices(const ContinuousIndexType * x,
+                                                  OutputType *                value,
+                                                  CovariantVectorType *       deriv,
+                                                  SizeValueType               numberOfIndices,
+                                                  ThreadIdType                threadId) const
+{
+  if (this->GetSplineOrder() == BatchedSplineOrder)
+  {
+    this->EvaluateCubicValuesAndDerivatives(x, value, deriv, numberOfIndices);
+    return;
+  }
+
+  /** Other spline orders are evaluated point by point, using the work arrays of the thread. */
+  for (SizeValueType i = 0; i < numberOfIndices; ++i)
+  {
+    if (deriv)
+    {
+      this->Superclass::EvaluateValueAndDerivativeAtContinuousIndex(x[i], value[i], deriv[i], threadId);
+    }
+    else
+    {
+      value[i] = this->Superclass::EvaluateAtContinuousIndex(x[i], threadId);
+    }
+  }
+
+} // end EvaluateValuesAndDerivativesAtContinuousIndices()
+
+
+/**
+ * ***************** EvaluateCubicValuesAndDerivatives ***********************
+ */
+
+template <class TImageType, class TCoordRep, class TCoefficientType>
+void
+AdvancedBSplineInterpolateImageFunction<TImageType, TCoordRep, TCoefficientType>::EvaluateCubicValuesAndDerivatives(
+  const ContinuousIndexType * x,
+  OutputType *                value,
+  CovariantVectorType *       deriv,
+  SizeValueType               numberOfIndices) const
+{
+  // Get some handles
+  const InputImageType *                       inputImage = this->GetInputImage();
+  const typename InputImageType::SpacingType & spacing = inputImage->GetSpacing();
+  const CoefficientImageType *                 coefficients = this->m_Coefficients.GetPointer();
+  const CoefficientDataType * const            buffer = coefficients->GetBufferPointer();
+  const OffsetValueType * const                offsetTable = coefficients->GetOffsetTable();
+  const IndexType                              bufferedRegionIndex = coefficients->GetBufferedRegion().GetIndex();
+
+  /** The number of rows of the support region, along the first dimension. */
+  unsigned int numberOfRows = 1;
+  for (unsigned int dim = 1; dim < ImageDimension; ++dim)
+  {
+    numberOfRows *= BatchedSupportSize;
+  }
+
+  double          weights[BatchGroupSize][ImageDimension][BatchedSupportSize];
+  double          derivativeWeights[BatchGroupSize][ImageDimension][BatchedSupportSize];
+  OffsetValueType offsets[BatchGroupSize][ImageDimension][BatchedSupportSize];
+
+  for (SizeValueType groupBegin = 0; groupBegin < numberOfIndices; groupBegin += BatchGroupSize)
+  {
+    const SizeValueType groupSize = std::min(static_cast<SizeValueType>(BatchGroupSize), numberOfIndices - groupBegin);
+
+    /** First pass: compute the interpolation weights and the mirrored coefficient offsets, for all indices of the
+     * group. The support region starts one index below the floor of x, as in DetermineRegionOfSupport(). */
+    for (SizeValueType i = 0; i < groupSize; ++i)
+    {
+      const ContinuousIndexType & xi = x[groupBegin + i];
+      for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+      {
+        const IndexValueType floorIndex = Math::Floor<IndexValueType>(xi[dim]);
+        const double         t = xi[dim] - static_cast<double>(floorIndex);
+        const double         t2 = t * t;
+        const double         t3 = t2 * t;
+        const double         s = 1.0 - t;
+
+        weights[i][dim][0] = s * s * s / 6.0;
+        weights[i][dim][1] = (3.0 * t3 - 6.0 * t2 + 4.0) / 6.0;
+        weights[i][dim][2] = (-3.0 * t3 + 3.0 * t2 + 3.0 * t + 1.0) / 6.0;
+        weights[i][dim][3] = t3 / 6.0;
+
+        /** The derivative weights, scaled to physical units. */
+        const double inverseSpacing = 1.0 / spacing[dim];
+        derivativeWeights[i][dim][0] = -0.5 * s * s * inverseSpacing;
+        derivativeWeights[i][dim][1] = (1.5 * t2 - 2.0 * t) * inverseSpacing;
+        derivativeWeights[i][dim][2] = (-1.5 * t2 + t + 0.5) * inverseSpacing;
+        derivativeWeights[i][dim][3] = 0.5 * t2 * inverseSpacing;
+
+        /** Apply the mirror boundary conditions, as in ApplyMirrorBoundaryConditions(). */
+        const IndexValueType dataLength = static_cast<IndexValueType>(this->m_DataLength[dim]);
+        const IndexValueType period = 2 * dataLength - 2;
+        for (unsigned int k = 0; k < BatchedSupportSize; ++k)
+        {
+          IndexValueType relativeIndex = floorIndex - 1 + static_cast<IndexValueType>(k) - bufferedRegionIndex[dim];
+          if (dataLength == 1)
+          {
+            relativeIndex = 0;
+          }
+          else
+          {
+            relativeIndex = std::abs(relativeIndex) % period;
+            if (relativeIndex >= dataLength)
+            {
+              relativeIndex = period - relativeIndex;
+            }
+          }
+          offsets[i][dim][k] = relativeIndex * offsetTable[dim];
+        }
+      }
+    }
+
+    /** Second pass: gather the coefficients row by row along the first dimension, and accumulate
+     * the value and the derivative. */
+    for (SizeValueType i = 0; i < groupSize; ++i)
+    {
+      double valueSum = 0.0;
+      double derivativeSum[ImageDimension] = {};
+
+      for (unsigned int row = 0; row < numberOfRows; ++row)
+      {
+        /** Decompose the row number into the support indices of the other dimensions. */
+        unsigned int    k[ImageDimension];
+        OffsetValueType rowOffset = 0;
+        unsigned int    rest = row;
+        for (unsigned int dim = 1; dim < ImageDimension; ++dim)
+        {
+          k[dim] = rest % BatchedSupportSize;
+          rest /= BatchedSupportSize;
+          rowOffset += offsets[i][dim][k[dim]];
+        }
+
+        /** Interpolate along the first dimension. */
+        double rowValue = 0.0;
+        double rowDerivative = 0.0;
+        for (unsigned int k0 = 0; k0 < BatchedSupportSize; ++k0)
+        {
+          const double coefficient = static_cast<double>(buffer[rowOffset + offsets[i][0][k0]]);
+          rowValue += weights[i][0][k0] * coefficient;
+          rowDerivative += derivativeWeights[i][0][k0] * coefficient;
+        }
+
+        /** Weight the row by the other dimensions. */
+        double rowWeight = 1.0;
+        for (unsigned int dim = 1; dim < ImageDimension; ++dim)
+        {
+          rowWeight *= weights[i][dim][k[dim]];
+        }
+        valueSum += rowWeight * rowValue;
+
+        if (deriv)
+        {
+          derivativeSum[0] += rowWeight * rowDerivative;
+          for (unsigned int d = 1; d < ImageDimension; ++d)
+          {
+            double weight = derivativeWeights[i][d][k[d]];
+            for (unsigned int dim = 1; dim < ImageDimension; ++dim)
+            {
+              if (dim != d)
+              {
+                weight *= weights[i][dim][k[dim]];
+              }
+            }
+            derivativeSum[d] += weight * rowValue;
+          }
+        }
+      }
+
+      value[groupBegin + i] = static_cast<OutputType>(valueSum);
+
+      if (deriv)
+      {
+        CovariantVectorType derivative;
+        for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+        {
+          derivative[dim] = static_cast<typename CovariantVectorType::ValueType>(derivativeSum[dim]);
+        }
+
+        /** Take direction cosines into account. */
+        deriv[groupBegin + i] =
+          this->GetUseImageDirection() ? inputImage->TransformLocalVectorToPhysicalVector(derivative) : derivative;
+      }
+    }
+  }
+
+} // end EvaluateCubicValuesAndDerivatives()
+
+
+} // end namespace itk
+
+#endif
@@ -117,12 +117,28 @@ public:
     return this->EvaluateValueAndDerivativeOptimized(Dispatch<ImageDimension>(), x, value, deriv);
   }
 
+  /** Method to compute both the values and the derivatives at a batch of
+   * continuous indices, which should all be inside the buffer. If deriv is
+   * a nullptr, only the values are computed. The buffer offsets and the
+   * interpolation weights of a group of indices are computed first, after which
+   * the pixel values are gathered directly from the buffer, so that the memory
+   * accesses of the group are independent of each other.
+   */
+  void
+  EvaluateValuesAndDerivativesAtContinuousIndices(const ContinuousIndexType * x,
+                                                  OutputType *                value,
+                                                  CovariantVectorType *       deriv,
+                                                  SizeValueType               numberOfIndices) const;
+
 
 protected:
   AdvancedLinearInterpolateImageFunction() = default;
   ~AdvancedLinearInterpolateImageFunction() override = default;
 
 private:
+  /** The number of indices that are processed together by EvaluateValuesAndDerivativesAtContinuousIndices. */
+  itkStaticConstMacro(BatchGroupSize, unsigned int, 64);
+
   /** Helper struct to select the correct dimension. */
   struct DispatchBase
   {};
@@ -22,6 +22,8 @@
 
 #include <vnl/vnl_math.h>
 
+#include <algorithm> // For min.
+
 namespace itk
 {
 
@@ -235,6 +237,144 @@ AdvancedLinearInterpolateImageFunction<TInputImage, TCoordRep>::EvaluateValueAnd
 } // end EvaluateValueAndDerivativeOptimized()
 
 
+/**
+ * ***************** EvaluateValuesAndDerivativesAtContinuousIndices ***********************
+ */
+
+template <class TInputImage, class TCoordRep>
+void
+AdvancedLinearInterpolateImageFunction<TInputImage, TCoordRep>::EvaluateValuesAndDerivativesAtContinuousIndices(
+  const ContinuousIndexType * x,
+  OutputType *                value,
+  CovariantVectorType *       deriv,
+  SizeValueType               numberOfIndices) const
+{
+  // Get some handles
+  const InputImageType *        inputImage = this->GetInputImage();
+  const InputImageSpacingType & spacing = inputImage->GetSpacing();
+  const InputPixelType * const  buffer = inputImage->GetBufferPointer();
+  const OffsetValueType * const offsetTable = inputImage->GetOffsetTable();
+  const IndexType               bufferedRegionIndex = inputImage->GetBufferedRegion().GetIndex();
+
+  /** The offsets of the corners of a pixel cell, relative to its lowest corner.
+   * Bit dim of the corner number tells whether the corner is at the upper side in dimension dim.
+   */
+  constexpr unsigned int numberOfCorners = 1u << ImageDimension;
+  OffsetValueType        cornerOffsets[numberOfCorners];
+  for (unsigned int corner = 0; corner < numberOfCorners; ++corner)
+  {
+    cornerOffsets[corner] = 0;
+    for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+    {
+      if ((corner >> dim) & 1)
+      {
+        cornerOffsets[corner] += offsetTable[dim];
+      }
+    }
+  }
+
+  OffsetValueType baseOffsets[BatchGroupSize];
+  double          dist[ImageDimension][BatchGroupSize];
+  double          deriv_sign[ImageDimension][BatchGroupSize];
+
+  for (SizeValueType groupBegin = 0; groupBegin < numberOfIndices; groupBegin += BatchGroupSize)
+  {
+    const SizeValueType groupSize = std::min(static_cast<SizeValueType>(BatchGroupSize), numberOfIndices - groupBegin);
+
+    /** First pass: compute the buffer offsets and the distances, for all indices of the group. */
+    for (SizeValueType i = 0; i < groupSize; ++i)
+    {
+      const ContinuousIndexType & xi = x[groupBegin + i];
+      OffsetValueType             offset = 0;
+      for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+      {
+        /** Create a possibly mirrored version of x, as in EvaluateValueAndDerivativeOptimized(). */
+        double xm = xi[dim];
+        double sign = 1.0 / spacing[dim];
+        if (xi[dim] < this->m_StartIndex[dim])
+        {
+          xm = 2.0 * this->m_StartIndex[dim] - xi[dim];
+          sign *= -1.0;
+        }
+        if (xi[dim] > this->m_EndIndex[dim])
+        {
+          xm = 2.0 * this->m_EndIndex[dim] - xi[dim];
+          sign *= -1.0;
+        }
+        if (Math::FloatAlmostEqual(xm, static_cast<double>(this->m_EndIndex[dim])))
+        {
+          xm -= 0.000001;
+        }
+
+        const IndexValueType baseIndex = Math::Floor<IndexValueType>(xm);
+        dist[dim][i] = xm - static_cast<double>(baseIndex);
+        deriv_sign[dim][i] = sign;
+        offset += (baseIndex - bufferedRegionIndex[dim]) * offsetTable[dim];
+      }
+      baseOffsets[i] = offset;
+    }
+
+    /** Second pass: gather the corner values, and interpolate. */
+    for (SizeValueType i = 0; i < groupSize; ++i)
+    {
+      const InputPixelType * const basePixel = buffer + baseOffsets[i];
+      RealType                     cornerValues[numberOfCorners];
+      for (unsigned int corner = 0; corner < numberOfCorners; ++corner)
+      {
+        cornerValues[corner] = static_cast<RealType>(basePixel[cornerOffsets[corner]]);
+      }
+
+      /** Interpolate to get the value. */
+      RealType interpolated = 0.0;
+      for (unsigned int corner = 0; corner < numberOfCorners; ++corner)
+      {
+        double weight = 1.0;
+        for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+        {
+          weight *= ((corner >> dim) & 1) ? dist[dim][i] : 1.0 - dist[dim][i];
+        }
+        interpolated += weight * cornerValues[corner];
+      }
+      value[groupBegin + i] = static_cast<OutputType>(interpolated);
+
+      if (deriv == nullptr)
+      {
+        continue;
+      }
+
+      /** Interpolate to get the derivative: the differences along dimension d,
+       * weighted by the linear weights of the other dimensions. */
+      CovariantVectorType derivative;
+      for (unsigned int d = 0; d < ImageDimension; ++d)
+      {
+        RealType sum = 0.0;
+        for (unsigned int corner = 0; corner < numberOfCorners; ++corner)
+        {
+          if ((corner >> d) & 1)
+          {
+            continue;
+          }
+          double weight = 1.0;
+          for (unsigned int dim = 0; dim < ImageDimension; ++dim)
+          {
+            if (dim != d)
+            {
+              weight *= ((corner >> dim) & 1) ? dist[dim][i] : 1.0 - dist[dim][i];
+            }
+          }
+          sum += weight * (cornerValues[corner | (1u << d)] - cornerValues[corner]);
+        }
+        derivative[d] = deriv_sign[d][i] * sum;
+      }
+
+      /** Take direction cosines into account. */
+      deriv[groupBegin + i] = inputImage->TransformLocalVectorToPhysicalVector(derivative);
+    }
+  }
+
+} // end EvaluateValuesAndDerivativesAtContinuousIndices()
+
+
 } // end namespace itk
 
 #endif
@@ -19,6 +19,10 @@
 #define itkComputeJacobianTerms_hxx
 
 #include "itkComputeJacobianTerms.h"
+#include "itkWorkStealingThreadPool.h"
+
+#include <algorithm>
+#include <vector>
 
 #include <vnl/vnl_math.h>
 #include <vnl/vnl_fastops.h>
@@ -78,12 +82,6 @@ ComputeJacobianTerms<TFixedImage, TTransform>::Compute(double & TrC, double & Tr
   /** Get scales vector */
   const ScalesType & scales = this->m_Scales;
 
-  /** Create iterator over the sample container. */
-  typename ImageSampleContainerType::ConstIterator iter;
-  typename ImageSampleContainerType::ConstIterator begin = sampleContainer->Begin();
-  typename ImageSampleContainerType::ConstIterator end = sampleContainer->End();
-  unsigned int                                     samplenr = 0;
-
   /** Variables for nonzerojacobian indices and the Jacobian. */
   NumberOfParametersType sizejacind = this->m_Transform->GetNumberOfNonZeroJacobianIndices();
   JacobianType           jacj(outdim, sizejacind);
@@ -199,110 +197,175 @@ ComputeJacobianTerms<TFixedImage, TTransform>::Compute(double & TrC, double & Tr
   bandcov = CovarianceMatrixType(numberOfParameters, bandcovsize);
   bandcov.Fill(0.0);
 
+  /** Add the sum of J_j^T J_j over a run of samples, divided by n, to the covariance matrix. */
+  const auto updateCovariance = [&](const NonZeroJacobianIndicesType & runJacobianIndices,
+                                    const CovarianceMatrixType &       runJacTJac) {
+    for (unsigned int pi = 0; pi < sizejacind; ++pi)
+    {
+      const unsigned int p = runJacobianIndices[pi];
+      for (unsigned int qi = 0; qi < sizejacind; ++qi)
+      {
+        const unsigned int q = runJacobianIndices[qi];
+        if (q >= p)
+        {
+          const double tempval = runJacTJac(pi, qi) / n;
+          if (std::abs(tempval) > 1e-14)
+          {
+            const unsigned int bandindex = bandcovMap[q - p];
+            if (bandindex < bandcovsize)
+            {
+              bandcov(p, bandindex) += tempval;
+            }
+            else
+            {
+              cov(p, q) += tempval;
+            }
+          }
+        }
+      } // qi
+    }   // pi
+  };
+
   /**
    *    TERM 1
    *
    * Loop over image and compute Jacobian.
    * Compute C = 1/n \sum_i J_i^T J_i
    * Possibly apply scaling afterwards.
+   *
+   * Consecutive samples with the same nonzero Jacobian indices form a run,
+   * for which the sum of J_j^T J_j is accumulated before it is added to the
+   * covariance matrix. The samples are processed in batches. For each batch,
+   * the Jacobians and the sums over the runs are computed in parallel. The runs
+   * are then added to the covariance matrix serially, in the order of the samples.
+   * The last run of a batch may continue in the next batch, so it is carried over.
+   * This gives exactly the same result as a serial computation, independent of
+   * the number of threads.
    */
   jacind[0] = 0;
   if (sizejacind > 1)
   {
     jacind[1] = 0;
   }
-  for (iter = begin; iter != end; ++iter)
+
+  struct RunType
   {
-    /** Print progress 0-50%.
-     *progressObserver->UpdateAndPrintProgress( samplenr );*/
-    ++samplenr;
+    bool                       m_ContinuesPreviousRun;
+    std::vector<SizeValueType> m_Samples;
+  };
 
-    /** Read fixed coordinates and get Jacobian J_j. */
-    const FixedImagePointType & point = iter->Value().m_ImageCoordinates;
-    this->m_Transform->GetJacobian(point, jacj, jacind);
+  const auto          threadPool = WorkStealingThreadPool::GetInstance();
+  const ThreadIdType  numberOfWorkers = threadPool->GetNumberOfThreads();
+  const SizeValueType batchSize = 8 * static_cast<SizeValueType>(std::max<ThreadIdType>(numberOfWorkers, 1));
 
-    /** Skip invalid Jacobians in the beginning, if any. */
-    if (sizejacind > 1)
+  std::vector<JacobianType>               batchJacobians(batchSize, jacj);
+  std::vector<NonZeroJacobianIndicesType> batchJacobianIndices(batchSize, jacind);
+  std::vector<RunType>                    runs;
+  std::vector<CovarianceMatrixType>       runJacTJacs;
+
+  for (SizeValueType batchBegin = 0; batchBegin < nrofsamples; batchBegin += batchSize)
+  {
+    const SizeValueType batchEnd = std::min(batchBegin + batchSize, nrofsamples);
+
+    /** Read fixed coordinates and get Jacobian J_j, for all samples in the batch. */
+    threadPool->ParallelFor(
+      batchBegin,
+      batchEnd,
+      1,
+      numberOfWorkers,
+      [this, &sampleContainer, &batchJacobians, &batchJacobianIndices, batchBegin](
+        const SizeValueType begin, const SizeValueType end, ThreadIdType) {
+        for (SizeValueType i = begin; i < end; ++i)
+        {
+          const FixedImagePointType & point = sampleContainer->ElementAt(i).m_ImageCoordinates;
+          this->m_Transform->GetJacobian(point, batchJacobians[i - batchBegin], batchJacobianIndices[i - batchBegin]);
+        }
+      });
+
+    /** Divide the samples of the batch into runs. */
+    runs.clear();
+    for (SizeValueType i = 0; i < batchEnd - batchBegin; ++i)
     {
-      if (jacind[0] == jacind[1])
+      const NonZeroJacobianIndicesType & currentjacind = batchJacobianIndices[i];
+
+      /** Skip invalid Jacobians in the beginning, if any. */
+      if (sizejacind > 1)
       {
-        continue;
+        if (currentjacind[0] == currentjacind[1])
+        {
+          continue;
+        }
       }
-    }
 
-    if (jacind == prevjacind)
-    {
-      /** Update sum of J_j^T J_j. */
-      vnl_fastops::inc_X_by_AtA(jactjac, jacj);
-    }
-    else
-    {
-      /** The following should only be done after the first sample. */
-      if (iter != begin)
+      const NonZeroJacobianIndicesType & runjacind =
+        runs.empty() ? prevjacind : batchJacobianIndices[runs.back().m_Samples.front()];
+      if (currentjacind == runjacind)
       {
-        /** Update covariance matrix. */
-        for (unsigned int pi = 0; pi < sizejacind; ++pi)
+        if (runs.empty())
         {
-          const unsigned int p = prevjacind[pi];
-          for (unsigned int qi = 0; qi < sizejacind; ++qi)
-          {
-            const unsigned int q = prevjacind[qi];
-            if (q >= p)
-            {
-              const double tempval = jactjac(pi, qi) / n;
-              if (std::abs(tempval) > 1e-14)
-              {
-                const unsigned int bandindex = bandcovMap[q - p];
-                if (bandindex < bandcovsize)
-                {
-                  bandcov(p, bandindex) += tempval;
-                }
-                else
-                {
-                  cov(p, q) += tempval;
-                }
-              }
-            }
-          } // qi
-        }   // pi
-      }     // end if
-
-      /** Initialize jactjac by J_j^T J_j. */
-      vnl_fastops::AtA(jactjac, jacj);
-
-      /** Remember nonzerojacobian indices. */
-      prevjacind = jacind;
-    } // end else
-
-  } // end iter loop: end computation of covariance matrix
+          runs.push_back(RunType{ true, {} });
+        }
+        runs.back().m_Samples.push_back(i);
+      }
+      else
+      {
+        runs.push_back(RunType{ false, { i } });
+      }
+    }
 
-  /** Update covariance matrix once again to include last jactjac updates
-   * \todo: a bit ugly that this loop is copied from above.
-   */
-  for (unsigned int pi = 0; pi < sizejacind; ++pi)
-  {
-    const unsigned int p = prevjacind[pi];
-    for (unsigned int qi = 0; qi < sizejacind; ++qi)
+    /** Sum J_j^T J_j over each run. A run that continues the last run of the
+     * previous batch starts from its sum. */
+    if (runJacTJacs.size() < runs.size())
     {
-      const unsigned int q = prevjacind[qi];
-      if (q >= p)
-      {
-        const double tempval = jactjac(pi, qi) / n;
-        if (std::abs(tempval) > 1e-14)
+      runJacTJacs.resize(runs.size(), jactjac);
+    }
+    threadPool->ParallelFor(
+      0,
+      runs.size(),
+      1,
+      numberOfWorkers,
+      [&runs, &runJacTJacs, &batchJacobians, &jactjac](
+        const SizeValueType begin, const SizeValueType end, ThreadIdType) {
+        for (SizeValueType r = begin; r < end; ++r)
         {
-          const unsigned int bandindex = bandcovMap[q - p];
-          if (bandindex < bandcovsize)
+          const std::vector<SizeValueType> & samples = runs[r].m_Samples;
+          CovarianceMatrixType &             runJacTJac = runJacTJacs[r];
+          auto                               sampleIt = samples.cbegin();
+          if (runs[r].m_ContinuesPreviousRun)
           {
-            bandcov(p, bandindex) += tempval;
+            runJacTJac = jactjac;
           }
           else
           {
-            cov(p, q) += tempval;
+            /** Initialize by J_j^T J_j. */
+            vnl_fastops::AtA(runJacTJac, batchJacobians[*sampleIt]);
+            ++sampleIt;
+          }
+          for (; sampleIt != samples.cend(); ++sampleIt)
+          {
+            /** Update sum of J_j^T J_j. */
+            vnl_fastops::inc_X_by_AtA(runJacTJac, batchJacobians[*sampleIt]);
           }
         }
+      });
+
+    /** Update the covariance matrix with the completed runs, in sample order. */
+    for (SizeValueType r = 0; r < runs.size(); ++r)
+    {
+      if (!runs[r].m_ContinuesPreviousRun)
+      {
+        updateCovariance(prevjacind, jactjac);
+
+        /** Remember nonzerojacobian indices. */
+        prevjacind = batchJacobianIndices[runs[r].m_Samples.front()];
       }
-    } // qi
-  }   // pi
+      jactjac = runJacTJacs[r];
+    }
+
+  } // end batch loop: end computation of covariance matrix
+
+  /** Update covariance matrix once again to include last jactjac updates. */
+  updateCovariance(prevjacind, jactjac);
 
   /** Copy the bandmatrix into the sparse matrix and empty the bandcov matrix.
    * \todo: perhaps work further with this bandmatrix instead.
@@ -379,122 +442,150 @@ ComputeJacobianTerms<TFixedImage, TTransform>::Compute(double & TrC, double & Tr
   maxJCJ = 0.0;
   const double sqrt2 = std::sqrt(static_cast<double>(2.0));
 
-  JacobianType                       jacjjacj(outdim, outdim);
-  JacobianType                       jacjcov(outdim, sizejacind);
-  DiagCovarianceMatrixType           diagcovsparse(sizejacind);
-  JacobianType                       jacjdiagcov(outdim, sizejacind);
-  JacobianType                       jacjdiagcovjacj(outdim, outdim);
-  JacobianType                       jacjcovjacj(outdim, outdim);
-  NonZeroJacobianIndicesExpandedType jacindExpanded(numberOfParameters);
-
-  samplenr = 0;
-  for (iter = begin; iter != end; ++iter)
+  /** The samples are processed in parallel, each worker with its own temporary
+   * variables, and its own maxima. The covariance matrix is only read. */
+  struct WorkerVariablesType
   {
-    /** Read fixed coordinates and get Jacobian. */
-    const FixedImagePointType & point = iter->Value().m_ImageCoordinates;
-    this->m_Transform->GetJacobian(point, jacj, jacind);
-
-    /** Apply scales, if necessary. */
-    if (this->m_UseScales)
-    {
-      for (unsigned int pi = 0; pi < sizejacind; ++pi)
+    JacobianType                       jacj;
+    NonZeroJacobianIndicesType         jacind;
+    JacobianType                       jacjjacj;
+    JacobianType                       jacjcov;
+    DiagCovarianceMatrixType           diagcovsparse;
+    JacobianType                       jacjdiagcov;
+    JacobianType                       jacjdiagcovjacj;
+    JacobianType                       jacjcovjacj;
+    NonZeroJacobianIndicesExpandedType jacindExpanded;
+    double                             maxJJ;
+    double                             maxJCJ;
+  };
+  const WorkerVariablesType initialWorkerVariables{ jacj,
+                                                    jacind,
+                                                    JacobianType(outdim, outdim),
+                                                    JacobianType(outdim, sizejacind),
+                                                    DiagCovarianceMatrixType(sizejacind),
+                                                    JacobianType(outdim, sizejacind),
+                                                    JacobianType(outdim, outdim),
+                                                    JacobianType(outdim, outdim),
+                                                    NonZeroJacobianIndicesExpandedType(numberOfParameters),
+                                                    0.0,
+                                                    0.0 };
+  std::vector<WorkerVariablesType> workerVariables(std::max<ThreadIdType>(numberOfWorkers, 1), initialWorkerVariables);
+
+  threadPool->ParallelFor(
+    0,
+    nrofsamples,
+    16,
+    numberOfWorkers,
+    [this, &sampleContainer, &workerVariables, &cov, &diagcov, &scales, sizejacind, outdim, sqrt2](
+      const SizeValueType begin, const SizeValueType end, const ThreadIdType workerId) {
+      WorkerVariablesType & v = workerVariables[workerId];
+      for (SizeValueType sample = begin; sample < end; ++sample)
       {
-        const unsigned int p = jacind[pi];
-        jacj.scale_column(pi, 1.0 / scales[p]);
-      }
-    }
-
-    /** Compute 1st part of JJ: ||J_j||_F^2. */
-    double JJ_j = vnl_math::sqr(jacj.frobenius_norm());
+        /** Read fixed coordinates and get Jacobian. */
+        const FixedImagePointType & point = sampleContainer->ElementAt(sample).m_ImageCoordinates;
+        this->m_Transform->GetJacobian(point, v.jacj, v.jacind);
 
-    /** Compute 2nd part of JJ: 2\sqrt{2} || J_j J_j^T ||_F. */
-    vnl_fastops::ABt(jacjjacj, jacj, jacj);
-    JJ_j += 2.0 * sqrt2 * jacjjacj.frobenius_norm();
+        /** Apply scales, if necessary. */
+        if (this->m_UseScales)
+        {
+          for (unsigned int pi = 0; pi < sizejacind; ++pi)
+          {
+            const unsigned int p = v.jacind[pi];
+            v.jacj.scale_column(pi, 1.0 / scales[p]);
+          }
+        }
 
-    /** Max_j [JJ_j]. */
-    maxJJ = std::max(maxJJ, JJ_j);
+        /** Compute 1st part of JJ: ||J_j||_F^2. */
+        double JJ_j = vnl_math::sqr(v.jacj.frobenius_norm());
 
-    /** Compute JCJ_j. */
-    double JCJ_j = 0.0;
+        /** Compute 2nd part of JJ: 2\sqrt{2} || J_j J_j^T ||_F. */
+        vnl_fastops::ABt(v.jacjjacj, v.jacj, v.jacj);
+        JJ_j += 2.0 * sqrt2 * v.jacjjacj.frobenius_norm();
 
-    /** J_j C = jacjC. */
-    jacjcov.Fill(0.0);
+        /** Max_j [JJ_j]. */
+        v.maxJJ = std::max(v.maxJJ, JJ_j);
 
-    /** Store the nonzero Jacobian indices in a different format
-     * and create the sparse diagcov.
-     */
-    jacindExpanded.Fill(sizejacind);
-    for (unsigned int pi = 0; pi < sizejacind; ++pi)
-    {
-      const unsigned int p = jacind[pi];
-      jacindExpanded[p] = pi;
-      diagcovsparse[pi] = diagcov[p];
-    }
+        /** Compute JCJ_j. */
+        double JCJ_j = 0.0;
 
-    /** We below calculate jacjC = J_j cov^T, but later we will correct
-     * for this using:
-     * J C J' = J (cov + cov' - diag(cov')) J'.
-     * (NB: cov now still contains only the upper triangular part of C)
-     */
-    for (unsigned int pi = 0; pi < sizejacind; ++pi)
-    {
-      const unsigned int p = jacind[pi];
-      if (!cov.empty_row(p))
-      {
-        SparseRowType &                  covrowp = cov.get_row(p);
-        typename SparseRowType::iterator covrowpit;
+        /** J_j C = jacjC. */
+        v.jacjcov.Fill(0.0);
 
-        /** Loop over row p of the sparse cov matrix. */
-        for (covrowpit = covrowp.begin(); covrowpit != covrowp.end(); ++covrowpit)
+        /** Store the nonzero Jacobian indices in a different format
+         * and create the sparse diagcov.
+         */
+        v.jacindExpanded.Fill(sizejacind);
+        for (unsigned int pi = 0; pi < sizejacind; ++pi)
         {
-          const unsigned int q = covrowpit->first;
-          const unsigned int qi = jacindExpanded[q];
+          const unsigned int p = v.jacind[pi];
+          v.jacindExpanded[p] = pi;
+          v.diagcovsparse[pi] = diagcov[p];
+        }
 
-          if (qi < sizejacind)
+        /** We below calculate jacjC = J_j cov^T, but later we will correct
+         * for this using:
+         * J C J' = J (cov + cov' - diag(cov')) J'.
+         * (NB: cov now still contains only the upper triangular part of C)
+         */
+        for (unsigned int pi = 0; pi < sizejacind; ++pi)
+        {
+          const unsigned int p = v.jacind[pi];
+          if (!cov.empty_row(p))
           {
-            /** If found, update the jacjC matrix. */
-            const CovarianceValueType covElement = covrowpit->second;
-            for (unsigned int dx = 0; dx < outdim; ++dx)
+            const SparseRowType & covrowp = cov.get_row(p);
+
+            /** Loop over row p of the sparse cov matrix. */
+            for (auto covrowpit = covrowp.cbegin(); covrowpit != covrowp.cend(); ++covrowpit)
             {
-              jacjcov[dx][pi] += jacj[dx][qi] * covElement;
-            } // dx
-          }   // if qi < sizejacind
-        }     // for covrow
+              const unsigned int q = covrowpit->first;
+              const unsigned int qi = v.jacindExpanded[q];
 
-      } // if not empty row
-    }   // pi
+              if (qi < sizejacind)
+              {
+                /** If found, update the jacjC matrix. */
+                const CovarianceValueType covElement = covrowpit->second;
+                for (unsigned int dx = 0; dx < outdim; ++dx)
+                {
+                  v.jacjcov[dx][pi] += v.jacj[dx][qi] * covElement;
+                } // dx
+              }   // if qi < sizejacind
+            }     // for covrow
 
-    /** J_j C J_j^T  = jacjCjacj.
-     * But note that we actually compute J_j cov' J_j^T
-     */
-    vnl_fastops::ABt(jacjcovjacj, jacjcov, jacj);
+          } // if not empty row
+        }   // pi
 
-    /** jacjCjacj = jacjCjacj+ jacjCjacj' - jacjdiagcovjacj */
-    jacjdiagcov = jacj * diagcovsparse;
-    vnl_fastops::ABt(jacjdiagcovjacj, jacjdiagcov, jacj);
-    jacjcovjacj += jacjcovjacj.transpose();
-    jacjcovjacj -= jacjdiagcovjacj;
+        /** J_j C J_j^T  = jacjCjacj.
+         * But note that we actually compute J_j cov' J_j^T
+         */
+        vnl_fastops::ABt(v.jacjcovjacj, v.jacjcov, v.jacj);
 
-    /** Compute 1st part of JCJ: Tr( J_j C J_j^T ). */
-    for (unsigned int d = 0; d < outdim; ++d)
-    {
-      JCJ_j += jacjcovjacj[d][d];
-    }
+        /** jacjCjacj = jacjCjacj+ jacjCjacj' - jacjdiagcovjacj */
+        v.jacjdiagcov = v.jacj * v.diagcovsparse;
+        vnl_fastops::ABt(v.jacjdiagcovjacj, v.jacjdiagcov, v.jacj);
+        v.jacjcovjacj += v.jacjcovjacj.transpose();
+        v.jacjcovjacj -= v.jacjdiagcovjacj;
 
-    /** Compute 2nd part of JCJ_j: 2 \sqrt{2} || J_j C J_j^T ||_F. */
-    JCJ_j += 2.0 * sqrt2 * jacjcovjacj.frobenius_norm();
+        /** Compute 1st part of JCJ: Tr( J_j C J_j^T ). */
+        for (unsigned int d = 0; d < outdim; ++d)
+        {
+          JCJ_j += v.jacjcovjacj[d][d];
+        }
 
-    /** Max_j [JCJ_j]. */
-    maxJCJ = std::max(maxJCJ, JCJ_j);
+        /** Compute 2nd part of JCJ_j: 2 \sqrt{2} || J_j C J_j^T ||_F. */
+        JCJ_j += 2.0 * sqrt2 * v.jacjcovjacj.frobenius_norm();
 
-    /** Show progress 50-100%. */
-    // progressObserver->UpdateAndPrintProgress( samplenr + nrofsamples );
-    ++samplenr;
+        /** Max_j [JCJ_j]. */
+        v.maxJCJ = std::max(v.maxJCJ, JCJ_j);
 
-  } // end loop over sample container
+      } // end loop over samples
+    });
 
-  /** Finalize progress information. */
-  // progressObserver->PrintProgress( 1.0 );
+  /** Combine the maxima of the workers. */
+  for (const auto & v : workerVariables)
+  {
+    maxJJ = std::max(maxJJ, v.maxJJ);
+    maxJCJ = std::max(maxJCJ, v.maxJCJ);
+  }
 
 } // end Compute()
 
@@ -104,7 +104,9 @@ private:
 
     localInputImage->Graft(static_cast<const ScalarInputImageType *>(inputImage));
 
+    /** When the writer streams, only the current piece of the input is buffered. */
     caster->SetInput(localInputImage);
+    caster->GetOutput()->SetRequestedRegion(localInputImage->GetBufferedRegion());
     caster->Update();
 
     /** return the pixel buffer of the casted image */
@@ -123,13 +125,15 @@ void
 WriteCastedImage(const TImage &      image,
                  const std::string & filename,
                  const std::string & outputComponentType,
-                 bool                compress)
+                 bool                compress,
+                 unsigned int        numberOfStreamDivisions = 1)
 {
   elx::DefaultConstruct<ImageFileCastWriter<TImage>> writer;
   writer.SetInput(&image);
   writer.SetFileName(filename);
   writer.SetOutputComponentType(outputComponentType);
   writer.SetUseCompression(compress);
+  writer.SetNumberOfStreamDivisions(numberOfStreamDivisions);
   writer.Update();
 }
 
@@ -0,0 +1,380 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkLBFGSHistory.h"
+#include "itkWorkStealingThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace itk
+{
+
+namespace
+{
+
+/** The number of products that is summed without compensation. */
+constexpr SizeValueType BlockSize = 1024;
+
+/** The number of elements processed by one task of the thread pool. */
+constexpr SizeValueType ChunkSize = 64 * BlockSize;
+
+/** Vectors shorter than this are processed by the calling thread only. */
+constexpr SizeValueType MinimumParallelSize = 4 * ChunkSize;
+
+
+/** Adds term to sum, and accumulates the rounding error in compensation (Neumaier). */
+inline void
+CompensatedAdd(double & sum, double & compensation, const double term)
+{
+  const double newSum = sum + term;
+  if (std::abs(sum) >= std::abs(term))
+  {
+    compensation += (sum - newSum) + term;
+  }
+  else
+  {
+    compensation += (term - newSum) + sum;
+  }
+  sum = newSum;
+}
+
+
+/** Sums the products of one block, using independent accumulators that can be vectorized. */
+template <typename TLeft, typename TRight>
+double
+BlockInnerProduct(const TLeft * a, const TRight * b, const SizeValueType n)
+{
+  double        sum0 = 0.0;
+  double        sum1 = 0.0;
+  double        sum2 = 0.0;
+  double        sum3 = 0.0;
+  SizeValueType i = 0;
+  for (; i + 4 <= n; i += 4)
+  {
+    sum0 += static_cast<double>(a[i]) * static_cast<double>(b[i]);
+    sum1 += static_cast<double>(a[i + 1]) * static_cast<double>(b[i + 1]);
+    sum2 += static_cast<double>(a[i + 2]) * static_cast<double>(b[i + 2]);
+    sum3 += static_cast<double>(a[i + 3]) * static_cast<double>(b[i + 3]);
+  }
+  for (; i < n; ++i)
+  {
+    sum0 += static_cast<double>(a[i]) * static_cast<double>(b[i]);
+  }
+  return (sum0 + sum1) + (sum2 + sum3);
+}
+
+
+/** Sums the block sums of one chunk, with compensated summation. */
+template <typename TLeft, typename TRight>
+double
+ChunkInnerProduct(const TLeft * a, const TRight * b, const SizeValueType n)
+{
+  double sum = 0.0;
+  double compensation = 0.0;
+  for (SizeValueType begin = 0; begin < n; begin += BlockSize)
+  {
+    CompensatedAdd(sum, compensation, BlockInnerProduct(a + begin, b + begin, std::min(BlockSize, n - begin)));
+  }
+  return sum + compensation;
+}
+
+
+/** The inner product of a and b. The chunk sums are combined in a fixed order,
+ * so the result is the same for the serial and the multi-threaded computation. */
+template <typename TLeft, typename TRight>
+double
+InnerProductKernel(const TLeft * a, const TRight * b, const SizeValueType n)
+{
+  const SizeValueType numberOfChunks = (n + ChunkSize - 1) / ChunkSize;
+  std::vector<double> chunkSums(numberOfChunks);
+
+  const auto computeChunkSums = [a, b, n, &chunkSums](SizeValueType chunkBegin, SizeValueType chunkEnd, ThreadIdType) {
+    for (SizeValueType chunk = chunkBegin; chunk < chunkEnd; ++chunk)
+    {
+      const SizeValueType offset = chunk * ChunkSize;
+      chunkSums[chunk] = ChunkInnerProduct(a + offset, b + offset, std::min(ChunkSize, n - offset));
+    }
+  };
+
+  if (n < MinimumParallelSize)
+  {
+    computeChunkSums(0, numberOfChunks, 0);
+  }
+  else
+  {
+    const auto threadPool = WorkStealingThreadPool::GetInstance();
+    threadPool->ParallelFor(0, numberOfChunks, 1, threadPool->GetNumberOfThreads(), computeChunkSums);
+  }
+
+  double sum = 0.0;
+  double compensation = 0.0;
+  for (const double chunkSum : chunkSums)
+  {
+    CompensatedAdd(sum, compensation, chunkSum);
+  }
+  return sum + compensation;
+}
+
+
+/** v += factor * a. */
+template <typename TStored>
+void
+AddScaledKernel(const TStored * a, const double factor, double * v, const SizeValueType n)
+{
+  const auto addScaled = [a, factor, v, n](SizeValueType chunkBegin, SizeValueType chunkEnd, ThreadIdType) {
+    const SizeValueType begin = chunkBegin * ChunkSize;
+    const SizeValueType end = std::min(chunkEnd * ChunkSize, n);
+    for (SizeValueType i = begin; i < end; ++i)
+    {
+      v[i] += factor * static_cast<double>(a[i]);
+    }
+  };
+
+  const SizeValueType numberOfChunks = (n + ChunkSize - 1) / ChunkSize;
+  if (n < MinimumParallelSize)
+  {
+    addScaled(0, numberOfChunks, 0);
+  }
+  else
+  {
+    const auto threadPool = WorkStealingThreadPool::GetInstance();
+    threadPool->ParallelFor(0, numberOfChunks, 1, threadPool->GetNumberOfThreads(), addScaled);
+  }
+}
+
+} // end namespace
+
+
+/**
+ * ********************* Initialize *****************************
+ */
+
+void
+LBFGSHistory::Initialize(const unsigned int memory, const SizeValueType numberOfParameters)
+{
+  this->m_Memory = memory;
+  this->m_NumberOfParameters = numberOfParameters;
+  this->m_IsSinglePrecision = this->m_UseSinglePrecision;
+
+  /** Release the memory of the previous resolution before allocating the new one. */
+  this->m_DoubleS.clear();
+  this->m_DoubleY.clear();
+  this->m_FloatS.clear();
+  this->m_FloatY.clear();
+  this->m_DoubleS.shrink_to_fit();
+  this->m_DoubleY.shrink_to_fit();
+  this->m_FloatS.shrink_to_fit();
+  this->m_FloatY.shrink_to_fit();
+
+  if (this->m_IsSinglePrecision)
+  {
+    this->m_FloatS.assign(memory, std::vector<float>(numberOfParameters, 0.0f));
+    this->m_FloatY.assign(memory, std::vector<float>(numberOfParameters, 0.0f));
+  }
+  else
+  {
+    this->m_DoubleS.assign(memory, std::vector<double>(numberOfParameters, 0.0));
+    this->m_DoubleY.assign(memory, std::vector<double>(numberOfParameters, 0.0));
+  }
+
+} // end Initialize()
+
+
+/**
+ * ********************* Store *****************************
+ */
+
+double
+LBFGSHistory::Store(const unsigned int index, const VectorType & s, const VectorType & y)
+{
+  if (index >= this->m_Memory || s.GetSize() != this->m_NumberOfParameters ||
+      y.GetSize() != this->m_NumberOfParameters)
+  {
+    itkExceptionMacro(<< "Cannot store vectors of size " << s.GetSize() << " and " << y.GetSize() << " at index "
+                      << index << " of a history of " << this->m_Memory << " vectors of size "
+                      << this->m_NumberOfParameters);
+  }
+
+  const SizeValueType n = this->m_NumberOfParameters;
+  if (this->m_IsSinglePrecision)
+  {
+    std::vector<float> & storedS = this->m_FloatS[index];
+    std::vector<float> & storedY = this->m_FloatY[index];
+    std::transform(s.begin(), s.end(), storedS.begin(), [](double value) { return static_cast<float>(value); });
+    std::transform(y.begin(), y.end(), storedY.begin(), [](double value) { return static_cast<float>(value); });
+    return InnerProductKernel(storedS.data(), storedY.data(), n);
+  }
+
+  std::vector<double> & storedS = this->m_DoubleS[index];
+  std::vector<double> & storedY = this->m_DoubleY[index];
+  std::copy(s.begin(), s.end(), storedS.begin());
+  std::copy(y.begin(), y.end(), storedY.begin());
+  return InnerProductKernel(storedS.data(), storedY.data(), n);
+
+} // end Store()
+
+
+/**
+ * ********************* InnerProductWithS *****************************
+ */
+
+double
+LBFGSHistory::InnerProductWithS(const unsigned int index, const VectorType & v) const
+{
+  this->CheckVectorSize(v);
+  const SizeValueType n = this->m_NumberOfParameters;
+  return this->m_IsSinglePrecision ? InnerProductKernel(this->m_FloatS[index].data(), v.data_block(), n)
+                                   : InnerProductKernel(this->m_DoubleS[index].data(), v.data_block(), n);
+
+} // end InnerProductWithS()
+
+
+/**
+ * ********************* InnerProductWithY *****************************
+ */
+
+double
+LBFGSHistory::InnerProductWithY(const unsigned int index, const VectorType & v) const
+{
+  this->CheckVectorSize(v);
+  const SizeValueType n = this->m_NumberOfParameters;
+  return this->m_IsSinglePrecision ? InnerProductKernel(this->m_FloatY[index].data(), v.data_block(), n)
+                                   : InnerProductKernel(this->m_DoubleY[index].data(), v.data_block(), n);
+
+} // end InnerProductWithY()
+
+
+/**
+ * ********************* GetSquaredMagnitudeOfY *****************************
+ */
+
+double
+LBFGSHistory::GetSquaredMagnitudeOfY(const unsigned int index) const
+{
+  const SizeValueType n = this->m_NumberOfParameters;
+  if (this->m_IsSinglePrecision)
+  {
+    const float * y = this->m_FloatY[index].data();
+    return InnerProductKernel(y, y, n);
+  }
+  const double * y = this->m_DoubleY[index].data();
+  return InnerProductKernel(y, y, n);
+
+} // end GetSquaredMagnitudeOfY()
+
+
+/**
+ * ********************* AddScaledS *****************************
+ */
+
+void
+LBFGSHistory::AddScaledS(const unsigned int index, const double factor, VectorType & v) const
+{
+  this->CheckVectorSize(v);
+  const SizeValueType n = this->m_NumberOfParameters;
+  if (this->m_IsSinglePrecision)
+  {
+    AddScaledKernel(this->m_FloatS[index].data(), factor, v.data_block(), n);
+  }
+  else
+  {
+    AddScaledKernel(this->m_DoubleS[index].data(), factor, v.data_block(), n);
+  }
+
+} // end AddScaledS()
+
+
+/**
+ * ********************* AddScaledY *****************************
+ */
+
+void
+LBFGSHistory::AddScaledY(const unsigned int index, const double factor, VectorType & v) const
+{
+  this->CheckVectorSize(v);
+  const SizeValueType n = this->m_NumberOfParameters;
+  if (this->m_IsSinglePrecision)
+  {
+    AddScaledKernel(this->m_FloatY[index].data(), factor, v.data_block(), n);
+  }
+  else
+  {
+    AddScaledKernel(this->m_DoubleY[index].data(), factor, v.data_block(), n);
+  }
+
+} // end AddScaledY()
+
+
+/**
+ * ********************* GetNumberOfBytes *****************************
+ */
+
+SizeValueType
+LBFGSHistory::GetNumberOfBytes() const
+{
+  const SizeValueType bytesPerValue = this->m_IsSinglePrecision ? sizeof(float) : sizeof(double);
+  return 2 * static_cast<SizeValueType>(this->m_Memory) * this->m_NumberOfParameters * bytesPerValue;
+
+} // end GetNumberOfBytes()
+
+
+/**
+ * ********************* InnerProduct *****************************
+ */
+
+double
+LBFGSHistory::InnerProduct(const VectorType & a, const VectorType & b)
+{
+  return InnerProductKernel(a.data_block(), b.data_block(), std::min(a.GetSize(), b.GetSize()));
+
+} // end InnerProduct()
+
+
+/**
+ * ********************* CheckVectorSize *****************************
+ */
+
+void
+LBFGSHistory::CheckVectorSize(const VectorType & v) const
+{
+  if (v.GetSize() != this->m_NumberOfParameters)
+  {
+    itkExceptionMacro(<< "The vector has size " << v.GetSize() << " instead of " << this->m_NumberOfParameters);
+  }
+
+} // end CheckVectorSize()
+
+
+/**
+ * ********************* PrintSelf *****************************
+ */
+
+void
+LBFGSHistory::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "UseSinglePrecision: " << this->m_UseSinglePrecision << std::endl;
+  os << indent << "Memory: " << this->m_Memory << std::endl;
+  os << indent << "NumberOfParameters: " << this->m_NumberOfParameters << std::endl;
+  os << indent << "NumberOfBytes: " << this->GetNumberOfBytes() << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
@@ -0,0 +1,147 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkLBFGSHistory_h
+#define itkLBFGSHistory_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkArray.h"
+
+#include <vector>
+
+namespace itk
+{
+
+/** \class LBFGSHistory
+ *
+ * \brief Stores the s = x_k - x_(k-1) and y = g_k - g_(k-1) vectors of an L-BFGS optimizer.
+ *
+ * The two-loop recursion of L-BFGS only needs inner products of the stored vectors
+ * with the search direction, and additions of scaled stored vectors to the search
+ * direction. This class stores the vectors of the last Memory iterations, and provides
+ * exactly these operations.
+ *
+ * For dense B-spline grids the number of parameters may be of the order of 10^7,
+ * so that a history of 10 iterations takes more than 1.5 GB in double precision.
+ * With UseSinglePrecision the vectors are stored as float, which halves this memory.
+ * The computations are still done in double precision: the float values are converted
+ * when they are read.
+ *
+ * The inner products sum blocks of products with several independent accumulators,
+ * which the compiler can vectorize, and combine the block sums with compensated
+ * (Neumaier) summation. Long vectors are divided into chunks, which are processed
+ * by the WorkStealingThreadPool. The chunk sums are combined in a fixed order,
+ * so the result does not depend on the number of threads.
+ *
+ * \ingroup Optimizers
+ */
+
+class LBFGSHistory : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(LBFGSHistory);
+
+  /** Standard ITK.*/
+  using Self = LBFGSHistory;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(LBFGSHistory, Object);
+
+  using VectorType = Array<double>;
+
+  /** Set/Get whether the vectors are stored in single precision. Takes effect
+   * at the next call of Initialize(). Default: false. */
+  itkSetMacro(UseSinglePrecision, bool);
+  itkGetConstMacro(UseSinglePrecision, bool);
+  itkBooleanMacro(UseSinglePrecision);
+
+  /** Allocate memory for the vectors of the given number of iterations. */
+  void
+  Initialize(unsigned int memory, SizeValueType numberOfParameters);
+
+  /** Get the number of iterations and the number of parameters, as passed to Initialize(). */
+  itkGetConstMacro(Memory, unsigned int);
+  itkGetConstMacro(NumberOfParameters, SizeValueType);
+
+  /** Store s and y at the given index, and return their inner product s'y.
+   * The inner product is computed from the stored values, so that it is
+   * consistent with the other operations when single precision is used. */
+  double
+  Store(unsigned int index, const VectorType & s, const VectorType & y);
+
+  /** Return the inner product of s or y at the given index with the vector v. */
+  double
+  InnerProductWithS(unsigned int index, const VectorType & v) const;
+
+  double
+  InnerProductWithY(unsigned int index, const VectorType & v) const;
+
+  /** Return y'y, of y at the given index. */
+  double
+  GetSquaredMagnitudeOfY(unsigned int index) const;
+
+  /** v += factor * s, or v += factor * y, of s or y at the given index. */
+  void
+  AddScaledS(unsigned int index, double factor, VectorType & v) const;
+
+  void
+  AddScaledY(unsigned int index, double factor, VectorType & v) const;
+
+  /** Return the number of bytes taken by the stored vectors. */
+  SizeValueType
+  GetNumberOfBytes() const;
+
+  /** Return the inner product of two vectors, computed in the same way as the
+   * inner products with the stored vectors. */
+  static double
+  InnerProduct(const VectorType & a, const VectorType & b);
+
+protected:
+  LBFGSHistory() = default;
+  ~LBFGSHistory() override = default;
+
+  /** PrintSelf. */
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** Throws an exception if v does not have NumberOfParameters elements. */
+  void
+  CheckVectorSize(const VectorType & v) const;
+
+  bool          m_UseSinglePrecision{ false };
+  bool          m_IsSinglePrecision{ false };
+  unsigned int  m_Memory{ 0 };
+  SizeValueType m_NumberOfParameters{ 0 };
+
+  /** Only the vectors of the used precision are allocated. */
+  std::vector<std::vector<double>> m_DoubleS;
+  std::vector<std::vector<double>> m_DoubleY;
+  std::vector<std::vector<float>>  m_FloatS;
+  std::vector<std::vector<float>>  m_FloatY;
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkLBFGSHistory_h
@@ -46,6 +46,8 @@
 #include "itkNumericTraits.h"
 #include "itkDataObjectDecorator.h"
 
+#include <vector>
+
 namespace itk
 {
 
@@ -91,6 +93,25 @@ namespace itk
  * This class is templated over the fixed image type and the moving image
  * type.
  *
+ * ---------------------------
+ *
+ * Multi-start registration:
+ *
+ * When MultiStartTransformParameters are set, the registration starts from
+ * each of these parameters, in addition to the InitialTransformParameters.
+ * At each resolution level, the optimizer is run from every active start.
+ * The starts share the images and the pyramids. After all runs, their results
+ * are ranked by their metric value, evaluated on one and the same sample set.
+ * Only the best MultiStartSurvivalFraction of the starts (at least one) remain
+ * active for the next level. With the default fraction of zero, only the best
+ * start survives the first level. The result of the best start is the result
+ * of the level: the optimizer is not run again. Instead, an EndEvent is invoked
+ * on the optimizer, to notify its observers that the level is optimized.
+ * During the runs of the starts, GetIsOptimizingMultiStarts() returns true, so
+ * that observers of the optimizer can ignore their events. The starts are
+ * optimized one after the other, because the metric and the transform have a
+ * single state.
+ *
  * \sa ImageRegistrationMethod
  * \ingroup RegistrationFilters
  */
@@ -160,6 +181,11 @@ public:
   /** Smart Pointer type to a DataObject. */
   using DataObjectPointer = typename DataObject::Pointer;
 
+  /** Types for the multi-start registration. */
+  using ParametersContainerType = std::vector<ParametersType>;
+  using MeasureType = typename MetricType::MeasureType;
+  using MeasureContainerType = std::vector<MeasureType>;
+
   /** Method that initiates the registration. */
   virtual void
   StartRegistration();
@@ -227,6 +253,49 @@ public:
    */
   itkGetConstReferenceMacro(LastTransformParameters, ParametersType);
 
+  /** Set/Get the transformation parameters of the additional starts of a
+   * multi-start registration. Empty by default, which disables multi-start.
+   */
+  void
+  SetMultiStartTransformParameters(const ParametersContainerType & parameters)
+  {
+    this->m_MultiStartTransformParameters = parameters;
+    this->Modified();
+  }
+
+  const ParametersContainerType &
+  GetMultiStartTransformParameters() const
+  {
+    return this->m_MultiStartTransformParameters;
+  }
+
+  /** Set/Get the fraction of the starts that remains active after each
+   * resolution level. At least one start remains active. Default: 0.
+   */
+  itkSetClampMacro(MultiStartSurvivalFraction, double, 0.0, 1.0);
+  itkGetConstMacro(MultiStartSurvivalFraction, double);
+
+  /** Get whether the optimizer is running from one of the starts of a
+   * multi-start registration, before it continues from the best one.
+   */
+  itkGetConstMacro(IsOptimizingMultiStarts, bool);
+
+  /** Get the metric values of the starts that were optimized at the current
+   * level, sorted from best to worst. Empty if no starts were optimized.
+   */
+  const MeasureContainerType &
+  GetMultiStartValues() const
+  {
+    return this->m_MultiStartValues;
+  }
+
+  /** Get the number of starts that remain active for the next level. */
+  SizeValueType
+  GetNumberOfActiveMultiStarts() const
+  {
+    return this->m_MultiStartPositions.size();
+  }
+
   /** Returns the transform resulting from the registration process. */
   const TransformOutputType *
   GetOutput() const;
@@ -271,6 +340,16 @@ protected:
   virtual void
   PreparePyramids();
 
+  /** Optimize the active starts of a multi-start registration at the
+   * current level, and keep the best ones. The result of the best start is
+   * stored in m_LastTransformParameters and set to the transform, after which
+   * an EndEvent is invoked on the optimizer. Returns false, without doing
+   * anything, when there is only one start: then the optimizer should still
+   * be run. Should be called after Initialize(), at each level.
+   */
+  virtual bool
+  OptimizeMultiStarts();
+
   /** Set the current level to be processed. */
   itkSetMacro(CurrentLevel, unsigned long);
 
@@ -301,6 +380,12 @@ private:
 
   unsigned long m_NumberOfLevels;
   unsigned long m_CurrentLevel;
+
+  ParametersContainerType m_MultiStartTransformParameters;
+  ParametersContainerType m_MultiStartPositions;
+  MeasureContainerType    m_MultiStartValues;
+  double                  m_MultiStartSurvivalFraction{ 0.0 };
+  bool                    m_IsOptimizingMultiStarts{ false };
 };
 
 } // end namespace itk
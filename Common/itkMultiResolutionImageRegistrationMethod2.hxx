@@ -44,6 +44,10 @@
 #include "itkContinuousIndex.h"
 #include <vnl/vnl_math.h>
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
 namespace itk
 {
 
@@ -321,23 +325,28 @@ MultiResolutionImageRegistrationMethod2<TFixedImage, TMovingImage>::StartRegistr
         throw;
       }
 
-      try
-      {
-        // do the optimization
-        this->m_Optimizer->StartOptimization();
-      }
-      catch (const ExceptionObject &)
+      // run the optimizer from each start of a multi-start registration, and
+      // keep the result of the best one, or else run it in the usual way
+      if (!this->OptimizeMultiStarts())
       {
-        // An error has occurred in the optimization.
-        // Update the parameters
+        try
+        {
+          // do the optimization
+          this->m_Optimizer->StartOptimization();
+        }
+        catch (const ExceptionObject &)
+        {
+          // An error has occurred in the optimization.
+          // Update the parameters
+          this->m_LastTransformParameters = this->m_Optimizer->GetCurrentPosition();
+
+          // Pass exception to caller
+          throw;
+        }
+
+        // get the results
         this->m_LastTransformParameters = this->m_Optimizer->GetCurrentPosition();
-
-        // Pass exception to caller
-        throw;
       }
-
-      // get the results
-      this->m_LastTransformParameters = this->m_Optimizer->GetCurrentPosition();
       this->m_Transform->SetParameters(this->m_LastTransformParameters);
 
       // setup the initial parameters for next level
@@ -351,6 +360,113 @@ MultiResolutionImageRegistrationMethod2<TFixedImage, TMovingImage>::StartRegistr
 } // end StartRegistration()
 
 
+/*
+ * Optimize the starts of a multi-start registration
+ */
+template <typename TFixedImage, typename TMovingImage>
+bool
+MultiResolutionImageRegistrationMethod2<TFixedImage, TMovingImage>::OptimizeMultiStarts()
+{
+  // The first start is the one that the optimizer would normally start from.
+  if (this->m_CurrentLevel == 0)
+  {
+    this->m_MultiStartPositions.assign(1, this->m_InitialTransformParametersOfNextLevel);
+    this->m_MultiStartPositions.insert(this->m_MultiStartPositions.end(),
+                                       this->m_MultiStartTransformParameters.begin(),
+                                       this->m_MultiStartTransformParameters.end());
+  }
+  else if (!this->m_MultiStartPositions.empty())
+  {
+    this->m_MultiStartPositions.front() = this->m_InitialTransformParametersOfNextLevel;
+  }
+
+  this->m_MultiStartValues.clear();
+  const std::size_t numberOfStarts = this->m_MultiStartPositions.size();
+  if (numberOfStarts <= 1)
+  {
+    return false;
+  }
+
+  // Optimize from each start. The flag is also reset when an exception other
+  // than an ExceptionObject leaves the loop.
+  std::vector<bool> succeeded(numberOfStarts, false);
+  {
+    struct IsOptimizingMultiStartsGuard
+    {
+      bool & m_IsOptimizingMultiStarts;
+      ~IsOptimizingMultiStartsGuard() { m_IsOptimizingMultiStarts = false; }
+    };
+    this->m_IsOptimizingMultiStarts = true;
+    const IsOptimizingMultiStartsGuard guard{ this->m_IsOptimizingMultiStarts };
+
+    for (std::size_t i = 0; i < numberOfStarts; ++i)
+    {
+      try
+      {
+        this->m_Optimizer->SetInitialPosition(this->m_MultiStartPositions[i]);
+        this->m_Optimizer->StartOptimization();
+        this->m_MultiStartPositions[i] = this->m_Optimizer->GetCurrentPosition();
+        succeeded[i] = true;
+      }
+      catch (const ExceptionObject &)
+      {
+        // A start that fails is ranked last.
+      }
+    }
+  }
+
+  // Score the results after all runs, so that they are evaluated on the same
+  // samples: the optimizer may have selected new samples during each run.
+  MeasureContainerType values(numberOfStarts, NumericTraits<MeasureType>::max());
+  for (std::size_t i = 0; i < numberOfStarts; ++i)
+  {
+    if (succeeded[i])
+    {
+      try
+      {
+        values[i] = this->m_Metric->GetValue(this->m_MultiStartPositions[i]);
+      }
+      catch (const ExceptionObject &)
+      {
+        // A result that cannot be evaluated is ranked last.
+      }
+    }
+  }
+
+  // Rank the starts, and keep the best ones.
+  std::vector<std::size_t> order(numberOfStarts);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(
+    order.begin(), order.end(), [&values](std::size_t a, std::size_t b) { return values[a] < values[b]; });
+  if (!(values[order.front()] < NumericTraits<MeasureType>::max()))
+  {
+    itkExceptionMacro(<< "The optimization failed for all " << numberOfStarts
+                      << " starts of the multi-start registration");
+  }
+
+  const std::size_t numberOfSurvivors = std::max<std::size_t>(
+    1, static_cast<std::size_t>(std::ceil(this->m_MultiStartSurvivalFraction * numberOfStarts)));
+  ParametersContainerType survivors;
+  for (const std::size_t i : order)
+  {
+    this->m_MultiStartValues.push_back(values[i]);
+    if (survivors.size() < numberOfSurvivors && values[i] < NumericTraits<MeasureType>::max())
+    {
+      survivors.push_back(this->m_MultiStartPositions[i]);
+    }
+  }
+  this->m_MultiStartPositions.swap(survivors);
+
+  // The best result is the result of this level. The observers of the
+  // optimizer are notified that the optimization of this level has ended.
+  this->m_LastTransformParameters = this->m_MultiStartPositions.front();
+  this->m_Transform->SetParameters(this->m_LastTransformParameters);
+  this->m_Optimizer->InvokeEvent(EndEvent());
+  return true;
+
+} // end OptimizeMultiStarts()
+
+
 /*
  * PrintSelf
  */
@@ -375,6 +491,10 @@ MultiResolutionImageRegistrationMethod2<TFixedImage, TMovingImage>::PrintSelf(st
   os << indent << "InitialTransformParametersOfNextLevel: " << this->m_InitialTransformParametersOfNextLevel
      << std::endl;
   os << indent << "LastTransformParameters: " << this->m_LastTransformParameters << std::endl;
+  os << indent << "NumberOfMultiStartTransformParameters: " << this->m_MultiStartTransformParameters.size()
+     << std::endl;
+  os << indent << "MultiStartSurvivalFraction: " << this->m_MultiStartSurvivalFraction << std::endl;
+  os << indent << "NumberOfActiveMultiStarts: " << this->m_MultiStartPositions.size() << std::endl;
   os << indent << "FixedImageRegion: " << this->m_FixedImageRegion << std::endl;
 
   for (unsigned int level = 0; level < this->m_FixedImageRegionPyramid.size(); ++level)
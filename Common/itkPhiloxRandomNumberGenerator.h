@@ -0,0 +1,141 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkPhiloxRandomNumberGenerator_h
+#define itkPhiloxRandomNumberGenerator_h
+
+#include <array>
+#include <cstdint>
+
+namespace itk
+{
+
+/** \class PhiloxRandomNumberGenerator
+ *
+ * \brief A counter-based random number generator: Philox4x32-10.
+ *
+ * A sequential generator, like the Mersenne Twister, has a state that is
+ * updated by every draw, so the random numbers have to be drawn one after
+ * the other. A counter-based generator computes the random numbers as a pure
+ * function of a key and a counter. Here, the key is derived from a seed, and
+ * the counter from a stream (for example the iteration number) and an index
+ * (for example the sample number). Any thread can therefore generate the
+ * random numbers of any sample, and the result does not depend on the number
+ * of threads, or on the order of evaluation.
+ *
+ * The algorithm is described in:
+ * J.K. Salmon, M.A. Moraes, R.O. Dror and D.E. Shaw,
+ * "Parallel random numbers: as easy as 1, 2, 3",
+ * Proceedings of the International Conference for High Performance Computing,
+ * Networking, Storage and Analysis (SC11), 2011.
+ *
+ * \ingroup Common
+ */
+
+class PhiloxRandomNumberGenerator
+{
+public:
+  using CounterType = std::array<std::uint32_t, 4>;
+  using KeyType = std::array<std::uint32_t, 2>;
+
+  /** Constructor. The key is derived from the seed. */
+  explicit PhiloxRandomNumberGenerator(const std::uint64_t seed = 0)
+    : m_Key{ { static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32) } }
+  {}
+
+  /** Get the key. */
+  const KeyType &
+  GetKey() const
+  {
+    return m_Key;
+  }
+
+
+  /** Compute the four random words of a counter, for the given key. */
+  static CounterType
+  Generate(CounterType counter, KeyType key)
+  {
+    for (unsigned int round = 0; round < NumberOfRounds; ++round)
+    {
+      if (round > 0)
+      {
+        key[0] += 0x9E3779B9u;
+        key[1] += 0xBB67AE85u;
+      }
+      const std::uint64_t product0 = std::uint64_t{ 0xD2511F53u } * counter[0];
+      const std::uint64_t product1 = std::uint64_t{ 0xCD9E8D57u } * counter[2];
+      counter = { { static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                    static_cast<std::uint32_t>(product1),
+                    static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                    static_cast<std::uint32_t>(product0) } };
+    }
+    return counter;
+  }
+
+
+  /** Get numberOfValues uniform variates in [0, 1), with 53 random bits each,
+   * for the given stream and index. Each group of two values takes one call
+   * to Generate().
+   */
+  void
+  GetUniformVariates(const std::uint32_t stream,
+                     const std::uint64_t index,
+                     double * const      values,
+                     const unsigned int  numberOfValues) const
+  {
+    for (unsigned int block = 0; 2 * block < numberOfValues; ++block)
+    {
+      const CounterType counter{
+        { static_cast<std::uint32_t>(index), static_cast<std::uint32_t>(index >> 32), stream, block }
+      };
+      const CounterType random = Generate(counter, m_Key);
+      values[2 * block] = ToUniform(random[0], random[1]);
+      if (2 * block + 1 < numberOfValues)
+      {
+        values[2 * block + 1] = ToUniform(random[2], random[3]);
+      }
+    }
+  }
+
+
+  /** Get a single uniform variate in [0, 1), for the given stream and index. */
+  double
+  GetUniformVariate(const std::uint32_t stream, const std::uint64_t index) const
+  {
+    double value;
+    this->GetUniformVariates(stream, index, &value, 1);
+    return value;
+  }
+
+
+  /** Convert two random words to a double in [0, 1), using the upper 53 bits. */
+  static double
+  ToUniform(const std::uint32_t high, const std::uint32_t low)
+  {
+    const std::uint64_t bits = ((std::uint64_t{ high } << 32) | low) >> 11;
+    return static_cast<double>(bits) * (1.0 / 9007199254740992.0);
+  }
+
+private:
+  static constexpr unsigned int NumberOfRounds = 10;
+
+  KeyType m_Key;
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkPhiloxRandomNumberGenerator_h
@@ -17,6 +17,7 @@
  *=========================================================================*/
 
 #include "itkScaledSingleValuedNonLinearOptimizer.h"
+#include "itkConcurrentCostFunctionEvaluator.h"
 
 namespace itk
 {
@@ -99,6 +100,31 @@ ScaledSingleValuedNonLinearOptimizer::GetScaledValue(const ParametersType & para
 } // end GetScaledValue()
 
 
+/**
+ * ********************* GetScaledValues *****************************
+ */
+
+void
+ScaledSingleValuedNonLinearOptimizer::GetScaledValues(const std::vector<ParametersType> & parameters,
+                                                      std::vector<MeasureType> &          values,
+                                                      std::vector<std::exception_ptr> &   exceptions) const
+{
+  /** The scaled wrappers of the concurrent cost functions use the same settings
+   * as the scaled cost function. */
+  ConcurrentCostFunctionEvaluator::CostFunctionContainerType costFunctions{ this->m_ScaledCostFunction.GetPointer() };
+  for (const auto & scaledCostFunction : this->m_ConcurrentScaledCostFunctions)
+  {
+    scaledCostFunction->SetScales(this->m_ScaledCostFunction->GetScales());
+    scaledCostFunction->SetUseScales(this->m_ScaledCostFunction->GetUseScales());
+    scaledCostFunction->SetNegateCostFunction(this->m_ScaledCostFunction->GetNegateCostFunction());
+    costFunctions.push_back(scaledCostFunction.GetPointer());
+  }
+
+  ConcurrentCostFunctionEvaluator::GetValues(costFunctions, parameters, values, exceptions);
+
+} // end GetScaledValues()
+
+
 /**
  * ********************* GetScaledDerivative *****************************
  */
@@ -211,6 +237,28 @@ ScaledSingleValuedNonLinearOptimizer::SetMaximize(bool _arg)
 } // end SetMaximize()
 
 
+/**
+ * ******************** SetConcurrentCostFunctions ********************
+ */
+
+void
+ScaledSingleValuedNonLinearOptimizer::SetConcurrentCostFunctions(const CostFunctionContainerType & costFunctions)
+{
+  this->m_ConcurrentCostFunctions = costFunctions;
+
+  /** Wrap each concurrent cost function in its own scaled cost function. */
+  this->m_ConcurrentScaledCostFunctions.clear();
+  for (const auto & costFunction : costFunctions)
+  {
+    const auto scaledCostFunction = ScaledCostFunctionType::New();
+    scaledCostFunction->SetUnscaledCostFunction(costFunction);
+    this->m_ConcurrentScaledCostFunctions.push_back(scaledCostFunction);
+  }
+  this->Modified();
+
+} // end SetConcurrentCostFunctions()
+
+
 /**
  * ******************** PrintSelf *******************************
  */
@@ -225,6 +273,7 @@ ScaledSingleValuedNonLinearOptimizer::PrintSelf(std::ostream & os, Indent indent
   os << indent << "UnscaledCurrentPosition: " << this->m_UnscaledCurrentPosition << std::endl;
   os << indent << "ScaledCostFunction: " << this->m_ScaledCostFunction.GetPointer() << std::endl;
   os << indent << "Maximize: " << (this->m_Maximize ? "true" : "false") << std::endl;
+  os << indent << "NumberOfConcurrentCostFunctions: " << this->m_ConcurrentCostFunctions.size() << std::endl;
 
 } // end PrintSelf()
 
@@ -21,6 +21,9 @@
 #include "itkSingleValuedNonLinearOptimizer.h"
 #include "itkScaledSingleValuedCostFunction.h"
 
+#include <exception>
+#include <vector>
+
 namespace itk
 {
 /** \class ScaledSingleValuedNonLinearOptimizer
@@ -85,6 +88,8 @@ public:
   using ScalesType = NonLinearOptimizer::ScalesType;
   using ScaledCostFunctionType = ScaledSingleValuedCostFunction;
   using ScaledCostFunctionPointer = ScaledCostFunctionType::Pointer;
+  using CostFunctionPointer = CostFunctionType::Pointer;
+  using CostFunctionContainerType = std::vector<CostFunctionPointer>;
 
   /** Configure the scaled cost function. This function
    * sets the current scales in the ScaledCostFunction.
@@ -131,6 +136,19 @@ public:
 
   itkGetConstMacro(Maximize, bool);
 
+  /** Set/Get the concurrent cost functions, see ConcurrentCostFunctionEvaluator.
+   * Optimizers that evaluate several positions at once, with GetScaledValues(),
+   * evaluate them in parallel when these are set. Empty by default.
+   */
+  virtual void
+  SetConcurrentCostFunctions(const CostFunctionContainerType & costFunctions);
+
+  const CostFunctionContainerType &
+  GetConcurrentCostFunctions() const
+  {
+    return this->m_ConcurrentCostFunctions;
+  }
+
 protected:
   /** The constructor. */
   ScaledSingleValuedNonLinearOptimizer();
@@ -169,6 +187,16 @@ protected:
   virtual MeasureType
   GetScaledValue(const ParametersType & parameters) const;
 
+  /** Call GetScaledValue for a number of (scaled) positions, in parallel when
+   * concurrent cost functions are set. An exception thrown by the evaluation of
+   * a position is not passed to the caller, but stored in the corresponding
+   * element of exceptions, which is empty for positions that succeeded.
+   */
+  virtual void
+  GetScaledValues(const std::vector<ParametersType> & parameters,
+                  std::vector<MeasureType> &          values,
+                  std::vector<std::exception_ptr> &   exceptions) const;
+
   /** Divide the (scaled) parameters by the scales, call the GetDerivative routine
    * of the unscaled cost function and divide the resulting derivative by
    * the scales.
@@ -189,6 +217,10 @@ private:
    */
   mutable ParametersType m_UnscaledCurrentPosition;
   bool                   m_Maximize;
+
+  /** The concurrent cost functions, and their scaled wrappers. */
+  CostFunctionContainerType              m_ConcurrentCostFunctions;
+  std::vector<ScaledCostFunctionPointer> m_ConcurrentScaledCostFunctions;
 };
 
 } // end namespace itk
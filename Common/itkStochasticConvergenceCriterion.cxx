@@ -0,0 +1,175 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkStochasticConvergenceCriterion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace itk
+{
+
+/**
+ * ********************* Initialize *****************************
+ */
+
+void
+StochasticConvergenceCriterion::Initialize()
+{
+  this->m_Values.clear();
+  this->m_SignChanges.clear();
+  this->m_PreviousGradient.SetSize(0);
+  this->m_StopReason.clear();
+
+} // end Initialize()
+
+
+/**
+ * ********************* Update *****************************
+ */
+
+bool
+StochasticConvergenceCriterion::Update(const double value, const DerivativeType & gradient)
+{
+  /** Add the value, and the sign of the inner product of this and the previous gradient. */
+  this->m_Values.push_back(value);
+  if (this->m_Values.size() > this->m_WindowSize)
+  {
+    this->m_Values.pop_front();
+  }
+  if (this->m_PreviousGradient.GetSize() == gradient.GetSize())
+  {
+    this->m_SignChanges.push_back(inner_product(gradient, this->m_PreviousGradient) < 0.0);
+    if (this->m_SignChanges.size() > this->m_WindowSize)
+    {
+      this->m_SignChanges.pop_front();
+    }
+  }
+  this->m_PreviousGradient = gradient;
+
+  /** Only test a full window. */
+  if (this->m_SignChanges.size() < this->m_WindowSize)
+  {
+    return false;
+  }
+
+  /** The gradient directions must be dominated by noise. */
+  const double signChangeRatio = this->GetSignChangeRatio();
+  if (signChangeRatio < this->m_MinimumSignChangeRatio)
+  {
+    return false;
+  }
+
+  /** The values must not decrease significantly. */
+  double slope = 0.0;
+  double standardError = 0.0;
+  this->GetValueSlope(slope, standardError);
+  if (slope <= -this->m_ZScore * standardError)
+  {
+    return false;
+  }
+
+  std::ostringstream reason;
+  reason << "Convergence detected: over the last " << this->m_WindowSize << " iterations, the sign-change ratio is "
+         << signChangeRatio << " and the slope of the metric value is " << slope << " (standard error "
+         << standardError << ")";
+  this->m_StopReason = reason.str();
+  return true;
+
+} // end Update()
+
+
+/**
+ * ********************* GetSignChangeRatio *****************************
+ */
+
+double
+StochasticConvergenceCriterion::GetSignChangeRatio() const
+{
+  if (this->m_SignChanges.empty())
+  {
+    return 0.0;
+  }
+  const auto numberOfSignChanges = std::count(this->m_SignChanges.begin(), this->m_SignChanges.end(), true);
+  return static_cast<double>(numberOfSignChanges) / static_cast<double>(this->m_SignChanges.size());
+
+} // end GetSignChangeRatio()
+
+
+/**
+ * ********************* GetValueSlope *****************************
+ */
+
+void
+StochasticConvergenceCriterion::GetValueSlope(double & slope, double & standardError) const
+{
+  slope = 0.0;
+  standardError = 0.0;
+  const std::size_t n = this->m_Values.size();
+  if (n < 3)
+  {
+    return;
+  }
+
+  /** Least squares fit of value = intercept + slope * i, for i = 0, ..., n - 1. */
+  const double meanIndex = 0.5 * (n - 1);
+  double       meanValue = 0.0;
+  for (const double value : this->m_Values)
+  {
+    meanValue += value;
+  }
+  meanValue /= n;
+
+  double sumOfSquaredIndexDeviations = 0.0;
+  double sumOfCrossDeviations = 0.0;
+  double sumOfSquaredValueDeviations = 0.0;
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    const double indexDeviation = i - meanIndex;
+    const double valueDeviation = this->m_Values[i] - meanValue;
+    sumOfSquaredIndexDeviations += indexDeviation * indexDeviation;
+    sumOfCrossDeviations += indexDeviation * valueDeviation;
+    sumOfSquaredValueDeviations += valueDeviation * valueDeviation;
+  }
+  slope = sumOfCrossDeviations / sumOfSquaredIndexDeviations;
+
+  const double residualVariance =
+    std::max(0.0, sumOfSquaredValueDeviations - slope * sumOfCrossDeviations) / static_cast<double>(n - 2);
+  standardError = std::sqrt(residualVariance / sumOfSquaredIndexDeviations);
+
+} // end GetValueSlope()
+
+
+/**
+ * ********************* PrintSelf *****************************
+ */
+
+void
+StochasticConvergenceCriterion::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "WindowSize: " << this->m_WindowSize << std::endl;
+  os << indent << "MinimumSignChangeRatio: " << this->m_MinimumSignChangeRatio << std::endl;
+  os << indent << "ZScore: " << this->m_ZScore << std::endl;
+  os << indent << "StopReason: " << this->m_StopReason << std::endl;
+
+} // end PrintSelf()
+
+
+} // end namespace itk
@@ -0,0 +1,125 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkStochasticConvergenceCriterion_h
+#define itkStochasticConvergenceCriterion_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkArray.h"
+
+#include <deque>
+#include <string>
+
+namespace itk
+{
+
+/** \class StochasticConvergenceCriterion
+ *
+ * \brief Detects the convergence of a stochastic optimizer from windowed statistics.
+ *
+ * The value and gradient of a stochastic optimizer are noisy, so the usual tests on
+ * the change of the value or the magnitude of the gradient do not work. Instead, this
+ * criterion keeps the values and gradient signs of the last WindowSize iterations,
+ * and reports convergence when, over this window, both:
+ * \li the inner product of consecutive gradients is negative in at least a fraction
+ *   MinimumSignChangeRatio of the iterations. Far from the optimum, consecutive
+ *   gradients point in the same direction; near the optimum, the noise dominates and
+ *   their directions are random. This is the quantity that drives the adaptive time
+ *   of the AdaptiveStochasticGradientDescentOptimizer.
+ * \li the slope of the least squares line through the values does not show a
+ *   significant decrease: slope > -ZScore * standardError(slope).
+ *
+ * Subclasses may implement other tests, by overriding Update().
+ *
+ * \ingroup Optimizers
+ */
+
+class StochasticConvergenceCriterion : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(StochasticConvergenceCriterion);
+
+  /** Standard ITK.*/
+  using Self = StochasticConvergenceCriterion;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(StochasticConvergenceCriterion, Object);
+
+  using DerivativeType = Array<double>;
+
+  /** Set/Get the number of iterations over which the statistics are computed. Default: 100. */
+  itkSetClampMacro(WindowSize, unsigned int, 3, NumericTraits<unsigned int>::max());
+  itkGetConstMacro(WindowSize, unsigned int);
+
+  /** Set/Get the minimum fraction of sign changes of the gradient inner product. Default: 0.4. */
+  itkSetMacro(MinimumSignChangeRatio, double);
+  itkGetConstMacro(MinimumSignChangeRatio, double);
+
+  /** Set/Get the number of standard errors by which the slope of the values must be
+   * negative, for the decrease to be significant. Default: 2.0. */
+  itkSetMacro(ZScore, double);
+  itkGetConstMacro(ZScore, double);
+
+  /** Forget the statistics of previous iterations. */
+  virtual void
+  Initialize();
+
+  /** Add the value and gradient of an iteration. Returns true when convergence is detected. */
+  virtual bool
+  Update(double value, const DerivativeType & gradient);
+
+  /** Get the fraction of sign changes in the current window. */
+  double
+  GetSignChangeRatio() const;
+
+  /** Get the slope of the values in the current window, and its standard error. */
+  void
+  GetValueSlope(double & slope, double & standardError) const;
+
+  /** Get a description of why convergence was detected. Empty when not converged. */
+  itkGetStringMacro(StopReason);
+
+protected:
+  StochasticConvergenceCriterion() = default;
+  ~StochasticConvergenceCriterion() override = default;
+
+  /** PrintSelf. */
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  std::string m_StopReason;
+
+private:
+  unsigned int m_WindowSize{ 100 };
+  double       m_MinimumSignChangeRatio{ 0.4 };
+  double       m_ZScore{ 2.0 };
+
+  std::deque<double> m_Values;
+  std::deque<bool>   m_SignChanges;
+  DerivativeType     m_PreviousGradient;
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkStochasticConvergenceCriterion_h
@@ -0,0 +1,241 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTransformixBinaryPointFile.h"
+
+#include <cstring> // For memcmp and memcpy.
+
+#ifdef _WIN32
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace itk
+{
+
+namespace
+{
+/** The first eight bytes of a binary point file. */
+constexpr char magic[8] = { 'E', 'L', 'X', 'P', 'N', 'T', 'S', '\0' };
+} // namespace
+
+
+/**
+ * ****************** Destructor *********************************
+ */
+
+TransformixBinaryPointFile::~TransformixBinaryPointFile()
+{
+  this->Close();
+
+} // end Destructor
+
+
+/**
+ * ****************** IsBinaryPointFile *********************************
+ */
+
+bool
+TransformixBinaryPointFile::IsBinaryPointFile(const std::string & fileName)
+{
+  std::ifstream file(fileName, std::ios::binary);
+  char          firstBytes[sizeof(magic)]{};
+  file.read(firstBytes, sizeof(magic));
+  return file && std::memcmp(firstBytes, magic, sizeof(magic)) == 0;
+
+} // end IsBinaryPointFile()
+
+
+/**
+ * ****************** Open *********************************
+ */
+
+void
+TransformixBinaryPointFile::Open(const std::string & fileName)
+{
+  this->Close();
+  this->m_FileName = fileName;
+
+  /** Map the whole file, read-only. */
+#ifdef _WIN32
+  const HANDLE fileHandle = CreateFileA(
+    fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (fileHandle == INVALID_HANDLE_VALUE)
+  {
+    itkExceptionMacro(<< "Cannot open the binary point file: " << fileName);
+  }
+  this->m_FileHandle = fileHandle;
+  LARGE_INTEGER fileSize;
+  GetFileSizeEx(fileHandle, &fileSize);
+  this->m_MappedSize = static_cast<std::size_t>(fileSize.QuadPart);
+  if (this->m_MappedSize >= HeaderSize)
+  {
+    this->m_MappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (this->m_MappingHandle != nullptr)
+    {
+      this->m_MappedData = MapViewOfFile(this->m_MappingHandle, FILE_MAP_READ, 0, 0, 0);
+    }
+  }
+#else
+  const int fileDescriptor = open(fileName.c_str(), O_RDONLY);
+  if (fileDescriptor < 0)
+  {
+    itkExceptionMacro(<< "Cannot open the binary point file: " << fileName);
+  }
+  struct stat fileStatus = {};
+  if (fstat(fileDescriptor, &fileStatus) == 0 && static_cast<std::size_t>(fileStatus.st_size) >= HeaderSize)
+  {
+    this->m_MappedSize = static_cast<std::size_t>(fileStatus.st_size);
+    void * const mappedData = mmap(nullptr, this->m_MappedSize, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    if (mappedData != MAP_FAILED)
+    {
+      this->m_MappedData = mappedData;
+      madvise(mappedData, this->m_MappedSize, MADV_SEQUENTIAL);
+    }
+  }
+  /** The mapping stays valid after closing the file descriptor. */
+  close(fileDescriptor);
+#endif
+
+  if (this->m_MappedData == nullptr)
+  {
+    this->Close();
+    itkExceptionMacro(<< "Cannot map the binary point file: " << fileName);
+  }
+
+  /** Read the header. */
+  const auto * const bytes = static_cast<const char *>(this->m_MappedData);
+  std::uint32_t      dimension = 0;
+  std::uint32_t      componentSize = 0;
+  std::uint32_t      pointsAreIndices = 0;
+  std::uint64_t      numberOfPoints = 0;
+  std::memcpy(&dimension, bytes + 8, sizeof(dimension));
+  std::memcpy(&componentSize, bytes + 12, sizeof(componentSize));
+  std::memcpy(&pointsAreIndices, bytes + 16, sizeof(pointsAreIndices));
+  std::memcpy(&numberOfPoints, bytes + 24, sizeof(numberOfPoints));
+
+  const bool validHeader = std::memcmp(bytes, magic, sizeof(magic)) == 0 && dimension > 0 &&
+                           (componentSize == sizeof(float) || componentSize == sizeof(double));
+  if (!validHeader || (this->m_MappedSize - HeaderSize) / (std::size_t{ dimension } * componentSize) < numberOfPoints)
+  {
+    this->Close();
+    itkExceptionMacro(<< "The file is not a valid binary point file, or it is too small.\n"
+                      << "Filename: " << fileName);
+  }
+
+  this->m_Dimension = dimension;
+  this->m_ComponentSize = componentSize;
+  this->m_PointsAreIndices = pointsAreIndices != 0;
+  this->m_NumberOfPoints = static_cast<SizeValueType>(numberOfPoints);
+  this->m_Coordinates = bytes + HeaderSize;
+
+} // end Open()
+
+
+/**
+ * ****************** Close *********************************
+ */
+
+void
+TransformixBinaryPointFile::Close()
+{
+#ifdef _WIN32
+  if (this->m_MappedData != nullptr)
+  {
+    UnmapViewOfFile(this->m_MappedData);
+  }
+  if (this->m_MappingHandle != nullptr)
+  {
+    CloseHandle(this->m_MappingHandle);
+  }
+  if (this->m_FileHandle != nullptr)
+  {
+    CloseHandle(this->m_FileHandle);
+  }
+  this->m_MappingHandle = nullptr;
+  this->m_FileHandle = nullptr;
+#else
+  if (this->m_MappedData != nullptr)
+  {
+    munmap(this->m_MappedData, this->m_MappedSize);
+  }
+#endif
+
+  this->m_MappedData = nullptr;
+  this->m_MappedSize = 0;
+  this->m_Coordinates = nullptr;
+  this->m_Dimension = 0;
+  this->m_ComponentSize = 0;
+  this->m_PointsAreIndices = false;
+  this->m_NumberOfPoints = 0;
+
+} // end Close()
+
+
+/**
+ * ****************** WriteHeader *********************************
+ */
+
+void
+TransformixBinaryPointFile::WriteHeader(std::ostream &      os,
+                                        const unsigned int  dimension,
+                                        const unsigned int  componentSize,
+                                        const bool          pointsAreIndices,
+                                        const SizeValueType numberOfPoints)
+{
+  if (componentSize != sizeof(float) && componentSize != sizeof(double))
+  {
+    itkGenericExceptionMacro(<< "The number of bytes per coordinate should be 4 or 8, not " << componentSize);
+  }
+
+  char                header[HeaderSize]{};
+  const std::uint32_t fields[] = { dimension, componentSize, pointsAreIndices ? 1u : 0u, 0u };
+  const std::uint64_t numberOfPoints64 = numberOfPoints;
+  std::memcpy(header, magic, sizeof(magic));
+  std::memcpy(header + 8, fields, sizeof(fields));
+  std::memcpy(header + 24, &numberOfPoints64, sizeof(numberOfPoints64));
+  os.write(header, HeaderSize);
+
+} // end WriteHeader()
+
+
+/**
+ * ****************** PrintSelf *********************************
+ */
+
+void
+TransformixBinaryPointFile::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "FileName: " << this->m_FileName << std::endl;
+  os << indent << "Dimension: " << this->m_Dimension << std::endl;
+  os << indent << "ComponentSize: " << this->m_ComponentSize << std::endl;
+  os << indent << "PointsAreIndices: " << this->m_PointsAreIndices << std::endl;
+  os << indent << "NumberOfPoints: " << this->m_NumberOfPoints << std::endl;
+
+} // end PrintSelf()
+
+} // end namespace itk
@@ -0,0 +1,205 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkTransformixBinaryPointFile_h
+#define itkTransformixBinaryPointFile_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkIntTypes.h"
+
+#include <algorithm> // For min.
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+
+/** \class TransformixBinaryPointFile
+ *
+ * \brief Reads and writes point sets in the binary point file format of transformix.
+ *
+ * A text input point file has to be parsed number by number, which dominates the
+ * run time of transformix for point sets of millions of points. A binary point file
+ * consists of a header of 32 bytes, followed by the coordinates of the points, point
+ * by point, as float32 or float64, in the native byte order of the machine:
+ * \li bytes 0-7: the characters "ELXPNTS" followed by a zero byte;
+ * \li bytes 8-11: the dimension of the points, as uint32;
+ * \li bytes 12-15: the number of bytes per coordinate, 4 or 8, as uint32;
+ * \li bytes 16-19: 1 if the points are image indices, 0 if they are world coordinates, as uint32;
+ * \li bytes 20-23: reserved, 0;
+ * \li bytes 24-31: the number of points, as uint64.
+ *
+ * Open() maps the file in memory, so the coordinates are only paged in when they are
+ * accessed, and no copy of the point set is made. GetPoint() may be called by multiple
+ * threads at the same time.
+ *
+ * \ingroup Common
+ */
+
+class TransformixBinaryPointFile : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(TransformixBinaryPointFile);
+
+  /** Standard ITK.*/
+  using Self = TransformixBinaryPointFile;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(TransformixBinaryPointFile, Object);
+
+  /** The size of the header, in bytes. */
+  static constexpr std::size_t HeaderSize = 32;
+
+  /** Returns true if the file starts with the magic characters of a binary point file. */
+  static bool
+  IsBinaryPointFile(const std::string & fileName);
+
+  /** Map the file in memory, and read its header. Throws an exception when the file
+   * cannot be mapped, or is not a valid binary point file. */
+  void
+  Open(const std::string & fileName);
+
+  /** Unmap the file. Called by the destructor as well. */
+  void
+  Close();
+
+  /** Get the properties of the opened point set. */
+  itkGetConstMacro(Dimension, unsigned int);
+  itkGetConstMacro(ComponentSize, unsigned int);
+  itkGetConstMacro(PointsAreIndices, bool);
+  itkGetConstMacro(NumberOfPoints, SizeValueType);
+
+  /** Get coordinate dimensionIndex of point pointId. */
+  double
+  GetCoordinate(const SizeValueType pointId, const unsigned int dimensionIndex) const
+  {
+    const SizeValueType offset = pointId * this->m_Dimension + dimensionIndex;
+    if (this->m_ComponentSize == sizeof(float))
+    {
+      return static_cast<const float *>(this->m_Coordinates)[offset];
+    }
+    return static_cast<const double *>(this->m_Coordinates)[offset];
+  }
+
+  /** Get point pointId. The dimension of TPoint should equal GetDimension(). */
+  template <class TPoint>
+  void
+  GetPoint(const SizeValueType pointId, TPoint & point) const
+  {
+    for (unsigned int i = 0; i < TPoint::Dimension; ++i)
+    {
+      point[i] = static_cast<typename TPoint::ValueType>(this->GetCoordinate(pointId, i));
+    }
+  }
+
+  /** Write numberOfPoints points to a binary point file, with componentSize bytes per
+   * coordinate: sizeof(float) or sizeof(double). */
+  template <class TPoint>
+  static void
+  Write(const std::string & fileName,
+        const TPoint *      points,
+        const SizeValueType numberOfPoints,
+        const bool          pointsAreIndices,
+        const unsigned int  componentSize)
+  {
+    std::ofstream file(fileName, std::ios::binary);
+    Self::WriteHeader(file, TPoint::Dimension, componentSize, pointsAreIndices, numberOfPoints);
+
+    /** Convert and write the coordinates in blocks, to limit the extra memory. */
+    constexpr SizeValueType blockSize = 65536;
+    std::vector<float>      floatBuffer;
+    std::vector<double>     doubleBuffer;
+    for (SizeValueType blockBegin = 0; blockBegin < numberOfPoints; blockBegin += blockSize)
+    {
+      const SizeValueType blockEnd = std::min(blockBegin + blockSize, numberOfPoints);
+      floatBuffer.clear();
+      doubleBuffer.clear();
+      for (SizeValueType j = blockBegin; j < blockEnd; ++j)
+      {
+        for (unsigned int i = 0; i < TPoint::Dimension; ++i)
+        {
+          if (componentSize == sizeof(float))
+          {
+            floatBuffer.push_back(static_cast<float>(points[j][i]));
+          }
+          else
+          {
+            doubleBuffer.push_back(static_cast<double>(points[j][i]));
+          }
+        }
+      }
+      if (componentSize == sizeof(float))
+      {
+        file.write(reinterpret_cast<const char *>(floatBuffer.data()), floatBuffer.size() * sizeof(float));
+      }
+      else
+      {
+        file.write(reinterpret_cast<const char *>(doubleBuffer.data()), doubleBuffer.size() * sizeof(double));
+      }
+    }
+
+    if (!file)
+    {
+      itkGenericExceptionMacro(<< "Error while writing the binary point file: " << fileName);
+    }
+  }
+
+protected:
+  TransformixBinaryPointFile() = default;
+  ~TransformixBinaryPointFile() override;
+
+  /** PrintSelf. */
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** Write the header. Throws an exception when the componentSize is not supported. */
+  static void
+  WriteHeader(std::ostream &      os,
+              const unsigned int  dimension,
+              const unsigned int  componentSize,
+              const bool          pointsAreIndices,
+              const SizeValueType numberOfPoints);
+
+  std::string   m_FileName;
+  unsigned int  m_Dimension{ 0 };
+  unsigned int  m_ComponentSize{ 0 };
+  bool          m_PointsAreIndices{ false };
+  SizeValueType m_NumberOfPoints{ 0 };
+
+  /** The mapping of the file, and the start of the coordinates within it. */
+  void *       m_MappedData{ nullptr };
+  std::size_t  m_MappedSize{ 0 };
+  const void * m_Coordinates{ nullptr };
+#ifdef _WIN32
+  void * m_FileHandle{ nullptr };
+  void * m_MappingHandle{ nullptr };
+#endif
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkTransformixBinaryPointFile_h
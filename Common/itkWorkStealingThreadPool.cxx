@@ -0,0 +1,373 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkWorkStealingThreadPool.h"
+
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm> // For find, min and max.
+
+namespace itk
+{
+
+namespace
+{
+/** True for the worker threads of the pool, and for a calling thread while it
+ * executes its share of a job. Used to run nested ParallelFor calls serially. */
+thread_local bool insidePoolTask = false;
+} // namespace
+
+
+/**
+ * ****************** Constructor *********************************
+ */
+
+WorkStealingThreadPool::WorkStealingThreadPool()
+{
+  this->StartThreads(MultiThreaderBase::GetGlobalDefaultNumberOfThreads());
+
+} // end Constructor
+
+
+/**
+ * ****************** Destructor *********************************
+ */
+
+WorkStealingThreadPool::~WorkStealingThreadPool()
+{
+  this->StopThreads();
+
+} // end Destructor
+
+
+/**
+ * ****************** GetInstance *********************************
+ */
+
+WorkStealingThreadPool::Pointer
+WorkStealingThreadPool::GetInstance()
+{
+  static const Pointer instance = Self::New();
+  return instance;
+
+} // end GetInstance()
+
+
+/**
+ * ****************** SetNumberOfThreads *********************************
+ */
+
+void
+WorkStealingThreadPool::SetNumberOfThreads(ThreadIdType numberOfThreads)
+{
+  numberOfThreads = std::max<ThreadIdType>(numberOfThreads, 1);
+
+  /** Running jobs are finished by their callers, so they do not need to be waited for. */
+  const std::lock_guard<std::mutex> threadsLock(this->m_ThreadsMutex);
+  if (numberOfThreads != this->m_NumberOfThreads)
+  {
+    this->StopThreads();
+    this->StartThreads(numberOfThreads);
+    this->Modified();
+  }
+
+} // end SetNumberOfThreads()
+
+
+/**
+ * ****************** GetNumberOfThreads *********************************
+ */
+
+ThreadIdType
+WorkStealingThreadPool::GetNumberOfThreads() const
+{
+  return this->m_NumberOfThreads;
+
+} // end GetNumberOfThreads()
+
+
+/**
+ * ****************** StartThreads *********************************
+ */
+
+void
+WorkStealingThreadPool::StartThreads(ThreadIdType numberOfThreads)
+{
+  this->m_NumberOfThreads = numberOfThreads;
+
+  /** The calling thread of a job is its worker 0, so only create the others. */
+  this->m_Threads.reserve(numberOfThreads - 1);
+  for (ThreadIdType i = 1; i < numberOfThreads; ++i)
+  {
+    this->m_Threads.emplace_back(&Self::WorkerLoop, this);
+  }
+
+} // end StartThreads()
+
+
+/**
+ * ****************** StopThreads *********************************
+ */
+
+void
+WorkStealingThreadPool::StopThreads()
+{
+  {
+    const std::lock_guard<std::mutex> lock(this->m_Mutex);
+    this->m_Stop = true;
+  }
+  this->m_WorkAvailable.notify_all();
+
+  for (auto & thread : this->m_Threads)
+  {
+    thread.join();
+  }
+  this->m_Threads.clear();
+
+  const std::lock_guard<std::mutex> lock(this->m_Mutex);
+  this->m_Stop = false;
+
+} // end StopThreads()
+
+
+/**
+ * ****************** ParallelFor *********************************
+ */
+
+void
+WorkStealingThreadPool::ParallelFor(const SizeValueType       begin,
+                                    const SizeValueType       end,
+                                    SizeValueType             grainSize,
+                                    ThreadIdType              maximumNumberOfWorkers,
+                                    const RangeFunctionType & func)
+{
+  if (end <= begin)
+  {
+    return;
+  }
+  grainSize = std::max<SizeValueType>(grainSize, 1);
+  const SizeValueType rangeSize = end - begin;
+  const SizeValueType numberOfChunks = (rangeSize + grainSize - 1) / grainSize;
+  const auto          numberOfParticipants = static_cast<ThreadIdType>(
+    std::min<SizeValueType>(numberOfChunks, std::min<ThreadIdType>(maximumNumberOfWorkers, this->m_NumberOfThreads)));
+
+  /** Nested calls and tiny ranges are executed by the calling thread only. */
+  if (insidePoolTask || numberOfParticipants <= 1)
+  {
+    for (SizeValueType chunkBegin = begin; chunkBegin < end; chunkBegin += grainSize)
+    {
+      func(chunkBegin, std::min(chunkBegin + grainSize, end), 0);
+    }
+    return;
+  }
+
+  /** Give each participant an equal, contiguous part of the range. */
+  JobType job;
+  job.m_Function = &func;
+  job.m_GrainSize = grainSize;
+  job.m_NumberOfParticipants = numberOfParticipants;
+  job.m_WorkRanges.reset(new PaddedWorkRangeType[numberOfParticipants]);
+  for (ThreadIdType workerId = 0; workerId < numberOfParticipants; ++workerId)
+  {
+    PaddedWorkRangeType & workRange = job.m_WorkRanges[workerId];
+    workRange.m_Begin = begin + rangeSize * workerId / numberOfParticipants;
+    workRange.m_End = begin + rangeSize * (workerId + 1) / numberOfParticipants;
+  }
+
+  /** Offer the job to the idle pool threads. */
+  {
+    const std::lock_guard<std::mutex> lock(this->m_Mutex);
+    this->m_Jobs.push_back(&job);
+  }
+  this->m_WorkAvailable.notify_all();
+
+  /** The calling thread does its share as worker 0, and steals the parts of
+   * the participants that have not joined. */
+  insidePoolTask = true;
+  this->ProcessJob(job, 0);
+  insidePoolTask = false;
+
+  /** Withdraw the job, and wait for the pool threads that did join. */
+  {
+    std::unique_lock<std::mutex> lock(this->m_Mutex);
+    const auto                   found = std::find(this->m_Jobs.begin(), this->m_Jobs.end(), &job);
+    if (found != this->m_Jobs.end())
+    {
+      this->m_Jobs.erase(found);
+    }
+    this->m_WorkFinished.wait(lock, [&job] { return job.m_NumberOfBusyWorkers == 0; });
+  }
+
+  if (job.m_Exception != nullptr)
+  {
+    std::rethrow_exception(job.m_Exception);
+  }
+
+} // end ParallelFor()
+
+
+/**
+ * ****************** WorkerLoop *********************************
+ */
+
+void
+WorkStealingThreadPool::WorkerLoop()
+{
+  insidePoolTask = true;
+
+  while (true)
+  {
+    JobType *    job = nullptr;
+    ThreadIdType workerId = 0;
+    {
+      std::unique_lock<std::mutex> lock(this->m_Mutex);
+      this->m_WorkAvailable.wait(lock, [this] { return this->m_Stop || !this->m_Jobs.empty(); });
+      if (this->m_Stop)
+      {
+        return;
+      }
+
+      /** Join the oldest job, and withdraw it when all its participants have joined. */
+      job = this->m_Jobs.front();
+      workerId = job->m_NumberOfJoinedWorkers++;
+      ++job->m_NumberOfBusyWorkers;
+      if (job->m_NumberOfJoinedWorkers == job->m_NumberOfParticipants)
+      {
+        this->m_Jobs.pop_front();
+      }
+    }
+
+    this->ProcessJob(*job, workerId);
+
+    bool isLastWorker = false;
+    {
+      const std::lock_guard<std::mutex> lock(this->m_Mutex);
+      isLastWorker = (--job->m_NumberOfBusyWorkers == 0);
+    }
+    if (isLastWorker)
+    {
+      /** Several callers may be waiting, each for its own job. */
+      this->m_WorkFinished.notify_all();
+    }
+  }
+
+} // end WorkerLoop()
+
+
+/**
+ * ****************** ProcessJob *********************************
+ */
+
+void
+WorkStealingThreadPool::ProcessJob(JobType & job, const ThreadIdType workerId)
+{
+  SizeValueType chunkBegin = 0;
+  SizeValueType chunkEnd = 0;
+  try
+  {
+    while (Self::TakeChunk(job, workerId, chunkBegin, chunkEnd))
+    {
+      (*job.m_Function)(chunkBegin, chunkEnd, workerId);
+    }
+  }
+  catch (...)
+  {
+    const std::lock_guard<std::mutex> lock(this->m_Mutex);
+    if (job.m_Exception == nullptr)
+    {
+      job.m_Exception = std::current_exception();
+    }
+  }
+
+} // end ProcessJob()
+
+
+/**
+ * ****************** TakeChunk *********************************
+ */
+
+bool
+WorkStealingThreadPool::TakeChunk(JobType &          job,
+                                  const ThreadIdType workerId,
+                                  SizeValueType &    chunkBegin,
+                                  SizeValueType &    chunkEnd)
+{
+  PaddedWorkRangeType & ownRange = job.m_WorkRanges[workerId];
+
+  /** First try to take a chunk from the front of the own range. */
+  {
+    const std::lock_guard<std::mutex> lock(ownRange.m_Mutex);
+    if (ownRange.m_Begin < ownRange.m_End)
+    {
+      chunkBegin = ownRange.m_Begin;
+      chunkEnd = std::min(chunkBegin + job.m_GrainSize, ownRange.m_End);
+      ownRange.m_Begin = chunkEnd;
+      return true;
+    }
+  }
+
+  /** Otherwise steal the back half of the range of another worker. */
+  const ThreadIdType numberOfParticipants = job.m_NumberOfParticipants;
+  for (ThreadIdType i = 1; i < numberOfParticipants; ++i)
+  {
+    PaddedWorkRangeType & victimRange = job.m_WorkRanges[(workerId + i) % numberOfParticipants];
+
+    SizeValueType stolenBegin = 0;
+    SizeValueType stolenEnd = 0;
+    {
+      const std::lock_guard<std::mutex> lock(victimRange.m_Mutex);
+      if (victimRange.m_Begin >= victimRange.m_End)
+      {
+        continue;
+      }
+      const SizeValueType remaining = victimRange.m_End - victimRange.m_Begin;
+      stolenEnd = victimRange.m_End;
+      stolenBegin = (remaining <= job.m_GrainSize) ? victimRange.m_Begin : stolenEnd - remaining / 2;
+      victimRange.m_End = stolenBegin;
+    }
+
+    /** Process the first chunk of the stolen part, and make the rest stealable again. */
+    chunkBegin = stolenBegin;
+    chunkEnd = std::min(stolenBegin + job.m_GrainSize, stolenEnd);
+    {
+      const std::lock_guard<std::mutex> lock(ownRange.m_Mutex);
+      ownRange.m_Begin = chunkEnd;
+      ownRange.m_End = stolenEnd;
+    }
+    return true;
+  }
+
+  return false;
+
+} // end TakeChunk()
+
+
+/**
+ * ****************** PrintSelf *********************************
+ */
+
+void
+WorkStealingThreadPool::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfThreads: " << this->m_NumberOfThreads << std::endl;
+
+} // end PrintSelf()
+
+} // end namespace itk
@@ -0,0 +1,189 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkWorkStealingThreadPool_h
+#define itkWorkStealingThreadPool_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkIntTypes.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace itk
+{
+
+/** \class WorkStealingThreadPool
+ *
+ * \brief A persistent pool of worker threads with a work-stealing scheduler.
+ *
+ * The itk::PlatformMultiThreader creates and joins its threads on every call
+ * to SingleMethodExecute(). For metrics that are evaluated thousands of times
+ * per resolution on a small number of samples, this start-up and join cost
+ * becomes a considerable part of the total computation time. This pool keeps
+ * its threads alive between calls, and puts them to sleep when there is no work.
+ *
+ * ParallelFor() divides an index range [begin, end[ into one contiguous part
+ * per participating thread. Each thread processes its own part in chunks of
+ * GrainSize indices, starting at the front. A thread that runs out of work
+ * steals the back half of the remaining part of another thread, so that the
+ * load is balanced even when the cost per index varies.
+ *
+ * The calling thread always participates as worker 0. A ParallelFor() that is
+ * called from within a pool task is executed serially by the calling worker,
+ * so nested parallelism cannot dead-lock the pool.
+ *
+ * ParallelFor() calls from different threads, like independent registrations
+ * in one process, run concurrently. Each call is a separate job, with its own
+ * work ranges. An idle pool thread joins the oldest job that still has a free
+ * participant slot. A caller never waits for another job: it steals the parts
+ * that no pool thread has joined for, and only waits for the pool threads that
+ * did join its own job.
+ *
+ * Normally the single global instance, obtained by GetInstance(), is used.
+ *
+ * \ingroup Common
+ */
+
+class WorkStealingThreadPool : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(WorkStealingThreadPool);
+
+  /** Standard ITK-stuff. */
+  using Self = WorkStealingThreadPool;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(WorkStealingThreadPool, Object);
+
+  /** The function that is called for every chunk [begin, end[ of the range,
+   * together with the id of the worker that executes it. */
+  using RangeFunctionType = std::function<void(SizeValueType, SizeValueType, ThreadIdType)>;
+
+  /** Get the global pool, which is shared by all metrics. */
+  static Pointer
+  GetInstance();
+
+  /** Set/Get the number of threads, including the calling thread.
+   * The default is the global default number of threads of ITK.
+   * Changing this number restarts the worker threads.
+   */
+  void
+  SetNumberOfThreads(ThreadIdType numberOfThreads);
+
+  ThreadIdType
+  GetNumberOfThreads() const;
+
+  /** Execute func on the range [begin, end[, divided into chunks of at most
+   * grainSize indices, using at most maximumNumberOfWorkers threads. The worker
+   * id that is passed to func is smaller than maximumNumberOfWorkers, so callers
+   * may use it to index their own per-thread data. Blocks until all chunks have
+   * been processed. An exception thrown by one of the tasks is rethrown in the
+   * calling thread.
+   */
+  void
+  ParallelFor(SizeValueType             begin,
+              SizeValueType             end,
+              SizeValueType             grainSize,
+              ThreadIdType              maximumNumberOfWorkers,
+              const RangeFunctionType & func);
+
+protected:
+  WorkStealingThreadPool();
+  ~WorkStealingThreadPool() override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** The part of the range that is owned by one worker. The owner takes
+   * chunks from the front, thieves take the back half. Padded to avoid
+   * false sharing between the workers. */
+  struct WorkRangeType
+  {
+    std::mutex    m_Mutex;
+    SizeValueType m_Begin{ 0 };
+    SizeValueType m_End{ 0 };
+  };
+  itkPadStruct(ITK_CACHE_LINE_ALIGNMENT, WorkRangeType, PaddedWorkRangeType);
+
+  /** The state of one ParallelFor() call. It lives on the stack of the caller,
+   * and is protected by m_Mutex, except for the work ranges. */
+  struct JobType
+  {
+    const RangeFunctionType *              m_Function{ nullptr };
+    SizeValueType                          m_GrainSize{ 1 };
+    ThreadIdType                           m_NumberOfParticipants{ 0 };
+    std::unique_ptr<PaddedWorkRangeType[]> m_WorkRanges;
+
+    /** The number of participants that have joined, including the caller. */
+    ThreadIdType m_NumberOfJoinedWorkers{ 1 };
+
+    /** The number of pool threads that are still processing this job. */
+    ThreadIdType       m_NumberOfBusyWorkers{ 0 };
+    std::exception_ptr m_Exception{ nullptr };
+  };
+
+  void
+  StartThreads(ThreadIdType numberOfThreads);
+
+  void
+  StopThreads();
+
+  /** The main loop of the persistent worker threads. */
+  void
+  WorkerLoop();
+
+  /** Process chunks of the job, until no work can be stolen anymore. */
+  void
+  ProcessJob(JobType & job, ThreadIdType workerId);
+
+  /** Take the next chunk of the own range, or steal from another worker of the job. */
+  static bool
+  TakeChunk(JobType & job, ThreadIdType workerId, SizeValueType & chunkBegin, SizeValueType & chunkEnd);
+
+  std::vector<std::thread>  m_Threads;
+  std::atomic<ThreadIdType> m_NumberOfThreads{ 0 };
+
+  /** Serializes SetNumberOfThreads() calls. */
+  std::mutex m_ThreadsMutex;
+
+  /** Protects the job queue and the job states, and is used with the condition variables. */
+  std::mutex              m_Mutex;
+  std::condition_variable m_WorkAvailable;
+  std::condition_variable m_WorkFinished;
+  std::deque<JobType *>   m_Jobs;
+  bool                    m_Stop{ false };
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkWorkStealingThreadPool_h
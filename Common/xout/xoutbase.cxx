@@ -70,6 +70,22 @@ xoutbase::WriteBufferedData()
 } // end WriteBufferedData
 
 
+/**
+ * ******************** DiscardBufferedData ***********************
+ */
+
+void
+xoutbase::DiscardBufferedData()
+{
+  /** DiscardBufferedData of the target xout-objects. */
+  for (const auto & cell : m_XTargetCells)
+  {
+    (*(cell.second)).DiscardBufferedData();
+  }
+
+} // end DiscardBufferedData
+
+
 /**
  * **************** AddTargetCell (std::ostream) ****************
  */
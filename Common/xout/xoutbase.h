@@ -99,6 +99,10 @@ public:
   virtual void
   WriteBufferedData();
 
+  /** Discard the buffered data, instead of writing it to the outputs. */
+  virtual void
+  DiscardBufferedData();
+
   /**
    * Methods to Add and Remove target cells. They return 0 when successful.
    */
@@ -62,4 +62,16 @@ xoutcell::WriteBufferedData()
 } // end WriteBufferedData
 
 
+/**
+ * ******************** DiscardBufferedData ***********************
+ */
+
+void
+xoutcell::DiscardBufferedData()
+{
+  this->m_InternalBuffer.str(std::string(""));
+
+} // end DiscardBufferedData
+
+
 } // end namespace xoutlibrary
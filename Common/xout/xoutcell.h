@@ -51,6 +51,10 @@ public:
   void
   WriteBufferedData() override;
 
+  /** Empty the buffer, without writing its data to the outputs. */
+  void
+  DiscardBufferedData() override;
+
 private:
   using InternalBufferType = std::ostringstream;
 
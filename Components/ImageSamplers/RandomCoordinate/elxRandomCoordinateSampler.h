@@ -70,6 +70,21 @@ namespace elastix
  *    With this option you can specify the order of interpolation.\n
  *    example: <tt>(FixedImageBSplineInterpolationOrder 0 0 1)</tt>\n
  *    Default value: 1. The parameter can be specified for each resolution.
+ * \parameter UseCounterBasedRandomNumbers: Whether the random numbers are computed by a
+ *    counter-based generator inside the threads of the multi-threaded sampler, instead of
+ *    drawn serially beforehand. The samples then do not depend on the number of threads.
+ *    Only takes effect when the samplers are multi-threaded, i.e. when elastix is run with
+ *    the command line argument <tt>-mts true</tt>; otherwise the option is ignored.\n
+ *    example: <tt>(UseCounterBasedRandomNumbers "true")</tt> \n
+ *    The default is "false". Can be specified for each resolution.
+ * \parameter UseBackgroundSampleGeneration: Whether the next set of samples is generated in a
+ *    background thread, while the metric derivative is computed with the current set. Only useful
+ *    in combination with NewSamplesEveryIteration. The random coordinates are then drawn from a
+ *    generator of the sampler itself, so the samples differ from those without this option.
+ *    A change of the number of samples, for example by UseAdaptiveNumberOfSamples, discards the
+ *    samples that were generated in the background, so they are then generated again.\n
+ *    example: <tt>(UseBackgroundSampleGeneration "true")</tt> \n
+ *    The default is "false". Can be specified for each resolution.
  *
  * \ingroup ImageSamplers
  */
@@ -138,6 +153,7 @@ public:
    * \li Set the number of samples.
    * \li Set the fixed image interpolation order
    * \li Set the UseRandomSampleRegion flag and the SampleRegionSize
+   * \li Set the UseCounterBasedRandomNumbers and UseBackgroundSampleGeneration flags
    */
   void
   BeforeEachResolution() override;
@@ -152,6 +168,15 @@ private:
   elxOverrideGetSelfMacro;
 };
 
+
+/** Sets the parameters that the RandomCoordinate and the QuasiRandomCoordinate samplers share,
+ * for the given resolution level: NumberOfSpatialSamples, FixedImageBSplineInterpolationOrder,
+ * UseRandomSampleRegion and SampleRegionSize.
+ */
+template <class TSampler>
+void
+ConfigureRandomCoordinateSampler(TSampler & sampler, const unsigned int level);
+
 } // end namespace elastix
 
 #ifndef ITK_MANUAL_INSTANTIATION
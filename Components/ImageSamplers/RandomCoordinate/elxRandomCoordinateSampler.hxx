@@ -25,50 +25,53 @@ namespace elastix
 {
 
 /**
- * ******************* BeforeEachResolution ******************
+ * ******************* ConfigureRandomCoordinateSampler ******************
  */
 
-template <class TElastix>
+template <class TSampler>
 void
-RandomCoordinateSampler<TElastix>::BeforeEachResolution()
+ConfigureRandomCoordinateSampler(TSampler & sampler, const unsigned int level)
 {
-  const unsigned int level = this->m_Registration->GetAsITKBaseType()->GetCurrentLevel();
+  using InputImageSpacingType = typename TSampler::InputImageSpacingType;
+  using InputImageSizeType = typename TSampler::InputImageSizeType;
+  constexpr unsigned int InputImageDimension = TSampler::InputImageDimension;
+
+  const auto &        configuration = *sampler.GetConfiguration();
+  const std::string & componentLabel = sampler.GetComponentLabel();
 
   /** Set the NumberOfSpatialSamples. */
   unsigned long numberOfSpatialSamples = 5000;
-  this->GetConfiguration()->ReadParameter(
-    numberOfSpatialSamples, "NumberOfSpatialSamples", this->GetComponentLabel(), level, 0);
-  this->SetNumberOfSamples(numberOfSpatialSamples);
+  configuration.ReadParameter(numberOfSpatialSamples, "NumberOfSpatialSamples", componentLabel, level, 0);
+  sampler.SetNumberOfSamples(numberOfSpatialSamples);
 
   /** Set up the fixed image interpolator and set the SplineOrder, default value = 1. */
   unsigned int splineOrder = 1;
-  this->GetConfiguration()->ReadParameter(
-    splineOrder, "FixedImageBSplineInterpolationOrder", this->GetComponentLabel(), level, 0);
+  configuration.ReadParameter(splineOrder, "FixedImageBSplineInterpolationOrder", componentLabel, level, 0);
   if (splineOrder == 1)
   {
-    using LinearInterpolatorType = itk::LinearInterpolateImageFunction<InputImageType, CoordRepType>;
+    using LinearInterpolatorType =
+      itk::LinearInterpolateImageFunction<typename TSampler::InputImageType, typename TSampler::CoordRepType>;
     auto fixedImageLinearInterpolator = LinearInterpolatorType::New();
-    this->SetInterpolator(fixedImageLinearInterpolator);
+    sampler.SetInterpolator(fixedImageLinearInterpolator);
   }
   else
   {
-    auto fixedImageBSplineInterpolator = DefaultInterpolatorType::New();
+    auto fixedImageBSplineInterpolator = TSampler::DefaultInterpolatorType::New();
     fixedImageBSplineInterpolator->SetSplineOrder(splineOrder);
-    this->SetInterpolator(fixedImageBSplineInterpolator);
+    sampler.SetInterpolator(fixedImageBSplineInterpolator);
   }
 
   /** Set the UseRandomSampleRegion bool. */
   bool useRandomSampleRegion = false;
-  this->GetConfiguration()->ReadParameter(
-    useRandomSampleRegion, "UseRandomSampleRegion", this->GetComponentLabel(), level, 0);
-  this->SetUseRandomSampleRegion(useRandomSampleRegion);
+  configuration.ReadParameter(useRandomSampleRegion, "UseRandomSampleRegion", componentLabel, level, 0);
+  sampler.SetUseRandomSampleRegion(useRandomSampleRegion);
 
   /** Set the SampleRegionSize. */
   if (useRandomSampleRegion)
   {
     InputImageSpacingType sampleRegionSize;
-    InputImageSpacingType fixedImageSpacing = this->GetElastix()->GetFixedImage()->GetSpacing();
-    InputImageSizeType    fixedImageSize = this->GetElastix()->GetFixedImage()->GetLargestPossibleRegion().GetSize();
+    InputImageSpacingType fixedImageSpacing = sampler.GetElastix()->GetFixedImage()->GetSpacing();
+    InputImageSizeType    fixedImageSize = sampler.GetElastix()->GetFixedImage()->GetLargestPossibleRegion().GetSize();
 
     /** Estimate default:
      * sampleRegionSize[i] = min ( fixedImageSizeInMM[i], max_i ( fixedImageSizeInMM[i]/3 ) )
@@ -87,25 +90,53 @@ RandomCoordinateSampler<TElastix>::BeforeEachResolution()
     /** Read and check user's choice. */
     for (unsigned int i = 0; i < InputImageDimension; ++i)
     {
-      this->GetConfiguration()->ReadParameter(
-        sampleRegionSize[i], "SampleRegionSize", this->GetComponentLabel(), level * InputImageDimension + i, 0);
+      configuration.ReadParameter(
+        sampleRegionSize[i], "SampleRegionSize", componentLabel, level * InputImageDimension + i, 0);
     }
-    this->SetSampleRegionSize(sampleRegionSize);
+    sampler.SetSampleRegionSize(sampleRegionSize);
 
     for (unsigned int i = 0; i < InputImageDimension; ++i)
     {
       if (sampleRegionSize[i] > (fixedImageSize[i] - 1) * fixedImageSpacing[i])
       {
-        itkExceptionMacro(<< "ERROR: in your parameter file you selected\n"
-                          << "  SampleRegionSize[ " << i << " ] = " << sampleRegionSize[i]
-                          << " mm,\n  while the fixed image size at dim = " << i << " is " << fixedImageSize[i]
-                          << " voxels or " << fixedImageSize[i] * fixedImageSpacing[i] << " mm.\n"
-                          << "  Please select a smaller SampleRegionSize!\n"
-                          << "  It is recommended to be not larger than 1/3 of the image size in mm.");
+        itkGenericExceptionMacro(<< "ERROR: in your parameter file you selected\n"
+                                 << "  SampleRegionSize[ " << i << " ] = " << sampleRegionSize[i]
+                                 << " mm,\n  while the fixed image size at dim = " << i << " is " << fixedImageSize[i]
+                                 << " voxels or " << fixedImageSize[i] * fixedImageSpacing[i] << " mm.\n"
+                                 << "  Please select a smaller SampleRegionSize!\n"
+                                 << "  It is recommended to be not larger than 1/3 of the image size in mm.");
       }
     }
   }
 
+} // end ConfigureRandomCoordinateSampler()
+
+
+/**
+ * ******************* BeforeEachResolution ******************
+ */
+
+template <class TElastix>
+void
+RandomCoordinateSampler<TElastix>::BeforeEachResolution()
+{
+  const unsigned int level = this->m_Registration->GetAsITKBaseType()->GetCurrentLevel();
+
+  /** Set the parameters that are shared with the QuasiRandomCoordinateSampler. */
+  ConfigureRandomCoordinateSampler(*this, level);
+
+  /** Set whether the random numbers are computed inside the threads. */
+  bool useCounterBasedRandomNumbers = false;
+  this->GetConfiguration()->ReadParameter(
+    useCounterBasedRandomNumbers, "UseCounterBasedRandomNumbers", this->GetComponentLabel(), level, 0);
+  this->SetUseCounterBasedRandomNumbers(useCounterBasedRandomNumbers);
+
+  /** Set whether the next set of samples is generated while the current one is used. */
+  bool useBackgroundSampleGeneration = false;
+  this->GetConfiguration()->ReadParameter(
+    useBackgroundSampleGeneration, "UseBackgroundSampleGeneration", this->GetComponentLabel(), level, 0);
+  this->SetUseBackgroundSampleGeneration(useBackgroundSampleGeneration);
+
 } // end BeforeEachResolution()
 
 
@@ -46,6 +46,13 @@ namespace elastix
  *    metric value and its derivative in each iteration. Must be given for each resolution.\n
  *    example: <tt>(NumberOfSpatialSamples 2048 2048 4000)</tt> \n
  *    The default is 5000.
+ * \parameter UseCounterBasedRandomNumbers: Whether the random numbers are computed by a
+ *    counter-based generator inside the threads of the multi-threaded sampler, instead of
+ *    drawn serially beforehand. The samples then do not depend on the number of threads.
+ *    Only takes effect when the samplers are multi-threaded, i.e. when elastix is run with
+ *    the command line argument <tt>-mts true</tt>; otherwise the option is ignored.\n
+ *    example: <tt>(UseCounterBasedRandomNumbers "true")</tt> \n
+ *    The default is "false". Can be specified for each resolution.
  *
  * \ingroup ImageSamplers
  */
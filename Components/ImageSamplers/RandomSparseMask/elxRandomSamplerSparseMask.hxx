@@ -41,6 +41,12 @@ RandomSamplerSparseMask<TElastix>::BeforeEachResolution()
 
   this->SetNumberOfSamples(numberOfSpatialSamples);
 
+  /** Set whether the random numbers are computed inside the threads. */
+  bool useCounterBasedRandomNumbers = false;
+  this->GetConfiguration()->ReadParameter(
+    useCounterBasedRandomNumbers, "UseCounterBasedRandomNumbers", this->GetComponentLabel(), level, 0);
+  this->SetUseCounterBasedRandomNumbers(useCounterBasedRandomNumbers);
+
 } // end BeforeEachResolution()
 
 
@@ -19,14 +19,14 @@
 #define elxBSplineInterpolator_h
 
 #include "elxIncludes.h" // include first to avoid MSVS warning
-#include "itkBSplineInterpolateImageFunction.h"
+#include "itkAdvancedBSplineInterpolateImageFunction.h"
 
 namespace elastix
 {
 
 /**
  * \class BSplineInterpolator
- * \brief An interpolator based on the itkBSplineInterpolateImageFunction.
+ * \brief An interpolator based on the itk::AdvancedBSplineInterpolateImageFunction.
  *
  * This interpolator interpolates images with an underlying B-spline
  * polynomial.
@@ -48,9 +48,9 @@ namespace elastix
 
 template <class TElastix>
 class ITK_TEMPLATE_EXPORT BSplineInterpolator
-  : public itk::BSplineInterpolateImageFunction<typename InterpolatorBase<TElastix>::InputImageType,
-                                                typename InterpolatorBase<TElastix>::CoordRepType,
-                                                double>
+  : public itk::AdvancedBSplineInterpolateImageFunction<typename InterpolatorBase<TElastix>::InputImageType,
+                                                        typename InterpolatorBase<TElastix>::CoordRepType,
+                                                        double>
   , // CoefficientType
     public InterpolatorBase<TElastix>
 {
@@ -59,9 +59,9 @@ public:
 
   /** Standard ITK-stuff. */
   using Self = BSplineInterpolator;
-  using Superclass1 = itk::BSplineInterpolateImageFunction<typename InterpolatorBase<TElastix>::InputImageType,
-                                                           typename InterpolatorBase<TElastix>::CoordRepType,
-                                                           double>;
+  using Superclass1 = itk::AdvancedBSplineInterpolateImageFunction<typename InterpolatorBase<TElastix>::InputImageType,
+                                                                   typename InterpolatorBase<TElastix>::CoordRepType,
+                                                                   double>;
   using Superclass2 = InterpolatorBase<TElastix>;
   using Pointer = itk::SmartPointer<Self>;
   using ConstPointer = itk::SmartPointer<const Self>;
@@ -70,7 +70,7 @@ public:
   itkNewMacro(Self);
 
   /** Run-time type information (and related methods). */
-  itkTypeMacro(BSplineInterpolator, itk::BSplineInterpolateImageFunction);
+  itkTypeMacro(BSplineInterpolator, itk::AdvancedBSplineInterpolateImageFunction);
 
   /** Name of this class.
    * Use this name in the parameter file to select this specific interpolator. \n
@@ -19,14 +19,14 @@
 #define elxBSplineInterpolatorFloat_h
 
 #include "elxIncludes.h" // include first to avoid MSVS warning
-#include "itkBSplineInterpolateImageFunction.h"
+#include "itkAdvancedBSplineInterpolateImageFunction.h"
 
 namespace elastix
 {
 
 /**
  * \class BSplineInterpolatorFloat
- * \brief An interpolator based on the itk::BSplineInterpolateImageFunction.
+ * \brief An interpolator based on the itk::AdvancedBSplineInterpolateImageFunction.
  *
  * This interpolator interpolates images with an underlying B-spline
  * polynomial.
@@ -48,9 +48,9 @@ namespace elastix
 
 template <class TElastix>
 class ITK_TEMPLATE_EXPORT BSplineInterpolatorFloat
-  : public itk::BSplineInterpolateImageFunction<typename InterpolatorBase<TElastix>::InputImageType,
-                                                typename InterpolatorBase<TElastix>::CoordRepType,
-                                                float>
+  : public itk::AdvancedBSplineInterpolateImageFunction<typename InterpolatorBase<TElastix>::InputImageType,
+                                                        typename InterpolatorBase<TElastix>::CoordRepType,
+                                                        float>
   , // CoefficientType
     public InterpolatorBase<TElastix>
 {
@@ -59,9 +59,9 @@ public:
 
   /** Standard ITK-stuff. */
   using Self = BSplineInterpolatorFloat;
-  using Superclass1 = itk::BSplineInterpolateImageFunction<typename InterpolatorBase<TElastix>::InputImageType,
-                                                           typename InterpolatorBase<TElastix>::CoordRepType,
-                                                           float>;
+  using Superclass1 = itk::AdvancedBSplineInterpolateImageFunction<typename InterpolatorBase<TElastix>::InputImageType,
+                                                                   typename InterpolatorBase<TElastix>::CoordRepType,
+                                                                   float>;
   using Superclass2 = InterpolatorBase<TElastix>;
   using Pointer = itk::SmartPointer<Self>;
   using ConstPointer = itk::SmartPointer<const Self>;
@@ -70,7 +70,7 @@ public:
   itkNewMacro(Self);
 
   /** Run-time type information (and related methods). */
-  itkTypeMacro(BSplineInterpolatorFloat, BSplineInterpolateImageFunction);
+  itkTypeMacro(BSplineInterpolatorFloat, AdvancedBSplineInterpolateImageFunction);
 
   /** Name of this class.
    * Use this name in the parameter file to select this specific interpolator. \n
@@ -91,6 +91,13 @@ namespace elastix
  *    B-spline grids.
  *    example: <tt>(UseFastAndLowMemoryVersion "false")</tt> \n
  *    The default is "true".
+ * \parameter NumberOfSharedJointPDFs: The number of joint histograms that are
+ *    shared by the threads when computing the histogram multi-threaded. By default
+ *    (0) each thread has its own joint histogram. A small number, for example one
+ *    per NUMA domain, reduces the memory use and the final summation of the
+ *    histograms for a large number of threads and histogram bins.\n
+ *    example: <tt>(NumberOfSharedJointPDFs 2)</tt> \n
+ *    The default is 0. Can be given for each resolution, or for all resolutions at once.
  *
  * \sa ParzenWindowMutualInformationImageToImageMetric
  * \ingroup Metrics
@@ -121,6 +121,12 @@ AdvancedMattesMutualInformationMetric<TElastix>::BeforeEachResolution()
     useFastAndLowMemoryVersion, "UseFastAndLowMemoryVersion", this->GetComponentLabel(), level, 0);
   this->SetUseExplicitPDFDerivatives(!useFastAndLowMemoryVersion);
 
+  /** Set the number of joint histograms that are shared by the threads. */
+  unsigned int numberOfSharedJointPDFs = 0;
+  this->GetConfiguration()->ReadParameter(
+    numberOfSharedJointPDFs, "NumberOfSharedJointPDFs", this->GetComponentLabel(), level, 0);
+  this->SetNumberOfSharedJointPDFs(numberOfSharedJointPDFs);
+
   /** Set whether to use Nick Tustison's preconditioning technique. */
   bool useJacobianPreconditioning = false;
   this->GetConfiguration()->ReadParameter(
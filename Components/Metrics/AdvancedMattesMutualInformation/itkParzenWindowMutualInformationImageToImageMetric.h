@@ -183,6 +183,7 @@ protected:
   using typename Superclass::ParzenValueContainerType;
   using typename Superclass::KernelFunctionType;
   using typename Superclass::NonZeroJacobianIndicesType;
+  using typename Superclass::SampleJacobianBlockType;
 
   /**  Get the value and analytic derivative.
    * Called by GetValueAndDerivative if UseFiniteDifferenceDerivative == false.
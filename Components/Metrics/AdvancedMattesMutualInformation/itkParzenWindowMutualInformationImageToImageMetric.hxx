@@ -423,10 +423,10 @@ void
 ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::ThreadedComputeDerivativeLowMemory(
   ThreadIdType threadId)
 {
-  /** Initialize array that stores dM(x)/dmu, and the sparse Jacobian + indices. */
+  /** Initialize the block of valid samples, which stores dM(x)/dmu, and the sparse Jacobian indices. */
+  SampleJacobianBlockType block;
+  this->InitializeSampleJacobianBlock(block);
   const NumberOfParametersType nnzji = this->m_AdvancedTransform->GetNumberOfNonZeroJacobianIndices();
-  NonZeroJacobianIndicesType   nzji = NonZeroJacobianIndicesType(nnzji);
-  DerivativeType               imageJacobian(nzji.size());
 
   /** Get a handle to the pre-allocated derivative for the current thread.
    * The initialization is performed at the beginning of each resolution in
@@ -439,7 +439,7 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Thre
   DerivativeType jacobianPreconditioner, preconditioningDivisor;
   if (this->GetUseJacobianPreconditioning())
   {
-    jacobianPreconditioner = DerivativeType(nzji.size());
+    jacobianPreconditioner = DerivativeType(nnzji);
     preconditioningDivisor = DerivativeType(this->GetNumberOfParameters());
     preconditioningDivisor.Fill(0.0);
   }
@@ -464,8 +464,46 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Thre
   fbegin += (int)pos_begin;
   fend += (int)pos_end;
 
+  /** Computes the contributions of the valid samples of the block to the joint distributions, and empties it. */
+  const auto processBlock = [&]() {
+    /** Compute the inner products of the transform Jacobian dT/dmu and the moving image gradient dM/dx. */
+    this->EvaluateSampleJacobianBlock(block);
+
+    for (SizeValueType n = 0; n < block.m_Size; ++n)
+    {
+      DerivativeType &             imageJacobian = block.m_ImageJacobians[n];
+      NonZeroJacobianIndicesType & nzji = block.m_NonZeroJacobianIndices[n];
+
+      /** If desired, apply the technique introduced by Tustison. */
+      TransformJacobianType jacobian;
+      if (this->GetUseJacobianPreconditioning())
+      {
+        this->EvaluateSampleTransformJacobian(block.m_SampleIndices[n], block.m_FixedPoints[n], jacobian, nzji);
+
+        this->ComputeJacobianPreconditioner(jacobian, nzji, jacobianPreconditioner, preconditioningDivisor);
+        DerivativeValueType * imjacit = imageJacobian.begin();
+        DerivativeValueType * jacprecit = jacobianPreconditioner.begin();
+        for (unsigned int i = 0; i < nzji.size(); ++i)
+        {
+          while (imjacit != imageJacobian.end())
+          {
+            (*imjacit) *= (*jacprecit);
+            ++imjacit;
+            ++jacprecit;
+          }
+        }
+      }
+
+      /** Compute this sample's contribution to the joint distributions. */
+      this->UpdateDerivativeLowMemory(
+        block.m_FixedImageValues[n], block.m_MovingImageValues[n], imageJacobian, nzji, derivative);
+    }
+    block.m_Size = 0;
+  };
+
   /** Loop over sample container and compute contribution of each sample to pdfs. */
-  for (fiter = fbegin; fiter != fend; ++fiter)
+  unsigned long sampleIndex = pos_begin;
+  for (fiter = fbegin; fiter != fend; ++fiter, ++sampleIndex)
   {
     /** Read fixed coordinates and create some variables. */
     const FixedImagePointType & fixedPoint = fiter->Value().m_ImageCoordinates;
@@ -473,7 +511,7 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Thre
     MovingImageDerivativeType   movingImageDerivative;
 
     /** Transform point. */
-    const MovingImagePointType mappedPoint = this->TransformPoint(fixedPoint);
+    const MovingImagePointType mappedPoint = this->TransformSamplePoint(sampleIndex, fixedPoint);
 
     /** Check if the point is inside the moving mask. */
     bool sampleOk = this->IsInsideMovingMask(mappedPoint);
@@ -496,45 +534,18 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Thre
       fixedImageValue = this->GetFixedImageLimiter()->Evaluate(fixedImageValue);
       movingImageValue = this->GetMovingImageLimiter()->Evaluate(movingImageValue, movingImageDerivative);
 
-#if 0
-      /** Get the TransformJacobian dT/dmu. */
-      this->EvaluateTransformJacobian( fixedPoint, jacobian, nzji );
-
-      /** Compute the inner products (dM/dx)^T (dT/dmu). */
-      this->EvaluateTransformJacobianInnerProduct(
-        jacobian, movingImageDerivative, imageJacobian );
-#else
-      /** Compute the inner product of the transform Jacobian dT/dmu and the moving image gradient dM/dx. */
-      this->m_AdvancedTransform->EvaluateJacobianWithImageGradientProduct(
-        fixedPoint, movingImageDerivative, imageJacobian, nzji);
-#endif
-
-      /** If desired, apply the technique introduced by Tustison. */
-      TransformJacobianType jacobian;
-      if (this->GetUseJacobianPreconditioning())
+      /** Add the sample to the block, and process the block when it is full. */
+      if (block.Add(sampleIndex, fixedPoint, fixedImageValue, movingImageValue, movingImageDerivative))
       {
-        this->EvaluateTransformJacobian(fixedPoint, jacobian, nzji);
-
-        this->ComputeJacobianPreconditioner(jacobian, nzji, jacobianPreconditioner, preconditioningDivisor);
-        DerivativeValueType * imjacit = imageJacobian.begin();
-        DerivativeValueType * jacprecit = jacobianPreconditioner.begin();
-        for (unsigned int i = 0; i < nzji.size(); ++i)
-        {
-          while (imjacit != imageJacobian.end())
-          {
-            (*imjacit) *= (*jacprecit);
-            ++imjacit;
-            ++jacprecit;
-          }
-        }
+        processBlock();
       }
 
-      /** Compute this sample's contribution to the joint distributions. */
-      this->UpdateDerivativeLowMemory(fixedImageValue, movingImageValue, imageJacobian, nzji, derivative);
-
     } // end sampleOk
   }   // end loop over sample container
 
+  /** Process the remaining samples. */
+  processBlock();
+
   /** If desired, apply the technique introduced by Tustison. */
   if (this->GetUseJacobianPreconditioning())
   {
@@ -601,9 +612,7 @@ ParzenWindowMutualInformationImageToImageMetric<TFixedImage, TMovingImage>::Afte
     this->m_ThreaderMetricParameters.st_DerivativePointer = derivative.begin();
     this->m_ThreaderMetricParameters.st_NormalizationFactor = 1.0;
 
-    this->m_Threader->SetSingleMethod(this->AccumulateDerivativesThreaderCallback,
-                                      const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)));
-    this->m_Threader->SingleMethodExecute();
+    this->LaunchAccumulateDerivativesThreaderCallback();
   }
 
 } // end AfterThreadedComputeDerivativeLowMemory()
@@ -108,6 +108,7 @@ public:
   using typename Superclass::ImageSamplerPointer;
   using typename Superclass::ImageSampleContainerType;
   using typename Superclass::ImageSampleContainerPointer;
+  using typename Superclass::ImageSampleType;
   using typename Superclass::FixedImageLimiterType;
   using typename Superclass::MovingImageLimiterType;
   using typename Superclass::FixedImageLimiterOutputType;
@@ -209,6 +210,9 @@ protected:
   using typename Superclass::CentralDifferenceGradientFilterType;
   using typename Superclass::MovingImageDerivativeType;
   using typename Superclass::NonZeroJacobianIndicesType;
+  using typename Superclass::SampleJacobianBlockType;
+  using typename Superclass::SinglePrecisionDerivativeValueType;
+  using typename Superclass::SinglePrecisionDerivativeType;
 
   /** Protected typedefs for SelfHessian */
   using SmootherType = SmoothingRecursiveGaussianImageFilter<FixedImageType, FixedImageType>;
@@ -229,6 +233,15 @@ protected:
                                 MeasureType &                      measure,
                                 DerivativeType &                   deriv) const;
 
+  /** The same, but accumulating the derivative in single precision. */
+  void
+  UpdateValueAndDerivativeTerms(const RealType                     fixedImageValue,
+                                const RealType                     movingImageValue,
+                                const DerivativeType &             imageJacobian,
+                                const NonZeroJacobianIndicesType & nzji,
+                                MeasureType &                      measure,
+                                SinglePrecisionDerivativeType &    deriv) const;
+
   /** Compute a pixel's contribution to the SelfHessian;
    * Called by GetSelfHessian(). */
   void
@@ -240,6 +253,10 @@ protected:
   void
   ThreadedGetValue(ThreadIdType threadID) override;
 
+  /** Get value for each thread, looping over blocks of samples. */
+  void
+  ThreadedGetValueInBlocks(ThreadIdType threadID, unsigned long pos_begin, unsigned long pos_end);
+
   /** Gather the values from all threads. */
   void
   AfterThreadedGetValue(MeasureType & value) const override;
@@ -324,6 +324,12 @@ AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::ThreadedGetVal
   pos_begin = (pos_begin > sampleContainerSize) ? sampleContainerSize : pos_begin;
   pos_end = (pos_end > sampleContainerSize) ? sampleContainerSize : pos_end;
 
+  /** Loop over blocks of samples, if requested. */
+  if (this->GetUseStructureOfArraysSamples())
+  {
+    return this->ThreadedGetValueInBlocks(threadId, pos_begin, pos_end);
+  }
+
   /** Create iterator over the sample container. */
   typename ImageSampleContainerType::ConstIterator threader_fiter;
   typename ImageSampleContainerType::ConstIterator threader_fbegin = sampleContainer->Begin();
@@ -337,14 +343,15 @@ AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::ThreadedGetVal
   MeasureType   measure = NumericTraits<MeasureType>::Zero;
 
   /** Loop over the fixed image to calculate the mean squares. */
-  for (threader_fiter = threader_fbegin; threader_fiter != threader_fend; ++threader_fiter)
+  unsigned long sampleIndex = pos_begin;
+  for (threader_fiter = threader_fbegin; threader_fiter != threader_fend; ++threader_fiter, ++sampleIndex)
   {
     /** Read fixed coordinates and initialize some variables. */
     const FixedImagePointType & fixedPoint = threader_fiter->Value().m_ImageCoordinates;
     RealType                    movingImageValue;
 
     /** Transform point. */
-    const MovingImagePointType mappedPoint = this->TransformPoint(fixedPoint);
+    const MovingImagePointType mappedPoint = this->TransformSamplePoint(sampleIndex, fixedPoint);
 
     /** Check if the point is inside the moving mask. */
     bool sampleOk = this->IsInsideMovingMask(mappedPoint);
@@ -379,6 +386,86 @@ AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::ThreadedGetVal
 } // end ThreadedGetValue()
 
 
+/**
+ * ******************* ThreadedGetValueInBlocks *******************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::ThreadedGetValueInBlocks(
+  const ThreadIdType  threadId,
+  const unsigned long pos_begin,
+  const unsigned long pos_end)
+{
+  /** Get a handle to the sample container. */
+  const ImageSampleContainerType & sampleContainer = *(this->GetImageSampler()->GetOutput());
+
+  /** Per block: the points, the fixed and moving image values, and whether the samples are valid (1) or not (0).
+   * The block is gathered from the sample container, and stays in L1 cache. */
+  FixedImagePointType  fixedPoints[Self::SampleBlockSize];
+  MovingImagePointType mappedPoints[Self::SampleBlockSize];
+  RealType             fixedImageValues[Self::SampleBlockSize];
+  RealType             movingImageValues[Self::SampleBlockSize];
+  bool                 sampleOk[Self::SampleBlockSize];
+  RealType             sampleOkFlags[Self::SampleBlockSize];
+
+  /** Create variables to store intermediate results. circumvent false sharing */
+  RealType    numberOfPixelsCounted = NumericTraits<RealType>::Zero;
+  MeasureType measure = NumericTraits<MeasureType>::Zero;
+
+  for (unsigned long blockBegin = pos_begin; blockBegin < pos_end; blockBegin += Self::SampleBlockSize)
+  {
+    const unsigned long blockSize = std::min(static_cast<unsigned long>(Self::SampleBlockSize), pos_end - blockBegin);
+
+    /** Transform the points of the block at once. */
+    for (unsigned long i = 0; i < blockSize; ++i)
+    {
+      const ImageSampleType & sample = sampleContainer[blockBegin + i];
+      fixedPoints[i] = sample.m_ImageCoordinates;
+      fixedImageValues[i] = static_cast<RealType>(sample.m_ImageValue);
+    }
+    if (this->HasTransformSampleCache())
+    {
+      for (unsigned long i = 0; i < blockSize; ++i)
+      {
+        mappedPoints[i] = this->TransformSamplePoint(blockBegin + i, fixedPoints[i]);
+      }
+    }
+    else
+    {
+      this->TransformPoints(fixedPoints, mappedPoints, blockSize);
+    }
+
+    /** Interpolate the moving image at the points of the block that are inside the moving mask. */
+    for (unsigned long i = 0; i < blockSize; ++i)
+    {
+      movingImageValues[i] = NumericTraits<RealType>::Zero;
+      sampleOk[i] = this->IsInsideMovingMask(mappedPoints[i]);
+    }
+    this->FastEvaluateMovingImageValuesAndDerivatives(
+      mappedPoints, movingImageValues, nullptr, sampleOk, blockSize, threadId);
+    for (unsigned long i = 0; i < blockSize; ++i)
+    {
+      sampleOkFlags[i] = sampleOk[i] ? 1.0 : 0.0;
+    }
+
+    /** The squared differences of the whole block, in a loop that can be vectorized. */
+    for (unsigned long i = 0; i < blockSize; ++i)
+    {
+      const RealType diff = movingImageValues[i] - fixedImageValues[i];
+      measure += sampleOkFlags[i] * diff * diff;
+      numberOfPixelsCounted += sampleOkFlags[i];
+    }
+  }
+
+  /** Only update these variables at the end to prevent unnecessary "false sharing". */
+  this->m_GetValueAndDerivativePerThreadVariables[threadId].st_NumberOfPixelsCounted =
+    static_cast<SizeValueType>(numberOfPixelsCounted);
+  this->m_GetValueAndDerivativePerThreadVariables[threadId].st_Value = measure;
+
+} // end ThreadedGetValueInBlocks()
+
+
 /**
  * ******************* AfterThreadedGetValue *******************
  */
@@ -606,10 +693,9 @@ template <class TFixedImage, class TMovingImage>
 void
 AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::ThreadedGetValueAndDerivative(ThreadIdType threadId)
 {
-  /** Initialize array that stores dM(x)/dmu, and the sparse Jacobian + indices. */
-  const NumberOfParametersType nnzji = this->m_AdvancedTransform->GetNumberOfNonZeroJacobianIndices();
-  NonZeroJacobianIndicesType   nzji = NonZeroJacobianIndicesType(nnzji);
-  DerivativeType               imageJacobian(nnzji);
+  /** Initialize the block of valid samples, which stores dM(x)/dmu, and the sparse Jacobian indices. */
+  SampleJacobianBlockType block;
+  this->InitializeSampleJacobianBlock(block);
 
   /** Get a handle to the pre-allocated derivative for the current thread.
    * The initialization is performed at the beginning of each resolution in
@@ -618,6 +704,11 @@ AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::ThreadedGetVal
    */
   DerivativeType & derivative = this->m_GetValueAndDerivativePerThreadVariables[threadId].st_Derivative;
 
+  /** With single precision derivative accumulation, the thread accumulates in its float derivative instead. */
+  const bool                      useSinglePrecision = this->GetUseSinglePrecisionDerivativeAccumulation();
+  SinglePrecisionDerivativeType & singlePrecisionDerivative =
+    this->m_GetValueAndDerivativePerThreadVariables[threadId].st_SinglePrecisionDerivative;
+
   /** Get a handle to the sample container. */
   ImageSampleContainerPointer sampleContainer = this->GetImageSampler()->GetOutput();
   const unsigned long         sampleContainerSize = sampleContainer->Size();
@@ -631,67 +722,146 @@ AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::ThreadedGetVal
   pos_begin = (pos_begin > sampleContainerSize) ? sampleContainerSize : pos_begin;
   pos_end = (pos_end > sampleContainerSize) ? sampleContainerSize : pos_end;
 
-  /** Create iterator over the sample container. */
-  typename ImageSampleContainerType::ConstIterator threader_fiter;
-  typename ImageSampleContainerType::ConstIterator threader_fbegin = sampleContainer->Begin();
-  typename ImageSampleContainerType::ConstIterator threader_fend = sampleContainer->Begin();
-
-  threader_fbegin += (int)pos_begin;
-  threader_fend += (int)pos_end;
-
   /** Create variables to store intermediate results. circumvent false sharing */
   unsigned long numberOfPixelsCounted = 0;
   MeasureType   measure = NumericTraits<MeasureType>::Zero;
 
-  /** Loop over the fixed image to calculate the mean squares. */
-  for (threader_fiter = threader_fbegin; threader_fiter != threader_fend; ++threader_fiter)
-  {
-    /** Read fixed coordinates and initialize some variables. */
-    const FixedImagePointType & fixedPoint = threader_fiter->Value().m_ImageCoordinates;
-    RealType                    movingImageValue;
-    MovingImageDerivativeType   movingImageDerivative;
-
-    /** Transform point. */
-    const MovingImagePointType mappedPoint = this->TransformPoint(fixedPoint);
+  /** Computes the contributions of the valid samples of the block, and empties it. */
+  const auto processBlock = [&]() {
+    /** Compute the inner products of the transform Jacobian dT/dmu and the moving image gradient dM/dx. */
+    this->EvaluateSampleJacobianBlock(block);
 
-    /** Check if the point is inside the moving mask. */
-    bool sampleOk = this->IsInsideMovingMask(mappedPoint);
-
-    /** Compute the moving image value M(T(x)) and derivative dM/dx and check if
-     * the point is inside the moving image buffer.
-     */
-    if (sampleOk)
+    /** Compute the contributions of the samples to the measure and derivatives. */
+    for (SizeValueType i = 0; i < block.m_Size; ++i)
     {
-      sampleOk = this->FastEvaluateMovingImageValueAndDerivative(
-        mappedPoint, movingImageValue, &movingImageDerivative, threadId);
+      if (useSinglePrecision)
+      {
+        this->UpdateValueAndDerivativeTerms(block.m_FixedImageValues[i],
+                                            block.m_MovingImageValues[i],
+                                            block.m_ImageJacobians[i],
+                                            block.m_NonZeroJacobianIndices[i],
+                                            measure,
+                                            singlePrecisionDerivative);
+      }
+      else
+      {
+        this->UpdateValueAndDerivativeTerms(block.m_FixedImageValues[i],
+                                            block.m_MovingImageValues[i],
+                                            block.m_ImageJacobians[i],
+                                            block.m_NonZeroJacobianIndices[i],
+                                            measure,
+                                            derivative);
+      }
     }
+    numberOfPixelsCounted += block.m_Size;
+    block.m_Size = 0;
+  };
+
+  /** Adds a valid sample to the block, and processes the block when it is full. */
+  const auto accumulateSample = [&](const unsigned long               sampleIndex,
+                                    const FixedImagePointType &       fixedPoint,
+                                    const RealType                    fixedImageValue,
+                                    const RealType                    movingImageValue,
+                                    const MovingImageDerivativeType & movingImageDerivative) {
+    if (block.Add(sampleIndex, fixedPoint, fixedImageValue, movingImageValue, movingImageDerivative))
+    {
+      processBlock();
+    }
+  };
 
-    if (sampleOk)
+  if (this->GetUseStructureOfArraysSamples())
+  {
+    /** Loop over blocks of samples, gathered from the sample container, transforming a block of points at once. */
+    FixedImagePointType       fixedPoints[Self::SampleBlockSize];
+    MovingImagePointType      mappedPoints[Self::SampleBlockSize];
+    RealType                  fixedImageValues[Self::SampleBlockSize];
+    RealType                  movingImageValues[Self::SampleBlockSize];
+    MovingImageDerivativeType movingImageDerivatives[Self::SampleBlockSize];
+    bool                      sampleOk[Self::SampleBlockSize];
+
+    for (unsigned long blockBegin = pos_begin; blockBegin < pos_end; blockBegin += Self::SampleBlockSize)
     {
-      ++numberOfPixelsCounted;
+      const unsigned long blockSize = std::min(static_cast<unsigned long>(Self::SampleBlockSize), pos_end - blockBegin);
+      for (unsigned long i = 0; i < blockSize; ++i)
+      {
+        const ImageSampleType & sample = sampleContainer->ElementAt(blockBegin + i);
+        fixedPoints[i] = sample.m_ImageCoordinates;
+        fixedImageValues[i] = static_cast<RealType>(sample.m_ImageValue);
+      }
 
-      /** Get the fixed image value. */
-      const RealType & fixedImageValue = static_cast<RealType>(threader_fiter->Value().m_ImageValue);
+      /** Transform the block, and interpolate the moving image values and derivatives at once. */
+      if (this->HasTransformSampleCache())
+      {
+        for (unsigned long i = 0; i < blockSize; ++i)
+        {
+          mappedPoints[i] = this->TransformSamplePoint(blockBegin + i, fixedPoints[i]);
+        }
+      }
+      else
+      {
+        this->TransformPoints(fixedPoints, mappedPoints, blockSize);
+      }
+      for (unsigned long i = 0; i < blockSize; ++i)
+      {
+        sampleOk[i] = this->IsInsideMovingMask(mappedPoints[i]);
+      }
+      this->FastEvaluateMovingImageValuesAndDerivatives(
+        mappedPoints, movingImageValues, movingImageDerivatives, sampleOk, blockSize, threadId);
 
-#if 0
-      /** Get the TransformJacobian dT/dmu. */
-      this->EvaluateTransformJacobian( fixedPoint, jacobian, nzji );
+      for (unsigned long i = 0; i < blockSize; ++i)
+      {
+        if (sampleOk[i])
+        {
+          accumulateSample(
+            blockBegin + i, fixedPoints[i], fixedImageValues[i], movingImageValues[i], movingImageDerivatives[i]);
+        }
+      }
+    }
+  }
+  else
+  {
+    /** Create iterator over the sample container. */
+    typename ImageSampleContainerType::ConstIterator threader_fiter;
+    typename ImageSampleContainerType::ConstIterator threader_fbegin = sampleContainer->Begin();
+    typename ImageSampleContainerType::ConstIterator threader_fend = sampleContainer->Begin();
 
-      /** Compute the inner products (dM/dx)^T (dT/dmu). */
-      this->EvaluateTransformJacobianInnerProduct(
-        jacobian, movingImageDerivative, imageJacobian );
-#else
-      /** Compute the inner product of the transform Jacobian dT/dmu and the moving image gradient dM/dx. */
-      this->m_AdvancedTransform->EvaluateJacobianWithImageGradientProduct(
-        fixedPoint, movingImageDerivative, imageJacobian, nzji);
-#endif
+    threader_fbegin += (int)pos_begin;
+    threader_fend += (int)pos_end;
 
-      /** Compute this pixel's contribution to the measure and derivatives. */
-      this->UpdateValueAndDerivativeTerms(fixedImageValue, movingImageValue, imageJacobian, nzji, measure, derivative);
+    /** Loop over the fixed image to calculate the mean squares. */
+    unsigned long sampleIndex = pos_begin;
+    for (threader_fiter = threader_fbegin; threader_fiter != threader_fend; ++threader_fiter, ++sampleIndex)
+    {
+      /** Read fixed coordinates and initialize some variables. */
+      const FixedImagePointType & fixedPoint = threader_fiter->Value().m_ImageCoordinates;
+      RealType                    movingImageValue;
+      MovingImageDerivativeType   movingImageDerivative;
 
-    } // end if sampleOk
+      /** Transform point. */
+      const MovingImagePointType mappedPoint = this->TransformSamplePoint(sampleIndex, fixedPoint);
 
-  } // end for loop over the image sample container
+      /** Check if the point is inside the moving mask. */
+      bool sampleOk = this->IsInsideMovingMask(mappedPoint);
+
+      /** Compute the moving image value M(T(x)) and derivative dM/dx and check if
+       * the point is inside the moving image buffer.
+       */
+      if (sampleOk)
+      {
+        sampleOk = this->FastEvaluateMovingImageValueAndDerivative(
+          mappedPoint, movingImageValue, &movingImageDerivative, threadId);
+      }
+
+      if (sampleOk)
+      {
+        const RealType fixedImageValue = static_cast<RealType>(threader_fiter->Value().m_ImageValue);
+        accumulateSample(sampleIndex, fixedPoint, fixedImageValue, movingImageValue, movingImageDerivative);
+      }
+    }
+  }
+
+  /** Process the remaining samples. */
+  processBlock();
 
   /** Only update these variables at the end to prevent unnecessary "false sharing". */
   this->m_GetValueAndDerivativePerThreadVariables[threadId].st_NumberOfPixelsCounted = numberOfPixelsCounted;
@@ -757,9 +927,7 @@ AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::AfterThreadedG
     this->m_ThreaderMetricParameters.st_DerivativePointer = derivative.begin();
     this->m_ThreaderMetricParameters.st_NormalizationFactor = 1.0 / normal_sum;
 
-    this->m_Threader->SetSingleMethod(this->AccumulateDerivativesThreaderCallback,
-                                      const_cast<void *>(static_cast<const void *>(&this->m_ThreaderMetricParameters)));
-    this->m_Threader->SingleMethodExecute();
+    this->LaunchAccumulateDerivativesThreaderCallback();
   }
 #ifdef ELASTIX_USE_OPENMP
   // compute multi-threadedly with openmp
@@ -831,6 +999,51 @@ AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::UpdateValueAnd
 } // end UpdateValueAndDerivativeTerms()
 
 
+/**
+ * *************** UpdateValueAndDerivativeTerms ***************************
+ */
+
+template <class TFixedImage, class TMovingImage>
+void
+AdvancedMeanSquaresImageToImageMetric<TFixedImage, TMovingImage>::UpdateValueAndDerivativeTerms(
+  const RealType                     fixedImageValue,
+  const RealType                     movingImageValue,
+  const DerivativeType &             imageJacobian,
+  const NonZeroJacobianIndicesType & nzji,
+  MeasureType &                      measure,
+  SinglePrecisionDerivativeType &    deriv) const
+{
+  /** The difference squared; the measure is kept in double precision. */
+  const RealType diff = movingImageValue - fixedImageValue;
+  measure += diff * diff;
+
+  /** Calculate the contributions to the derivatives with respect to each parameter. */
+  const auto diff_2 = static_cast<SinglePrecisionDerivativeValueType>(diff * 2.0);
+
+  const auto numberOfParameters = this->GetNumberOfParameters();
+
+  if (nzji.size() == numberOfParameters)
+  {
+    /** Loop over all Jacobians. */
+    const DerivativeValueType *                imjacit = imageJacobian.begin();
+    SinglePrecisionDerivativeValueType * const derivit = deriv.begin();
+    for (unsigned int mu = 0; mu < numberOfParameters; ++mu)
+    {
+      derivit[mu] += diff_2 * static_cast<SinglePrecisionDerivativeValueType>(imjacit[mu]);
+    }
+  }
+  else
+  {
+    /** Only pick the nonzero Jacobians. */
+    for (unsigned int i = 0; i < imageJacobian.GetSize(); ++i)
+    {
+      const unsigned int index = nzji[i];
+      deriv[index] += diff_2 * static_cast<SinglePrecisionDerivativeValueType>(imageJacobian[i]);
+    }
+  }
+} // end UpdateValueAndDerivativeTerms()
+
+
 /**
  * ******************* GetSelfHessian *******************
  */
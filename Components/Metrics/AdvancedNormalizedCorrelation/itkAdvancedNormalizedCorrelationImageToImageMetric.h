@@ -143,6 +143,7 @@ public:
   using typename Superclass::ImageSamplerPointer;
   using typename Superclass::ImageSampleContainerType;
   using typename Superclass::ImageSampleContainerPointer;
+  using typename Superclass::ImageSampleType;
   using typename Superclass::FixedImageLimiterType;
   using typename Superclass::MovingImageLimiterType;
   using typename Superclass::FixedImageLimiterOutputType;
@@ -205,6 +206,7 @@ protected:
   using typename Superclass::CentralDifferenceGradientFilterType;
   using typename Superclass::MovingImageDerivativeType;
   using typename Superclass::NonZeroJacobianIndicesType;
+  using typename Superclass::SampleJacobianBlockType;
 
   /** Compute a pixel's contribution to the derivative terms;
    * Called by GetValueAndDerivative().
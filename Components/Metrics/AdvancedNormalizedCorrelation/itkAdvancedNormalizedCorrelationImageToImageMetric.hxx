@@ -498,10 +498,9 @@ void
 AdvancedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>::ThreadedGetValueAndDerivative(
   ThreadIdType threadId)
 {
-  /** Initialize array that stores dM(x)/dmu, and the sparse Jacobian + indices. */
-  const NumberOfParametersType nnzji = this->m_AdvancedTransform->GetNumberOfNonZeroJacobianIndices();
-  NonZeroJacobianIndicesType   nzji = NonZeroJacobianIndicesType(nnzji);
-  DerivativeType               imageJacobian(nzji.size());
+  /** Initialize the block of valid samples, which stores dM(x)/dmu, and the sparse Jacobian indices. */
+  SampleJacobianBlockType block;
+  this->InitializeSampleJacobianBlock(block);
 
   /** Get handles to the pre-allocated derivatives for the current thread.
    * The initialization is performed at the beginning of each resolution in
@@ -525,14 +524,6 @@ AdvancedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>::Thre
   pos_begin = (pos_begin > sampleContainerSize) ? sampleContainerSize : pos_begin;
   pos_end = (pos_end > sampleContainerSize) ? sampleContainerSize : pos_end;
 
-  /** Create iterator over the sample container. */
-  typename ImageSampleContainerType::ConstIterator threader_fiter;
-  typename ImageSampleContainerType::ConstIterator threader_fbegin = sampleContainer->Begin();
-  typename ImageSampleContainerType::ConstIterator threader_fend = sampleContainer->Begin();
-
-  threader_fbegin += (int)pos_begin;
-  threader_fend += (int)pos_end;
-
   /** Create variables to store intermediate results. */
   AccumulateType sff = NumericTraits<AccumulateType>::Zero;
   AccumulateType smm = NumericTraits<AccumulateType>::Zero;
@@ -541,63 +532,149 @@ AdvancedNormalizedCorrelationImageToImageMetric<TFixedImage, TMovingImage>::Thre
   AccumulateType sm = NumericTraits<AccumulateType>::Zero;
   unsigned long  numberOfPixelsCounted = 0;
 
-  /** Loop over the fixed image to calculate the mean squares. */
-  for (threader_fiter = threader_fbegin; threader_fiter != threader_fend; ++threader_fiter)
+  /** Computes the derivative terms of the valid samples of the block, and empties it. */
+  const auto processBlock = [&]() {
+    /** Compute the inner products of the transform Jacobian dT/dmu and the moving image gradient dM/dx. */
+    this->EvaluateSampleJacobianBlock(block);
+
+    /** Compute the contributions of the samples to the derivative terms. */
+    for (SizeValueType i = 0; i < block.m_Size; ++i)
+    {
+      this->UpdateDerivativeTerms(block.m_FixedImageValues[i],
+                                  block.m_MovingImageValues[i],
+                                  block.m_ImageJacobians[i],
+                                  block.m_NonZeroJacobianIndices[i],
+                                  derivativeF,
+                                  derivativeM,
+                                  differential);
+    }
+    block.m_Size = 0;
+  };
+
+  /** Adds a valid sample to the block, and processes the block when it is full. */
+  const auto updateDerivativeTerms = [&](const unsigned long               sampleIndex,
+                                         const FixedImagePointType &       fixedPoint,
+                                         const RealType                    fixedImageValue,
+                                         const RealType                    movingImageValue,
+                                         const MovingImageDerivativeType & movingImageDerivative) {
+    if (block.Add(sampleIndex, fixedPoint, fixedImageValue, movingImageValue, movingImageDerivative))
+    {
+      processBlock();
+    }
+  };
+
+  if (this->GetUseStructureOfArraysSamples())
   {
-    /** Read fixed coordinates and initialize some variables. */
-    const FixedImagePointType & fixedPoint = threader_fiter->Value().m_ImageCoordinates;
-    RealType                    movingImageValue;
-    MovingImageDerivativeType   movingImageDerivative;
+    /** Per block: the points, the fixed and moving image values, the moving image derivatives, and whether
+     * the samples are valid. The block is gathered from the sample container, and stays in L1 cache. */
+    FixedImagePointType       fixedPoints[Self::SampleBlockSize];
+    MovingImagePointType      mappedPoints[Self::SampleBlockSize];
+    RealType                  fixedImageValues[Self::SampleBlockSize];
+    RealType                  movingImageValues[Self::SampleBlockSize];
+    MovingImageDerivativeType movingImageDerivatives[Self::SampleBlockSize];
+    bool                      sampleOk[Self::SampleBlockSize];
+    RealType                  sampleOkFlags[Self::SampleBlockSize];
+
+    for (unsigned long blockBegin = pos_begin; blockBegin < pos_end; blockBegin += Self::SampleBlockSize)
+    {
+      const unsigned long blockSize = std::min(static_cast<unsigned long>(Self::SampleBlockSize), pos_end - blockBegin);
 
-    /** Transform point. */
-    const MovingImagePointType mappedPoint = this->TransformPoint(fixedPoint);
+      /** Transform the block, and interpolate the moving image values and derivatives at once. */
+      for (unsigned long i = 0; i < blockSize; ++i)
+      {
+        const ImageSampleType & sample = sampleContainer->ElementAt(blockBegin + i);
+        fixedPoints[i] = sample.m_ImageCoordinates;
+        fixedImageValues[i] = static_cast<RealType>(sample.m_ImageValue);
+      }
+      this->TransformPoints(fixedPoints, mappedPoints, blockSize);
+      for (unsigned long i = 0; i < blockSize; ++i)
+      {
+        movingImageValues[i] = NumericTraits<RealType>::Zero;
+        sampleOk[i] = this->IsInsideMovingMask(mappedPoints[i]);
+      }
+      this->FastEvaluateMovingImageValuesAndDerivatives(
+        mappedPoints, movingImageValues, movingImageDerivatives, sampleOk, blockSize, threadId);
 
-    /** Check if the point is inside the moving mask. */
-    bool sampleOk = this->IsInsideMovingMask(mappedPoint);
+      /** The derivative terms, one sample at a time. */
+      for (unsigned long i = 0; i < blockSize; ++i)
+      {
+        sampleOkFlags[i] = sampleOk[i] ? 1.0 : 0.0;
+        if (sampleOk[i])
+        {
+          ++numberOfPixelsCounted;
+          updateDerivativeTerms(
+            blockBegin + i, fixedPoints[i], fixedImageValues[i], movingImageValues[i], movingImageDerivatives[i]);
+        }
+      }
 
-    /** Compute the moving image value M(T(x)) and derivative dM/dx and check if
-     * the point is inside the moving image buffer.
-     */
-    if (sampleOk)
-    {
-      sampleOk = this->FastEvaluateMovingImageValueAndDerivative(
-        mappedPoint, movingImageValue, &movingImageDerivative, threadId);
+      /** The sums needed to calculate the value of NC, in a loop that can be vectorized. */
+      for (unsigned long i = 0; i < blockSize; ++i)
+      {
+        const RealType fixedImageValue = sampleOkFlags[i] * fixedImageValues[i];
+        const RealType movingImageValue = sampleOkFlags[i] * movingImageValues[i];
+        sff += fixedImageValue * fixedImageValue;
+        smm += movingImageValue * movingImageValue;
+        sfm += fixedImageValue * movingImageValue;
+        sf += fixedImageValue;  // Only needed when m_SubtractMean == true
+        sm += movingImageValue; // Only needed when m_SubtractMean == true
+      }
     }
+  }
+  else
+  {
+    /** Create iterator over the sample container. */
+    typename ImageSampleContainerType::ConstIterator threader_fiter;
+    typename ImageSampleContainerType::ConstIterator threader_fbegin = sampleContainer->Begin();
+    typename ImageSampleContainerType::ConstIterator threader_fend = sampleContainer->Begin();
 
-    if (sampleOk)
+    threader_fbegin += (int)pos_begin;
+    threader_fend += (int)pos_end;
+
+    /** Loop over the fixed image to calculate the correlation. */
+    unsigned long sampleIndex = pos_begin;
+    for (threader_fiter = threader_fbegin; threader_fiter != threader_fend; ++threader_fiter, ++sampleIndex)
     {
-      ++numberOfPixelsCounted;
+      /** Read fixed coordinates and initialize some variables. */
+      const FixedImagePointType & fixedPoint = threader_fiter->Value().m_ImageCoordinates;
+      RealType                    movingImageValue;
+      MovingImageDerivativeType   movingImageDerivative;
 
-      /** Get the fixed image value. */
-      const RealType & fixedImageValue = static_cast<RealType>(threader_fiter->Value().m_ImageValue);
+      /** Transform point. */
+      const MovingImagePointType mappedPoint = this->TransformPoint(fixedPoint);
 
-#if 0
-      /** Get the TransformJacobian dT/dmu. */
-      this->EvaluateTransformJacobian( fixedPoint, jacobian, nzji );
-
-      /** Compute the inner products (dM/dx)^T (dT/dmu). */
-      this->EvaluateTransformJacobianInnerProduct(
-        jacobian, movingImageDerivative, imageJacobian );
-#else
-      /** Compute the inner product of the transform Jacobian dT/dmu and the moving image gradient dM/dx. */
-      this->m_AdvancedTransform->EvaluateJacobianWithImageGradientProduct(
-        fixedPoint, movingImageDerivative, imageJacobian, nzji);
-#endif
+      /** Check if the point is inside the moving mask. */
+      bool sampleOk = this->IsInsideMovingMask(mappedPoint);
 
-      /** Update some sums needed to calculate the value of NC. */
-      sff += fixedImageValue * fixedImageValue;
-      smm += movingImageValue * movingImageValue;
-      sfm += fixedImageValue * movingImageValue;
-      sf += fixedImageValue;  // Only needed when m_SubtractMean == true
-      sm += movingImageValue; // Only needed when m_SubtractMean == true
+      /** Compute the moving image value M(T(x)) and derivative dM/dx and check if
+       * the point is inside the moving image buffer.
+       */
+      if (sampleOk)
+      {
+        sampleOk = this->FastEvaluateMovingImageValueAndDerivative(
+          mappedPoint, movingImageValue, &movingImageDerivative, threadId);
+      }
 
-      /** Compute this voxel's contribution to the derivative terms. */
-      this->UpdateDerivativeTerms(
-        fixedImageValue, movingImageValue, imageJacobian, nzji, derivativeF, derivativeM, differential);
+      if (sampleOk)
+      {
+        ++numberOfPixelsCounted;
 
-    } // end if sampleOk
+        /** Get the fixed image value. */
+        const RealType fixedImageValue = static_cast<RealType>(threader_fiter->Value().m_ImageValue);
 
-  } // end for loop over the image sample container
+        /** Update some sums needed to calculate the value of NC. */
+        sff += fixedImageValue * fixedImageValue;
+        smm += movingImageValue * movingImageValue;
+        sfm += fixedImageValue * movingImageValue;
+        sf += fixedImageValue;  // Only needed when m_SubtractMean == true
+        sm += movingImageValue; // Only needed when m_SubtractMean == true
+
+        updateDerivativeTerms(sampleIndex, fixedPoint, fixedImageValue, movingImageValue, movingImageDerivative);
+      }
+    }
+  }
+
+  /** Process the remaining samples. */
+  processBlock();
 
   /** Only update these variables at the end to prevent unnecessary "false sharing". */
   this->m_CorrelationGetValueAndDerivativePerThreadVariables[threadId].st_NumberOfPixelsCounted = numberOfPixelsCounted;
@@ -182,6 +182,20 @@ namespace elastix
  *   The parameter can be specified for each resolution, or for all resolutions at once.\n
  *   example: <tt>(NoiseCompensation "true")</tt>\n
  *   Default/recommended: true.
+ * \parameter AutomaticParameterEstimationCacheFile: A file in which the results of the automatic
+ *   parameter estimation are stored. The results are reused, instead of estimated again, when the
+ *   estimation is repeated with the same metrics and metric weights, fixed and moving image geometry,
+ *   transform grid (fixed parameters) and estimation settings, for example in a later registration
+ *   of a similar image. Note that the
+ *   image intensities and the mask are not taken into account.
+ *   The parameter can be specified for each resolution, or for all resolutions at once.\n
+ *   example: <tt>(AutomaticParameterEstimationCacheFile "asgd_parameters.txt")</tt>\n
+ *   Default: "", which means that the results are not cached.
+ *
+ * Of the automatic parameter estimation, the Jacobian terms (see NumberOfJacobianMeasurements)
+ * are computed on multiple threads. The gradient measurements (see NumberOfGradientMeasurements)
+ * are taken one after another, because each of them switches the image samplers of the single
+ * elastix metric; only the metric evaluation of each gradient is multi-threaded.
  *
  * \todo: this class contains a lot of functional code, which actually does not belong here.
  *
@@ -379,12 +393,28 @@ protected:
   virtual void
   AutomaticParameterEstimationUsingDisplacementDistribution();
 
+  /** Get the key under which the results of the automatic parameter estimation are
+   * stored in the cache file: the estimation settings, the metrics and their weights, the
+   * geometry of the fixed and moving image, and the number of parameters and fixed parameters
+   * of the transform. */
+  virtual std::string
+  GetAutomaticParameterEstimationCacheKey(const std::string & estimationMethod);
+
+  /** Look up the settings stored under key in the cache file. Returns false if not found. */
+  virtual bool
+  ReadCachedSettings(const std::string & key, SettingsType & settings) const;
+
+  /** Append the settings to the cache file, under key. */
+  virtual void
+  WriteCachedSettings(const std::string & key, const SettingsType & settings) const;
+
   /** Measure some derivatives, exact and approximated. Returns
    * the squared magnitude of the gradient and approximation error.
    * Needed for the automatic parameter estimation.
    * Gradients are measured at position mu_n, which are generated according to:
    * mu_n - mu_0 ~ N(0, perturbationSigma^2 I );
    * gg = g^T g, etc.
+   * The gradients are measured one after another, using the metric of the registration.
    */
   virtual void
   SampleGradients(const ParametersType & mu0, double perturbationSigma, double & gg, double & ee);
@@ -421,6 +451,9 @@ private:
   /** The flag of using noise compensation. */
   bool m_UseNoiseCompensation;
   bool m_OriginalButSigmoidToDefault;
+
+  /** The file in which the automatically estimated parameters are cached. */
+  std::string m_AutomaticParameterEstimationCacheFileName;
 };
 
 } // end namespace elastix
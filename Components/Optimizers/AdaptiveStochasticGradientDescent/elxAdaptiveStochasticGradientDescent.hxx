@@ -20,6 +20,7 @@
 
 #include "elxAdaptiveStochasticGradientDescent.h"
 
+#include <fstream>
 #include <iomanip>
 #include <string>
 #include <vector>
@@ -224,6 +225,14 @@ AdaptiveStochasticGradientDescent<TElastix>::BeforeEachResolution()
       sigmoidScaleFactor, "SigmoidScaleFactor", this->GetComponentLabel(), level, 0);
     this->m_SigmoidScaleFactor = sigmoidScaleFactor;
 
+    /** Set the file in which the estimated parameters are cached. Default: no caching. */
+    this->m_AutomaticParameterEstimationCacheFileName.clear();
+    this->GetConfiguration()->ReadParameter(this->m_AutomaticParameterEstimationCacheFileName,
+                                            "AutomaticParameterEstimationCacheFile",
+                                            this->GetComponentLabel(),
+                                            level,
+                                            0);
+
   } // end if automatic parameter estimation
   else
   {
@@ -281,9 +290,21 @@ AdaptiveStochasticGradientDescent<TElastix>::AfterEachIteration()
     this->GetIterationInfoAt("4:||Gradient||") << this->GetGradient().magnitude();
   }
 
-  /** Select new spatial samples for the computation of the metric. */
+  /** Stop when the statistics of the last iterations show convergence. */
+  if (this->DetectStochasticConvergence(this->GetValue(), this->GetGradient()))
+  {
+    this->StopOptimization();
+  }
+
+  /** Select new spatial samples for the computation of the metric, possibly
+   * adapting their number to the noise in the gradient. */
   if (this->GetNewSamplesEveryIteration())
   {
+    if (!this->AdaptNumberOfSamples(this->GetGradient()))
+    {
+      this->m_StopCondition = MaximumNumberOfSamples;
+      this->StopOptimization();
+    }
     this->SelectNewSamples();
   }
 
@@ -305,7 +326,8 @@ AdaptiveStochasticGradientDescent<TElastix>::AfterEachResolution()
    * enum StopConditionType {
    *   MaximumNumberOfIterations,
    *   MetricError,
-   *   MinimumStepSize };
+   *   MinimumStepSize,
+   *   MaximumNumberOfSamples };
    */
   std::string stopcondition;
 
@@ -323,11 +345,21 @@ AdaptiveStochasticGradientDescent<TElastix>::AfterEachResolution()
       stopcondition = "The minimum step length has been reached";
       break;
 
+    case MaximumNumberOfSamples:
+      stopcondition = "The budget of spatial samples has been used";
+      break;
+
     default:
       stopcondition = "Unknown";
       break;
   }
 
+  /** The stochastic convergence detection stops the optimization without a stop condition. */
+  if (!this->GetStochasticConvergenceStopReason().empty())
+  {
+    stopcondition = this->GetStochasticConvergenceStopReason();
+  }
+
   /** Print the stopping condition. */
   elxout << "Stopping condition: " << stopcondition << "." << std::endl;
 
@@ -472,24 +504,66 @@ AdaptiveStochasticGradientDescent<TElastix>::AutomaticParameterEstimation()
   this->GetConfiguration()->ReadParameter(
     asgdParameterEstimationMethod, "ASGDParameterEstimationMethod", this->GetComponentLabel(), 0, 0);
 
-  /** Perform automatic optimizer parameter estimation by the desired method. */
-  if (asgdParameterEstimationMethod == "Original")
+  /** Look up the results of a previous estimation with the same settings, if desired. */
+  const bool        useCache = !this->m_AutomaticParameterEstimationCacheFileName.empty();
+  const std::string cacheKey =
+    useCache ? this->GetAutomaticParameterEstimationCacheKey(asgdParameterEstimationMethod) : std::string();
+  SettingsType cachedSettings;
+  if (useCache && this->ReadCachedSettings(cacheKey, cachedSettings))
   {
-    /** Original ASGD estimation method. */
-    this->m_OriginalButSigmoidToDefault = false;
-    this->AutomaticParameterEstimationOriginal();
+    elxout << "  Using the cached estimation from " << this->m_AutomaticParameterEstimationCacheFileName << std::endl;
+    this->SetParam_a(cachedSettings.a);
+    this->SetParam_alpha(cachedSettings.alpha);
+    if (asgdParameterEstimationMethod == "Original")
+    {
+      this->SetSigmoidMax(cachedSettings.fmax);
+      this->SetSigmoidMin(cachedSettings.fmin);
+      this->SetSigmoidScale(cachedSettings.omega);
+    }
   }
-  else if (asgdParameterEstimationMethod == "OriginalButSigmoidToDefault")
+  else
   {
-    /** Original ASGD estimation method, but keeping the sigmoid parameters fixed. */
-    this->m_OriginalButSigmoidToDefault = true;
-    this->AutomaticParameterEstimationOriginal();
+    /** Perform automatic optimizer parameter estimation by the desired method. */
+    if (asgdParameterEstimationMethod == "Original")
+    {
+      /** Original ASGD estimation method. */
+      this->m_OriginalButSigmoidToDefault = false;
+      this->AutomaticParameterEstimationOriginal();
+    }
+    else if (asgdParameterEstimationMethod == "OriginalButSigmoidToDefault")
+    {
+      /** Original ASGD estimation method, but keeping the sigmoid parameters fixed. */
+      this->m_OriginalButSigmoidToDefault = true;
+      this->AutomaticParameterEstimationOriginal();
+    }
+    else if (asgdParameterEstimationMethod == "DisplacementDistribution")
+    {
+      /** Accelerated parameter estimation method. */
+      this->AutomaticParameterEstimationUsingDisplacementDistribution();
+    }
+
+    /** Store the results for later registrations. */
+    if (useCache)
+    {
+      SettingsType settings;
+      settings.a = this->GetParam_a();
+      settings.A = this->GetParam_A();
+      settings.alpha = this->GetParam_alpha();
+      settings.fmax = this->GetSigmoidMax();
+      settings.fmin = this->GetSigmoidMin();
+      settings.omega = this->GetSigmoidScale();
+      this->WriteCachedSettings(cacheKey, settings);
+    }
   }
-  else if (asgdParameterEstimationMethod == "DisplacementDistribution")
+
+  /** Print the estimated parameters. */
+  elxout << "  Estimated SP_a: " << this->GetParam_a() << ", SP_alpha: " << this->GetParam_alpha();
+  if (asgdParameterEstimationMethod == "Original")
   {
-    /** Accelerated parameter estimation method. */
-    this->AutomaticParameterEstimationUsingDisplacementDistribution();
+    elxout << ", SigmoidMax: " << this->GetSigmoidMax() << ", SigmoidMin: " << this->GetSigmoidMin()
+           << ", SigmoidScale: " << this->GetSigmoidScale();
   }
+  elxout << std::endl;
 
   /** Print the elapsed time. */
   timer1.Stop();
@@ -754,6 +828,139 @@ AdaptiveStochasticGradientDescent<TElastix>::AutomaticParameterEstimationUsingDi
 } // end AutomaticParameterEstimationUsingDisplacementDistribution()
 
 
+/**
+ * *************** GetAutomaticParameterEstimationCacheKey *****
+ */
+
+template <class TElastix>
+std::string
+AdaptiveStochasticGradientDescent<TElastix>::GetAutomaticParameterEstimationCacheKey(
+  const std::string & estimationMethod)
+{
+  std::ostringstream key;
+  key << std::setprecision(17);
+
+  /** The estimation settings. */
+  std::string maximumDisplacementEstimationMethod = "2sigma";
+  this->GetConfiguration()->ReadParameter(
+    maximumDisplacementEstimationMethod, "MaximumDisplacementEstimationMethod", this->GetComponentLabel(), 0, 0);
+  bool useNoiseCompensation = true;
+  this->GetConfiguration()->ReadParameter(useNoiseCompensation, "NoiseCompensation", this->GetComponentLabel(), 0, 0);
+  key << estimationMethod << ' ' << maximumDisplacementEstimationMethod << ' ' << useNoiseCompensation << ' '
+      << this->m_MaximumStepLength << ' ' << this->GetParam_A() << ' ' << this->m_NumberOfJacobianMeasurements << ' '
+      << this->m_NumberOfGradientMeasurements << ' ' << this->m_NumberOfSamplesForExactGradient << ' '
+      << this->m_SigmoidScaleFactor << ' ' << this->m_MaxBandCovSize << ' ' << this->m_NumberOfBandStructureSamples
+      << ' ' << this->GetNewSamplesEveryIteration();
+  if (this->GetUseScales())
+  {
+    key << " scales " << this->m_ScaledCostFunction->GetScales();
+  }
+
+  /** The metrics and their weights, as used at the current resolution level. */
+  const unsigned int level = static_cast<unsigned int>(this->m_Registration->GetAsITKBaseType()->GetCurrentLevel());
+  const unsigned int numberOfMetrics = this->GetElastix()->GetNumberOfMetrics();
+  bool               useRelativeWeights = false;
+  this->GetConfiguration()->ReadParameter(useRelativeWeights, "UseRelativeWeights", 0, false);
+  key << " metrics " << useRelativeWeights;
+  for (unsigned int i = 0; i < numberOfMetrics; ++i)
+  {
+    const std::string metricName = "Metric" + std::to_string(i);
+    double            weight = 1.0 / static_cast<double>(numberOfMetrics);
+    this->GetConfiguration()->ReadParameter(
+      weight, metricName + (useRelativeWeights ? "RelativeWeight" : "Weight"), "", level, 0, false);
+    bool use = true;
+    this->GetConfiguration()->ReadParameter(use, metricName + "Use", "", level, 0, false);
+    key << ' ' << this->GetElastix()->GetElxMetricBase(i)->GetAsITKBaseType()->GetNameOfClass() << ' ' << weight
+        << ' ' << use;
+  }
+
+  /** The geometry of the fixed and moving image, as used by the metric. */
+  using MetricType = typename ElastixType::MetricBaseType::AdvancedMetricType;
+  const MetricType * metric =
+    dynamic_cast<const MetricType *>(this->GetElastix()->GetElxMetricBase()->GetAsITKBaseType());
+  if (metric != nullptr && metric->GetFixedImage() != nullptr)
+  {
+    const FixedImageType &       fixedImage = *metric->GetFixedImage();
+    const FixedImageRegionType & region = metric->GetFixedImageRegion();
+    key << " image " << fixedImage.GetLargestPossibleRegion().GetSize() << ' ' << fixedImage.GetSpacing() << ' '
+        << fixedImage.GetOrigin() << ' ' << fixedImage.GetDirection() << ' ' << region.GetIndex() << ' '
+        << region.GetSize();
+  }
+  if (metric != nullptr && metric->GetMovingImage() != nullptr)
+  {
+    const auto & movingImage = *metric->GetMovingImage();
+    key << " moving " << movingImage.GetLargestPossibleRegion().GetSize() << ' ' << movingImage.GetSpacing() << ' '
+        << movingImage.GetOrigin() << ' ' << movingImage.GetDirection();
+  }
+
+  /** The transform. */
+  const TransformType & transform = *this->GetRegistration()->GetAsITKBaseType()->GetModifiableTransform();
+  key << " transform " << transform.GetNameOfClass() << ' ' << transform.GetNumberOfParameters() << ' '
+      << transform.GetFixedParameters();
+
+  /** The key is stored on a single line, before a tab. */
+  std::string keyString = key.str();
+  std::replace_if(
+    keyString.begin(), keyString.end(), [](const char c) { return c == '\n' || c == '\t'; }, ' ');
+  return keyString;
+
+} // end GetAutomaticParameterEstimationCacheKey()
+
+
+/**
+ * *************** ReadCachedSettings **************************
+ */
+
+template <class TElastix>
+bool
+AdaptiveStochasticGradientDescent<TElastix>::ReadCachedSettings(const std::string & key, SettingsType & settings) const
+{
+  /** Each line holds a key, a tab, and the settings. The last matching line is used. */
+  std::ifstream file(this->m_AutomaticParameterEstimationCacheFileName);
+  bool          found = false;
+  std::string   line;
+  while (std::getline(file, line))
+  {
+    const std::string::size_type tab = line.rfind('\t');
+    if (tab != std::string::npos && line.compare(0, tab, key) == 0 && tab == key.size())
+    {
+      std::istringstream values(line.substr(tab + 1));
+      SettingsType       lineSettings;
+      if (values >> lineSettings.a >> lineSettings.A >> lineSettings.alpha >> lineSettings.fmax >> lineSettings.fmin >>
+          lineSettings.omega)
+      {
+        settings = lineSettings;
+        found = true;
+      }
+    }
+  }
+  return found;
+
+} // end ReadCachedSettings()
+
+
+/**
+ * *************** WriteCachedSettings **************************
+ */
+
+template <class TElastix>
+void
+AdaptiveStochasticGradientDescent<TElastix>::WriteCachedSettings(const std::string &  key,
+                                                                 const SettingsType & settings) const
+{
+  std::ofstream file(this->m_AutomaticParameterEstimationCacheFileName, std::ios::app);
+  if (!file)
+  {
+    xl::xout["warning"] << "WARNING: the automatic parameter estimation could not be cached in "
+                        << this->m_AutomaticParameterEstimationCacheFileName << std::endl;
+    return;
+  }
+  file << std::setprecision(17) << key << '\t' << settings.a << ' ' << settings.A << ' ' << settings.alpha << ' '
+       << settings.fmax << ' ' << settings.fmin << ' ' << settings.omega << '\n';
+
+} // end WriteCachedSettings()
+
+
 /**
  * ******************** SampleGradients **********************
  */
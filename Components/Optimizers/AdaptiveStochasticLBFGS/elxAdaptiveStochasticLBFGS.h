@@ -26,6 +26,7 @@
 #include "itkMersenneTwisterRandomVariateGenerator.h"
 #include "itkComputeJacobianTerms.h"
 #include "itkComputeDisplacementDistribution.h"
+#include "itkLBFGSHistory.h"
 #include "itkPlatformMultiThreader.h"
 #include "itkImageRandomSampler.h"
 #include "itkLineSearchOptimizer.h"
@@ -92,6 +93,11 @@ namespace elastix
  *   example: <tt>(MaximumStepLength 1.0)</tt>\n
  *   Default: mean voxel spacing of fixed and moving image. This seems to work well in general.
  *   This parameter only has influence when AutomaticParameterEstimation is used.
+ * \parameter UseSinglePrecisionLBFGSHistory: Whether the curvature pairs of the past LBFGSMemory
+ *   updates are stored in single precision. This halves the memory of the optimizer, which may
+ *   be considerable for dense B-spline grids. The computations remain in double precision.\n
+ *   example: <tt>(UseSinglePrecisionLBFGSHistory "true")</tt>\n
+ *   Default: "false".
  *
  * \todo: this class contains a lot of functional code, which actually does not belong here.
  *
@@ -288,8 +294,8 @@ protected:
 
   /** For L-BFGS usage. */
   using RhoType = itk::Array<double>;
-  using SType = std::vector<ParametersType>;
-  using YType = std::vector<DerivativeType>;
+  using HistoryType = itk::LBFGSHistory;
+  using HistoryPointer = HistoryType::Pointer;
   using DiagonalMatrixType = itk::Array<double>;
 
   AdaptiveStochasticLBFGS();
@@ -360,7 +366,7 @@ protected:
   virtual void
   AddRandomPerturbation(ParametersType & parameters, double sigma);
 
-  /** Store s = x_k - x_k-1 and y = g_k - g_k-1 in m_S and m_Y,
+  /** Store s = x_k - x_k-1 and y = g_k - g_k-1 in m_History,
    * and store 1/(ys) in m_Rho. */
   virtual void
   StoreCurrentPoint(const ParametersType & step, const DerivativeType & grad_dif);
@@ -393,11 +399,10 @@ protected:
   unsigned int m_PreviousT;
   unsigned int m_Bound;
 
-  RhoType m_Rho;
-  SType   m_S;
-  YType   m_Y;
-  RhoType m_HessianFillValue;
-  double  m_WindowScale;
+  RhoType        m_Rho;
+  HistoryPointer m_History{ HistoryType::New() };
+  RhoType        m_HessianFillValue;
+  double         m_WindowScale;
 
 private:
   elxOverrideGetSelfMacro;
@@ -134,6 +134,12 @@ AdaptiveStochasticLBFGS<TElastix>::BeforeEachResolution()
   this->GetConfiguration()->ReadParameter(memory, "LBFGSMemory", this->GetComponentLabel(), level, 0);
   this->m_LBFGSMemory = memory;
 
+  /** Set whether the curvature pairs are stored in single precision. */
+  bool useSinglePrecisionHistory = false;
+  this->GetConfiguration()->ReadParameter(
+    useSinglePrecisionHistory, "UseSinglePrecisionLBFGSHistory", this->GetComponentLabel(), level, 0);
+  this->m_History->SetUseSinglePrecision(useSinglePrecisionHistory);
+
   /** Set the updateFrequenceL. */
   SizeValueType updateFrequenceL = 5;
   this->GetConfiguration()->ReadParameter(updateFrequenceL, "UpdateFrequenceL", this->GetComponentLabel(), level, 0);
@@ -356,9 +362,21 @@ AdaptiveStochasticLBFGS<TElastix>::AfterEachIteration()
   this->GetIterationInfoAt("4a:||Gradient||") << this->GetGradient().magnitude();
   this->GetIterationInfoAt("4b:||SearchDir||") << this->m_SearchDir.magnitude();
 
-  /** Select new spatial samples for the computation of the metric. */
+  /** Stop when the statistics of the last iterations show convergence. */
+  if (this->DetectStochasticConvergence(this->GetValue(), this->GetGradient()))
+  {
+    this->StopOptimization();
+  }
+
+  /** Select new spatial samples for the computation of the metric, possibly
+   * adapting their number to the noise in the gradient. */
   if (this->GetNewSamplesEveryIteration())
   {
+    if (!this->AdaptNumberOfSamples(this->GetGradient()))
+    {
+      this->m_StopCondition = MaximumNumberOfSamples;
+      this->StopOptimization();
+    }
     this->SelectNewSamples();
   }
 
@@ -406,11 +424,21 @@ AdaptiveStochasticLBFGS<TElastix>::AfterEachResolution()
       stopcondition = "The last step size was (nearly) zero";
       break;
 
+    case MaximumNumberOfSamples:
+      stopcondition = "The budget of spatial samples has been used";
+      break;
+
     default:
       stopcondition = "Unknown";
       break;
   }
 
+  /** The stochastic convergence detection stops the optimization without a stop condition. */
+  if (!this->GetStochasticConvergenceStopReason().empty())
+  {
+    stopcondition = this->GetStochasticConvergenceStopReason();
+  }
+
   /** Print the stopping condition. */
   elxout << "Stopping condition: " << stopcondition << "." << std::endl;
   this->m_CurrentTime = 0.0;
@@ -489,14 +517,13 @@ AdaptiveStochasticLBFGS<TElastix>::StartOptimization()
   /** Get the number of parameters; checks also if a cost function has been set at all.
    * if not: an exception is thrown.
    */
-  this->GetScaledCostFunction()->GetNumberOfParameters();
+  const unsigned int numberOfParameters = this->GetScaledCostFunction()->GetNumberOfParameters();
 
   /** Resize Rho, S and Y. */
   this->m_Rho.SetSize(this->m_LBFGSMemory);
   this->m_HessianFillValue.SetSize(this->m_LBFGSMemory);
   this->m_HessianFillValue.fill(0.0);
-  this->m_S.resize(this->m_LBFGSMemory);
-  this->m_Y.resize(this->m_LBFGSMemory);
+  this->m_History->Initialize(this->m_LBFGSMemory, numberOfParameters);
 
   /** Initialize the scaledCostFunction with the currently set scales */
   this->InitializeScales();
@@ -1530,9 +1557,9 @@ AdaptiveStochasticLBFGS<TElastix>::StoreCurrentPoint(const ParametersType & step
 
   //   const double rho = 1.0 / inner_product( step, grad_dif ) ; // 1/ys
   //   const double  ys = 1.0 / rho;
-  const double ys = inner_product(step, grad_dif); // 1/ys;
+  const double ys = this->m_History->Store(this->m_CurrentT, step, grad_dif); // s, y
   const double rho = 1.0 / ys;
-  const double yy = grad_dif.squared_magnitude();
+  const double yy = this->m_History->GetSquaredMagnitudeOfY(this->m_CurrentT);
 
   double fill_value = ys / yy;
   if (fill_value < 0.0)
@@ -1542,8 +1569,6 @@ AdaptiveStochasticLBFGS<TElastix>::StoreCurrentPoint(const ParametersType & step
     this->StopOptimization();
   }
 
-  this->m_S[this->m_CurrentT] = step;     // expensive copy
-  this->m_Y[this->m_CurrentT] = grad_dif; // expensive copy
   this->m_Rho[this->m_CurrentT] = rho;
   this->m_HessianFillValue[this->m_CurrentT] = fill_value;
 
@@ -1594,7 +1619,7 @@ AdaptiveStochasticLBFGS<TElastix>::ComputeSearchDirection(const DerivativeType &
 {
   itkDebugMacro("ComputeSearchDirection");
 
-  /** Assumes m_Rho, m_S, and m_Y are up-to-date at m_PreviousPoint */
+  /** Assumes m_Rho and m_History are up-to-date at m_PreviousPoint */
   using AlphaType = itk::Array<double>;
   AlphaType alpha(this->m_LBFGSMemory);
 
@@ -1633,14 +1658,9 @@ AdaptiveStochasticLBFGS<TElastix>::ComputeSearchDirection(const DerivativeType &
     {
       cp = this->m_LBFGSMemory - 1;
     }
-    const double sq = inner_product(this->m_S[cp], searchDir);
+    const double sq = this->m_History->InnerProductWithS(cp, searchDir);
     alpha[cp] = this->m_Rho[cp] * sq;
-    const double &         alpha_cp = alpha[cp];
-    const DerivativeType & y = this->m_Y[cp];
-    for (unsigned int j = 0; j < numberOfParameters; ++j)
-    {
-      searchDir[j] -= alpha_cp * y[j];
-    }
+    this->m_History->AddScaledY(cp, -alpha[cp], searchDir);
   }
 
   for (unsigned int j = 0; j < numberOfParameters; ++j)
@@ -1654,14 +1674,9 @@ AdaptiveStochasticLBFGS<TElastix>::ComputeSearchDirection(const DerivativeType &
 
   for (unsigned int i = 0; i < this->m_Bound; ++i)
   {
-    const double           yr = inner_product(this->m_Y[cp], searchDir);
-    const double           beta = this->m_Rho[cp] * yr;
-    const double           alpha_min_beta = alpha[cp] - beta;
-    const ParametersType & s = this->m_S[cp];
-    for (unsigned int j = 0; j < numberOfParameters; ++j)
-    {
-      searchDir[j] += alpha_min_beta * s[j];
-    }
+    const double yr = this->m_History->InnerProductWithY(cp, searchDir);
+    const double beta = this->m_Rho[cp] * yr;
+    this->m_History->AddScaledS(cp, alpha[cp] - beta, searchDir);
     ++cp;
     if (static_cast<unsigned int>(cp) == this->m_LBFGSMemory)
     {
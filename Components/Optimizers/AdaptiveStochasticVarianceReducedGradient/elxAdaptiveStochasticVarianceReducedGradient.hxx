@@ -308,9 +308,21 @@ AdaptiveStochasticVarianceReducedGradient<TElastix>::AfterEachIteration()
     this->GetIterationInfoAt("4:||Gradient||") << this->GetGradient().magnitude();
   }
 
-  /** Select new spatial samples for the computation of the metric. */
+  /** Stop when the statistics of the last iterations show convergence. */
+  if (this->DetectStochasticConvergence(this->GetValue(), this->GetGradient()))
+  {
+    this->StopOptimization();
+  }
+
+  /** Select new spatial samples for the computation of the metric, possibly
+   * adapting their number to the noise in the gradient. */
   if (this->GetNewSamplesEveryIteration())
   {
+    if (!this->AdaptNumberOfSamples(this->GetGradient()))
+    {
+      this->m_StopCondition = MaximumNumberOfSamples;
+      this->StopOptimization();
+    }
     this->SelectNewSamples();
   }
 
@@ -346,11 +358,21 @@ AdaptiveStochasticVarianceReducedGradient<TElastix>::AfterEachResolution()
       stopcondition = "The minimum step length has been reached";
       break;
 
+    case MaximumNumberOfSamples:
+      stopcondition = "The budget of spatial samples has been used";
+      break;
+
     default:
       stopcondition = "Unknown";
       break;
   }
 
+  /** The stochastic convergence detection stops the optimization without a stop condition. */
+  if (!this->GetStochasticConvergenceStopReason().empty())
+  {
+    stopcondition = this->GetStochasticConvergenceStopReason();
+  }
+
   /** Print the stopping condition. */
   elxout << "Stopping condition: " << stopcondition << "." << std::endl;
   this->m_CurrentTime = 0.0;
@@ -77,7 +77,8 @@ public:
 
   /** Codes of stopping conditions
    * The MinimumStepSize stop condition never occurs, but may
-   * be implemented in inheriting classes */
+   * be implemented in inheriting classes. The MaximumNumberOfSamples
+   * stop condition is set by the users of an adaptive number of samples. */
   enum StopConditionType
   {
     MaximumNumberOfIterations,
@@ -85,7 +86,8 @@ public:
     MinimumStepSize,
     InvalidDiagonalMatrix,
     GradientMagnitudeTolerance,
-    LineSearchError
+    LineSearchError,
+    MaximumNumberOfSamples
   };
 
   /** Advance one step following the gradient direction. */
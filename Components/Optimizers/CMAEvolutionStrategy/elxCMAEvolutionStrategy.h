@@ -108,6 +108,10 @@ namespace elastix
  *    example: <tt>(UpdateBDPeriod 0 0 50)</tt> \n
  *    Default: 0 (so, automatically determined).
  *
+ * This component evaluates the offspring one after another. The concurrent evaluation of
+ * the itk::CMAEvolutionStrategyOptimizer is only available through the ITK API, see
+ * itk::ConcurrentCostFunctionEvaluator.
+ *
  * \ingroup Optimizers
  */
 
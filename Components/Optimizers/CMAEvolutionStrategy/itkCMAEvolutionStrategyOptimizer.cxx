@@ -21,6 +21,7 @@
 #include <vnl/vnl_math.h>
 #include <algorithm>
 #include <cmath>
+#include <exception>
 #include "itkCommand.h"
 #include "itkEventObject.h"
 #include "itkMacro.h"
@@ -451,37 +452,74 @@ CMAEvolutionStrategyOptimizer::GenerateOffspring()
 {
   itkDebugMacro("GenerateOffspring");
 
-  /** Get the number of parameters from the cost function */
-  const unsigned int numberOfParameters = this->GetScaledCostFunction()->GetNumberOfParameters();
-
   /** Some casts/aliases: */
-  const unsigned int N = numberOfParameters;
   const unsigned int lambda = this->m_PopulationSize;
 
   /** Clear the old values */
   this->m_CostFunctionValues.clear();
 
-  /** Fill the m_NormalizedSearchDirs and SearchDirs */
-  unsigned int lam = 0;
-  unsigned int nrOfFails = 0;
-  while (lam < lambda)
+  /** With concurrent cost functions, first draw all search directions, in the same
+   * order as below, and evaluate the offspring in parallel. An offspring member for
+   * which the evaluation fails gets a new search direction, as below. */
+  if (!this->GetConcurrentCostFunctions().empty())
   {
-    /** draw from distribution N(0,I) */
-    for (unsigned int par = 0; par < N; ++par)
-    {
-      this->m_NormalizedSearchDirs[lam][par] = this->m_RandomGenerator->GetNormalVariate();
-    }
-    /** Make like it was drawn from N(0,C) */
-    if (this->GetUseCovarianceMatrixAdaptation())
+    ParameterContainerType x(lambda);
+    for (unsigned int lam = 0; lam < lambda; ++lam)
     {
-      this->m_SearchDirs[lam] = this->m_B * (this->m_D * this->m_NormalizedSearchDirs[lam]);
+      this->GenerateSearchDirection(lam);
+      x[lam] = this->GetScaledCurrentPosition();
+      x[lam] += this->m_SearchDirs[lam];
     }
-    else
+
+    std::vector<MeasureType>        costFunctionValues;
+    std::vector<std::exception_ptr> exceptions;
+    this->GetScaledValues(x, costFunctionValues, exceptions);
+
+    for (unsigned int lam = 0; lam < lambda; ++lam)
     {
-      this->m_SearchDirs[lam] = this->m_NormalizedSearchDirs[lam];
+      unsigned int nrOfFails = 0;
+      while (exceptions[lam])
+      {
+        /** As below, only ITK exceptions are retried. Other exceptions are passed on at once. */
+        try
+        {
+          std::rethrow_exception(exceptions[lam]);
+        }
+        catch (const ExceptionObject &)
+        {}
+
+        ++nrOfFails;
+        /** try another parameter vector if we haven't tried that for 10 times already */
+        if (nrOfFails > 10)
+        {
+          this->m_StopCondition = MetricError;
+          this->StopOptimization();
+          std::rethrow_exception(exceptions[lam]);
+        }
+        this->GenerateSearchDirection(lam);
+        x[lam] = this->GetScaledCurrentPosition();
+        x[lam] += this->m_SearchDirs[lam];
+        try
+        {
+          costFunctionValues[lam] = this->GetScaledValue(x[lam]);
+          exceptions[lam] = nullptr;
+        }
+        catch (const ExceptionObject &)
+        {
+          exceptions[lam] = std::current_exception();
+        }
+      }
+      this->m_CostFunctionValues.push_back(MeasureIndexPairType(costFunctionValues[lam], lam));
     }
-    /** Make like it was drawn from N( 0, sigma^2 C ) */
-    this->m_SearchDirs[lam] *= this->m_CurrentSigma;
+    return;
+  }
+
+  /** Fill the m_NormalizedSearchDirs and SearchDirs */
+  unsigned int lam = 0;
+  unsigned int nrOfFails = 0;
+  while (lam < lambda)
+  {
+    this->GenerateSearchDirection(lam);
 
     /** Compute the cost function */
     MeasureType costFunctionValue = 0.0;
@@ -520,6 +558,35 @@ CMAEvolutionStrategyOptimizer::GenerateOffspring()
 } // end GenerateOffspring
 
 
+/**
+ * ****************** GenerateSearchDirection *********************
+ */
+
+void
+CMAEvolutionStrategyOptimizer::GenerateSearchDirection(const unsigned int lam)
+{
+  const unsigned int N = this->GetScaledCostFunction()->GetNumberOfParameters();
+
+  /** draw from distribution N(0,I) */
+  for (unsigned int par = 0; par < N; ++par)
+  {
+    this->m_NormalizedSearchDirs[lam][par] = this->m_RandomGenerator->GetNormalVariate();
+  }
+  /** Make like it was drawn from N(0,C) */
+  if (this->GetUseCovarianceMatrixAdaptation())
+  {
+    this->m_SearchDirs[lam] = this->m_B * (this->m_D * this->m_NormalizedSearchDirs[lam]);
+  }
+  else
+  {
+    this->m_SearchDirs[lam] = this->m_NormalizedSearchDirs[lam];
+  }
+  /** Make like it was drawn from N( 0, sigma^2 C ) */
+  this->m_SearchDirs[lam] *= this->m_CurrentSigma;
+
+} // end GenerateSearchDirection
+
+
 /**
  * ****************** SortCostFunctionValues *********************
  */
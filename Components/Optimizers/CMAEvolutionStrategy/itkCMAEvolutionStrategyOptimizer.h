@@ -43,6 +43,13 @@ namespace itk
  *   - See also the Matlab code, cmaes.m, which you can download from the
  *     website mentioned above.
  *
+ * When concurrent cost functions are set (see SetConcurrentCostFunctions()),
+ * all offspring of a generation are evaluated in parallel. The search directions
+ * are drawn in the same order as in the serial evaluation, so for a given random
+ * seed the optimization follows the same path, as long as no evaluation fails.
+ * The elastix CMAEvolutionStrategy component does not set them, see
+ * ConcurrentCostFunctionEvaluator.
+ *
  * \ingroup Numerics Optimizers
  */
 
@@ -366,6 +373,10 @@ protected:
   virtual void
   GenerateOffspring();
 
+  /** Draw a new m_NormalizedSearchDirs[lam] and compute m_SearchDirs[lam] from it */
+  virtual void
+  GenerateSearchDirection(unsigned int lam);
+
   /** Sort the m_CostFunctionValues vector and update m_MeasureHistory */
   virtual void
   SortCostFunctionValues();
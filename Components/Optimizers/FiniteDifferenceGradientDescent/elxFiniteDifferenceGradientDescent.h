@@ -71,6 +71,10 @@ namespace elastix
  *   example: <tt>(ShowMetricValues "true" )</tt> \n
  *   Default value: "false". Note that turning this flag on increases computation time.
 
+ *
+ * This component evaluates the perturbed positions one after another. The concurrent
+ * evaluation of the itk::FiniteDifferenceGradientDescentOptimizer is only available
+ * through the ITK API, see itk::ConcurrentCostFunctionEvaluator.
  *
  * \ingroup Optimizers
  * \sa FiniteDifferenceGradientDescentOptimizer
@@ -20,6 +20,11 @@
 #include "itkCommand.h"
 #include "itkEventObject.h"
 #include "itkMacro.h"
+#include "itkConcurrentCostFunctionEvaluator.h"
+
+#include <algorithm>
+#include <exception>
+#include <vector>
 
 #include "math.h"
 #include <vnl/vnl_math.h>
@@ -150,20 +155,32 @@ FiniteDifferenceGradientDescentOptimizer::ResumeOptimization()
     /** Calculate the derivative; this may take a while... */
     try
     {
-      for (unsigned int j = 0; j < spaceDimension; ++j)
+      if (!this->GetConcurrentCostFunctions().empty())
+      {
+        /** Evaluate the perturbed positions in parallel. */
+        this->ComputeGradientConcurrently(param, ck, this->m_Gradient);
+        for (unsigned int j = 0; j < spaceDimension; ++j)
+        {
+          sumOfSquaredGradients += (this->m_Gradient[j] * this->m_Gradient[j]);
+        }
+      }
+      else
       {
-        param[j] += ck;
-        valueplus = this->GetScaledValue(param);
-        param[j] -= 2.0 * ck;
-        valuemin = this->GetScaledValue(param);
-        param[j] += ck;
+        for (unsigned int j = 0; j < spaceDimension; ++j)
+        {
+          param[j] += ck;
+          valueplus = this->GetScaledValue(param);
+          param[j] -= 2.0 * ck;
+          valuemin = this->GetScaledValue(param);
+          param[j] += ck;
 
-        const double gradient = (valueplus - valuemin) / (2.0 * ck);
-        this->m_Gradient[j] = gradient;
+          const double gradient = (valueplus - valuemin) / (2.0 * ck);
+          this->m_Gradient[j] = gradient;
 
-        sumOfSquaredGradients += (gradient * gradient);
+          sumOfSquaredGradients += (gradient * gradient);
 
-      } // for j = 0 .. spaceDimension
+        } // for j = 0 .. spaceDimension
+      }
     }
     catch (const ExceptionObject &)
     {
@@ -194,6 +211,53 @@ FiniteDifferenceGradientDescentOptimizer::ResumeOptimization()
 } // end ResumeOptimization
 
 
+/**
+ * ****************** ComputeGradientConcurrently ***************
+ */
+
+void
+FiniteDifferenceGradientDescentOptimizer::ComputeGradientConcurrently(ParametersType & param,
+                                                                      const double     ck,
+                                                                      DerivativeType & gradient) const
+{
+  const unsigned int spaceDimension = param.GetSize();
+
+  /** Evaluate the parameters in blocks, to limit the memory used by the perturbed
+   * positions, while keeping all cost functions busy. */
+  const auto         numberOfCostFunctions = static_cast<unsigned int>(this->GetConcurrentCostFunctions().size() + 1);
+  const unsigned int blockSize = std::min(spaceDimension, 8 * numberOfCostFunctions);
+
+  std::vector<ParametersType>     positions;
+  std::vector<MeasureType>        values;
+  std::vector<std::exception_ptr> exceptions;
+  for (unsigned int blockBegin = 0; blockBegin < spaceDimension; blockBegin += blockSize)
+  {
+    const unsigned int blockEnd = std::min(blockBegin + blockSize, spaceDimension);
+
+    /** The positions param + ck e_j and param - ck e_j, for all j in the block,
+     * computed with exactly the same operations as the serial evaluation. */
+    positions.resize(2 * (blockEnd - blockBegin));
+    for (unsigned int j = blockBegin; j < blockEnd; ++j)
+    {
+      param[j] += ck;
+      positions[2 * (j - blockBegin)] = param;
+      param[j] -= 2.0 * ck;
+      positions[2 * (j - blockBegin) + 1] = param;
+      param[j] += ck;
+    }
+
+    this->GetScaledValues(positions, values, exceptions);
+    ConcurrentCostFunctionEvaluator::RethrowFirstException(exceptions);
+
+    for (unsigned int j = blockBegin; j < blockEnd; ++j)
+    {
+      gradient[j] = (values[2 * (j - blockBegin)] - values[2 * (j - blockBegin) + 1]) / (2.0 * ck);
+    }
+  }
+
+} // end ComputeGradientConcurrently
+
+
 /**
  * ********************** StopOptimization **********************
  */
@@ -48,6 +48,12 @@ namespace itk
  * Note the similarities to the SimultaneousPerturbation optimizer and
  * the StandardGradientDescent optimizer.
  *
+ * When concurrent cost functions are set (see SetConcurrentCostFunctions()),
+ * the perturbed positions of an iteration are evaluated in parallel, and the
+ * gradient is assembled afterwards. The gradient is the same as in the serial
+ * evaluation. The elastix FiniteDifferenceGradientDescent component does not set
+ * them, see ConcurrentCostFunctionEvaluator.
+ *
  * \ingroup Optimizers
  * \sa FiniteDifferenceGradientDescent
  */
@@ -164,6 +170,12 @@ protected:
   virtual double
   Compute_c(unsigned long k) const;
 
+  /** Compute the finite difference gradient at param, with perturbation size ck,
+   * by evaluating the perturbed positions with the concurrent cost functions.
+   * Each element of param is perturbed and restored as in the serial evaluation. */
+  virtual void
+  ComputeGradientConcurrently(ParametersType & param, double ck, DerivativeType & gradient) const;
+
 private:
   /** Private member variables.*/
   bool              m_Stop{ false };
@@ -49,6 +49,10 @@ namespace elastix
  *   and the third parameter in the range [-1.0 1.0] with steps of 0.5. The names are used
  *   as column headers in the screen output.
  *
+ * This component evaluates the search space point by point. The parallel batch evaluation
+ * of the itk::FullSearchOptimizer is only available through the ITK API, see
+ * itk::ConcurrentCostFunctionEvaluator.
+ *
  * \ingroup Optimizers
  * \sa FullSearchOptimizer
  */
@@ -21,6 +21,9 @@
 #include "itkEventObject.h"
 #include "itkMacro.h"
 #include "itkNumericTraits.h"
+#include "itkConcurrentCostFunctionEvaluator.h"
+
+#include <algorithm> // For min.
 
 namespace itk
 {
@@ -81,6 +84,14 @@ FullSearchOptimizer::ResumeOptimization()
   m_Stop = false;
 
   InvokeEvent(StartEvent());
+
+  /** Evaluate the search space in parallel, if possible. */
+  if (!m_ConcurrentCostFunctions.empty())
+  {
+    this->ResumeOptimizationInBatches();
+    return;
+  }
+
   while (!m_Stop)
   {
 
@@ -88,7 +99,7 @@ FullSearchOptimizer::ResumeOptimization()
     {
       m_Value = m_CostFunction->GetValue(this->GetCurrentPosition());
     }
-    catch (ExceptionObject & err)
+    catch (...)
     {
       // An exception has occurred.
       // Terminate immediately.
@@ -132,6 +143,91 @@ FullSearchOptimizer::ResumeOptimization()
 } // end function ResumeOptimization
 
 
+/**
+ * ***************** ResumeOptimizationInBatches *****************
+ */
+void
+FullSearchOptimizer::ResumeOptimizationInBatches()
+{
+  itkDebugMacro("ResumeOptimizationInBatches");
+
+  const unsigned long numberOfIterations = this->GetNumberOfIterations();
+
+  /** Worker 0 uses the cost function itself, the others use the concurrent cost functions. */
+  ConcurrentCostFunctionEvaluator::CostFunctionContainerType costFunctions{ m_CostFunction.GetPointer() };
+  for (const auto & costFunction : m_ConcurrentCostFunctions)
+  {
+    costFunctions.push_back(costFunction.GetPointer());
+  }
+  const unsigned long batchSize = m_BatchSize > 0 ? m_BatchSize : 8 * costFunctions.size();
+
+  ConcurrentCostFunctionEvaluator::ParametersContainerType positions;
+  ConcurrentCostFunctionEvaluator::MeasureContainerType    values;
+  ConcurrentCostFunctionEvaluator::ExceptionContainerType  exceptions;
+  while (!m_Stop)
+  {
+    /** Compute the positions of the next batch. Done serially, because the
+     * conversion functions update the search space administration. */
+    const unsigned long batchBegin = m_CurrentIteration;
+    const unsigned long batchEnd = std::min(batchBegin + batchSize, numberOfIterations);
+    positions.resize(batchEnd - batchBegin);
+    for (unsigned long iteration = batchBegin; iteration < batchEnd; ++iteration)
+    {
+      positions[iteration - batchBegin] = this->IndexToPosition(this->IterationToIndex(iteration));
+    }
+
+    /** Evaluate the batch in parallel. */
+    ConcurrentCostFunctionEvaluator::GetValues(costFunctions, positions, values, exceptions);
+
+    /** Process the results in the same order as the serial search. */
+    for (unsigned long iteration = batchBegin; iteration < batchEnd; ++iteration)
+    {
+      if (exceptions[iteration - batchBegin])
+      {
+        // An exception has occurred at this point, as it would have in the serial search.
+        // Terminate immediately.
+        m_StopCondition = MetricError;
+        StopOptimization();
+
+        // Pass exception to caller
+        std::rethrow_exception(exceptions[iteration - batchBegin]);
+      }
+
+      m_Value = values[iteration - batchBegin];
+
+      /** Check if the value is a minimum or maximum */
+      if ((m_Value < m_BestValue) ^ m_Maximize) // ^ = xor, yields true if only one of the expressions is true
+      {
+        m_BestValue = m_Value;
+        m_BestPointInSearchSpace = m_CurrentPointInSearchSpace;
+        m_BestIndexInSearchSpace = m_CurrentIndexInSearchSpace;
+      }
+
+      this->InvokeEvent(IterationEvent());
+      if (m_Stop)
+      {
+        break;
+      }
+
+      /** Prepare for next step */
+      ++m_CurrentIteration;
+
+      if (m_CurrentIteration >= numberOfIterations)
+      {
+        m_StopCondition = FullRangeSearched;
+        StopOptimization();
+        break;
+      }
+
+      /** Set the next position in search space. */
+      this->UpdateCurrentPosition();
+    }
+
+  } // end while
+
+} // end ResumeOptimizationInBatches()
+
+
 /**
  * ************************** Stop optimization ******************
  */
@@ -431,4 +527,38 @@ FullSearchOptimizer::IndexToPoint(const SearchSpaceIndexType & index)
 } // end IndexToPoint
 
 
+/**
+ * ********************* IterationToIndex ***********************
+ */
+FullSearchOptimizer::SearchSpaceIndexType
+FullSearchOptimizer::IterationToIndex(unsigned long iteration)
+{
+  const unsigned int          searchSpaceDimension = this->GetNumberOfSearchSpaceDimensions();
+  const SearchSpaceSizeType & searchSpaceSize = this->GetSearchSpaceSize();
+  SearchSpaceIndexType        index(searchSpaceDimension);
+
+  /** The first dimension varies fastest, see UpdateCurrentPosition(). */
+  for (unsigned int ssdim = 0; ssdim < searchSpaceDimension; ++ssdim)
+  {
+    index[ssdim] = static_cast<IndexValueType>(iteration % searchSpaceSize[ssdim]);
+    iteration /= searchSpaceSize[ssdim];
+  }
+
+  return index;
+
+} // end IterationToIndex
+
+
+/**
+ * ****************** SetConcurrentCostFunctions ****************
+ */
+void
+FullSearchOptimizer::SetConcurrentCostFunctions(const CostFunctionContainerType & costFunctions)
+{
+  m_ConcurrentCostFunctions = costFunctions;
+  this->Modified();
+
+} // end SetConcurrentCostFunctions
+
+
 } // end namespace itk
@@ -25,6 +25,8 @@
 #include "itkArray.h"
 #include "itkFixedArray.h"
 
+#include <vector>
+
 namespace itk
 {
 
@@ -35,6 +37,14 @@ namespace itk
  * Optimizer that scans a subspace of the parameter space
  * and searches for the best parameters.
  *
+ * The cost function is evaluated at one point of the search space at a time.
+ * When concurrent cost functions are set (see ConcurrentCostFunctionEvaluator),
+ * the points are evaluated in batches: the points of a batch are distributed over
+ * the cost functions, which are evaluated in parallel. Afterwards, the results are
+ * processed in the normal order, so that the best point, the iteration events, the
+ * stop condition and a possible metric error are the same as in the serial search.
+ * The elastix FullSearch component does not set them, see ConcurrentCostFunctionEvaluator.
+ *
  * \todo This optimizer has similar functionality as the recently added
  * itkExhaustiveOptimizer. See if we can replace it by that optimizer,
  * or inherit from it.
@@ -91,6 +101,9 @@ public:
   /** The size of each dimension to be searched ((max-min)/step)) */
   using SearchSpaceSizeType = Array<SizeValueType>;
 
+  /** A list of cost functions that can be evaluated concurrently. */
+  using CostFunctionContainerType = std::vector<CostFunctionPointer>;
+
   /** NB: The methods SetScales has no influence! */
 
   /** Methods to configure the cost function. */
@@ -196,6 +209,29 @@ public:
   virtual SearchSpacePointType
   IndexToPoint(const SearchSpaceIndexType & index);
 
+  /** Convert an iteration number to the index that is searched in that iteration. */
+  virtual SearchSpaceIndexType
+  IterationToIndex(unsigned long iteration);
+
+  /** Set/Get the concurrent cost functions, see ConcurrentCostFunctionEvaluator.
+   * When set, the search space is evaluated in parallel batches. Empty by default.
+   */
+  void
+  SetConcurrentCostFunctions(const CostFunctionContainerType & costFunctions);
+
+  const CostFunctionContainerType &
+  GetConcurrentCostFunctions() const
+  {
+    return this->m_ConcurrentCostFunctions;
+  }
+
+  /** Set/Get the number of points evaluated in parallel, before the results are
+   * processed. Only used with concurrent cost functions. The default, 0, selects
+   * 8 points per cost function.
+   */
+  itkSetMacro(BatchSize, unsigned long);
+  itkGetConstMacro(BatchSize, unsigned long);
+
   /** Get the current iteration number. */
   itkGetConstMacro(CurrentIteration, unsigned long);
 
@@ -240,8 +276,15 @@ protected:
   virtual void
   ProcessSearchSpaceChanges();
 
+  /** Evaluate the points of the next batch in parallel, and process the results in order. */
+  virtual void
+  ResumeOptimizationInBatches();
+
 private:
   unsigned long m_CurrentIteration{ 0 };
+
+  CostFunctionContainerType m_ConcurrentCostFunctions;
+  unsigned long             m_BatchSize{ 0 };
 };
 
 } // end namespace itk
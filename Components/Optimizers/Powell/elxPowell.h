@@ -33,7 +33,7 @@ namespace elastix
  * information.
  * For detailed information about the optimisation method, please read the
  * documentation of the itkPowellOptimizer (in the ITK-manual).
- * \sa ImprovedPowellOptimizer
+ * \sa ImprovedPowellOptimizer, SpeculativePowell
  * \ingroup Optimizers
  */
 
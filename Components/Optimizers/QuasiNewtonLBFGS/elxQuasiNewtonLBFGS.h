@@ -75,6 +75,11 @@ namespace elastix
  *    line search.\n
  *    example: <tt>(LBFGSUpdateAccuracy 5 10 20)</tt> \n
  *    Default value: 5.\n
+ * \parameter UseSinglePrecisionLBFGSHistory: Whether the vectors of the past iterations are
+ *    stored in single precision. This halves the memory of the optimizer, which may be
+ *    considerable for dense B-spline grids. The computations remain in double precision.\n
+ *    example: <tt>(UseSinglePrecisionLBFGSHistory "true")</tt> \n
+ *    Default value: "false".\n
  * \parameter StopIfWolfeNotSatisfied: Whether to stop the optimisation if in one iteration
  *    the Wolfe conditions can not be satisfied by the itk::MoreThuenteLineSearchOptimizer.\n
  *    In general it is wise to do so.\n
@@ -261,6 +261,12 @@ QuasiNewtonLBFGS<TElastix>::BeforeEachResolution()
   this->m_Configuration->ReadParameter(LBFGSUpdateAccuracy, "LBFGSUpdateAccuracy", this->GetComponentLabel(), level, 0);
   this->SetMemory(LBFGSUpdateAccuracy);
 
+  /** Set whether the history is stored in single precision. */
+  bool useSinglePrecisionHistory = false;
+  this->m_Configuration->ReadParameter(
+    useSinglePrecisionHistory, "UseSinglePrecisionLBFGSHistory", this->GetComponentLabel(), level, 0);
+  this->SetUseSinglePrecisionHistory(useSinglePrecisionHistory);
+
   /** Check whether to stop optimisation if Wolfe conditions are not satisfied. */
   this->m_StopIfWolfeNotSatisfied = true;
   std::string stopIfWolfeNotSatisfied = "true";
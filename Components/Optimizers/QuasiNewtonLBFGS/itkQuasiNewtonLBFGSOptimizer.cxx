@@ -61,10 +61,10 @@ QuasiNewtonLBFGSOptimizer::StartOptimization()
   this->m_CurrentGradient.SetSize(numberOfParameters);
   this->m_CurrentGradient.Fill(0.0);
 
-  /** Resize Rho, Alpha, S and Y. */
+  /** Resize Rho, S and Y. */
   this->m_Rho.SetSize(this->GetMemory());
-  this->m_S.resize(this->GetMemory());
-  this->m_Y.resize(this->GetMemory());
+  this->m_History->SetUseSinglePrecision(this->m_UseSinglePrecisionHistory);
+  this->m_History->Initialize(this->GetMemory(), numberOfParameters);
 
   /** Initialize the scaledCostFunction with the currently set scales */
   this->InitializeScales();
@@ -145,7 +145,7 @@ QuasiNewtonLBFGSOptimizer::ResumeOptimization()
       break;
     }
 
-    /** Store s (in m_S), y (in m_Y), and ys (in m_Rho). These are used to
+    /** Store s and y (in m_History), and ys (in m_Rho). These are used to
      * compute the search direction in the next iterations */
     if (this->GetMemory() > 0)
     {
@@ -158,7 +158,7 @@ QuasiNewtonLBFGSOptimizer::ResumeOptimization()
       y.clear();
     }
 
-    /** Number of valid entries in m_S and m_Y */
+    /** Number of valid entries in m_History */
     if (this->m_Bound < this->GetMemory())
     {
       this->m_Bound++;
@@ -179,7 +179,7 @@ QuasiNewtonLBFGSOptimizer::ResumeOptimization()
       break;
     }
 
-    /** Update the index of m_S and m_Y for the next iteration */
+    /** Update the index of m_History for the next iteration */
     this->m_PreviousPoint = this->m_Point;
     this->m_Point++;
     if (this->m_Point >= this->m_Memory)
@@ -220,9 +220,8 @@ QuasiNewtonLBFGSOptimizer::ComputeDiagonalMatrix(DiagonalMatrixType & diag_H0)
 
   if (this->m_Bound > 0)
   {
-    const DerivativeType & y = this->m_Y[this->m_PreviousPoint];
-    const double           ys = 1.0 / this->m_Rho[this->m_PreviousPoint];
-    const double           yy = y.squared_magnitude();
+    const double ys = 1.0 / this->m_Rho[this->m_PreviousPoint];
+    const double yy = this->m_History->GetSquaredMagnitudeOfY(this->m_PreviousPoint);
     fill_value = ys / yy;
     if (fill_value <= 0.)
     {
@@ -245,7 +244,7 @@ QuasiNewtonLBFGSOptimizer::ComputeSearchDirection(const DerivativeType & gradien
 {
   itkDebugMacro("ComputeSearchDirection");
 
-  /** Assumes m_Rho, m_S, and m_Y are up-to-date at m_PreviousPoint */
+  /** Assumes m_Rho and m_History are up-to-date at m_PreviousPoint */
 
   using AlphaType = Array<double>;
   AlphaType alpha(this->GetMemory());
@@ -265,14 +264,9 @@ QuasiNewtonLBFGSOptimizer::ComputeSearchDirection(const DerivativeType & gradien
     {
       cp = this->GetMemory() - 1;
     }
-    const double sq = inner_product(this->m_S[cp], searchDir);
+    const double sq = this->m_History->InnerProductWithS(cp, searchDir);
     alpha[cp] = this->m_Rho[cp] * sq;
-    const double &         alpha_cp = alpha[cp];
-    const DerivativeType & y = this->m_Y[cp];
-    for (unsigned int j = 0; j < numberOfParameters; ++j)
-    {
-      searchDir[j] -= alpha_cp * y[j];
-    }
+    this->m_History->AddScaledY(cp, -alpha[cp], searchDir);
   }
 
   for (unsigned int j = 0; j < numberOfParameters; ++j)
@@ -282,14 +276,9 @@ QuasiNewtonLBFGSOptimizer::ComputeSearchDirection(const DerivativeType & gradien
 
   for (unsigned int i = 0; i < this->m_Bound; ++i)
   {
-    const double           yr = inner_product(this->m_Y[cp], searchDir);
-    const double           beta = this->m_Rho[cp] * yr;
-    const double           alpha_min_beta = alpha[cp] - beta;
-    const ParametersType & s = this->m_S[cp];
-    for (unsigned int j = 0; j < numberOfParameters; ++j)
-    {
-      searchDir[j] += alpha_min_beta * s[j];
-    }
+    const double yr = this->m_History->InnerProductWithY(cp, searchDir);
+    const double beta = this->m_Rho[cp] * yr;
+    this->m_History->AddScaledS(cp, alpha[cp] - beta, searchDir);
     ++cp;
     if (static_cast<unsigned int>(cp) == this->GetMemory())
     {
@@ -378,9 +367,8 @@ QuasiNewtonLBFGSOptimizer::StoreCurrentPoint(const ParametersType & step, const
 {
   itkDebugMacro("StoreCurrentPoint");
 
-  this->m_S[this->m_Point] = step;                                  // s
-  this->m_Y[this->m_Point] = grad_dif;                              // y
-  this->m_Rho[this->m_Point] = 1.0 / inner_product(step, grad_dif); // 1/ys
+  const double ys = this->m_History->Store(this->m_Point, step, grad_dif); // s, y
+  this->m_Rho[this->m_Point] = 1.0 / ys;                                 // 1/ys
 
 } // end StoreCurrentPoint
 
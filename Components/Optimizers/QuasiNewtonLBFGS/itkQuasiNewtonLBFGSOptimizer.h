@@ -21,7 +21,7 @@
 
 #include "itkScaledSingleValuedNonLinearOptimizer.h"
 #include "itkLineSearchOptimizer.h"
-#include <vector>
+#include "itkLBFGSHistory.h"
 
 namespace itk
 {
@@ -76,8 +76,8 @@ public:
   using Superclass::ScalesType;
 
   using RhoType = Array<double>;
-  using SType = std::vector<ParametersType>;
-  using YType = std::vector<DerivativeType>;
+  using HistoryType = LBFGSHistory;
+  using HistoryPointer = HistoryType::Pointer;
   using DiagonalMatrixType = Array<double>;
   using LineSearchOptimizerType = LineSearchOptimizer;
 
@@ -133,6 +133,12 @@ public:
   itkSetMacro(Memory, unsigned int);
   itkGetConstMacro(Memory, unsigned int);
 
+  /** Setting: whether the s and y vectors of the last Memory iterations are
+   * stored in single precision, which halves the memory they take. False by default. */
+  itkSetMacro(UseSinglePrecisionHistory, bool);
+  itkGetConstMacro(UseSinglePrecisionHistory, bool);
+  itkBooleanMacro(UseSinglePrecisionHistory);
+
 protected:
   QuasiNewtonLBFGSOptimizer();
   ~QuasiNewtonLBFGSOptimizer() override = default;
@@ -152,9 +158,9 @@ protected:
   /** Is true when the LineSearchOptimizer has been started. */
   bool m_InLineSearch{ false };
 
-  RhoType m_Rho;
-  SType   m_S;
-  YType   m_Y;
+  /** The vectors s and y, and 1/(ys), of the last Memory iterations. */
+  RhoType        m_Rho;
+  HistoryPointer m_History{ HistoryType::New() };
 
   unsigned int m_Point{ 0 };
   unsigned int m_PreviousPoint{ 0 };
@@ -185,7 +191,7 @@ protected:
   virtual void
   LineSearch(const ParametersType searchDir, double & step, ParametersType & x, MeasureType & f, DerivativeType & g);
 
-  /** Store s = x_k - x_k-1 and y = g_k - g_k-1 in m_S and m_Y,
+  /** Store s = x_k - x_k-1 and y = g_k - g_k-1 in m_History,
    * and store 1/(ys) in m_Rho. */
   virtual void
   StoreCurrentPoint(const ParametersType & step, const DerivativeType & grad_dif);
@@ -202,6 +208,7 @@ private:
   double                     m_GradientMagnitudeTolerance{ 1e-5 };
   LineSearchOptimizerPointer m_LineSearchOptimizer{ nullptr };
   unsigned int               m_Memory{ 5 };
+  bool                       m_UseSinglePrecisionHistory{ false };
 };
 
 } // end namespace itk
@@ -33,7 +33,7 @@ namespace elastix
  * information.
  * For detailed information about the optimisation method, please read the
  * documentation of the itkAmoebaOptimizer (in the ITK-manual).
- * \sa ImprovedSimplexOptimizer
+ * \sa ImprovedSimplexOptimizer, SpeculativeSimplex
  * \ingroup Optimizers
  */
 
@@ -21,6 +21,8 @@
 #include "elxIncludes.h" // include first to avoid MSVS warning
 #include "itkSPSAOptimizer.h"
 
+#include <vector>
+
 namespace elastix
 {
 
@@ -76,6 +78,16 @@ namespace elastix
  *   Default value: "false". Note that turning this flag on increases computation time.
  *
  *
+ * When concurrent cost functions are set (see SetConcurrentCostFunctions()),
+ * the paired evaluations of all perturbations of an iteration are done in
+ * parallel. The perturbations are drawn in the same order as in the serial
+ * evaluation, so the gradient estimate is the same. Each concurrent cost
+ * function must be an independent copy of the cost function, with its own
+ * transform. The elastix registration does not set them, so within elastix
+ * this component evaluates the perturbations one after another. Concurrent
+ * evaluation is only available when the optimizer is used via the ITK API,
+ * see itk::ConcurrentCostFunctionEvaluator.
+ *
  * \ingroup Optimizers
  */
 
@@ -117,6 +129,11 @@ public:
 
   /** Typedef for the ParametersType. */
   using typename Superclass1::ParametersType;
+  using typename Superclass1::DerivativeType;
+  using typename Superclass1::ScalesType;
+
+  /** Typedef for a list of cost functions. */
+  using CostFunctionContainerType = std::vector<CostFunctionPointer>;
 
   /** Methods that take care of setting parameters and printing progress information.*/
   void
@@ -141,14 +158,36 @@ public:
   void
   SetInitialPosition(const ParametersType & param) override;
 
+  /** Set/Get the concurrent cost functions, see itk::ConcurrentCostFunctionEvaluator.
+   * Empty by default; the elastix registration does not set them. */
+  void
+  SetConcurrentCostFunctions(const CostFunctionContainerType & costFunctions)
+  {
+    this->m_ConcurrentCostFunctions = costFunctions;
+    this->itk::Object::Modified();
+  }
+
+  const CostFunctionContainerType &
+  GetConcurrentCostFunctions() const
+  {
+    return this->m_ConcurrentCostFunctions;
+  }
+
 protected:
   SimultaneousPerturbation();
   ~SimultaneousPerturbation() override = default;
 
+  /** Compute the gradient estimate. With concurrent cost functions, all perturbations
+   * are drawn first, and the perturbed positions are evaluated in parallel. */
+  void
+  ComputeGradient(const ParametersType & parameters, DerivativeType & gradient) override;
+
   bool m_ShowMetricValues;
 
 private:
   elxOverrideGetSelfMacro;
+
+  CostFunctionContainerType m_ConcurrentCostFunctions;
 };
 
 } // end namespace elastix
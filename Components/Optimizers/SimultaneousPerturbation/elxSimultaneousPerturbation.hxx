@@ -20,8 +20,11 @@
 #define elxSimultaneousPerturbation_hxx
 
 #include "elxSimultaneousPerturbation.h"
+#include "itkConcurrentCostFunctionEvaluator.h"
 #include <iomanip>
+#include <exception>
 #include <string>
+#include <vector>
 #include <vnl/vnl_math.h>
 
 namespace elastix
@@ -238,6 +241,72 @@ SimultaneousPerturbation<TElastix>::SetInitialPosition(const ParametersType & pa
 } // end SetInitialPosition
 
 
+/**
+ * ******************* ComputeGradient ***********************
+ */
+
+template <class TElastix>
+void
+SimultaneousPerturbation<TElastix>::ComputeGradient(const ParametersType & parameters, DerivativeType & gradient)
+{
+  if (this->m_ConcurrentCostFunctions.empty())
+  {
+    this->Superclass1::ComputeGradient(parameters, gradient);
+    return;
+  }
+
+  const unsigned int  spaceDimension = parameters.GetSize();
+  const unsigned long numberOfPerturbations = this->GetNumberOfPerturbations();
+  const double        ck = this->Compute_c(this->GetCurrentIteration());
+
+  /** Draw all perturbations, in the same order as the serial evaluation,
+   * and create the positions thetaplus and thetamin for each of them. */
+  std::vector<DerivativeType> deltas(numberOfPerturbations);
+  std::vector<ParametersType> positions(2 * numberOfPerturbations, ParametersType(spaceDimension));
+  for (unsigned long perturbation = 0; perturbation < numberOfPerturbations; ++perturbation)
+  {
+    this->GenerateDelta(spaceDimension);
+    deltas[perturbation] = this->m_Delta;
+    for (unsigned int j = 0; j < spaceDimension; ++j)
+    {
+      positions[2 * perturbation][j] = parameters[j] + ck * this->m_Delta[j];
+      positions[2 * perturbation + 1][j] = parameters[j] - ck * this->m_Delta[j];
+    }
+  }
+
+  /** Evaluate all positions in parallel. */
+  itk::ConcurrentCostFunctionEvaluator::CostFunctionContainerType costFunctions{ this->GetCostFunction() };
+  for (const auto & costFunction : this->m_ConcurrentCostFunctions)
+  {
+    costFunctions.push_back(costFunction.GetPointer());
+  }
+  std::vector<double>             values;
+  std::vector<std::exception_ptr> exceptions;
+  itk::ConcurrentCostFunctionEvaluator::GetValues(costFunctions, positions, values, exceptions);
+  itk::ConcurrentCostFunctionEvaluator::RethrowFirstException(exceptions);
+
+  /** Assemble the gradient, as the superclass does. */
+  gradient.SetSize(spaceDimension);
+  gradient.Fill(0.0);
+  for (unsigned long perturbation = 0; perturbation < numberOfPerturbations; ++perturbation)
+  {
+    const double valuediff = (values[2 * perturbation] - values[2 * perturbation + 1]) / (2 * ck);
+    for (unsigned int j = 0; j < spaceDimension; ++j)
+    {
+      gradient[j] += valuediff / deltas[perturbation][j];
+    }
+  }
+
+  /** Apply the scaling and divide by the NumberOfPerturbations. */
+  const ScalesType & scales = this->GetScales();
+  for (unsigned int j = 0; j < spaceDimension; ++j)
+  {
+    gradient[j] /= (vnl_math::sqr(scales[j]) * static_cast<double>(numberOfPerturbations));
+  }
+
+} // end ComputeGradient
+
+
 } // end namespace elastix
 
 #endif // end #ifndef elxSimultaneousPerturbation_hxx
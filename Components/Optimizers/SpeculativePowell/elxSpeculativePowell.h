@@ -0,0 +1,144 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef elxSpeculativePowell_h
+#define elxSpeculativePowell_h
+
+#include "elxIncludes.h" // include first to avoid MSVS warning
+#include "itkSpeculativePowellOptimizer.h"
+
+namespace elastix
+{
+
+/**
+ * \class SpeculativePowell
+ * \brief A Powell direction set optimizer that can evaluate its bracketing points speculatively.
+ *
+ * This optimizer is a wrap around the itk::SpeculativePowellOptimizer.
+ * This wrap-around class takes care of setting parameters, and printing progress
+ * information.
+ * For detailed information about the optimisation method, please read the
+ * documentation of the itk::SpeculativePowellOptimizer.
+ *
+ * The speculative evaluation needs concurrent cost functions, which elastix does
+ * not set, because it cannot copy a metric and its transform per thread. Within
+ * elastix the bracketing points are therefore evaluated serially, and the
+ * optimization follows the same path as with UseSpeculativeEvaluation "false".
+ *
+ * The parameters used in this class are:
+ * \parameter Optimizer: Select this optimizer as follows:\n
+ *   <tt>(Optimizer "SpeculativePowell")</tt>
+ * \parameter MaximumNumberOfIterations: The maximum number of iterations in each resolution. \n
+ *   example: <tt>(MaximumNumberOfIterations 100 100 50)</tt> \n
+ *   Default value: 500.
+ * \parameter ValueTolerance: The optimization stops when an iteration decreases the value by less
+ *   than this tolerance, relative to the value. \n
+ *   example: <tt>(ValueTolerance 0.001 0.0001 0.000001)</tt> \n
+ *   Default value: 1e-8.
+ * \parameter MaximumStepLength: The length of the initial directions. \n
+ *   example: <tt>(MaximumStepLength 16.0 8.0 4.0)</tt> \n
+ *   Default value: 16 / 2^level.
+ * \parameter StepTolerance: The tolerance of the line minimizations. \n
+ *   example: <tt>(StepTolerance 0.5 0.25 0.125)</tt> \n
+ *   Default value: 0.5 / 2^level.
+ * \parameter UseSpeculativeEvaluation: Whether the bracketing points are evaluated speculatively,
+ *   when concurrent cost functions are set. \n
+ *   example: <tt>(UseSpeculativeEvaluation "false")</tt> \n
+ *   Default value: "true".
+ *
+ * \sa Powell
+ * \ingroup Optimizers
+ */
+
+template <class TElastix>
+class ITK_TEMPLATE_EXPORT SpeculativePowell
+  : public itk::SpeculativePowellOptimizer
+  , public OptimizerBase<TElastix>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(SpeculativePowell);
+
+  /** Standard ITK.*/
+  using Self = SpeculativePowell;
+  using Superclass1 = SpeculativePowellOptimizer;
+  using Superclass2 = OptimizerBase<TElastix>;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(SpeculativePowell, SpeculativePowellOptimizer);
+
+  /** Name of this class.
+   * Use this name in the parameter file to select this specific optimizer. \n
+   * example: <tt>(Optimizer "SpeculativePowell")</tt>\n
+   */
+  elxClassNameMacro("SpeculativePowell");
+
+  /** Typedef's inherited from Superclass1.*/
+  using Superclass1::CostFunctionType;
+  using Superclass1::CostFunctionPointer;
+  using Superclass1::StopConditionType;
+  using Superclass1::ScalesType;
+
+  /** Typedef's inherited from Elastix.*/
+  using typename Superclass2::ElastixType;
+  using typename Superclass2::RegistrationType;
+  using ITKBaseType = typename Superclass2::ITKBaseType;
+
+  /** Typedef for the ParametersType. */
+  using typename Superclass1::ParametersType;
+
+  /** Check if any scales are set, and set the UseScales flag on or off;
+   * after that call the superclass' implementation */
+  void
+  StartOptimization() override;
+
+  /** Methods invoked by elastix, in which parameters can be set and
+   * progress information can be printed. */
+  void
+  BeforeRegistration() override;
+
+  void
+  BeforeEachResolution() override;
+
+  void
+  AfterEachResolution() override;
+
+  void
+  AfterEachIteration() override;
+
+  void
+  AfterRegistration() override;
+
+protected:
+  SpeculativePowell() = default;
+  ~SpeculativePowell() override = default;
+
+private:
+  elxOverrideGetSelfMacro;
+};
+
+} // end namespace elastix
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "elxSpeculativePowell.hxx"
+#endif
+
+#endif // end #ifndef elxSpeculativePowell_h
@@ -0,0 +1,188 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef elxSpeculativePowell_hxx
+#define elxSpeculativePowell_hxx
+
+#include "elxSpeculativePowell.h"
+#include <cmath>
+#include <iomanip>
+#include <string>
+
+namespace elastix
+{
+
+/**
+ * ***************** StartOptimization ************************
+ */
+
+template <class TElastix>
+void
+SpeculativePowell<TElastix>::StartOptimization()
+{
+  /** Check if the entered scales are correct and != [ 1 1 1 ...] */
+  this->SetUseScales(false);
+  const ScalesType & scales = this->GetScales();
+  if (scales.GetSize() == this->GetInitialPosition().GetSize())
+  {
+    ScalesType unit_scales(scales.GetSize());
+    unit_scales.Fill(1.0);
+    if (scales != unit_scales)
+    {
+      /** only then: */
+      this->SetUseScales(true);
+    }
+  }
+
+  /** Call the superclass */
+  this->Superclass1::StartOptimization();
+
+} // end StartOptimization
+
+
+/**
+ * ***************** BeforeRegistration ***********************
+ */
+
+template <class TElastix>
+void
+SpeculativePowell<TElastix>::BeforeRegistration()
+{
+  /** Add the target cell "2:Metric" to IterationInfo.*/
+  this->AddTargetCellToIterationInfo("2:Metric");
+
+  /** Format the metric as floats */
+  this->GetIterationInfoAt("2:Metric") << std::showpoint << std::fixed;
+
+} // end BeforeRegistration
+
+
+/**
+ * ***************** BeforeEachResolution ***********************
+ */
+
+template <class TElastix>
+void
+SpeculativePowell<TElastix>::BeforeEachResolution()
+{
+  /** Get the current resolution level.*/
+  unsigned int level = static_cast<unsigned int>(this->m_Registration->GetAsITKBaseType()->GetCurrentLevel());
+
+  /** Set the value tolerance.*/
+  double valueTolerance = 1e-8;
+  this->m_Configuration->ReadParameter(valueTolerance, "ValueTolerance", this->GetComponentLabel(), level, 0);
+  this->SetValueTolerance(valueTolerance);
+
+  /** Set the MaximumStepLength.*/
+  double maxStepLength = 16.0 / std::pow(2.0, static_cast<int>(level));
+  this->m_Configuration->ReadParameter(maxStepLength, "MaximumStepLength", this->GetComponentLabel(), level, 0);
+  this->SetStepLength(maxStepLength);
+
+  /** Set the StepTolerance.*/
+  double stepTolerance = 0.5 / std::pow(2.0, static_cast<int>(level));
+  this->m_Configuration->ReadParameter(stepTolerance, "StepTolerance", this->GetComponentLabel(), level, 0);
+  this->SetStepTolerance(stepTolerance);
+
+  /** Set the maximumNumberOfIterations.*/
+  unsigned int maximumNumberOfIterations = 500;
+  this->m_Configuration->ReadParameter(
+    maximumNumberOfIterations, "MaximumNumberOfIterations", this->GetComponentLabel(), level, 0);
+  this->SetMaximumIteration(maximumNumberOfIterations);
+
+  /** Set the UseSpeculativeEvaluation.*/
+  bool useSpeculativeEvaluation = true;
+  this->m_Configuration->ReadParameter(
+    useSpeculativeEvaluation, "UseSpeculativeEvaluation", this->GetComponentLabel(), level, 0);
+  this->SetUseSpeculativeEvaluation(useSpeculativeEvaluation);
+
+} // end BeforeEachResolution
+
+
+/**
+ * ***************** AfterEachIteration *************************
+ */
+
+template <class TElastix>
+void
+SpeculativePowell<TElastix>::AfterEachIteration()
+{
+  /** Print some information */
+  this->GetIterationInfoAt("2:Metric") << this->GetCurrentValue();
+
+} // end AfterEachIteration
+
+
+/**
+ * ***************** AfterEachResolution *************************
+ */
+
+template <class TElastix>
+void
+SpeculativePowell<TElastix>::AfterEachResolution()
+{
+  /**
+   * enum StopConditionType { MetricError, MaximumNumberOfIterations, Convergence, Unknown };
+   */
+  std::string stopcondition;
+
+  switch (this->GetStopCondition())
+  {
+    case MetricError:
+      stopcondition = "Error in metric";
+      break;
+
+    case MaximumNumberOfIterations:
+      stopcondition = "Maximum number of iterations has been reached";
+      break;
+
+    case Convergence:
+      stopcondition = "Almost no decrease in function value anymore";
+      break;
+
+    default:
+      stopcondition = "Unknown";
+      break;
+  }
+
+  /** Print the stopping condition */
+  elxout << "Stopping condition: " << stopcondition << "." << std::endl;
+
+  /** Print the number of cost function evaluations, including the speculative ones */
+  elxout << "Number of metric evaluations: " << this->GetNumberOfEvaluations() << std::endl;
+
+} // end AfterEachResolution
+
+
+/**
+ * ******************* AfterRegistration ************************
+ */
+
+template <class TElastix>
+void
+SpeculativePowell<TElastix>::AfterRegistration()
+{
+  /** Print the best metric value */
+  double bestValue = this->GetCurrentValue();
+  elxout << '\n' << "Final metric value  = " << bestValue << std::endl;
+
+} // end AfterRegistration
+
+
+} // end namespace elastix
+
+#endif // end #ifndef elxSpeculativePowell_hxx
@@ -0,0 +1,470 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkSpeculativePowellOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include "itkMacro.h"
+
+namespace
+{
+/** The ratio by which the bracketing steps grow, and its complement for Brent's method. */
+constexpr double GoldenRatio = 1.618034;
+constexpr double GoldenSection = 0.3819660;
+
+/** The line points that the bracketing steps visit after the points a and b. */
+std::vector<double>
+PredictBracketPoints(double a, double b, const std::size_t numberOfPoints)
+{
+  std::vector<double> points;
+  points.reserve(numberOfPoints);
+  for (std::size_t i = 0; i < numberOfPoints; ++i)
+  {
+    /** The same expression as in LineMinimization, so that the points are exactly equal. */
+    const double c = b + GoldenRatio * (b - a);
+    points.push_back(c);
+    a = b;
+    b = c;
+  }
+  return points;
+}
+
+} // end namespace
+
+namespace itk
+{
+
+/**
+ * ******************* PrintSelf *********************
+ */
+
+void
+SpeculativePowellOptimizer::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "m_CurrentValue: " << this->m_CurrentValue << std::endl;
+  os << indent << "m_CurrentIteration: " << this->m_CurrentIteration << std::endl;
+  os << indent << "m_StopCondition: " << this->m_StopCondition << std::endl;
+  os << indent << "m_Stop: " << this->m_Stop << std::endl;
+  os << indent << "m_NumberOfEvaluations: " << this->m_NumberOfEvaluations << std::endl;
+
+  os << indent << "m_MaximumIteration: " << this->m_MaximumIteration << std::endl;
+  os << indent << "m_MaximumLineIteration: " << this->m_MaximumLineIteration << std::endl;
+  os << indent << "m_MaximumBracketIteration: " << this->m_MaximumBracketIteration << std::endl;
+  os << indent << "m_StepLength: " << this->m_StepLength << std::endl;
+  os << indent << "m_StepTolerance: " << this->m_StepTolerance << std::endl;
+  os << indent << "m_ValueTolerance: " << this->m_ValueTolerance << std::endl;
+  os << indent << "m_UseSpeculativeEvaluation: " << this->m_UseSpeculativeEvaluation << std::endl;
+
+} // end PrintSelf()
+
+
+/**
+ * ******************* StartOptimization *********************
+ */
+
+void
+SpeculativePowellOptimizer::StartOptimization()
+{
+  itkDebugMacro("StartOptimization");
+
+  /** Reset some variables */
+  this->m_CurrentValue = NumericTraits<MeasureType>::Zero;
+  this->m_CurrentIteration = 0;
+  this->m_Stop = false;
+  this->m_StopCondition = Unknown;
+  this->m_NumberOfEvaluations = 0;
+
+  /** Get the number of parameters; checks also if a cost function has been set at all.
+   * if not: an exception is thrown */
+  const unsigned int numberOfParameters = this->GetScaledCostFunction()->GetNumberOfParameters();
+
+  /** Initialize the scaledCostFunction with the currently set scales */
+  this->InitializeScales();
+
+  /** Set the current position as the scaled initial position */
+  this->SetCurrentPosition(this->GetInitialPosition());
+
+  this->InvokeEvent(StartEvent());
+
+  ParametersType position = this->GetScaledCurrentPosition();
+  MeasureType    value = this->GetValueOrStop(position);
+  this->m_CurrentValue = value;
+
+  /** The initial directions: the axes of the scaled parameter space. */
+  std::vector<ParametersType> directions(numberOfParameters, ParametersType(numberOfParameters));
+  for (unsigned int i = 0; i < numberOfParameters; ++i)
+  {
+    directions[i].Fill(0.0);
+    directions[i][i] = this->m_StepLength;
+  }
+
+  ParametersType previousPosition(position);
+  while (!this->m_Stop)
+  {
+    if (this->m_CurrentIteration >= this->m_MaximumIteration)
+    {
+      this->m_StopCondition = MaximumNumberOfIterations;
+      this->StopOptimization();
+      break;
+    }
+
+    /** Minimize along each direction, and remember the direction of the largest decrease. */
+    const MeasureType previousValue = value;
+    unsigned int      largestDecreaseIndex = 0;
+    MeasureType       largestDecrease = 0.0;
+    for (unsigned int i = 0; i < numberOfParameters; ++i)
+    {
+      ParametersType    direction(directions[i]);
+      const MeasureType valueBeforeLine = value;
+      this->LineMinimization(position, direction, value);
+      if (valueBeforeLine - value > largestDecrease)
+      {
+        largestDecrease = valueBeforeLine - value;
+        largestDecreaseIndex = i;
+      }
+    }
+
+    const bool convergence = 2.0 * (previousValue - value) <=
+                             this->m_ValueTolerance * (std::abs(previousValue) + std::abs(value)) + 1e-25;
+
+    if (!convergence)
+    {
+      /** Replace the direction of the largest decrease by the total displacement of
+       * this iteration, when the extrapolated point suggests that it helps. */
+      ParametersType extrapolatedPosition(position);
+      extrapolatedPosition *= 2.0;
+      extrapolatedPosition -= previousPosition;
+      ParametersType displacement(position);
+      displacement -= previousPosition;
+      previousPosition = position;
+
+      const MeasureType extrapolatedValue = this->GetValueOrStop(extrapolatedPosition);
+      if (extrapolatedValue < previousValue)
+      {
+        const MeasureType a = previousValue - value - largestDecrease;
+        const MeasureType b = previousValue - extrapolatedValue;
+        const MeasureType t =
+          2.0 * (previousValue - 2.0 * value + extrapolatedValue) * a * a - largestDecrease * b * b;
+        if (t < 0.0)
+        {
+          this->LineMinimization(position, displacement, value);
+          directions[largestDecreaseIndex] = directions[numberOfParameters - 1];
+          directions[numberOfParameters - 1] = displacement;
+        }
+      }
+    }
+
+    this->m_CurrentValue = value;
+    this->SetScaledCurrentPosition(position);
+
+    /** Give the user opportunity to observe progress */
+    this->InvokeEvent(IterationEvent());
+
+    ++(this->m_CurrentIteration);
+
+    if (convergence)
+    {
+      this->m_StopCondition = Convergence;
+      this->StopOptimization();
+    }
+
+  } // end while !m_Stop
+
+} // end StartOptimization()
+
+
+/**
+ * ******************* StopOptimization *********************
+ */
+
+void
+SpeculativePowellOptimizer::StopOptimization()
+{
+  itkDebugMacro("StopOptimization");
+  this->m_Stop = true;
+  this->InvokeEvent(EndEvent());
+
+} // end StopOptimization()
+
+
+/**
+ * ******************* LineMinimization *********************
+ */
+
+void
+SpeculativePowellOptimizer::LineMinimization(ParametersType & position,
+                                             ParametersType & direction,
+                                             MeasureType &    value)
+{
+  const double directionLength = direction.two_norm();
+  if (directionLength == 0.0)
+  {
+    return;
+  }
+
+  this->m_LineValues.clear();
+  this->m_LineValues.push_back({ 0.0, value, nullptr });
+
+  /** The number of points per speculative batch. */
+  std::size_t batchSize = 0;
+  if (this->GetIsEvaluatingInParallel())
+  {
+    batchSize = std::max<std::size_t>(2, this->GetConcurrentCostFunctions().size());
+  }
+
+  /** Bracket the minimum. The first step is speculated in both orientations: the
+   * serial algorithm turns around when the first step increases the value. */
+  std::vector<double> speculativeLinePoints;
+  if (batchSize > 0)
+  {
+    const std::vector<double> forward = PredictBracketPoints(0.0, 1.0, batchSize);
+    const std::vector<double> backward = PredictBracketPoints(1.0, 0.0, batchSize);
+    for (std::size_t i = 0; speculativeLinePoints.size() + 1 < batchSize; ++i)
+    {
+      speculativeLinePoints.push_back(forward[i]);
+      speculativeLinePoints.push_back(backward[i]);
+    }
+    speculativeLinePoints.resize(batchSize - 1);
+  }
+
+  double      a = 0.0;
+  double      b = 1.0;
+  MeasureType fa = value;
+  MeasureType fb = this->GetLineValue(position, direction, b, speculativeLinePoints);
+  if (fb > fa)
+  {
+    std::swap(a, b);
+    std::swap(fa, fb);
+  }
+  double      c = b + GoldenRatio * (b - a);
+  MeasureType fc =
+    this->GetLineValue(position, direction, c, PredictBracketPoints(b, c, batchSize > 0 ? batchSize - 1 : 0));
+  for (unsigned int k = 0; fb > fc && k < this->m_MaximumBracketIteration; ++k)
+  {
+    a = b;
+    fa = fb;
+    b = c;
+    fb = fc;
+    c = b + GoldenRatio * (b - a);
+    fc = this->GetLineValue(position, direction, c, PredictBracketPoints(b, c, batchSize > 0 ? batchSize - 1 : 0));
+  }
+
+  /** Refine the minimum with Brent's method, in the interval [lower, upper]. */
+  const double tolerance = this->m_StepTolerance / directionLength;
+  double       lower = std::min(a, c);
+  double       upper = std::max(a, c);
+  double       x = b;
+  double       w = b;
+  double       v = b;
+  MeasureType  fx = fb;
+  MeasureType  fw = fb;
+  MeasureType  fv = fb;
+  double       d = 0.0;
+  double       e = 0.0;
+  for (unsigned int iteration = 0; iteration < this->m_MaximumLineIteration; ++iteration)
+  {
+    const double middle = 0.5 * (lower + upper);
+    if (std::abs(x - middle) <= 2.0 * tolerance - 0.5 * (upper - lower))
+    {
+      break;
+    }
+
+    bool useGoldenSection = true;
+    if (std::abs(e) > tolerance)
+    {
+      /** Try a parabolic step through x, v and w. */
+      const double r = (x - w) * (fx - fv);
+      double       q = (x - v) * (fx - fw);
+      double       p = (x - v) * q - (x - w) * r;
+      q = 2.0 * (q - r);
+      if (q > 0.0)
+      {
+        p = -p;
+      }
+      q = std::abs(q);
+      const double previousE = e;
+      e = d;
+      if (std::abs(p) < std::abs(0.5 * q * previousE) && p > q * (lower - x) && p < q * (upper - x))
+      {
+        d = p / q;
+        const double u = x + d;
+        if (u - lower < 2.0 * tolerance || upper - u < 2.0 * tolerance)
+        {
+          d = (middle >= x) ? tolerance : -tolerance;
+        }
+        useGoldenSection = false;
+      }
+    }
+    if (useGoldenSection)
+    {
+      e = (x >= middle) ? lower - x : upper - x;
+      d = GoldenSection * e;
+    }
+
+    const double      u = (std::abs(d) >= tolerance) ? x + d : x + ((d >= 0.0) ? tolerance : -tolerance);
+    const MeasureType fu = this->GetLineValue(position, direction, u, {});
+    if (fu <= fx)
+    {
+      (u >= x ? lower : upper) = x;
+      v = w;
+      w = x;
+      x = u;
+      fv = fw;
+      fw = fx;
+      fx = fu;
+    }
+    else
+    {
+      (u < x ? lower : upper) = u;
+      if (fu <= fw || w == x)
+      {
+        v = w;
+        w = u;
+        fv = fw;
+        fw = fu;
+      }
+      else if (fu <= fv || v == x || v == w)
+      {
+        v = u;
+        fv = fu;
+      }
+    }
+  }
+
+  direction *= x;
+  position += direction;
+  value = fx;
+
+} // end LineMinimization()
+
+
+/**
+ * ******************* GetLineValue *********************
+ */
+
+SpeculativePowellOptimizer::MeasureType
+SpeculativePowellOptimizer::GetLineValue(const ParametersType &      position,
+                                         const ParametersType &      direction,
+                                         const double                t,
+                                         const std::vector<double> & speculativeLinePoints)
+{
+  const auto findLineValue = [this](const double lineT) {
+    return std::find_if(this->m_LineValues.begin(), this->m_LineValues.end(), [lineT](const LineValueType & lineValue) {
+      return lineValue.t == lineT;
+    });
+  };
+
+  auto found = findLineValue(t);
+  if (found == this->m_LineValues.end())
+  {
+    /** Evaluate t, and the speculative line points that have not been evaluated yet. */
+    std::vector<double> lineTs{ t };
+    if (this->GetIsEvaluatingInParallel())
+    {
+      for (const double lineT : speculativeLinePoints)
+      {
+        if (findLineValue(lineT) == this->m_LineValues.end() &&
+            std::find(lineTs.begin(), lineTs.end(), lineT) == lineTs.end())
+        {
+          lineTs.push_back(lineT);
+        }
+      }
+    }
+
+    std::vector<ParametersType> positions(lineTs.size(), direction);
+    for (std::size_t i = 0; i < lineTs.size(); ++i)
+    {
+      positions[i] *= lineTs[i];
+      positions[i] += position;
+    }
+
+    std::vector<MeasureType>        values(lineTs.size());
+    std::vector<std::exception_ptr> exceptions(lineTs.size());
+    if (this->GetIsEvaluatingInParallel())
+    {
+      this->GetScaledValues(positions, values, exceptions);
+    }
+    else
+    {
+      try
+      {
+        values[0] = this->GetScaledValue(positions[0]);
+      }
+      catch (const ExceptionObject &)
+      {
+        exceptions[0] = std::current_exception();
+      }
+    }
+    this->m_NumberOfEvaluations += lineTs.size();
+
+    for (std::size_t i = 0; i < lineTs.size(); ++i)
+    {
+      this->m_LineValues.push_back({ lineTs[i], values[i], exceptions[i] });
+    }
+    found = findLineValue(t);
+  }
+
+  /** An exception of a speculative point is only passed on when the point is needed. */
+  if (found->exception)
+  {
+    this->m_StopCondition = MetricError;
+    this->StopOptimization();
+    std::rethrow_exception(found->exception);
+  }
+  return found->value;
+
+} // end GetLineValue()
+
+
+/**
+ * ******************* GetIsEvaluatingInParallel *********************
+ */
+
+bool
+SpeculativePowellOptimizer::GetIsEvaluatingInParallel() const
+{
+  return this->m_UseSpeculativeEvaluation && !this->GetConcurrentCostFunctions().empty();
+
+} // end GetIsEvaluatingInParallel()
+
+
+/**
+ * ******************* GetValueOrStop *********************
+ */
+
+SpeculativePowellOptimizer::MeasureType
+SpeculativePowellOptimizer::GetValueOrStop(const ParametersType & position)
+{
+  ++(this->m_NumberOfEvaluations);
+  try
+  {
+    return this->GetScaledValue(position);
+  }
+  catch (const ExceptionObject &)
+  {
+    this->m_StopCondition = MetricError;
+    this->StopOptimization();
+    throw;
+  }
+
+} // end GetValueOrStop()
+
+
+} // end namespace itk
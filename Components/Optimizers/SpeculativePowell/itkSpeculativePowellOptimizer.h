@@ -0,0 +1,190 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSpeculativePowellOptimizer_h
+#define itkSpeculativePowellOptimizer_h
+
+#include "itkScaledSingleValuedNonLinearOptimizer.h"
+#include <exception>
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class SpeculativePowellOptimizer
+ * \brief A Powell direction set optimizer that evaluates its bracketing points speculatively.
+ *
+ * Powell's method minimizes the cost function along each direction of a set of
+ * directions in turn, and replaces the direction of the largest decrease by the
+ * total displacement of the iteration, when that is expected to help. Each line
+ * minimization first brackets the minimum, by stepping along the line with
+ * steps that grow by the golden ratio, and then refines it with Brent's method.
+ *
+ * The bracketing points are known in advance, because the steps do not depend
+ * on the values. When concurrent cost functions are set (see
+ * SetConcurrentCostFunctions()) and UseSpeculativeEvaluation is true, a
+ * bracketing point that has not been evaluated yet is evaluated in parallel with
+ * the points that follow it, in both orientations of the line. The values are
+ * stored, and the serial algorithm then takes its decisions on them, so the
+ * optimization follows the same path as without speculative evaluation. Brent's
+ * method chooses each point from the previous values, and is evaluated serially.
+ *
+ * The optimizer works on the scaled parameters. The initial directions are the
+ * axes of the (scaled) parameter space, with length StepLength.
+ *
+ * The optimization stops when an iteration decreases the value by less than
+ * ValueTolerance relative to the value, or after MaximumIteration iterations.
+ *
+ * Each concurrent cost function must be an independent copy of the cost
+ * function. In elastix, this optimizer is available as the SpeculativePowell
+ * component. The registration cannot copy a metric and its transform per
+ * thread, so it sets no concurrent cost functions, and the points are
+ * evaluated serially there.
+ *
+ * \sa SpeculativePowell
+ *
+ * \ingroup Numerics Optimizers
+ */
+
+class SpeculativePowellOptimizer : public ScaledSingleValuedNonLinearOptimizer
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(SpeculativePowellOptimizer);
+
+  using Self = SpeculativePowellOptimizer;
+  using Superclass = ScaledSingleValuedNonLinearOptimizer;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(SpeculativePowellOptimizer, ScaledSingleValuedNonLinearOptimizer);
+
+  using Superclass::ParametersType;
+  using Superclass::CostFunctionType;
+  using Superclass::MeasureType;
+  using Superclass::ScalesType;
+
+  enum StopConditionType
+  {
+    MetricError,
+    MaximumNumberOfIterations,
+    Convergence,
+    Unknown
+  };
+
+  void
+  StartOptimization() override;
+
+  virtual void
+  StopOptimization();
+
+  /** Get information about the optimization process. */
+  itkGetConstMacro(CurrentIteration, unsigned long);
+  itkGetConstMacro(CurrentValue, MeasureType);
+  itkGetConstReferenceMacro(StopCondition, StopConditionType);
+
+  /** Get the number of cost function evaluations, including the speculative ones. */
+  itkGetConstMacro(NumberOfEvaluations, SizeValueType);
+
+  /** Setting: the maximum number of iterations. Default: 100. */
+  itkSetMacro(MaximumIteration, unsigned long);
+  itkGetConstMacro(MaximumIteration, unsigned long);
+
+  /** Setting: the maximum number of iterations of Brent's method, per line. Default: 100. */
+  itkSetMacro(MaximumLineIteration, unsigned int);
+  itkGetConstMacro(MaximumLineIteration, unsigned int);
+
+  /** Setting: the maximum number of golden ratio steps to bracket a minimum. Default: 50. */
+  itkSetMacro(MaximumBracketIteration, unsigned int);
+  itkGetConstMacro(MaximumBracketIteration, unsigned int);
+
+  /** Setting: the length of the initial directions, in scaled units. Default: 1.0. */
+  itkSetMacro(StepLength, double);
+  itkGetConstMacro(StepLength, double);
+
+  /** Setting: the tolerance of the line minimizations, in scaled units. Default: 1e-6. */
+  itkSetMacro(StepTolerance, double);
+  itkGetConstMacro(StepTolerance, double);
+
+  /** Setting: the relative tolerance on the decrease of the value per iteration. Default: 1e-6. */
+  itkSetMacro(ValueTolerance, double);
+  itkGetConstMacro(ValueTolerance, double);
+
+  /** Setting: whether the bracketing points are evaluated speculatively, in parallel,
+   * when concurrent cost functions are set. Default: true. */
+  itkSetMacro(UseSpeculativeEvaluation, bool);
+  itkGetConstMacro(UseSpeculativeEvaluation, bool);
+  itkBooleanMacro(UseSpeculativeEvaluation);
+
+protected:
+  SpeculativePowellOptimizer() = default;
+  ~SpeculativePowellOptimizer() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** Minimize the cost function along the line through position in the given direction.
+   * On return, position is the minimum, direction is the displacement to it, and
+   * value is the value at the minimum. On entry, value is the value at position. */
+  virtual void
+  LineMinimization(ParametersType & position, ParametersType & direction, MeasureType & value);
+
+  /** Get the value at position + t * direction. When it has not been evaluated yet, it is
+   * evaluated together with the speculative line points (t excluded), in parallel when
+   * speculative evaluation is active. */
+  MeasureType
+  GetLineValue(const ParametersType &      position,
+               const ParametersType &      direction,
+               double                      t,
+               const std::vector<double> & speculativeLinePoints);
+
+  /** Whether the bracketing points are evaluated in parallel. */
+  bool
+  GetIsEvaluatingInParallel() const;
+
+  /** Evaluate the value at a position. Stops the optimization on an exception. */
+  MeasureType
+  GetValueOrStop(const ParametersType & position);
+
+  unsigned long     m_CurrentIteration{ 0 };
+  MeasureType       m_CurrentValue{ 0.0 };
+  StopConditionType m_StopCondition{ Unknown };
+  bool              m_Stop{ false };
+  SizeValueType     m_NumberOfEvaluations{ 0 };
+
+private:
+  /** The values along the current line, stored per line point t. */
+  struct LineValueType
+  {
+    double             t;
+    MeasureType        value;
+    std::exception_ptr exception;
+  };
+  std::vector<LineValueType> m_LineValues;
+
+  unsigned long m_MaximumIteration{ 100 };
+  unsigned int  m_MaximumLineIteration{ 100 };
+  unsigned int  m_MaximumBracketIteration{ 50 };
+  double        m_StepLength{ 1.0 };
+  double        m_StepTolerance{ 1e-6 };
+  double        m_ValueTolerance{ 1e-6 };
+  bool          m_UseSpeculativeEvaluation{ true };
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkSpeculativePowellOptimizer_h
@@ -0,0 +1,146 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef elxSpeculativeSimplex_h
+#define elxSpeculativeSimplex_h
+
+#include "elxIncludes.h" // include first to avoid MSVS warning
+#include "itkSpeculativeSimplexOptimizer.h"
+
+namespace elastix
+{
+
+/**
+ * \class SpeculativeSimplex
+ * \brief A Nelder-Mead simplex optimizer that can evaluate its candidate points speculatively.
+ *
+ * This optimizer is a wrap around the itk::SpeculativeSimplexOptimizer.
+ * This wrap-around class takes care of setting parameters, and printing progress
+ * information.
+ * For detailed information about the optimisation method, please read the
+ * documentation of the itk::SpeculativeSimplexOptimizer.
+ *
+ * The speculative evaluation needs concurrent cost functions, which elastix does
+ * not set, because it cannot copy a metric and its transform per thread. Within
+ * elastix the candidate points are therefore evaluated serially, and the
+ * optimization follows the same path as with UseSpeculativeEvaluation "false".
+ *
+ * The parameters used in this class are:
+ * \parameter Optimizer: Select this optimizer as follows:\n
+ *   <tt>(Optimizer "SpeculativeSimplex")</tt>
+ * \parameter MaximumNumberOfIterations: The maximum number of iterations in each resolution. \n
+ *   example: <tt>(MaximumNumberOfIterations 100 100 50)</tt> \n
+ *   Default value: 500.
+ * \parameter ValueTolerance: The optimization stops when the values of all vertices of the simplex
+ *   are within this tolerance of the best value, and the vertices have converged. \n
+ *   example: <tt>(ValueTolerance 0.001 0.0001 0.000001)</tt> \n
+ *   Default value: 1e-8.
+ * \parameter ParametersTolerance: The optimization stops when all vertices of the simplex are within
+ *   this tolerance of the best vertex, and the values have converged. \n
+ *   example: <tt>(ParametersTolerance 0.001 0.0001 0.000001)</tt> \n
+ *   Default value: 1e-8.
+ * \parameter InitialSimplexDelta: The offsets of the initial vertices from the initial position,
+ *   one per parameter. When not given, 5% of the initial parameter is used, or 0.00025 for
+ *   parameters that are zero. \n
+ *   example: <tt>(InitialSimplexDelta 0.1 0.1 1.0 1.0)</tt> \n
+ * \parameter UseSpeculativeEvaluation: Whether the candidate points of an iteration are evaluated
+ *   speculatively, when concurrent cost functions are set. \n
+ *   example: <tt>(UseSpeculativeEvaluation "false")</tt> \n
+ *   Default value: "true".
+ *
+ * \sa Simplex
+ * \ingroup Optimizers
+ */
+
+template <class TElastix>
+class ITK_TEMPLATE_EXPORT SpeculativeSimplex
+  : public itk::SpeculativeSimplexOptimizer
+  , public OptimizerBase<TElastix>
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(SpeculativeSimplex);
+
+  /** Standard ITK.*/
+  using Self = SpeculativeSimplex;
+  using Superclass1 = SpeculativeSimplexOptimizer;
+  using Superclass2 = OptimizerBase<TElastix>;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(SpeculativeSimplex, SpeculativeSimplexOptimizer);
+
+  /** Name of this class.
+   * Use this name in the parameter file to select this specific optimizer. \n
+   * example: <tt>(Optimizer "SpeculativeSimplex")</tt>\n
+   */
+  elxClassNameMacro("SpeculativeSimplex");
+
+  /** Typedef's inherited from Superclass1.*/
+  using Superclass1::CostFunctionType;
+  using Superclass1::CostFunctionPointer;
+  using Superclass1::StopConditionType;
+  using Superclass1::ScalesType;
+
+  /** Typedef's inherited from Elastix.*/
+  using typename Superclass2::ElastixType;
+  using typename Superclass2::RegistrationType;
+  using ITKBaseType = typename Superclass2::ITKBaseType;
+
+  /** Typedef for the ParametersType. */
+  using typename Superclass1::ParametersType;
+
+  /** Check if any scales are set, and set the UseScales flag on or off;
+   * after that call the superclass' implementation */
+  void
+  StartOptimization() override;
+
+  /** Methods invoked by elastix, in which parameters can be set and
+   * progress information can be printed. */
+  void
+  BeforeRegistration() override;
+
+  void
+  BeforeEachResolution() override;
+
+  void
+  AfterEachResolution() override;
+
+  void
+  AfterEachIteration() override;
+
+  void
+  AfterRegistration() override;
+
+protected:
+  SpeculativeSimplex() = default;
+  ~SpeculativeSimplex() override = default;
+
+private:
+  elxOverrideGetSelfMacro;
+};
+
+} // end namespace elastix
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "elxSpeculativeSimplex.hxx"
+#endif
+
+#endif // end #ifndef elxSpeculativeSimplex_h
@@ -0,0 +1,412 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkSpeculativeSimplexOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <numeric>
+#include "itkMacro.h"
+
+namespace itk
+{
+
+/**
+ * ******************* PrintSelf *********************
+ */
+
+void
+SpeculativeSimplexOptimizer::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "m_CurrentValue: " << this->m_CurrentValue << std::endl;
+  os << indent << "m_CurrentIteration: " << this->m_CurrentIteration << std::endl;
+  os << indent << "m_StopCondition: " << this->m_StopCondition << std::endl;
+  os << indent << "m_Stop: " << this->m_Stop << std::endl;
+  os << indent << "m_NumberOfEvaluations: " << this->m_NumberOfEvaluations << std::endl;
+
+  os << indent << "m_MaximumNumberOfIterations: " << this->m_MaximumNumberOfIterations << std::endl;
+  os << indent << "m_FunctionConvergenceTolerance: " << this->m_FunctionConvergenceTolerance << std::endl;
+  os << indent << "m_ParametersConvergenceTolerance: " << this->m_ParametersConvergenceTolerance << std::endl;
+  os << indent << "m_InitialSimplexDelta: " << this->m_InitialSimplexDelta << std::endl;
+  os << indent << "m_UseSpeculativeEvaluation: " << this->m_UseSpeculativeEvaluation << std::endl;
+
+} // end PrintSelf()
+
+
+/**
+ * ******************* StartOptimization *********************
+ */
+
+void
+SpeculativeSimplexOptimizer::StartOptimization()
+{
+  itkDebugMacro("StartOptimization");
+
+  /** Reset some variables */
+  this->m_CurrentValue = NumericTraits<MeasureType>::Zero;
+  this->m_CurrentIteration = 0;
+  this->m_Stop = false;
+  this->m_StopCondition = Unknown;
+  this->m_NumberOfEvaluations = 0;
+
+  /** Get the number of parameters; checks also if a cost function has been set at all.
+   * if not: an exception is thrown */
+  const unsigned int numberOfParameters = this->GetScaledCostFunction()->GetNumberOfParameters();
+
+  const ParametersType & initialPosition = this->GetInitialPosition();
+  if (!this->m_InitialSimplexDelta.empty() && this->m_InitialSimplexDelta.GetSize() != numberOfParameters)
+  {
+    itkExceptionMacro("The size of the InitialSimplexDelta (" << this->m_InitialSimplexDelta.GetSize()
+                                                              << ") does not match the number of parameters ("
+                                                              << numberOfParameters << ").");
+  }
+
+  /** Initialize the scaledCostFunction with the currently set scales */
+  this->InitializeScales();
+
+  /** Set the current position as the scaled initial position */
+  this->SetCurrentPosition(initialPosition);
+
+  /** The initial simplex: the initial position, and one vertex per parameter, offset
+   * along that parameter. The offsets are in unscaled units. */
+  this->m_Vertices.assign(numberOfParameters + 1, this->GetScaledCurrentPosition());
+  for (unsigned int i = 0; i < numberOfParameters; ++i)
+  {
+    ParametersType vertex = initialPosition;
+    if (!this->m_InitialSimplexDelta.empty())
+    {
+      vertex[i] += this->m_InitialSimplexDelta[i];
+    }
+    else
+    {
+      vertex[i] = (vertex[i] != 0.0) ? 1.05 * vertex[i] : 0.00025;
+    }
+    this->GetScaledCostFunction()->ConvertUnscaledToScaledParameters(vertex);
+    this->m_Vertices[i + 1] = vertex;
+  }
+
+  try
+  {
+    this->EvaluatePositions(this->m_Vertices, this->m_VertexValues);
+  }
+  catch (const ExceptionObject &)
+  {
+    this->m_StopCondition = MetricError;
+    this->StopOptimization();
+    throw;
+  }
+  this->SortVertices();
+
+  this->ResumeOptimization();
+
+} // end StartOptimization()
+
+
+/**
+ * ******************* ResumeOptimization *********************
+ */
+
+void
+SpeculativeSimplexOptimizer::ResumeOptimization()
+{
+  itkDebugMacro("ResumeOptimization");
+
+  const unsigned int numberOfVertices = static_cast<unsigned int>(this->m_Vertices.size());
+  if (numberOfVertices < 2)
+  {
+    itkExceptionMacro("The simplex has not been initialized; call StartOptimization() first.");
+  }
+  const unsigned int worst = numberOfVertices - 1;
+
+  this->m_Stop = false;
+  this->m_StopCondition = Unknown;
+
+  this->InvokeEvent(StartEvent());
+
+  /** The candidates of an iteration: reflection, expansion, outside and inside contraction. */
+  enum CandidateIndex : unsigned int
+  {
+    Reflection,
+    Expansion,
+    OutsideContraction,
+    InsideContraction,
+    NumberOfCandidates
+  };
+  std::vector<ParametersType>     candidates(NumberOfCandidates);
+  std::vector<MeasureType>        candidateValues(NumberOfCandidates);
+  std::vector<std::exception_ptr> exceptions(NumberOfCandidates);
+  std::vector<bool>               evaluated(NumberOfCandidates);
+
+  /** Get the value of a candidate. When the candidates were evaluated speculatively,
+   * the stored value is returned. Otherwise it is evaluated now, as in the serial
+   * algorithm. */
+  const auto getCandidateValue = [&](const unsigned int k) -> MeasureType {
+    if (!evaluated[k])
+    {
+      exceptions[k] = nullptr;
+      try
+      {
+        candidateValues[k] = this->GetScaledValue(candidates[k]);
+      }
+      catch (const ExceptionObject &)
+      {
+        exceptions[k] = std::current_exception();
+      }
+      ++(this->m_NumberOfEvaluations);
+      evaluated[k] = true;
+    }
+    if (exceptions[k])
+    {
+      this->m_StopCondition = MetricError;
+      this->StopOptimization();
+      std::rethrow_exception(exceptions[k]);
+    }
+    return candidateValues[k];
+  };
+
+  while (!this->m_Stop)
+  {
+    this->m_CurrentValue = this->m_VertexValues[0];
+    this->SetScaledCurrentPosition(this->m_Vertices[0]);
+
+    if (this->TestConvergence())
+    {
+      this->m_StopCondition = Convergence;
+      this->StopOptimization();
+      break;
+    }
+    if (this->m_CurrentIteration >= this->m_MaximumNumberOfIterations)
+    {
+      this->m_StopCondition = MaximumNumberOfIterations;
+      this->StopOptimization();
+      break;
+    }
+
+    /** The centroid of all vertices except the worst one, and the candidates on the line
+     * from the worst vertex through the centroid. */
+    ParametersType centroid = this->m_Vertices[0];
+    for (unsigned int i = 1; i < worst; ++i)
+    {
+      centroid += this->m_Vertices[i];
+    }
+    centroid /= static_cast<double>(worst);
+    ParametersType step(centroid);
+    step -= this->m_Vertices[worst];
+    const auto pointAlongStep = [&centroid, &step](const double factor) {
+      ParametersType point(step);
+      point *= factor;
+      point += centroid;
+      return point;
+    };
+
+    candidates[Reflection] = pointAlongStep(1.0);
+    candidates[Expansion] = pointAlongStep(2.0);
+    candidates[OutsideContraction] = pointAlongStep(0.5);
+    candidates[InsideContraction] = pointAlongStep(-0.5);
+    std::fill(evaluated.begin(), evaluated.end(), false);
+
+    if (this->GetIsEvaluatingInParallel())
+    {
+      this->GetScaledValues(candidates, candidateValues, exceptions);
+      this->m_NumberOfEvaluations += NumberOfCandidates;
+      std::fill(evaluated.begin(), evaluated.end(), true);
+    }
+
+    /** The decisions of the serial Nelder-Mead method. */
+    const MeasureType reflectionValue = getCandidateValue(Reflection);
+    int               accepted = -1;
+    if (reflectionValue < this->m_VertexValues[0])
+    {
+      accepted = (getCandidateValue(Expansion) < reflectionValue) ? Expansion : Reflection;
+    }
+    else if (reflectionValue < this->m_VertexValues[worst - 1])
+    {
+      accepted = Reflection;
+    }
+    else if (reflectionValue < this->m_VertexValues[worst])
+    {
+      if (getCandidateValue(OutsideContraction) <= reflectionValue)
+      {
+        accepted = OutsideContraction;
+      }
+    }
+    else if (getCandidateValue(InsideContraction) < this->m_VertexValues[worst])
+    {
+      accepted = InsideContraction;
+    }
+
+    if (accepted >= 0)
+    {
+      this->m_Vertices[worst] = candidates[accepted];
+      this->m_VertexValues[worst] = candidateValues[accepted];
+    }
+    else
+    {
+      /** Shrink the simplex towards the best vertex. */
+      std::vector<ParametersType> shrunkVertices(worst);
+      for (unsigned int i = 0; i < worst; ++i)
+      {
+        shrunkVertices[i] = this->m_Vertices[i + 1];
+        shrunkVertices[i] -= this->m_Vertices[0];
+        shrunkVertices[i] *= 0.5;
+        shrunkVertices[i] += this->m_Vertices[0];
+      }
+      std::vector<MeasureType> shrunkValues;
+      try
+      {
+        this->EvaluatePositions(shrunkVertices, shrunkValues);
+      }
+      catch (const ExceptionObject &)
+      {
+        this->m_StopCondition = MetricError;
+        this->StopOptimization();
+        throw;
+      }
+      std::copy(shrunkVertices.begin(), shrunkVertices.end(), this->m_Vertices.begin() + 1);
+      std::copy(shrunkValues.begin(), shrunkValues.end(), this->m_VertexValues.begin() + 1);
+    }
+    this->SortVertices();
+
+    this->m_CurrentValue = this->m_VertexValues[0];
+    this->SetScaledCurrentPosition(this->m_Vertices[0]);
+
+    /** Give the user opportunity to observe progress */
+    this->InvokeEvent(IterationEvent());
+
+    ++(this->m_CurrentIteration);
+
+  } // end while !m_Stop
+
+} // end ResumeOptimization()
+
+
+/**
+ * ******************* StopOptimization *********************
+ */
+
+void
+SpeculativeSimplexOptimizer::StopOptimization()
+{
+  itkDebugMacro("StopOptimization");
+  this->m_Stop = true;
+  this->InvokeEvent(EndEvent());
+
+} // end StopOptimization()
+
+
+/**
+ * ******************* GetIsEvaluatingInParallel *********************
+ */
+
+bool
+SpeculativeSimplexOptimizer::GetIsEvaluatingInParallel() const
+{
+  return this->m_UseSpeculativeEvaluation && !this->GetConcurrentCostFunctions().empty();
+
+} // end GetIsEvaluatingInParallel()
+
+
+/**
+ * ******************* EvaluatePositions *********************
+ */
+
+void
+SpeculativeSimplexOptimizer::EvaluatePositions(const std::vector<ParametersType> & positions,
+                                               std::vector<MeasureType> &          values)
+{
+  this->m_NumberOfEvaluations += positions.size();
+
+  if (this->GetIsEvaluatingInParallel())
+  {
+    std::vector<std::exception_ptr> exceptions;
+    this->GetScaledValues(positions, values, exceptions);
+    for (const auto & exception : exceptions)
+    {
+      if (exception)
+      {
+        std::rethrow_exception(exception);
+      }
+    }
+    return;
+  }
+
+  values.resize(positions.size());
+  for (std::size_t i = 0; i < positions.size(); ++i)
+  {
+    values[i] = this->GetScaledValue(positions[i]);
+  }
+
+} // end EvaluatePositions()
+
+
+/**
+ * ******************* SortVertices *********************
+ */
+
+void
+SpeculativeSimplexOptimizer::SortVertices()
+{
+  std::vector<std::size_t> order(this->m_Vertices.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [this](const std::size_t a, const std::size_t b) {
+    return this->m_VertexValues[a] < this->m_VertexValues[b];
+  });
+
+  std::vector<ParametersType> vertices(order.size());
+  std::vector<MeasureType>    values(order.size());
+  for (std::size_t i = 0; i < order.size(); ++i)
+  {
+    vertices[i] = this->m_Vertices[order[i]];
+    values[i] = this->m_VertexValues[order[i]];
+  }
+  this->m_Vertices.swap(vertices);
+  this->m_VertexValues.swap(values);
+
+} // end SortVertices()
+
+
+/**
+ * ******************* TestConvergence *********************
+ */
+
+bool
+SpeculativeSimplexOptimizer::TestConvergence() const
+{
+  const ParametersType & best = this->m_Vertices[0];
+  for (std::size_t i = 1; i < this->m_Vertices.size(); ++i)
+  {
+    if (std::abs(this->m_VertexValues[i] - this->m_VertexValues[0]) > this->m_FunctionConvergenceTolerance)
+    {
+      return false;
+    }
+    for (unsigned int j = 0; j < best.GetSize(); ++j)
+    {
+      if (std::abs(this->m_Vertices[i][j] - best[j]) > this->m_ParametersConvergenceTolerance)
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+
+} // end TestConvergence()
+
+
+} // end namespace itk
@@ -0,0 +1,174 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkSpeculativeSimplexOptimizer_h
+#define itkSpeculativeSimplexOptimizer_h
+
+#include "itkScaledSingleValuedNonLinearOptimizer.h"
+#include <vector>
+
+namespace itk
+{
+/**
+ * \class SpeculativeSimplexOptimizer
+ * \brief A Nelder-Mead simplex optimizer that evaluates its candidate points speculatively.
+ *
+ * Each iteration of the Nelder-Mead method replaces the worst vertex of the
+ * simplex by the reflected, expanded, outside contracted or inside contracted
+ * point, or shrinks the simplex towards the best vertex. The serial algorithm
+ * evaluates these candidates one after the other, because which one is needed
+ * depends on the values of the previous ones.
+ *
+ * When concurrent cost functions are set (see SetConcurrentCostFunctions()) and
+ * UseSpeculativeEvaluation is true, all four candidates of an iteration are
+ * evaluated at once, in parallel, before the decision is made. The shrink step
+ * and the initial simplex evaluate their vertices in parallel as well. The
+ * decisions are made on exactly the same values as in the serial algorithm,
+ * so the optimization follows the same path. The price is that some of the
+ * candidates are evaluated in vain, which costs CPU time, but not wall time.
+ *
+ * The optimizer works on the scaled parameters. The coefficients of reflection,
+ * expansion, contraction and shrinkage are the standard ones: 1, 2, 0.5 and 0.5.
+ *
+ * The optimization stops when the values of all vertices are within
+ * FunctionConvergenceTolerance of the best value, and all vertices are within
+ * ParametersConvergenceTolerance of the best vertex, or after
+ * MaximumNumberOfIterations iterations.
+ *
+ * Each concurrent cost function must be an independent copy of the cost
+ * function. In elastix, this optimizer is available as the SpeculativeSimplex
+ * component. The registration cannot copy a metric and its transform per
+ * thread, so it sets no concurrent cost functions, and the points are
+ * evaluated serially there.
+ *
+ * \sa SpeculativeSimplex
+ *
+ * \ingroup Numerics Optimizers
+ */
+
+class SpeculativeSimplexOptimizer : public ScaledSingleValuedNonLinearOptimizer
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(SpeculativeSimplexOptimizer);
+
+  using Self = SpeculativeSimplexOptimizer;
+  using Superclass = ScaledSingleValuedNonLinearOptimizer;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(SpeculativeSimplexOptimizer, ScaledSingleValuedNonLinearOptimizer);
+
+  using Superclass::ParametersType;
+  using Superclass::CostFunctionType;
+  using Superclass::MeasureType;
+  using Superclass::ScalesType;
+
+  enum StopConditionType
+  {
+    MetricError,
+    MaximumNumberOfIterations,
+    Convergence,
+    Unknown
+  };
+
+  void
+  StartOptimization() override;
+
+  virtual void
+  ResumeOptimization();
+
+  virtual void
+  StopOptimization();
+
+  /** Get information about the optimization process. The current value is
+   * the value of the best vertex, which is the current position. */
+  itkGetConstMacro(CurrentIteration, unsigned long);
+  itkGetConstMacro(CurrentValue, MeasureType);
+  itkGetConstReferenceMacro(StopCondition, StopConditionType);
+
+  /** Get the number of cost function evaluations, including the speculative ones. */
+  itkGetConstMacro(NumberOfEvaluations, SizeValueType);
+
+  /** Setting: the maximum number of iterations. Default: 500. */
+  itkGetConstMacro(MaximumNumberOfIterations, unsigned long);
+  itkSetClampMacro(MaximumNumberOfIterations, unsigned long, 1, NumericTraits<unsigned long>::max());
+
+  /** Setting: the convergence tolerances on the values and the (scaled) parameters.
+   * Defaults: 1e-8 and 1e-8. */
+  itkSetMacro(FunctionConvergenceTolerance, double);
+  itkGetConstMacro(FunctionConvergenceTolerance, double);
+  itkSetMacro(ParametersConvergenceTolerance, double);
+  itkGetConstMacro(ParametersConvergenceTolerance, double);
+
+  /** Setting: the offsets of the initial vertices from the initial position, one
+   * per parameter, in unscaled units. When empty, 5% of the initial parameter is
+   * used, or 0.00025 for parameters that are zero. Empty by default. */
+  itkSetMacro(InitialSimplexDelta, ParametersType);
+  itkGetConstReferenceMacro(InitialSimplexDelta, ParametersType);
+
+  /** Setting: whether the candidates of an iteration are evaluated speculatively, in
+   * parallel, when concurrent cost functions are set. Default: true. */
+  itkSetMacro(UseSpeculativeEvaluation, bool);
+  itkGetConstMacro(UseSpeculativeEvaluation, bool);
+  itkBooleanMacro(UseSpeculativeEvaluation);
+
+protected:
+  SpeculativeSimplexOptimizer() = default;
+  ~SpeculativeSimplexOptimizer() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** Evaluate the (scaled) cost function at the positions. In parallel, when
+   * concurrent cost functions are set. Exceptions are rethrown. */
+  void
+  EvaluatePositions(const std::vector<ParametersType> & positions, std::vector<MeasureType> & values);
+
+  /** Whether the candidates are evaluated in parallel. */
+  bool
+  GetIsEvaluatingInParallel() const;
+
+  /** Sort the vertices from best to worst. */
+  void
+  SortVertices();
+
+  /** Check the convergence criteria. */
+  bool
+  TestConvergence() const;
+
+  unsigned long     m_CurrentIteration{ 0 };
+  MeasureType       m_CurrentValue{ 0.0 };
+  StopConditionType m_StopCondition{ Unknown };
+  bool              m_Stop{ false };
+  SizeValueType     m_NumberOfEvaluations{ 0 };
+
+  /** The (scaled) vertices of the simplex and their values, sorted from best to worst. */
+  std::vector<ParametersType> m_Vertices;
+  std::vector<MeasureType>    m_VertexValues;
+
+private:
+  unsigned long  m_MaximumNumberOfIterations{ 500 };
+  double         m_FunctionConvergenceTolerance{ 1e-8 };
+  double         m_ParametersConvergenceTolerance{ 1e-8 };
+  ParametersType m_InitialSimplexDelta;
+  bool           m_UseSpeculativeEvaluation{ true };
+};
+
+} // end namespace itk
+
+#endif // end #ifndef itkSpeculativeSimplexOptimizer_h
@@ -79,12 +79,14 @@ public:
 
   /** Codes of stopping conditions
    * The MinimumStepSize stopcondition never occurs, but may
-   * be implemented in inheriting classes */
+   * be implemented in inheriting classes. The MaximumNumberOfSamples
+   * stopcondition is set by the users of an adaptive number of samples. */
   enum StopConditionType
   {
     MaximumNumberOfIterations,
     MetricError,
-    MinimumStepSize
+    MinimumStepSize,
+    MaximumNumberOfSamples
   };
 
   /** Advance one step following the gradient direction. */
@@ -78,7 +78,8 @@ public:
 
   /** Codes of stopping conditions
    * The MinimumStepSize stopcondition never occurs, but may
-   * be implemented in inheriting classes */
+   * be implemented in inheriting classes. The MaximumNumberOfSamples
+   * stopcondition is set by the users of an adaptive number of samples. */
   enum StopConditionType
   {
     MaximumNumberOfIterations,
@@ -87,6 +88,7 @@ public:
     InvalidDiagonalMatrix,
     GradientMagnitudeTolerance,
     LineSearchError,
+    MaximumNumberOfSamples,
   };
 
   /** Advance one step following the gradient direction. */
@@ -482,23 +482,28 @@ MultiInputMultiResolutionImageRegistrationMethodBase<TFixedImage, TMovingImage>:
       throw;
     }
 
-    try
-    {
-      // do the optimization
-      this->GetModifiableOptimizer()->StartOptimization();
-    }
-    catch (const ExceptionObject &)
+    // run the optimizer from each start of a multi-start registration, and
+    // keep the result of the best one, or else run it in the usual way
+    if (!this->OptimizeMultiStarts())
     {
-      // An error has occurred in the optimization.
-      // Update the parameters
-      this->m_LastTransformParameters = this->GetOptimizer()->GetCurrentPosition();
+      try
+      {
+        // do the optimization
+        this->GetModifiableOptimizer()->StartOptimization();
+      }
+      catch (const ExceptionObject &)
+      {
+        // An error has occurred in the optimization.
+        // Update the parameters
+        this->m_LastTransformParameters = this->GetOptimizer()->GetCurrentPosition();
 
-      // Pass exception to caller
-      throw;
-    }
+        // Pass exception to caller
+        throw;
+      }
 
-    /** Get the results. */
-    this->m_LastTransformParameters = this->GetOptimizer()->GetCurrentPosition();
+      /** Get the results. */
+      this->m_LastTransformParameters = this->GetOptimizer()->GetCurrentPosition();
+    }
     this->GetModifiableTransform()->SetParameters(this->m_LastTransformParameters);
 
     /** Setup the initial parameters for next level. */
@@ -20,6 +20,8 @@
 
 #include "elxIncludes.h" // include first to avoid MSVS warning
 #include "itkResampleImageFilter.h"
+#include "itkAdvancedTransform.h"
+#include "itkLinearInterpolateImageFunction.h"
 
 namespace elastix
 {
@@ -31,6 +33,11 @@ namespace elastix
  * The parameters used in this class are:
  * \parameter Resampler: Select this resampler as follows:\n
  *    <tt>(Resampler "DefaultResampler")</tt>
+ * \parameter UseFusedResampling: Whether nonlinear advanced transforms, like the B-spline
+ *    transforms, are evaluated per row of output voxels, by TransformPointsAlongLine(), and
+ *    the mapped row is interpolated right away. For a linear interpolator, the interpolation
+ *    is done directly on the image buffer. The default is true.\n
+ *    example: <tt>(UseFusedResampling "false")</tt>
  *
  * \ingroup Resamplers
  */
@@ -83,8 +90,24 @@ public:
   using typename Superclass2::ElastixType;
   using typename Superclass2::RegistrationType;
   using ITKBaseType = typename Superclass2::ITKBaseType;
+  using typename Superclass2::CoordRepType;
 
-  /* Nothing to add. In the baseclass already everything is done what should be done. */
+  /** Typedefs for the fused resampling. */
+  using AdvancedTransformType =
+    itk::AdvancedTransform<CoordRepType, OutputImageType::ImageDimension, InputImageType::ImageDimension>;
+  using LinearInterpolatorType = itk::LinearInterpolateImageFunction<InputImageType, CoordRepType>;
+
+  /** Set/Get whether nonlinear advanced transforms are resampled row by row. Default: true. */
+  itkSetMacro(UseFusedResampling, bool);
+  itkGetConstMacro(UseFusedResampling, bool);
+
+  /** Read UseFusedResampling before registration. */
+  void
+  BeforeRegistration() override;
+
+  /** Read UseFusedResampling from the transform parameter file. */
+  void
+  ReadFromFile() override;
 
 protected:
   /** The constructor. */
@@ -92,8 +115,20 @@ protected:
   /** The destructor. */
   ~MyStandardResampler() override = default;
 
+  /** Resample row by row when the transform is a nonlinear advanced transform, and
+   * forward to the itk::ResampleImageFilter otherwise. */
+  void
+  DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
 private:
   elxOverrideGetSelfMacro;
+
+  /** Map every row of output voxels by TransformPointsAlongLine() and interpolate it. */
+  void
+  FusedThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                            const AdvancedTransformType & transform);
+
+  bool m_UseFusedResampling{ true };
 };
 
 } // end namespace elastix
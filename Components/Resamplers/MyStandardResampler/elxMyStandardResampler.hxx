@@ -21,6 +21,186 @@
 
 #include "elxMyStandardResampler.h"
 
-// nothing
+#include "itkImageScanlineIterator.h"
+#include "itkTotalProgressReporter.h"
+#include <algorithm> // For min and max.
+#include <cmath>
+#include <vector>
 
-#endif
+namespace elastix
+{
+
+/**
+ * ******************* BeforeRegistration ***********************
+ */
+
+template <class TElastix>
+void
+MyStandardResampler<TElastix>::BeforeRegistration()
+{
+  this->m_UseFusedResampling = true;
+  this->m_Configuration->ReadParameter(this->m_UseFusedResampling, "UseFusedResampling", 0, false);
+
+} // end BeforeRegistration()
+
+
+/**
+ * ******************* ReadFromFile  ****************************
+ */
+
+template <class TElastix>
+void
+MyStandardResampler<TElastix>::ReadFromFile()
+{
+  /** Call ReadFromFile of the ResamplerBase. */
+  this->Superclass2::ReadFromFile();
+
+  this->m_UseFusedResampling = true;
+  this->m_Configuration->ReadParameter(this->m_UseFusedResampling, "UseFusedResampling", 0, false);
+
+} // end ReadFromFile()
+
+
+/**
+ * ******************* DynamicThreadedGenerateData ***********************
+ */
+
+template <class TElastix>
+void
+MyStandardResampler<TElastix>::DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread)
+{
+  /** Linear transforms are already mapped incrementally by the itk::ResampleImageFilter,
+   * and an extrapolator is only supported by the itk::ResampleImageFilter. */
+  const auto * const advancedTransform = dynamic_cast<const AdvancedTransformType *>(this->GetTransform());
+  if (!this->m_UseFusedResampling || advancedTransform == nullptr || advancedTransform->IsLinear() ||
+      this->GetExtrapolator() != nullptr || outputRegionForThread.GetNumberOfPixels() == 0)
+  {
+    this->Superclass1::DynamicThreadedGenerateData(outputRegionForThread);
+    return;
+  }
+
+  this->FusedThreadedGenerateData(outputRegionForThread, *advancedTransform);
+
+} // end DynamicThreadedGenerateData()
+
+
+/**
+ * ******************* FusedThreadedGenerateData ***********************
+ */
+
+template <class TElastix>
+void
+MyStandardResampler<TElastix>::FusedThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                                         const AdvancedTransformType & transform)
+{
+  constexpr unsigned int Dimension = InputImageType::ImageDimension;
+  using InputPointType = typename AdvancedTransformType::InputPointType;
+  using OutputPointType = typename AdvancedTransformType::OutputPointType;
+  using InputVectorType = typename AdvancedTransformType::InputVectorType;
+  using ContinuousIndexType = typename InterpolatorType::ContinuousIndexType;
+  using InputPixelType = typename InputImageType::PixelType;
+
+  OutputImageType * const      outputPtr = this->GetOutput();
+  const InputImageType * const inputPtr = this->GetInput();
+  const InterpolatorType &     interpolator = *(this->GetInterpolator());
+  const PixelType              defaultValue = this->GetDefaultPixelValue();
+
+  /** Clamp the interpolated values to the range of the output pixel type, like the itk::ResampleImageFilter. */
+  const auto minimumValue = static_cast<double>(itk::NumericTraits<PixelType>::NonpositiveMin());
+  const auto maximumValue = static_cast<double>(itk::NumericTraits<PixelType>::max());
+  const auto castValue = [minimumValue, maximumValue](const double value) {
+    return value < minimumValue   ? static_cast<PixelType>(minimumValue)
+           : value > maximumValue ? static_cast<PixelType>(maximumValue)
+                                  : static_cast<PixelType>(value);
+  };
+
+  /** A linear interpolator is evaluated directly on the buffer: the weighted sum of the
+   * 2^Dimension neighbours, which are clamped to the buffered region, like it does itself. */
+  const bool useLinearKernel = dynamic_cast<const LinearInterpolatorType *>(&interpolator) != nullptr;
+
+  const InputPixelType * const inputBuffer = inputPtr->GetBufferPointer();
+  const auto * const           offsetTable = inputPtr->GetOffsetTable();
+  const auto                   startIndex = interpolator.GetStartIndex();
+  const auto                   endIndex = interpolator.GetEndIndex();
+
+  const auto evaluateLinear = [&](const ContinuousIndexType & cindex) {
+    itk::OffsetValueType baseOffset = 0;
+    itk::OffsetValueType upperOffset[Dimension];
+    double               distance[Dimension];
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      auto       base = static_cast<itk::IndexValueType>(std::floor(cindex[d]));
+      const auto upper = std::min(std::max(base + 1, startIndex[d]), endIndex[d]);
+      distance[d] = cindex[d] - static_cast<double>(base);
+      base = std::min(std::max(base, startIndex[d]), endIndex[d]);
+      baseOffset += (base - startIndex[d]) * offsetTable[d];
+      upperOffset[d] = (upper - base) * offsetTable[d];
+    }
+
+    double value = 0.0;
+    for (unsigned int corner = 0; corner < (1u << Dimension); ++corner)
+    {
+      double               weight = 1.0;
+      itk::OffsetValueType offset = baseOffset;
+      for (unsigned int d = 0; d < Dimension; ++d)
+      {
+        if (corner & (1u << d))
+        {
+          weight *= distance[d];
+          offset += upperOffset[d];
+        }
+        else
+        {
+          weight *= 1.0 - distance[d];
+        }
+      }
+      value += weight * static_cast<double>(inputBuffer[offset]);
+    }
+    return value;
+  };
+
+  /** All rows run along the first output axis. */
+  const auto &    direction = outputPtr->GetDirection();
+  const auto &    spacing = outputPtr->GetSpacing();
+  InputVectorType step;
+  for (unsigned int i = 0; i < Dimension; ++i)
+  {
+    step[i] = direction[i][0] * spacing[0];
+  }
+
+  const itk::SizeValueType     rowLength = outputRegionForThread.GetSize(0);
+  std::vector<OutputPointType> mappedPoints(rowLength);
+  itk::TotalProgressReporter   progress(this, outputPtr->GetRequestedRegion().GetNumberOfPixels());
+
+  itk::ImageScanlineIterator<OutputImageType> outIt(outputPtr, outputRegionForThread);
+  while (!outIt.IsAtEnd())
+  {
+    InputPointType firstPoint;
+    outputPtr->TransformIndexToPhysicalPoint(outIt.GetIndex(), firstPoint);
+    transform.TransformPointsAlongLine(firstPoint, step, rowLength, mappedPoints.data());
+
+    for (itk::SizeValueType k = 0; k < rowLength; ++k)
+    {
+      const ContinuousIndexType cindex =
+        inputPtr->template TransformPhysicalPointToContinuousIndex<CoordRepType>(mappedPoints[k]);
+      if (interpolator.IsInsideBuffer(cindex))
+      {
+        outIt.Set(castValue(useLinearKernel ? evaluateLinear(cindex)
+                                            : static_cast<double>(interpolator.EvaluateAtContinuousIndex(cindex))));
+      }
+      else
+      {
+        outIt.Set(defaultValue);
+      }
+      ++outIt;
+    }
+    outIt.NextLine();
+    progress.Completed(rowLength);
+  }
+
+} // end FusedThreadedGenerateData()
+
+
+} // end namespace elastix
+
+#endif // end #ifndef elxMyStandardResampler_hxx
@@ -32,6 +32,9 @@ template <class TElastix>
 void
 ImageSamplerBase<TElastix>::BeforeEachResolutionBase()
 {
+  /** The settings of the sampler may only change when its background sample generation has finished. */
+  this->GetAsITKBaseType()->WaitForBackgroundSampleGeneration();
+
   /** Get the current resolution level. */
   unsigned int level = this->m_Registration->GetAsITKBaseType()->GetCurrentLevel();
 
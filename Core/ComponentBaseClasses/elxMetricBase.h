@@ -63,6 +63,39 @@ namespace elastix
  *    CheckNumberOfSamples. \n
  *    example: <tt>(RequiredRatioOfValidSamples 0.1)</tt> \n
  *    The default is 0.25.
+ * \parameter UseWorkStealingThreadPool: Whether the multi-threaded metric computation
+ *    uses a persistent pool of threads, instead of starting new threads on each
+ *    evaluation. This reduces the overhead when the number of samples is small.
+ *    The pool is shared by all registrations in the process; the number of threads
+ *    of the metric only limits how many of its threads an evaluation uses.
+ *    Can be given for each resolution or for all resolutions at once. \n
+ *    example: <tt>(UseWorkStealingThreadPool "true")</tt> \n
+ *    The default is false.
+ * \parameter UseStructureOfArraysSamples: Whether the metric loops over blocks of
+ *    image samples. The points and values of each block are gathered into small arrays,
+ *    so that the block is transformed and interpolated at once. This is supported by the
+ *    AdvancedMeanSquares and AdvancedNormalizedCorrelation metrics. The samples are not
+ *    copied, so the metric value and derivative do not change, and no memory is added.
+ *    Can be given for each resolution or for all resolutions at once. \n
+ *    example: <tt>(UseStructureOfArraysSamples "true")</tt> \n
+ *    The default is false.
+ * \parameter UseSinglePrecisionDerivativeAccumulation: Whether each thread accumulates
+ *    its derivative in float. Only the accumulation is single precision: the samples,
+ *    image gradients and Jacobian products remain double, and the sum over the threads
+ *    is done in double precision. This is supported by the AdvancedMeanSquares metric,
+ *    and halves the memory traffic of the derivative accumulation.
+ *    Can be given for each resolution or for all resolutions at once. \n
+ *    example: <tt>(UseSinglePrecisionDerivativeAccumulation "true")</tt> \n
+ *    The default is false.
+ * \parameter UseTransformSampleCache: Whether the transform stores the data that only
+ *    depends on the sample positions, like the B-spline support region and weights,
+ *    and reuses it until the sampler produces new samples. Only useful when the
+ *    samples are fixed during a resolution, for example with the Grid and Full
+ *    samplers, or with (NewSamplesEveryIteration "false"). Currently supported by the
+ *    RecursiveBSplineTransform, also when composed with an initial transform.
+ *    Can be given for each resolution or for all resolutions at once. \n
+ *    example: <tt>(UseTransformSampleCache "true")</tt> \n
+ *    The default is false.
  *
  * \ingroup Metrics
  * \ingroup ComponentBaseClasses
@@ -151,6 +151,33 @@ MetricBase<TElastix>::BeforeEachResolutionBase()
       }
     }
 
+    /** Should the metric use the persistent thread pool? */
+    bool useThreadPool = false;
+    this->GetConfiguration()->ReadParameter(
+      useThreadPool, "UseWorkStealingThreadPool", this->GetComponentLabel(), level, 0);
+    thisAsAdvanced->SetUseWorkStealingThreadPool(useThreadPool);
+
+    /** Should the metric loop over blocks of samples? */
+    bool useStructureOfArraysSamples = false;
+    this->GetConfiguration()->ReadParameter(
+      useStructureOfArraysSamples, "UseStructureOfArraysSamples", this->GetComponentLabel(), level, 0);
+    thisAsAdvanced->SetUseStructureOfArraysSamples(useStructureOfArraysSamples);
+
+    /** Should the threads accumulate their derivative in single precision? */
+    bool useSinglePrecisionDerivativeAccumulation = false;
+    this->GetConfiguration()->ReadParameter(useSinglePrecisionDerivativeAccumulation,
+                                            "UseSinglePrecisionDerivativeAccumulation",
+                                            this->GetComponentLabel(),
+                                            level,
+                                            0);
+    thisAsAdvanced->SetUseSinglePrecisionDerivativeAccumulation(useSinglePrecisionDerivativeAccumulation);
+
+    /** Should the transform cache the sample dependent data, like the B-spline weights? */
+    bool useTransformSampleCache = false;
+    this->GetConfiguration()->ReadParameter(
+      useTransformSampleCache, "UseTransformSampleCache", this->GetComponentLabel(), level, 0);
+    thisAsAdvanced->SetUseTransformSampleCache(useTransformSampleCache);
+
   } // end advanced metric
 
 } // end BeforeEachResolutionBase()
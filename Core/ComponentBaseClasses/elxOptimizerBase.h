@@ -24,6 +24,10 @@
 
 #include "elxBaseComponentSE.h"
 #include "itkOptimizer.h"
+#include "itkAdaptiveSampleSizeSchedule.h"
+#include "itkImageRandomSamplerBase.h"
+#include "itkStochasticConvergenceCriterion.h"
+#include <vector>
 
 namespace elastix
 {
@@ -44,6 +48,57 @@ namespace elastix
  *    Choose one from {"true", "false"} for every resolution.\n
  *    example: <tt>(NewSamplesEveryIteration "true" "true" "true")</tt> \n
  *    Default is "false" for every resolution.\n
+ * \parameter UseAdaptiveNumberOfSamples: if this flag is set to "true", in combination with
+ *    NewSamplesEveryIteration, the number of samples of the random image samplers is adapted
+ *    every iteration to the noise in the gradient: few samples while the gradient is large,
+ *    more samples near convergence. Only supported by the AdaptiveStochasticGradientDescent,
+ *    AdaptiveStochasticLBFGS and AdaptiveStochasticVarianceReducedGradient optimizers.
+ *    The first iteration uses the NumberOfSpatialSamples of the sampler. The number of samples
+ *    of the first random sampler follows the schedule; the other random samplers keep their ratio
+ *    to it. Every change of the number of samples discards the samples that a sampler has generated
+ *    in the background (UseBackgroundSampleGeneration).\n
+ *    example: <tt>(UseAdaptiveNumberOfSamples "true")</tt> \n
+ *    Default is "false" for every resolution.\n
+ * \parameter MinimumNumberOfSpatialSamples: the minimum number of samples per iteration, when
+ *    UseAdaptiveNumberOfSamples is "true". It applies to the first random sampler.\n
+ *    example: <tt>(MinimumNumberOfSpatialSamples 500 1000 2000)</tt> \n
+ *    Default is a quarter of the NumberOfSpatialSamples of the sampler.\n
+ * \parameter MaximumNumberOfSpatialSamples: the maximum number of samples per iteration, when
+ *    UseAdaptiveNumberOfSamples is "true". It applies to the first random sampler.\n
+ *    example: <tt>(MaximumNumberOfSpatialSamples 20000 20000 40000)</tt> \n
+ *    Default is ten times the NumberOfSpatialSamples of the sampler.\n
+ * \parameter MaximumTotalNumberOfSpatialSamples: the budget of samples for all iterations of a
+ *    resolution, when UseAdaptiveNumberOfSamples is "true". The optimization of the resolution
+ *    stops when the budget is used. Zero means no budget.\n
+ *    example: <tt>(MaximumTotalNumberOfSpatialSamples 5000000)</tt> \n
+ *    Default is 0 for every resolution.\n
+ * \parameter AdaptiveNumberOfSamplesNoiseRatio: the desired ratio of the standard deviation of
+ *    the gradient noise and the magnitude of the exact gradient, when UseAdaptiveNumberOfSamples
+ *    is "true". Larger values give fewer samples.\n
+ *    example: <tt>(AdaptiveNumberOfSamplesNoiseRatio 0.5)</tt> \n
+ *    Default is 1.0 for every resolution.\n
+ * \parameter UseStochasticConvergenceDetection: if this flag is set to "true", the resolution
+ *    stops before MaximumNumberOfIterations, when windowed statistics of the metric value and of
+ *    the gradient show that the optimization has converged: the inner products of consecutive
+ *    gradients change sign often, and the metric value no longer decreases significantly.
+ *    The sign-change ratio is printed in the "5:SignChanges" column of the iteration info, which
+ *    shows "converged" in the iteration that stops. Only supported by the
+ *    AdaptiveStochasticGradientDescent, AdaptiveStochasticLBFGS and
+ *    AdaptiveStochasticVarianceReducedGradient optimizers.\n
+ *    example: <tt>(UseStochasticConvergenceDetection "false" "false" "true")</tt> \n
+ *    Default is "false" for every resolution.\n
+ * \parameter ConvergenceWindowSize: the number of iterations over which the statistics of
+ *    UseStochasticConvergenceDetection are computed.\n
+ *    example: <tt>(ConvergenceWindowSize 200)</tt> \n
+ *    Default is 100 for every resolution.\n
+ * \parameter ConvergenceSignChangeRatio: the minimum fraction of iterations in the window in
+ *    which the inner product of consecutive gradients is negative.\n
+ *    example: <tt>(ConvergenceSignChangeRatio 0.45)</tt> \n
+ *    Default is 0.4 for every resolution.\n
+ * \parameter ConvergenceZScore: the number of standard errors by which the slope of the metric
+ *    value in the window must be negative, for the optimization to continue.\n
+ *    example: <tt>(ConvergenceZScore 3.0)</tt> \n
+ *    Default is 2.0 for every resolution.\n
  *
  * \ingroup Optimizers
  * \ingroup ComponentBaseClasses
@@ -92,18 +147,38 @@ public:
   virtual void
   SetCurrentPositionPublic(const ParametersType & param);
 
+  /** Execute stuff before the registration:
+   * \li Add the iteration info column of UseStochasticConvergenceDetection, if it is used.
+   */
+  void
+  BeforeRegistrationBase() override;
+
   /** Execute stuff before each new pyramid resolution:
    * \li Find out if new samples are used every new iteration in this resolution.
    */
   void
   BeforeEachResolutionBase() override;
 
+  /** Execute stuff after each pyramid resolution:
+   * \li Print the total number of samples, when the number of samples is adaptive.
+   */
+  void
+  AfterEachResolutionBase() override;
+
   /** Execute stuff after registration:
    * \li Compute and print MD5 hash of the transform parameters.
    */
   void
   AfterRegistrationBase() override;
 
+  /** Restart the adaptive number of samples and the stochastic convergence detection,
+   * for another run of the optimizer in the current resolution, such as the run from the
+   * next start of a multi-start registration. The random image samplers get their initial
+   * number of samples back.
+   */
+  void
+  RestartResolution();
+
   /** Method that sets the scales defined by a sinus
    * scale[i] = amplitude^( sin(i/nrofparam*2pi*frequency) )
    */
@@ -126,13 +201,51 @@ protected:
   virtual bool
   GetNewSamplesEveryIteration() const;
 
+  /** When UseAdaptiveNumberOfSamples is set, pass the gradient of the current iteration
+   * to the schedule, and give the random image samplers the number of samples for the
+   * next iteration, each relative to its own initial number of samples. Call it before
+   * SelectNewSamples(). Returns false when the budget of samples is used, in which case
+   * the optimization should stop. */
+  bool
+  AdaptNumberOfSamples(const itk::Array<double> & gradient);
+
+  /** When UseStochasticConvergenceDetection is set, pass the value and gradient of the
+   * current iteration to the convergence criterion. Returns true when convergence is
+   * detected, in which case the optimization should stop. */
+  bool
+  DetectStochasticConvergence(double value, const itk::Array<double> & gradient);
+
+  /** Get the reason why DetectStochasticConvergence() stopped the current resolution.
+   * Empty when it did not. */
+  std::string
+  GetStochasticConvergenceStopReason() const;
+
 private:
   elxDeclarePureVirtualGetSelfMacro(ITKBaseType);
 
+  using ImageRandomSamplerBaseType = itk::ImageRandomSamplerBase<typename ElastixType::FixedImageType>;
+
+  /** Get the random image samplers of the metrics. Other samplers have a fixed number of samples. */
+  std::vector<ImageRandomSamplerBaseType *>
+  GetRandomImageSamplers() const;
+
   /** Member variable to store the user preference for using new
    * samples each iteration.
    */
   bool m_NewSamplesEveryIteration{ false };
+
+  /** The schedule of the number of samples, and whether it is used and initialized. */
+  itk::AdaptiveSampleSizeSchedule::Pointer m_AdaptiveSampleSizeSchedule{ itk::AdaptiveSampleSizeSchedule::New() };
+  bool                                     m_UseAdaptiveNumberOfSamples{ false };
+  bool                                     m_AdaptiveSampleSizeScheduleIsInitialized{ false };
+  std::vector<unsigned long>               m_InitialNumbersOfSamples;
+
+  /** The convergence criterion, and whether it is used in the current resolution, or in any resolution. */
+  itk::StochasticConvergenceCriterion::Pointer m_StochasticConvergenceCriterion{
+    itk::StochasticConvergenceCriterion::New()
+  };
+  bool m_UseStochasticConvergenceDetection{ false };
+  bool m_StochasticConvergenceDetectionIsUsed{ false };
 };
 
 } // end namespace elastix
@@ -22,6 +22,8 @@
 
 #include "itkSingleValuedNonLinearOptimizer.h"
 #include "itk_zlib.h"
+#include <algorithm> // For max.
+#include <cmath>     // For lround.
 
 namespace elastix
 {
@@ -45,6 +47,40 @@ OptimizerBase<TElastix>::SetCurrentPositionPublic(const ParametersType & /** par
 } // end SetCurrentPositionPublic()
 
 
+/**
+ * ****************** BeforeRegistrationBase **********************
+ */
+
+template <class TElastix>
+void
+OptimizerBase<TElastix>::BeforeRegistrationBase()
+{
+  /** The columns of the iteration info must be known before the first iteration, so all
+   * resolutions are checked. The default number of resolutions is that of the registration. */
+  unsigned int numberOfResolutions = 3;
+  this->GetConfiguration()->ReadParameter(numberOfResolutions, "NumberOfResolutions", 0, false);
+  const std::string  parameterName = "UseStochasticConvergenceDetection";
+  const std::size_t  numberOfEntries =
+    std::max(this->GetConfiguration()->CountNumberOfParameterEntries(parameterName),
+             this->GetConfiguration()->CountNumberOfParameterEntries(this->GetComponentLabel() + parameterName));
+  const unsigned int numberOfLevels = std::max({ numberOfResolutions, static_cast<unsigned int>(numberOfEntries), 1u });
+  this->m_StochasticConvergenceDetectionIsUsed = false;
+  for (unsigned int level = 0; level < numberOfLevels; ++level)
+  {
+    bool useStochasticConvergenceDetection = false;
+    this->GetConfiguration()->ReadParameter(
+      useStochasticConvergenceDetection, parameterName, this->GetComponentLabel(), level, 0, false);
+    this->m_StochasticConvergenceDetectionIsUsed |= useStochasticConvergenceDetection;
+  }
+  if (this->m_StochasticConvergenceDetectionIsUsed)
+  {
+    this->AddTargetCellToIterationInfo("5:SignChanges");
+    this->GetIterationInfoAt("5:SignChanges") << std::showpoint << std::fixed;
+  }
+
+} // end BeforeRegistrationBase()
+
+
 /**
  * ****************** BeforeEachResolutionBase **********************
  */
@@ -61,9 +97,54 @@ OptimizerBase<TElastix>::BeforeEachResolutionBase()
   this->GetConfiguration()->ReadParameter(
     this->m_NewSamplesEveryIteration, "NewSamplesEveryIteration", this->GetComponentLabel(), level, 0);
 
+  /** Check if the number of samples should be adapted every iteration. */
+  this->m_UseAdaptiveNumberOfSamples = false;
+  this->GetConfiguration()->ReadParameter(
+    this->m_UseAdaptiveNumberOfSamples, "UseAdaptiveNumberOfSamples", this->GetComponentLabel(), level, 0);
+  this->m_AdaptiveSampleSizeScheduleIsInitialized = false;
+
+  /** Check if the resolution may stop when convergence is detected. */
+  this->m_UseStochasticConvergenceDetection = false;
+  this->GetConfiguration()->ReadParameter(this->m_UseStochasticConvergenceDetection,
+                                          "UseStochasticConvergenceDetection",
+                                          this->GetComponentLabel(),
+                                          level,
+                                          0);
+  if (this->m_UseStochasticConvergenceDetection)
+  {
+    unsigned int windowSize = 100;
+    double       minimumSignChangeRatio = 0.4;
+    double       zScore = 2.0;
+    this->GetConfiguration()->ReadParameter(windowSize, "ConvergenceWindowSize", this->GetComponentLabel(), level, 0);
+    this->GetConfiguration()->ReadParameter(
+      minimumSignChangeRatio, "ConvergenceSignChangeRatio", this->GetComponentLabel(), level, 0);
+    this->GetConfiguration()->ReadParameter(zScore, "ConvergenceZScore", this->GetComponentLabel(), level, 0);
+    this->m_StochasticConvergenceCriterion->SetWindowSize(windowSize);
+    this->m_StochasticConvergenceCriterion->SetMinimumSignChangeRatio(minimumSignChangeRatio);
+    this->m_StochasticConvergenceCriterion->SetZScore(zScore);
+  }
+  this->m_StochasticConvergenceCriterion->Initialize();
+
 } // end BeforeEachResolutionBase()
 
 
+/**
+ * ****************** AfterEachResolutionBase **********************
+ */
+
+template <class TElastix>
+void
+OptimizerBase<TElastix>::AfterEachResolutionBase()
+{
+  if (this->m_AdaptiveSampleSizeScheduleIsInitialized)
+  {
+    elxout << "Total number of spatial samples used in this resolution: "
+           << this->m_AdaptiveSampleSizeSchedule->GetTotalNumberOfSamples() << std::endl;
+  }
+
+} // end AfterEachResolutionBase()
+
+
 /**
  * ****************** AfterRegistrationBase **********************
  */
@@ -75,7 +156,7 @@ OptimizerBase<TElastix>::AfterRegistrationBase()
   using ParametersValueType = typename ParametersType::ValueType;
 
   /** Get the final parameters, round to six decimals. */
-  ParametersType      finalTP = this->GetAsITKBaseType()->GetCurrentPosition();
+  ParametersType      finalTP = this->GetElastix()->GetCurrentTransformParameters();
   const unsigned long N = finalTP.GetSize();
   ParametersType      roundedTP(N);
   for (unsigned int i = 0; i < N; ++i)
@@ -126,6 +207,176 @@ OptimizerBase<TElastix>::GetNewSamplesEveryIteration() const
 } // end GetNewSamplesEveryIteration()
 
 
+/**
+ * ****************** AdaptNumberOfSamples ********************
+ */
+
+template <class TElastix>
+bool
+OptimizerBase<TElastix>::AdaptNumberOfSamples(const itk::Array<double> & gradient)
+{
+  if (!this->m_UseAdaptiveNumberOfSamples || !this->m_NewSamplesEveryIteration)
+  {
+    return true;
+  }
+
+  const std::vector<ImageRandomSamplerBaseType *> randomSamplers = this->GetRandomImageSamplers();
+  if (randomSamplers.empty())
+  {
+    elxout["warning"] << "WARNING: UseAdaptiveNumberOfSamples requires a random image sampler, and is ignored."
+                      << std::endl;
+    this->m_UseAdaptiveNumberOfSamples = false;
+    return true;
+  }
+
+  /** Start the schedule at the number of samples of the first sampler. The initial
+   * number of samples of each sampler is kept, to scale the schedule per sampler. */
+  if (!this->m_AdaptiveSampleSizeScheduleIsInitialized)
+  {
+    this->m_InitialNumbersOfSamples.clear();
+    for (const ImageRandomSamplerBaseType * randomSampler : randomSamplers)
+    {
+      this->m_InitialNumbersOfSamples.push_back(std::max(randomSampler->GetNumberOfSamples(), 1ul));
+    }
+
+    const unsigned int  level = this->GetRegistration()->GetAsITKBaseType()->GetCurrentLevel();
+    const unsigned long numberOfSamples = this->m_InitialNumbersOfSamples[0];
+
+    unsigned long minimumNumberOfSamples = std::max(numberOfSamples / 4, 1ul);
+    unsigned long maximumNumberOfSamples = 10 * numberOfSamples;
+    unsigned long maximumTotalNumberOfSamples = 0;
+    double        noiseToSignalRatio = 1.0;
+    this->GetConfiguration()->ReadParameter(
+      minimumNumberOfSamples, "MinimumNumberOfSpatialSamples", this->GetComponentLabel(), level, 0);
+    this->GetConfiguration()->ReadParameter(
+      maximumNumberOfSamples, "MaximumNumberOfSpatialSamples", this->GetComponentLabel(), level, 0);
+    this->GetConfiguration()->ReadParameter(
+      maximumTotalNumberOfSamples, "MaximumTotalNumberOfSpatialSamples", this->GetComponentLabel(), level, 0);
+    this->GetConfiguration()->ReadParameter(
+      noiseToSignalRatio, "AdaptiveNumberOfSamplesNoiseRatio", this->GetComponentLabel(), level, 0);
+
+    this->m_AdaptiveSampleSizeSchedule->SetMinimumNumberOfSamples(minimumNumberOfSamples);
+    this->m_AdaptiveSampleSizeSchedule->SetMaximumNumberOfSamples(
+      std::max(maximumNumberOfSamples, minimumNumberOfSamples));
+    this->m_AdaptiveSampleSizeSchedule->SetMaximumTotalNumberOfSamples(maximumTotalNumberOfSamples);
+    this->m_AdaptiveSampleSizeSchedule->SetNoiseToSignalRatio(noiseToSignalRatio);
+    this->m_AdaptiveSampleSizeSchedule->Initialize(numberOfSamples);
+    this->m_AdaptiveSampleSizeScheduleIsInitialized = true;
+  }
+
+  /** Compute the number of samples of the next iteration. */
+  if (!this->m_AdaptiveSampleSizeSchedule->Update(gradient))
+  {
+    elxout << "The budget of " << this->m_AdaptiveSampleSizeSchedule->GetMaximumTotalNumberOfSamples()
+           << " spatial samples has been used." << std::endl;
+    return false;
+  }
+  /** The first sampler follows the schedule, the others keep their ratio to it. Note that
+   * a new number of samples discards the samples that are generated in the background. */
+  const double scheduleRatio = static_cast<double>(this->m_AdaptiveSampleSizeSchedule->GetNumberOfSamples()) /
+                               static_cast<double>(this->m_InitialNumbersOfSamples[0]);
+  for (std::size_t i = 0; i < randomSamplers.size(); ++i)
+  {
+    const double numberOfSamples = scheduleRatio * static_cast<double>(this->m_InitialNumbersOfSamples[i]);
+    randomSamplers[i]->SetNumberOfSamples(std::max(static_cast<unsigned long>(std::lround(numberOfSamples)), 1ul));
+  }
+  return true;
+
+} // end AdaptNumberOfSamples()
+
+
+/**
+ * ****************** RestartResolution ********************
+ */
+
+template <class TElastix>
+void
+OptimizerBase<TElastix>::RestartResolution()
+{
+  /** The schedule is initialized again at the next call of AdaptNumberOfSamples(). */
+  if (this->m_AdaptiveSampleSizeScheduleIsInitialized)
+  {
+    const std::vector<ImageRandomSamplerBaseType *> randomSamplers = this->GetRandomImageSamplers();
+    for (std::size_t i = 0; i < randomSamplers.size() && i < this->m_InitialNumbersOfSamples.size(); ++i)
+    {
+      randomSamplers[i]->SetNumberOfSamples(this->m_InitialNumbersOfSamples[i]);
+    }
+    this->m_AdaptiveSampleSizeScheduleIsInitialized = false;
+  }
+
+  this->m_StochasticConvergenceCriterion->Initialize();
+
+} // end RestartResolution()
+
+
+/**
+ * ****************** GetRandomImageSamplers ********************
+ */
+
+template <class TElastix>
+auto
+OptimizerBase<TElastix>::GetRandomImageSamplers() const -> std::vector<ImageRandomSamplerBaseType *>
+{
+  std::vector<ImageRandomSamplerBaseType *> randomSamplers;
+  for (unsigned int i = 0; i < this->GetElastix()->GetNumberOfMetrics(); ++i)
+  {
+    auto * randomSampler = dynamic_cast<ImageRandomSamplerBaseType *>(
+      this->GetElastix()->GetElxMetricBase(i)->GetAdvancedMetricImageSampler());
+    if (randomSampler != nullptr)
+    {
+      randomSamplers.push_back(randomSampler);
+    }
+  }
+  return randomSamplers;
+
+} // end GetRandomImageSamplers()
+
+
+/**
+ * ****************** DetectStochasticConvergence ********************
+ */
+
+template <class TElastix>
+bool
+OptimizerBase<TElastix>::DetectStochasticConvergence(const double value, const itk::Array<double> & gradient)
+{
+  if (!this->m_UseStochasticConvergenceDetection)
+  {
+    if (this->m_StochasticConvergenceDetectionIsUsed)
+    {
+      this->GetIterationInfoAt("5:SignChanges") << "---";
+    }
+    return false;
+  }
+
+  const bool converged = this->m_StochasticConvergenceCriterion->Update(value, gradient);
+  if (converged)
+  {
+    this->GetIterationInfoAt("5:SignChanges") << "converged";
+    elxout << this->m_StochasticConvergenceCriterion->GetStopReason() << "." << std::endl;
+  }
+  else
+  {
+    this->GetIterationInfoAt("5:SignChanges") << this->m_StochasticConvergenceCriterion->GetSignChangeRatio();
+  }
+  return converged;
+
+} // end DetectStochasticConvergence()
+
+
+/**
+ * ****************** GetStochasticConvergenceStopReason ********************
+ */
+
+template <class TElastix>
+std::string
+OptimizerBase<TElastix>::GetStochasticConvergenceStopReason() const
+{
+  return this->m_StochasticConvergenceCriterion->GetStopReason();
+
+} // end GetStochasticConvergenceStopReason()
+
+
 /**
  * ****************** SetSinusScales ********************
  */
@@ -66,6 +66,28 @@ namespace elastix
  *    from one resolution level to another. Choose from {"true", "false"} \n
  *    example: <tt>(ErodeMovingMask2 "true" "false")</tt>
  *    This setting overrules ErodeMask and ErodeMovingMask.\n
+ * \parameter NumberOfMultiStarts: the number of starts of a multi-start registration.
+ *    The registration starts from the initial transform, and from NumberOfMultiStarts - 1
+ *    randomly rotated and translated versions of it. At each resolution the optimizer
+ *    runs from every active start, and the worst starts are pruned. The result of the
+ *    best start is the result of the resolution. Only supported for transforms with a
+ *    matrix and a translation, such as the EulerTransform, the SimilarityTransform and
+ *    the AffineTransform. The iterations of the runs from the starts are not written to
+ *    the iteration info, and the components only report the resolution as a whole. \n
+ *    example: <tt>(NumberOfMultiStarts 8)</tt> \n
+ *    The default is 1, which disables multi-start. \n
+ * \parameter MultiStartRotationRange: the maximum rotation angle of the additional starts,
+ *    in radians. The rotations are around the center of rotation, about a random axis. \n
+ *    example: <tt>(MultiStartRotationRange 1.57)</tt> \n
+ *    The default is 0.785398 (45 degrees). \n
+ * \parameter MultiStartTranslationRange: the maximum translation of the additional starts,
+ *    in mm, in each direction. \n
+ *    example: <tt>(MultiStartTranslationRange 20.0)</tt> \n
+ *    The default is 0.0. \n
+ * \parameter MultiStartSurvivalFraction: the fraction of the starts that remains active
+ *    after each resolution. At least one start remains active. \n
+ *    example: <tt>(MultiStartSurvivalFraction 0.5)</tt> \n
+ *    The default is 0.0: only the best start continues after the first resolution. \n
  *
  * \ingroup Registrations
  * \ingroup ComponentBaseClasses
@@ -145,6 +167,18 @@ public:
                      const std::string &       whichMask,
                      const unsigned int        level) const;
 
+  /** Execute stuff before each resolution:
+   * \li Generate the starts of a multi-start registration, at the first resolution.
+   */
+  void
+  BeforeEachResolutionBase() override;
+
+  /** Execute stuff after each resolution:
+   * \li Print the metric values of the starts of a multi-start registration.
+   */
+  void
+  AfterEachResolutionBase() override;
+
 protected:
   /** The constructor. */
   RegistrationBase() = default;
@@ -207,6 +241,12 @@ protected:
                                   const MovingImagePyramidType * pyramid,
                                   unsigned int                   level) const;
 
+  /** Generate NumberOfMultiStarts - 1 additional starts, by rotating and translating
+   * the initial transform, and pass them to the registration.
+   */
+  virtual void
+  GenerateMultiStartTransformParameters(unsigned int numberOfMultiStarts);
+
 private:
   elxDeclarePureVirtualGetSelfMacro(ITKBaseType);
 };
@@ -19,6 +19,11 @@
 #define elxRegistrationBase_hxx
 
 #include "elxRegistrationBase.h"
+#include "itkAdvancedMatrixOffsetTransformBase.h"
+#include <vnl/vnl_math.h>
+
+#include <cmath>
+#include <random>
 
 namespace elastix
 {
@@ -214,6 +219,173 @@ RegistrationBase<TElastix>::GenerateMovingMaskSpatialObject(const MovingMaskImag
 } // end GenerateMovingMaskSpatialObject()
 
 
+/**
+ * ******************* BeforeEachResolutionBase ***********************
+ */
+
+template <class TElastix>
+void
+RegistrationBase<TElastix>::BeforeEachResolutionBase()
+{
+  /** The starts are generated once, from the initialized transform. */
+  const unsigned int level = this->GetAsITKBaseType()->GetCurrentLevel();
+  if (level != 0)
+  {
+    return;
+  }
+
+  unsigned int numberOfMultiStarts = 1;
+  this->GetConfiguration()->ReadParameter(
+    numberOfMultiStarts, "NumberOfMultiStarts", this->GetComponentLabel(), 0, 0, false);
+
+  double survivalFraction = 0.0;
+  this->GetConfiguration()->ReadParameter(
+    survivalFraction, "MultiStartSurvivalFraction", this->GetComponentLabel(), 0, 0, false);
+  this->GetAsITKBaseType()->SetMultiStartSurvivalFraction(survivalFraction);
+
+  this->GenerateMultiStartTransformParameters(numberOfMultiStarts);
+
+} // end BeforeEachResolutionBase()
+
+
+/**
+ * ******************* AfterEachResolutionBase ***********************
+ */
+
+template <class TElastix>
+void
+RegistrationBase<TElastix>::AfterEachResolutionBase()
+{
+  const auto & values = this->GetAsITKBaseType()->GetMultiStartValues();
+  if (values.empty())
+  {
+    return;
+  }
+
+  elxout << "Final metric values of the " << values.size() << " starts of the multi-start registration:";
+  for (const auto value : values)
+  {
+    elxout << " " << value;
+  }
+  elxout << "\n"
+         << this->GetAsITKBaseType()->GetNumberOfActiveMultiStarts()
+         << " start(s) remain active. The result of the best start is kept." << std::endl;
+
+} // end AfterEachResolutionBase()
+
+
+/**
+ * ******************* GenerateMultiStartTransformParameters ***********************
+ */
+
+template <class TElastix>
+void
+RegistrationBase<TElastix>::GenerateMultiStartTransformParameters(const unsigned int numberOfMultiStarts)
+{
+  using ParametersContainerType = typename ITKBaseType::ParametersContainerType;
+  using CoordRepType = ElastixBase::CoordRepType;
+  using MatrixOffsetTransformType =
+    itk::AdvancedMatrixOffsetTransformBase<CoordRepType, Self::FixedImageDimension, Self::FixedImageDimension>;
+  using MatrixType = typename MatrixOffsetTransformType::MatrixType;
+  using OutputVectorType = typename MatrixOffsetTransformType::OutputVectorType;
+  constexpr unsigned int Dimension = Self::FixedImageDimension;
+
+  ParametersContainerType multiStartParameters;
+  if (numberOfMultiStarts <= 1)
+  {
+    this->GetAsITKBaseType()->SetMultiStartTransformParameters(multiStartParameters);
+    return;
+  }
+
+  auto * const matrixOffsetTransform = dynamic_cast<MatrixOffsetTransformType *>(
+    this->GetElastix()->GetElxTransformBase()->GetAsITKBaseType()->GetModifiableCurrentTransform());
+  if (matrixOffsetTransform == nullptr)
+  {
+    xl::xout["warning"] << "WARNING: NumberOfMultiStarts is only supported for transforms with a matrix and a "
+                           "translation. The registration uses a single start."
+                        << std::endl;
+    this->GetAsITKBaseType()->SetMultiStartTransformParameters(multiStartParameters);
+    return;
+  }
+
+  double rotationRange = vnl_math::pi / 4.0;
+  double translationRange = 0.0;
+  this->GetConfiguration()->ReadParameter(
+    rotationRange, "MultiStartRotationRange", this->GetComponentLabel(), 0, 0, false);
+  this->GetConfiguration()->ReadParameter(
+    translationRange, "MultiStartTranslationRange", this->GetComponentLabel(), 0, 0, false);
+
+  /** Use the RandomSeed, so that the starts are reproducible. */
+  unsigned int randomSeed = 121212;
+  this->GetConfiguration()->ReadParameter(randomSeed, "RandomSeed", 0, false);
+  std::mt19937                           randomGenerator(randomSeed);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+  std::normal_distribution<double>       normal;
+
+  const auto             initialParameters = matrixOffsetTransform->GetParameters();
+  const MatrixType       initialMatrix = matrixOffsetTransform->GetMatrix();
+  const OutputVectorType initialTranslation = matrixOffsetTransform->GetTranslation();
+
+  for (unsigned int start = 1; start < numberOfMultiStarts; ++start)
+  {
+    /** A rotation about a random axis (in 2D: the normal of the image plane). */
+    const double angle = rotationRange * uniform(randomGenerator);
+    MatrixType   rotation;
+    rotation.SetIdentity();
+    if (Dimension == 2)
+    {
+      rotation(0, 0) = std::cos(angle);
+      rotation(0, 1) = -std::sin(angle);
+      rotation(1, 0) = std::sin(angle);
+      rotation(1, 1) = std::cos(angle);
+    }
+    else if (Dimension == 3)
+    {
+      /** Rodrigues' formula. */
+      double axis[3] = { normal(randomGenerator), normal(randomGenerator), normal(randomGenerator) };
+      const double norm = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+      for (double & a : axis)
+      {
+        a /= (norm > 0.0 ? norm : 1.0);
+      }
+      const double c = std::cos(angle);
+      const double s = std::sin(angle);
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+          rotation(i, j) = (1.0 - c) * axis[i] * axis[j] + (i == j ? c : 0.0);
+        }
+      }
+      rotation(0, 1) -= s * axis[2];
+      rotation(0, 2) += s * axis[1];
+      rotation(1, 0) += s * axis[2];
+      rotation(1, 2) -= s * axis[0];
+      rotation(2, 0) -= s * axis[1];
+      rotation(2, 1) += s * axis[0];
+    }
+
+    OutputVectorType translation = initialTranslation;
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      translation[d] += translationRange * uniform(randomGenerator);
+    }
+
+    /** The rotation is applied after the initial matrix, around the center of rotation. */
+    matrixOffsetTransform->SetMatrix(rotation * initialMatrix);
+    matrixOffsetTransform->SetTranslation(translation);
+    multiStartParameters.push_back(matrixOffsetTransform->GetParameters());
+  }
+
+  /** Restore the initial transform. */
+  matrixOffsetTransform->SetParameters(initialParameters);
+
+  this->GetAsITKBaseType()->SetMultiStartTransformParameters(multiStartParameters);
+  elxout << "Multi-start registration with " << numberOfMultiStarts << " starts." << std::endl;
+
+} // end GenerateMultiStartTransformParameters()
+
+
 } // end namespace elastix
 
 #endif // end #ifndef elxRegistrationBase_hxx
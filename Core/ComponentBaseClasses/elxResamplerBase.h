@@ -67,6 +67,13 @@ namespace elastix
  *    of the written image is desired.\n
  *    example: <tt>(CompressResultImage "true")</tt> \n
  *    The default is "false".
+ * \parameter ResultImageMaximumMemoryMB: the maximum amount of memory, in megabytes, for the
+ *    resampled result image and its casted copy. When the image needs more, it is resampled and
+ *    written in slabs along the slowest image dimension, one at a time. This only works for file
+ *    formats that support streamed writing, like mhd and mha without compression. Other formats
+ *    are written at once.\n
+ *    example: <tt>(ResultImageMaximumMemoryMB 4096)</tt> \n
+ *    The default is 0, which means no limit: the whole image is resampled before writing.
  *
  * \ingroup Resamplers
  * \ingroup ComponentBaseClasses
@@ -186,9 +193,14 @@ public:
   void
   ResampleAndWriteResultImage(const char * filename, const bool showProgress = true);
 
-  /** Function to write the result output image to a file. */
+  /** Function to write the result output image to a file. When numberOfStreamDivisions is larger
+   * than one, the image is requested from its pipeline, and written, in that many pieces, or at
+   * once when the ImageIO cannot stream. The number of pieces that is actually used is logged. */
   void
-  WriteResultImage(OutputImageType * imageimage, const char * filename, const bool showProgress = true);
+  WriteResultImage(OutputImageType *  imageimage,
+                   const char *       filename,
+                   const bool         showProgress = true,
+                   const unsigned int numberOfStreamDivisions = 1);
 
   /** Function to create the result image in the format of an itk::Image. */
   virtual void
@@ -210,6 +222,11 @@ protected:
 private:
   elxDeclarePureVirtualGetSelfMacro(ITKBaseType);
 
+  /** The number of pieces in which the result image is resampled and written, such that
+   * every piece fits in ResultImageMaximumMemoryMB. */
+  unsigned int
+  GetNumberOfStreamDivisions() const;
+
   virtual ParameterMapType
   CreateDerivedTransformParametersMap() const
   {
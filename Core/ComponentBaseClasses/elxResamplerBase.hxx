@@ -26,6 +26,9 @@
 #include "itkAdvancedRayCastInterpolateImageFunction.h"
 #include "itkTimeProbe.h"
 
+#include <algorithm> // For max.
+#include <cmath>     // For ceil.
+
 namespace elastix
 {
 
@@ -301,25 +304,29 @@ ResamplerBase<TElastix>::ResampleAndWriteResultImage(const char * filename, cons
     progressObserver->SetEndString("%");
   }
 
-  /** Do the resampling. */
-  try
+  /** Do the resampling, unless the image is resampled piece by piece while it is written. */
+  const unsigned int numberOfStreamDivisions = this->GetNumberOfStreamDivisions();
+  if (numberOfStreamDivisions == 1)
   {
-    resampleImageFilter.Update();
-  }
-  catch (itk::ExceptionObject & excp)
-  {
-    /** Add information to the exception. */
-    excp.SetLocation("ResamplerBase - WriteResultImage()");
-    std::string err_str = excp.GetDescription();
-    err_str += "\nError occurred while resampling the image.\n";
-    excp.SetDescription(err_str);
-
-    /** Pass the exception to an higher level. */
-    throw;
+    try
+    {
+      resampleImageFilter.Update();
+    }
+    catch (itk::ExceptionObject & excp)
+    {
+      /** Add information to the exception. */
+      excp.SetLocation("ResamplerBase - WriteResultImage()");
+      std::string err_str = excp.GetDescription();
+      err_str += "\nError occurred while resampling the image.\n";
+      excp.SetDescription(err_str);
+
+      /** Pass the exception to an higher level. */
+      throw;
+    }
   }
 
   /** Perform the writing. */
-  this->WriteResultImage(resampleImageFilter.GetOutput(), filename, showProgress);
+  this->WriteResultImage(resampleImageFilter.GetOutput(), filename, showProgress, numberOfStreamDivisions);
 
   /** Disconnect from the resampler. */
   if (showProgress && (progressObserver != nullptr))
@@ -336,7 +343,10 @@ ResamplerBase<TElastix>::ResampleAndWriteResultImage(const char * filename, cons
 
 template <class TElastix>
 void
-ResamplerBase<TElastix>::WriteResultImage(OutputImageType * image, const char * filename, const bool showProgress)
+ResamplerBase<TElastix>::WriteResultImage(OutputImageType *  image,
+                                          const char *       filename,
+                                          const bool         showProgress,
+                                          const unsigned int numberOfStreamDivisions)
 {
   ITKBaseType & resampleImageFilter = this->GetSelf();
 
@@ -377,6 +387,28 @@ ResamplerBase<TElastix>::WriteResultImage(OutputImageType * image, const char *
   infoChanger->SetChangeDirection(retdc & !this->GetElastix()->GetUseDirectionCosines());
   infoChanger->SetInput(image);
 
+  /** When the image is written in pieces, each piece is resampled during the writing. Keep
+   * track of whether the resampler is running, to tell resampling errors from writing errors,
+   * and count the pieces: the writer uses only one when the ImageIO cannot stream.
+   */
+  struct ObserverGuard
+  {
+    ITKBaseType &       m_Filter;
+    const unsigned long m_Tag;
+    ~ObserverGuard() { m_Filter.RemoveObserver(m_Tag); }
+  };
+  bool         isResampling = false;
+  unsigned int numberOfPieces = 0;
+  const auto   onStart = [&isResampling, &numberOfPieces](const itk::EventObject &) {
+    isResampling = true;
+    ++numberOfPieces;
+  };
+  const auto onEnd = [&isResampling](const itk::EventObject &) { isResampling = false; };
+
+  /** The observers are removed when leaving this function, also by an exception. */
+  const ObserverGuard startGuard{ resampleImageFilter, resampleImageFilter.AddObserver(itk::StartEvent(), onStart) };
+  const ObserverGuard endGuard{ resampleImageFilter, resampleImageFilter.AddObserver(itk::EndEvent(), onEnd) };
+
   /** Do the writing. */
   if (showProgress)
   {
@@ -384,22 +416,64 @@ ResamplerBase<TElastix>::WriteResultImage(OutputImageType * image, const char *
   }
   try
   {
-    itk::WriteCastedImage(*(infoChanger->GetOutput()), filename, resultImagePixelType, doCompression);
+    itk::WriteCastedImage(
+      *(infoChanger->GetOutput()), filename, resultImagePixelType, doCompression, numberOfStreamDivisions);
   }
   catch (itk::ExceptionObject & excp)
   {
     /** Add information to the exception. */
-    excp.SetLocation("ResamplerBase - AfterRegistrationBase()");
     std::string err_str = excp.GetDescription();
-    err_str += "\nError occurred while writing resampled image.\n";
+    if (isResampling)
+    {
+      excp.SetLocation("ResamplerBase - WriteResultImage()");
+      err_str += "\nError occurred while resampling the image.\n";
+    }
+    else
+    {
+      excp.SetLocation("ResamplerBase - AfterRegistrationBase()");
+      err_str += "\nError occurred while writing resampled image.\n";
+    }
     excp.SetDescription(err_str);
 
     /** Pass the exception to an higher level. */
     throw;
   }
+
+  if (numberOfStreamDivisions > 1)
+  {
+    elxout << "  Resampled and wrote the result image in " << numberOfPieces
+           << (numberOfPieces == 1 ? " piece." : " pieces.") << std::endl;
+  }
+
 } // end WriteResultImage()
 
 
+/**
+ * ******************* GetNumberOfStreamDivisions ********************
+ */
+
+template <class TElastix>
+unsigned int
+ResamplerBase<TElastix>::GetNumberOfStreamDivisions() const
+{
+  double maximumMemoryMB = 0.0;
+  this->m_Configuration->ReadParameter(maximumMemoryMB, "ResultImageMaximumMemoryMB", 0, false);
+  if (!(maximumMemoryMB > 0.0))
+  {
+    return 1;
+  }
+
+  /** Per voxel, the resampled image holds an output pixel, and the writer at most a double,
+   * when it casts the pixels to the ResultImagePixelType. */
+  const auto   numberOfPixels = static_cast<double>(this->GetAsITKBaseType()->GetSize().CalculateProductOfElements());
+  const double requiredMemoryMB =
+    numberOfPixels * static_cast<double>(sizeof(typename OutputImageType::PixelType) + sizeof(double)) / 1048576.0;
+
+  return static_cast<unsigned int>(std::max(1.0, std::ceil(requiredMemoryMB / maximumMemoryMB)));
+
+} // end GetNumberOfStreamDivisions()
+
+
 /*
  * ******************* CreateItkResultImage ********************
  * \todo: avoid code duplication with WriteResultImage function
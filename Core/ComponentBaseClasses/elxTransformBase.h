@@ -56,6 +56,23 @@ namespace elastix
  *   "Compose" by composition: \f$T(x) = T_1 ( T_0(x) )\f$.\n
  *   example: <tt>(HowToCombineTransforms "Add")</tt>\n
  *   Default: "Add".
+ * \parameter FlattenInitialTransform: Whether a linear initial transform, like the result
+ *   of a translation stage followed by an affine stage, is evaluated as a single matrix
+ *   and offset, instead of stage by stage. Consecutive linear stages at the start of a
+ *   longer chain are collapsed as well. The initial transform is fixed during the
+ *   registration, so the result is the same, up to rounding.\n
+ *   example: <tt>(FlattenInitialTransform "true")</tt>\n
+ *   Default: "false".
+ * \parameter BakeInitialTransform: Whether the initial transform is evaluated from a
+ *   dense grid of its displacements, sampled once over the fixed image domain, and
+ *   linearly interpolated. This makes the cost of the initial transform independent of
+ *   the number of stages, at the cost of memory and a small interpolation error.\n
+ *   example: <tt>(BakeInitialTransform "true")</tt>\n
+ *   Default: "false".
+ * \parameter InitialTransformGridSpacing: The spacing, in physical units, of the grid of
+ *   BakeInitialTransform, for each dimension.\n
+ *   example: <tt>(InitialTransformGridSpacing 2.0 2.0 2.0)</tt>\n
+ *   Default: the voxel spacing of the fixed image.
  *
  * \transformparameter UseDirectionCosines: Controls whether to use or ignore the
  * direction cosines (world matrix, transform matrix) set in the images.
@@ -76,6 +93,21 @@ namespace elastix
  *   "Compose" by composition: \f$T(x) = T_1 ( T_0(x) )\f$.\n
  *   example: <tt>(HowToCombineTransforms "Add")</tt>\n
  *   Default: "Compose".
+ * \transformparameter FlattenInitialTransform: See the elastix parameter. Default: "false".
+ * \transformparameter BakeInitialTransform: See the elastix parameter. The grid covers the
+ *   image domain given by Size, Spacing, Origin and Direction. Default: "false".
+ * \transformparameter InitialTransformGridSpacing: See the elastix parameter. Default: Spacing.
+ * \transformparameter OutputPointsFileFormat: The format in which transformix saves the points that are
+ *   transformed with the -def command-line argument: "text", or "binary". A text file,
+ *   outputpoints.txt, lists for every point its input and output index and point, and its
+ *   displacement. A binary point file, outputpoints.bin, only holds the output points, in world
+ *   coordinates, in the format of itk::TransformixBinaryPointFile. Other values are rejected.\n
+ *   example: <tt>(OutputPointsFileFormat "binary")</tt>\n
+ *   Default: "text".
+ * \transformparameter OutputPointsComponentType: The type of the coordinates in a binary output
+ *   point file: "float" or "double". Other values are rejected.\n
+ *   example: <tt>(OutputPointsComponentType "float")</tt>\n
+ *   Default: "double".
  * \transformparameter Size: The size (number of voxels in each dimension) of the fixed image
  * that was used during registration, and which is used for resampling the deformed moving image.\n
  * example: <tt>(Size 100 90 90)</tt>\n
@@ -122,6 +154,8 @@ namespace elastix
  *    "point", depending if the user supplies voxel indices or real world coordinates.
  *    The second line should be the number of points that should be transformed. The
  *    third and following lines give the indices or points.\n
+ *    For large point sets, the points can also be given as a binary point file, in the
+ *    format of itk::TransformixBinaryPointFile, which is detected by its first bytes.\n
  *    It is also possible to deform all points, thereby generating a deformation field
  *    image. This is done by:\n
  *    example: <tt>-def all</tt> \n
@@ -314,6 +348,18 @@ private:
   void
   ReadInitialTransformFromConfiguration(const Configuration::Pointer);
 
+  /** Flatten the initial transform for its evaluation, when FlattenInitialTransform is true. */
+  void
+  FlattenInitialTransform();
+
+  /** Evaluate the initial transform from a dense displacement grid over the given image
+   * domain, when BakeInitialTransform is true. */
+  void
+  BakeInitialTransform(const typename FixedImageType::PointType &     origin,
+                       const typename FixedImageType::SpacingType &   spacing,
+                       const typename FixedImageType::SizeType &      size,
+                       const typename FixedImageType::DirectionType & direction);
+
   /** Execute stuff before everything else:
    * \li Check the appearance of an initial transform.
    */
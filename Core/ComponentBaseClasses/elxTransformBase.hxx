@@ -26,11 +26,13 @@
 
 #include "itkPointSet.h"
 #include "itkDefaultStaticMeshTraits.h"
+#include "itkTransformixBinaryPointFile.h"
 #include "itkTransformixInputPointFileReader.h"
+#include "itkWorkStealingThreadPool.h"
 #include <itksys/SystemTools.hxx>
 #include "itkVector.h"
-#include "itkTransformToDisplacementFieldFilter.h"
 #include "itkTransformToDeterminantOfSpatialJacobianSource.h"
+#include "itkTransformToDisplacementFieldSource.h"
 #include "itkTransformToSpatialJacobianSource.h"
 #include "itkImageFileWriter.h"
 #include "itkImageGridSampler.h"
@@ -42,6 +44,7 @@
 #include "itkCommonEnums.h"
 
 #include <cassert>
+#include <cmath>
 #include <fstream>
 #include <iomanip> // For setprecision.
 
@@ -186,6 +189,14 @@ TransformBase<TElastix>::BeforeRegistrationBase()
     }
   }
 
+  /** The initial transform is fixed during the registration: evaluate it faster. */
+  this->FlattenInitialTransform();
+  const auto & fixedImage = *(this->m_Elastix->GetFixedImage());
+  this->BakeInitialTransform(fixedImage.GetOrigin(),
+                             fixedImage.GetSpacing(),
+                             fixedImage.GetLargestPossibleRegion().GetSize(),
+                             fixedImage.GetDirection());
+
 } // end BeforeRegistrationBase()
 
 
@@ -229,7 +240,7 @@ TransformBase<TElastix>::SetFinalParameters()
   /** Make a local copy, since some transforms do not do this,
    * like the B-spline transform.
    */
-  this->m_FinalParameters = this->GetElastix()->GetElxOptimizerBase()->GetAsITKBaseType()->GetCurrentPosition();
+  this->m_FinalParameters = this->GetElastix()->GetCurrentTransformParameters();
 
   /** Set the final Parameters for the resampler. */
   this->GetAsITKBaseType()->SetParameters(this->m_FinalParameters);
@@ -384,9 +395,110 @@ TransformBase<TElastix>::ReadFromFile()
    */
   this->SetTransformParametersFileName(this->GetConfiguration()->GetCommandLineArgument("-tp").c_str());
 
+  /** Evaluate the initial transform faster. Only the outermost transform of
+   * transformix bakes its initial transform, over the output image domain.
+   */
+  this->FlattenInitialTransform();
+  if (this->GetElastix()->GetElxTransformBase() == this)
+  {
+    typename FixedImageType::PointType     origin;
+    typename FixedImageType::SpacingType   spacing;
+    typename FixedImageType::SizeType      size;
+    typename FixedImageType::DirectionType direction;
+    direction.SetIdentity();
+    for (unsigned int i = 0; i < FixedImageDimension; ++i)
+    {
+      size[i] = 0;
+      this->m_Configuration->ReadParameter(size[i], "Size", i, false);
+      spacing[i] = 1.0;
+      this->m_Configuration->ReadParameter(spacing[i], "Spacing", i, false);
+      origin[i] = 0.0;
+      this->m_Configuration->ReadParameter(origin[i], "Origin", i, false);
+      for (unsigned int j = 0; j < FixedImageDimension; ++j)
+      {
+        this->m_Configuration->ReadParameter(direction(j, i), "Direction", i * FixedImageDimension + j, false);
+      }
+    }
+    this->BakeInitialTransform(origin, spacing, size, direction);
+  }
+
 } // end ReadFromFile()
 
 
+/**
+ * ******************* FlattenInitialTransform *****************************
+ */
+
+template <class TElastix>
+void
+TransformBase<TElastix>::FlattenInitialTransform()
+{
+  bool flattenInitialTransform = false;
+  this->m_Configuration->ReadParameter(flattenInitialTransform, "FlattenInitialTransform", 0, false);
+
+  if (flattenInitialTransform && this->GetInitialTransform() != nullptr)
+  {
+    this->GetAsITKBaseType()->FlattenInitialTransform();
+  }
+
+} // end FlattenInitialTransform()
+
+
+/**
+ * ******************* BakeInitialTransform *****************************
+ */
+
+template <class TElastix>
+void
+TransformBase<TElastix>::BakeInitialTransform(const typename FixedImageType::PointType &     origin,
+                                              const typename FixedImageType::SpacingType &   spacing,
+                                              const typename FixedImageType::SizeType &      size,
+                                              const typename FixedImageType::DirectionType & direction)
+{
+  bool bakeInitialTransform = false;
+  this->m_Configuration->ReadParameter(bakeInitialTransform, "BakeInitialTransform", 0, false);
+
+  if (!bakeInitialTransform || this->GetInitialTransform() == nullptr)
+  {
+    return;
+  }
+
+  /** The grid covers the image domain, with one node of margin on each side, so that
+   * all points of the domain are interpolated. */
+  using GridOriginType = typename CombinationTransformType::GridOriginType;
+  using GridSpacingType = typename CombinationTransformType::GridSpacingType;
+  using GridSizeType = typename CombinationTransformType::GridSizeType;
+  using GridDirectionType = typename CombinationTransformType::GridDirectionType;
+  GridOriginType    gridOrigin = origin;
+  GridSpacingType   gridSpacing;
+  GridSizeType      gridSize;
+  GridDirectionType gridDirection = direction;
+  for (unsigned int i = 0; i < FixedImageDimension; ++i)
+  {
+    gridSpacing[i] = spacing[i];
+    this->m_Configuration->ReadParameter(gridSpacing[i], "InitialTransformGridSpacing", i, false);
+    if (!(gridSpacing[i] > 0.0))
+    {
+      itkExceptionMacro(<< "ERROR: InitialTransformGridSpacing should be positive, but is " << gridSpacing[i]);
+    }
+    const double extent = (size[i] > 0) ? (size[i] - 1) * spacing[i] : 0.0;
+    gridSize[i] = static_cast<typename GridSizeType::SizeValueType>(std::ceil(extent / gridSpacing[i])) + 3;
+  }
+  for (unsigned int i = 0; i < FixedImageDimension; ++i)
+  {
+    for (unsigned int j = 0; j < FixedImageDimension; ++j)
+    {
+      gridOrigin[i] -= gridDirection[i][j] * gridSpacing[j];
+    }
+  }
+
+  this->GetAsITKBaseType()->BakeInitialTransform(gridOrigin, gridSpacing, gridSize, gridDirection);
+
+  elxout << "The initial transform is evaluated from a grid of " << gridSize << " displacements." << std::endl;
+
+} // end BakeInitialTransform()
+
+
 /**
  * ******************* ReadInitialTransformFromFile *************
  */
@@ -652,7 +764,7 @@ TransformBase<TElastix>::TransformPoints() const
  * these fixed-image coordinates to moving-image
  * coordinates.
  *
- * Reads the inputpoints from a text file, either as index or as point.
+ * Reads the inputpoints from a text file or a binary point file, either as index or as point.
  * Computes the transformed points, converts them back to an index and compute
  * the deformation vector as the difference between the outputpoint and
  * the input point. Save the results.
@@ -675,24 +787,56 @@ TransformBase<TElastix>::TransformPointsSomePoints(const std::string & filename)
   using PointSetType = itk::PointSet<DummyIPPPixelType, FixedImageDimension, MeshTraitsType>;
   using DeformationVectorType = itk::Vector<float, FixedImageDimension>;
 
-  /** Construct an ipp-file reader. */
-  const auto ippReader = itk::TransformixInputPointFileReader<PointSetType>::New();
-  ippReader->SetFileName(filename.c_str());
-
-  /** Read the input points. */
+  /** Read the input points: a binary point file is mapped in memory, a text file is parsed. */
   elxout << "  Reading input point file: " << filename << std::endl;
-  try
+  itk::TransformixBinaryPointFile::Pointer binaryPointFile;
+  typename PointSetType::Pointer           inputPointSet;
+  bool                                     pointsAreIndices = false;
+  itk::SizeValueType                       nrofpoints = 0;
+  if (itk::TransformixBinaryPointFile::IsBinaryPointFile(filename))
   {
-    ippReader->Update();
+    binaryPointFile = itk::TransformixBinaryPointFile::New();
+    try
+    {
+      binaryPointFile->Open(filename);
+    }
+    catch (const itk::ExceptionObject & err)
+    {
+      xl::xout["error"] << "  Error while opening input point file." << std::endl;
+      xl::xout["error"] << err << std::endl;
+      return;
+    }
+    if (binaryPointFile->GetDimension() != FixedImageDimension)
+    {
+      xl::xout["error"] << "  ERROR: The input point file contains points of dimension "
+                        << binaryPointFile->GetDimension() << ", instead of " << FixedImageDimension << '.'
+                        << std::endl;
+      return;
+    }
+    pointsAreIndices = binaryPointFile->GetPointsAreIndices();
+    nrofpoints = binaryPointFile->GetNumberOfPoints();
   }
-  catch (const itk::ExceptionObject & err)
+  else
   {
-    xl::xout["error"] << "  Error while opening input point file." << std::endl;
-    xl::xout["error"] << err << std::endl;
+    /** Construct an ipp-file reader. */
+    const auto ippReader = itk::TransformixInputPointFileReader<PointSetType>::New();
+    ippReader->SetFileName(filename.c_str());
+    try
+    {
+      ippReader->Update();
+    }
+    catch (const itk::ExceptionObject & err)
+    {
+      xl::xout["error"] << "  Error while opening input point file." << std::endl;
+      xl::xout["error"] << err << std::endl;
+    }
+    pointsAreIndices = ippReader->GetPointsAreIndices();
+    nrofpoints = ippReader->GetNumberOfPoints();
+    inputPointSet = ippReader->GetOutput();
   }
 
   /** Some user-feedback. */
-  if (ippReader->GetPointsAreIndices())
+  if (pointsAreIndices)
   {
     elxout << "  Input points are specified as image indices." << std::endl;
   }
@@ -700,19 +844,33 @@ TransformBase<TElastix>::TransformPointsSomePoints(const std::string & filename)
   {
     elxout << "  Input points are specified in world coordinates." << std::endl;
   }
-  const unsigned int nrofpoints = ippReader->GetNumberOfPoints();
   elxout << "  Number of specified input points: " << nrofpoints << std::endl;
 
-  /** Get the set of input points. */
-  typename PointSetType::Pointer inputPointSet = ippReader->GetOutput();
+  /** Read the format of the output point file. */
+  std::string outputPointsFileFormat = "text";
+  this->m_Configuration->ReadParameter(outputPointsFileFormat, "OutputPointsFileFormat", 0, false);
+  if (outputPointsFileFormat != "text" && outputPointsFileFormat != "binary")
+  {
+    itkExceptionMacro(<< "ERROR: OutputPointsFileFormat should be \"text\" or \"binary\", but is \""
+                      << outputPointsFileFormat << "\".");
+  }
+  const bool  textOutput = outputPointsFileFormat == "text";
+  std::string outputPointsComponentType = "double";
+  this->m_Configuration->ReadParameter(outputPointsComponentType, "OutputPointsComponentType", 0, false);
+  if (outputPointsComponentType != "float" && outputPointsComponentType != "double")
+  {
+    itkExceptionMacro(<< "ERROR: OutputPointsComponentType should be \"float\" or \"double\", but is \""
+                      << outputPointsComponentType << "\".");
+  }
 
-  /** Create the storage classes. */
-  std::vector<FixedImageIndexType>   inputindexvec(nrofpoints);
-  std::vector<InputPointType>        inputpointvec(nrofpoints);
+  /** Create the storage classes. Only the text output needs more than the output points. */
+  const itk::SizeValueType           nrofpointsText = textOutput ? nrofpoints : 0;
+  std::vector<FixedImageIndexType>   inputindexvec(nrofpointsText);
+  std::vector<InputPointType>        inputpointvec(nrofpointsText);
   std::vector<OutputPointType>       outputpointvec(nrofpoints);
-  std::vector<FixedImageIndexType>   outputindexfixedvec(nrofpoints);
-  std::vector<MovingImageIndexType>  outputindexmovingvec(nrofpoints);
-  std::vector<DeformationVectorType> deformationvec(nrofpoints);
+  std::vector<FixedImageIndexType>   outputindexfixedvec(nrofpointsText);
+  std::vector<MovingImageIndexType>  outputindexmovingvec(nrofpointsText);
+  std::vector<DeformationVectorType> deformationvec(nrofpointsText);
 
   const auto & resampleImageFilter = *(this->m_Elastix->GetElxResamplerBase()->GetAsITKBaseType());
 
@@ -731,67 +889,102 @@ TransformBase<TElastix>::TransformPointsSomePoints(const std::string & filename)
   const typename MovingImageType::Pointer movingImage = this->GetElastix()->GetMovingImage();
   const bool                              alsoMovingIndices = movingImage.IsNotNull();
 
-  /** Read the input points, as index or as point. */
-  if (ippReader->GetPointsAreIndices())
-  {
-    for (unsigned int j = 0; j < nrofpoints; ++j)
+  const auto roundToFixedIndex = [&dummyImage](const InputPointType & point) {
+    const auto          cindex = dummyImage->template TransformPhysicalPointToContinuousIndex<double>(point);
+    FixedImageIndexType index;
+    for (unsigned int i = 0; i < FixedImageDimension; ++i)
     {
-      /** The read point from the inutPointSet is actually an index
-       * Cast to the proper type.
-       */
-      InputPointType point{};
-      inputPointSet->GetPoint(j, &point);
-      for (unsigned int i = 0; i < FixedImageDimension; ++i)
-      {
-        inputindexvec[j][i] = static_cast<FixedImageIndexValueType>(itk::Math::Round<double>(point[i]));
-      }
-      /** Compute the input point in physical coordinates. */
-      dummyImage->TransformIndexToPhysicalPoint(inputindexvec[j], inputpointvec[j]);
+      index[i] = static_cast<FixedImageIndexValueType>(itk::Math::Round<double>(cindex[i]));
     }
-  }
-  else
-  {
-    for (unsigned int j = 0; j < nrofpoints; ++j)
+    return index;
+  };
+
+  /** Apply the transform. The points are divided in chunks over the threads, and
+   * every chunk is passed to the transform at once. */
+  elxout << "  The input points are transformed." << std::endl;
+  const ITKBaseType & transform = *(this->GetAsITKBaseType());
+
+  const auto transformChunk = [&](const itk::SizeValueType begin, const itk::SizeValueType end, itk::ThreadIdType) {
+    /** Read the input points of this chunk, as index or as point. */
+    std::vector<InputPointType> chunkInputPoints(end - begin);
+    for (itk::SizeValueType j = begin; j < end; ++j)
     {
-      /** Compute index of nearest voxel in fixed image. */
       InputPointType point{};
-      inputPointSet->GetPoint(j, &point);
-      inputpointvec[j] = point;
-      const auto fixedcindex = dummyImage->template TransformPhysicalPointToContinuousIndex<double>(point);
-      for (unsigned int i = 0; i < FixedImageDimension; ++i)
+      if (binaryPointFile)
+      {
+        binaryPointFile->GetPoint(j, point);
+      }
+      else
       {
-        inputindexvec[j][i] = static_cast<FixedImageIndexValueType>(itk::Math::Round<double>(fixedcindex[i]));
+        inputPointSet->GetPoint(j, &point);
       }
+
+      if (pointsAreIndices)
+      {
+        /** The read point is actually an index. Compute the input point in physical coordinates. */
+        FixedImageIndexType index;
+        for (unsigned int i = 0; i < FixedImageDimension; ++i)
+        {
+          index[i] = static_cast<FixedImageIndexValueType>(itk::Math::Round<double>(point[i]));
+        }
+        dummyImage->TransformIndexToPhysicalPoint(index, point);
+      }
+      chunkInputPoints[j - begin] = point;
     }
-  }
 
-  /** Apply the transform. */
-  elxout << "  The input points are transformed." << std::endl;
-  for (unsigned int j = 0; j < nrofpoints; ++j)
-  {
-    /** Call TransformPoint. */
-    outputpointvec[j] = this->GetAsITKBaseType()->TransformPoint(inputpointvec[j]);
+    transform.TransformPoints(chunkInputPoints.data(), &outputpointvec[begin], end - begin);
 
-    /** Transform back to index in fixed image domain. */
-    const auto fixedcindex = dummyImage->template TransformPhysicalPointToContinuousIndex<double>(outputpointvec[j]);
-    for (unsigned int i = 0; i < FixedImageDimension; ++i)
+    if (!textOutput)
     {
-      outputindexfixedvec[j][i] = static_cast<FixedImageIndexValueType>(itk::Math::Round<double>(fixedcindex[i]));
+      return;
     }
 
-    if (alsoMovingIndices)
+    for (itk::SizeValueType j = begin; j < end; ++j)
     {
-      /** Transform back to index in moving image domain. */
-      const auto movingcindex =
-        movingImage->template TransformPhysicalPointToContinuousIndex<double>(outputpointvec[j]);
-      for (unsigned int i = 0; i < MovingImageDimension; ++i)
+      /** Compute index of nearest voxel in fixed image, before and after the transform. */
+      inputpointvec[j] = chunkInputPoints[j - begin];
+      inputindexvec[j] = roundToFixedIndex(inputpointvec[j]);
+      outputindexfixedvec[j] = roundToFixedIndex(outputpointvec[j]);
+
+      if (alsoMovingIndices)
       {
-        outputindexmovingvec[j][i] = static_cast<MovingImageIndexValueType>(itk::Math::Round<double>(movingcindex[i]));
+        /** Transform back to index in moving image domain. */
+        const auto movingcindex =
+          movingImage->template TransformPhysicalPointToContinuousIndex<double>(outputpointvec[j]);
+        for (unsigned int i = 0; i < MovingImageDimension; ++i)
+        {
+          outputindexmovingvec[j][i] =
+            static_cast<MovingImageIndexValueType>(itk::Math::Round<double>(movingcindex[i]));
+        }
       }
+
+      /** Compute displacement. */
+      deformationvec[j].CastFrom(outputpointvec[j] - inputpointvec[j]);
     }
+  };
+
+  auto & threadPool = *itk::WorkStealingThreadPool::GetInstance();
+  threadPool.ParallelFor(0, nrofpoints, 1024, threadPool.GetNumberOfThreads(), transformChunk);
 
-    /** Compute displacement. */
-    deformationvec[j].CastFrom(outputpointvec[j] - inputpointvec[j]);
+  if (!textOutput)
+  {
+    /** Save the output points, in world coordinates, as a binary point file. */
+    const std::string outputPointsFileName = this->m_Configuration->GetCommandLineArgument("-out") + "outputpoints.bin";
+    elxout << "  The transformed points are saved in: " << outputPointsFileName << std::endl;
+    try
+    {
+      itk::TransformixBinaryPointFile::Write(outputPointsFileName,
+                                             outputpointvec.data(),
+                                             nrofpoints,
+                                             false,
+                                             outputPointsComponentType == "float" ? sizeof(float) : sizeof(double));
+    }
+    catch (const itk::ExceptionObject & err)
+    {
+      xl::xout["error"] << "  Error while saving points." << std::endl;
+      xl::xout["error"] << err << std::endl;
+    }
+    return;
   }
 
   /** Create filename and file stream. */
@@ -808,7 +1001,7 @@ TransformBase<TElastix>::TransformPointsSomePoints(const std::string & filename)
   };
 
   /** Print the results. */
-  for (unsigned int j = 0; j < nrofpoints; ++j)
+  for (itk::SizeValueType j = 0; j < nrofpoints; ++j)
   {
     /** The input index. */
     outputPointsFile << "Point\t" << j << "\t; InputIndex = [ ";
@@ -955,12 +1148,13 @@ TransformBase<TElastix>::GenerateDeformationFieldImage() const -> typename Defor
 {
   const auto & resampleImageFilter = *(this->m_Elastix->GetElxResamplerBase()->GetAsITKBaseType());
 
-  /** Create an setup deformation field generator. */
-  const auto defGenerator = itk::TransformToDisplacementFieldFilter<DeformationFieldImageType, CoordRepType>::New();
-  defGenerator->SetSize(resampleImageFilter.GetSize());
+  /** Create an setup deformation field generator. For B-spline transforms, it
+   * evaluates the field per row of voxels, instead of per voxel. */
+  const auto defGenerator = itk::TransformToDisplacementFieldSource<DeformationFieldImageType, CoordRepType>::New();
+  defGenerator->SetOutputSize(resampleImageFilter.GetSize());
   defGenerator->SetOutputSpacing(resampleImageFilter.GetOutputSpacing());
   defGenerator->SetOutputOrigin(resampleImageFilter.GetOutputOrigin());
-  defGenerator->SetOutputStartIndex(resampleImageFilter.GetOutputStartIndex());
+  defGenerator->SetOutputIndex(resampleImageFilter.GetOutputStartIndex());
   defGenerator->SetOutputDirection(resampleImageFilter.GetOutputDirection());
   defGenerator->SetTransform(this->GetAsITKBaseType());
 
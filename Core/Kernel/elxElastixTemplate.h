@@ -247,6 +247,14 @@ public:
   /** Get the name of the current transform parameter file. */
   itkGetStringMacro(CurrentTransformParameterFileName);
 
+  /** Get the current transform parameters. These are the current position of the
+   * optimizer, except when the starts of a multi-start registration are optimized in the
+   * current resolution: after the runs from the starts, these are the parameters of the
+   * best start, as the optimizer then still has the position of the last run.
+   */
+  const itk::Optimizer::ParametersType &
+  GetCurrentTransformParameters();
+
   /** Get the original direction cosines of the fixed image. Returns
    * false if it failed to determine the original fixed image direction. In
    * that case the direction var is left unchanged. If no fixed image is
@@ -573,6 +573,14 @@ template <class TFixedImage, class TMovingImage>
 void
 ElastixTemplate<TFixedImage, TMovingImage>::AfterEachResolution()
 {
+  /** The run from a start of a multi-start registration does not end the resolution. The
+   * optimizer only restarts its per-resolution state, for the run from the next start. */
+  if (this->GetElxRegistrationBase()->GetAsITKBaseType()->GetIsOptimizingMultiStarts())
+  {
+    this->GetElxOptimizerBase()->RestartResolution();
+    return;
+  }
+
   /** Get current resolution level. */
   unsigned long level = this->GetElxRegistrationBase()->GetAsITKBaseType()->GetCurrentLevel();
 
@@ -623,8 +631,12 @@ template <class TFixedImage, class TMovingImage>
 void
 ElastixTemplate<TFixedImage, TMovingImage>::AfterEachIteration()
 {
+  /** The iterations from the starts of a multi-start registration are not logged. */
+  const bool isOptimizingMultiStarts =
+    this->GetElxRegistrationBase()->GetAsITKBaseType()->GetIsOptimizingMultiStarts();
+
   /** Write the headers of the columns that are printed each iteration. */
-  if (this->m_IterationCounter == 0)
+  if (this->m_IterationCounter == 0 && !isOptimizingMultiStarts)
   {
     this->GetIterationInfo().WriteHeaders();
   }
@@ -634,6 +646,15 @@ ElastixTemplate<TFixedImage, TMovingImage>::AfterEachIteration()
   CallInEachComponent(&BaseComponentType::AfterEachIterationBase);
   CallInEachComponent(&BaseComponentType::AfterEachIteration);
 
+  /** Discard the iteration info of the run from a start, and restart the timer. */
+  if (isOptimizingMultiStarts)
+  {
+    this->GetIterationInfo().DiscardBufferedData();
+    this->m_IterationTimer.Reset();
+    this->m_IterationTimer.Start();
+    return;
+  }
+
   /** Write the iteration number to the table. */
   this->GetIterationInfoAt("1:ItNr") << m_IterationCounter;
 
@@ -804,8 +825,7 @@ ElastixTemplate<TFixedImage, TMovingImage>::CreateTransformParameterFile(const s
    * Actually we could loop over all resample interpolators, resamplers,
    * and transforms etc. But for now, there seems to be no use yet for that.
    */
-  this->GetElxTransformBase()->WriteToFile(transformationParameterInfo,
-                                           this->GetElxOptimizerBase()->GetAsITKBaseType()->GetCurrentPosition());
+  this->GetElxTransformBase()->WriteToFile(transformationParameterInfo, this->GetCurrentTransformParameters());
   this->GetElxResampleInterpolatorBase()->WriteToFile(transformationParameterInfo);
   this->GetElxResamplerBase()->WriteToFile(transformationParameterInfo);
 
@@ -826,8 +846,8 @@ template <class TFixedImage, class TMovingImage>
 void
 ElastixTemplate<TFixedImage, TMovingImage>::CreateTransformParametersMap()
 {
-  this->GetElxTransformBase()->CreateTransformParametersMap(
-    this->GetElxOptimizerBase()->GetAsITKBaseType()->GetCurrentPosition(), this->m_TransformParametersMap);
+  this->GetElxTransformBase()->CreateTransformParametersMap(this->GetCurrentTransformParameters(),
+                                                            this->m_TransformParametersMap);
   this->GetElxResampleInterpolatorBase()->CreateTransformParametersMap(this->m_TransformParametersMap);
   this->GetElxResamplerBase()->CreateTransformParametersMap(this->m_TransformParametersMap);
 
@@ -1054,6 +1074,25 @@ ElastixTemplate<TFixedImage, TMovingImage>::OpenIterationInfoFile()
 } // end OpenIterationInfoFile()
 
 
+/**
+ * ************** GetCurrentTransformParameters *********************
+ */
+
+template <class TFixedImage, class TMovingImage>
+const itk::Optimizer::ParametersType &
+ElastixTemplate<TFixedImage, TMovingImage>::GetCurrentTransformParameters()
+{
+  /** The values of the starts are only known after their runs in the current resolution. */
+  const auto & registration = *(this->GetElxRegistrationBase()->GetAsITKBaseType());
+  if (!registration.GetMultiStartValues().empty())
+  {
+    return registration.GetLastTransformParameters();
+  }
+  return this->GetElxOptimizerBase()->GetAsITKBaseType()->GetCurrentPosition();
+
+} // end GetCurrentTransformParameters()
+
+
 /**
  * ************** GetOriginalFixedImageDirection *********************
  * Determine the original fixed image direction (it might have been
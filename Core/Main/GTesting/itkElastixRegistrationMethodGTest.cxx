@@ -42,9 +42,11 @@
 
 #include <algorithm> // For transform
 #include <cmath>     // For M_PI
+#include <fstream>
 #include <map>
 #include <string>
 #include <utility> // For pair
+#include <vector>
 
 
 // Using-declarations:
@@ -52,6 +54,7 @@ using elx::CoreMainGTestUtilities::CheckNew;
 using elx::CoreMainGTestUtilities::ConvertToOffset;
 using elx::CoreMainGTestUtilities::CreateImage;
 using elx::CoreMainGTestUtilities::CreateImageFilledWithSequenceOfNaturalNumbers;
+using elx::CoreMainGTestUtilities::CreateParameterMap;
 using elx::CoreMainGTestUtilities::CreateParameterObject;
 using elx::CoreMainGTestUtilities::Deref;
 using elx::CoreMainGTestUtilities::DerefSmartPointer;
@@ -813,3 +816,113 @@ GTEST_TEST(itkElastixRegistrationMethod, EulerDiscRotation2D)
     EXPECT_EQ(std::round(transformParameters[2]), 0.0);                        // translation Y
   }
 }
+
+
+// Tests "UseStochasticConvergenceDetection" when it is only enabled in the last of the (default) resolutions.
+GTEST_TEST(itkElastixRegistrationMethod, StochasticConvergenceDetectionInLastResolution)
+{
+  constexpr auto ImageDimension = 2U;
+  using PixelType = float;
+  using ImageType = itk::Image<PixelType, ImageDimension>;
+  using SizeType = itk::Size<ImageDimension>;
+  using IndexType = itk::Index<ImageDimension>;
+  using OffsetType = itk::Offset<ImageDimension>;
+
+  const OffsetType translationOffset{ { 1, -2 } };
+  const auto       regionSize = SizeType::Filled(2);
+  const SizeType   imageSize{ { 5, 6 } };
+  const IndexType  fixedImageRegionIndex{ { 1, 3 } };
+
+  const auto fixedImage = CreateImage<PixelType>(imageSize);
+  FillImageRegion(*fixedImage, fixedImageRegionIndex, regionSize);
+  const auto movingImage = CreateImage<PixelType>(imageSize);
+  FillImageRegion(*movingImage, fixedImageRegionIndex + translationOffset, regionSize);
+
+  auto parameterMap = CreateParameterMap({ // Parameters in alphabetic order:
+                                           { "ImageSampler", "Full" },
+                                           { "MaximumNumberOfIterations", "2" },
+                                           { "Metric", "AdvancedNormalizedCorrelation" },
+                                           { "Optimizer", "AdaptiveStochasticGradientDescent" },
+                                           { "Transform", "TranslationTransform" } });
+  parameterMap["UseStochasticConvergenceDetection"] = { "false", "false", "true" };
+
+  const auto parameterObject = elx::ParameterObject::New();
+  parameterObject->SetParameterMap(parameterMap);
+
+  DefaultConstructibleElastixRegistrationMethod<ImageType, ImageType> registration;
+  registration.SetFixedImage(fixedImage);
+  registration.SetMovingImage(movingImage);
+  registration.SetParameterObject(parameterObject);
+  EXPECT_NO_THROW(registration.Update());
+
+  const auto transformParameters = GetTransformParametersFromFilter(registration);
+  EXPECT_EQ(ConvertToOffset<ImageDimension>(transformParameters), translationOffset);
+}
+
+
+// Tests that the runs from the starts of a multi-start registration are not logged as iterations, and that the
+// components only report the resolution as a whole, which is not optimized again after these runs.
+GTEST_TEST(itkElastixRegistrationMethod, MultiStartRunsAreNotLoggedAsIterations)
+{
+  constexpr auto ImageDimension = 2U;
+  using PixelType = float;
+  using ImageType = itk::Image<PixelType, ImageDimension>;
+  using SizeType = itk::Size<ImageDimension>;
+  using IndexType = itk::Index<ImageDimension>;
+  using OffsetType = itk::Offset<ImageDimension>;
+
+  const OffsetType translationOffset{ { 1, -2 } };
+  const auto       regionSize = SizeType::Filled(4);
+  const SizeType   imageSize{ { 12, 14 } };
+  const IndexType  fixedImageRegionIndex{ { 4, 5 } };
+
+  const auto fixedImage = CreateImage<PixelType>(imageSize);
+  FillImageRegion(*fixedImage, fixedImageRegionIndex, regionSize);
+  const auto movingImage = CreateImage<PixelType>(imageSize);
+  FillImageRegion(*movingImage, fixedImageRegionIndex + translationOffset, regionSize);
+
+  const std::string outputDirectoryPath = GetCurrentBinaryDirectoryPath() + '/' + GetNameOfTest(*this) + '/';
+  itk::FileTools::CreateDirectory(outputDirectoryPath);
+
+  constexpr unsigned int numberOfMultiStarts = 3;
+  constexpr unsigned int maximumNumberOfIterations = 4;
+
+  DefaultConstructibleElastixRegistrationMethod<ImageType, ImageType> registration;
+  registration.SetFixedImage(fixedImage);
+  registration.SetMovingImage(movingImage);
+  registration.SetOutputDirectory(outputDirectoryPath);
+  registration.LogToFileOn();
+  registration.SetParameterObject(
+    CreateParameterObject({ // Parameters in alphabetic order:
+                            { "AutomaticTransformInitialization", "false" },
+                            { "ImageSampler", "Full" },
+                            { "MaximumNumberOfIterations", std::to_string(maximumNumberOfIterations) },
+                            { "Metric", "AdvancedNormalizedCorrelation" },
+                            { "MultiStartRotationRange", "0.2" },
+                            { "NumberOfMultiStarts", std::to_string(numberOfMultiStarts) },
+                            { "NumberOfResolutions", "1" },
+                            { "Optimizer", "AdaptiveStochasticGradientDescent" },
+                            { "Transform", "EulerTransform" } }));
+  registration.Update();
+
+  // The only resolution is entirely optimized by the runs from the starts, so its iteration info is empty.
+  std::ifstream            iterationInfoFile(outputDirectoryPath + "IterationInfo.0.R0.txt");
+  std::vector<std::string> iterationInfoLines;
+  for (std::string line; std::getline(iterationInfoFile, line);)
+  {
+    iterationInfoLines.push_back(line);
+  }
+  EXPECT_TRUE(iterationInfoLines.empty());
+
+  // The optimizer reports its stopping condition once, at the end of the resolution.
+  std::ifstream logFile(outputDirectoryPath + "elastix.log");
+  unsigned int  numberOfStoppingConditions = 0;
+  for (std::string line; std::getline(logFile, line);)
+  {
+    if (line.find("Stopping condition: ") != std::string::npos)
+    {
+      ++numberOfStoppingConditions;
+    }
+  }
+  EXPECT_EQ(numberOfStoppingConditions, 1U);
+}
@@ -52,9 +52,12 @@
 
 #include <algorithm> // For equal and transform.
 #include <cmath>
+#include <fstream>
 #include <map>
 #include <random>
 #include <string>
+#include <utility> // For pair.
+#include <vector>
 
 
 // Type aliases:
@@ -730,6 +733,136 @@ GTEST_TEST(itkTransformixFilter, ITKBSplineTransform3D)
 }
 
 
+// Tests that the fused resampling of MyStandardResampler, which maps each output row at once by
+// TransformPointsAlongLine, yields the same output as the itk::ResampleImageFilter path, which it uses with
+// (UseFusedResampling "false"). It resamples an ITK B-spline transform onto a grid with a rotated direction, and an
+// elastix AdvancedBSpline transform onto a grid with an identity direction, so that the rows of the latter run along
+// an axis of the B-spline grid, and are mapped by ComputeDisplacementsAlongLine. Each transform is resampled on its
+// own and combined with an affine transform, using both a linear and a B-spline interpolator.
+GTEST_TEST(itkTransformixFilter, FusedResamplingEqualsResampleImageFilterPath)
+{
+  using PixelType = float;
+  constexpr unsigned int dimension = 2;
+  using ImageType = itk::Image<PixelType, dimension>;
+
+  const std::string outputDirectoryPath = GetCurrentBinaryDirectoryPath() + '/' + GetNameOfTest(*this);
+  itk::FileTools::CreateDirectory(outputDirectoryPath);
+
+  const std::string affineTransformParametersFileName = outputDirectoryPath + "/AffineTransformParameters.txt";
+  {
+    std::ofstream affineTransformParametersFile(affineTransformParametersFileName);
+    affineTransformParametersFile << "(Transform \"AffineTransform\")\n"
+                                  << "(NumberOfParameters 6)\n"
+                                  << "(TransformParameters 1.05 0.1 -0.08 0.95 0.7 -0.4)\n"
+                                  << "(CenterOfRotationPoint 8 9)\n";
+  }
+
+  const auto imageSize = itk::MakeSize(16, 19);
+  const auto inputImage = CreateImageFilledWithSequenceOfNaturalNumbers<PixelType>(imageSize);
+
+  elx::DefaultConstruct<itk::BSplineTransform<double, dimension>> bsplineTransform;
+  bsplineTransform.SetTransformDomainPhysicalDimensions(ConvertToItkVector(imageSize));
+  bsplineTransform.SetParameters(GeneratePseudoRandomParameters(bsplineTransform.GetParameters().size(), -1.0));
+
+  // The direction of the output grid of the ITK B-spline transform is rotated by 0.3 radians.
+  const itk::NumberToString<double> numberToString{};
+  const double                      cosine = std::cos(0.3);
+  const double                      sine = std::sin(0.3);
+  const ParameterValuesType         rotatedDirection = {
+    numberToString(cosine), numberToString(-sine), numberToString(sine), numberToString(cosine)
+  };
+
+  // The coefficients of a cubic elastix AdvancedBSpline transform, whose grid covers the output grid.
+  const auto                gridSize = itk::MakeSize(8, 9);
+  const unsigned            numberOfAdvancedBSplineParameters = dimension * gridSize[0] * gridSize[1];
+  const ParameterValuesType advancedBSplineTransformParameters =
+    ConvertToParameterValues(GeneratePseudoRandomParameters(numberOfAdvancedBSplineParameters, -1.0));
+
+  // Resamples the input image by either the ITK B-spline transform or the elastix AdvancedBSpline transform.
+  const auto resample = [&](const bool          useAdvancedBSplineTransform,
+                            const std::string & initialTransformParametersFileName,
+                            const std::string & howToCombineTransforms,
+                            const std::string & resampleInterpolator,
+                            const std::string & useFusedResampling) {
+    ParameterMapType parameterMap{ // Parameters in alphabetic order:
+                                   { "Direction", rotatedDirection },
+                                   { "FinalBSplineInterpolationOrder", { "3" } },
+                                   { "HowToCombineTransforms", { howToCombineTransforms } },
+                                   { "Index", ParameterValuesType(dimension, "0") },
+                                   { "InitialTransformParametersFileName", { initialTransformParametersFileName } },
+                                   { "Origin", { "2", "-1" } },
+                                   { "ResampleInterpolator", { resampleInterpolator } },
+                                   { "Size", ConvertToParameterValues(imageSize) },
+                                   { "Spacing", { "0.9", "1.1" } },
+                                   { "UseFusedResampling", { useFusedResampling } } };
+
+    DefaultConstructibleTransformixFilter<ImageType> filter;
+    filter.SetMovingImage(inputImage);
+    if (useAdvancedBSplineTransform)
+    {
+      parameterMap["BSplineTransformSplineOrder"] = { "3" };
+      parameterMap["Direction"] = CreateDefaultDirectionParameterValues<dimension>();
+      parameterMap["GridDirection"] = CreateDefaultDirectionParameterValues<dimension>();
+      parameterMap["GridIndex"] = ParameterValuesType(dimension, "0");
+      parameterMap["GridOrigin"] = { "-4", "-6" };
+      parameterMap["GridSize"] = ConvertToParameterValues(gridSize);
+      parameterMap["GridSpacing"] = ParameterValuesType(dimension, "4");
+      parameterMap["NumberOfParameters"] = { std::to_string(numberOfAdvancedBSplineParameters) };
+      parameterMap["Transform"] = { "BSplineTransform" };
+      parameterMap["TransformParameters"] = advancedBSplineTransformParameters;
+    }
+    else
+    {
+      filter.SetTransform(&bsplineTransform);
+    }
+    filter.SetTransformParameterObject(CreateParameterObject(parameterMap));
+    filter.Update();
+    return itk::SmartPointer<ImageType>(filter.GetOutput());
+  };
+
+  const std::vector<std::pair<std::string, std::string>> initialTransforms = {
+    { "NoInitialTransform", "Compose" },
+    { affineTransformParametersFileName, "Compose" },
+    { affineTransformParametersFileName, "Add" }
+  };
+
+  for (const bool useAdvancedBSplineTransform : { false, true })
+  {
+    for (const std::string resampleInterpolator : { "FinalLinearInterpolator", "FinalBSplineInterpolator" })
+    {
+      for (const auto & initialTransform : initialTransforms)
+      {
+        SCOPED_TRACE((useAdvancedBSplineTransform ? "AdvancedBSpline, " : "ITK BSpline, ") + resampleInterpolator +
+                     ", " + initialTransform.first + ", " + initialTransform.second);
+
+        const auto fusedOutputImage = resample(useAdvancedBSplineTransform,
+                                               initialTransform.first,
+                                               initialTransform.second,
+                                               resampleInterpolator,
+                                               "true");
+        const auto expectedOutputImage = resample(useAdvancedBSplineTransform,
+                                                  initialTransform.first,
+                                                  initialTransform.second,
+                                                  resampleInterpolator,
+                                                  "false");
+
+        // Check that the output is not simply a black image, otherwise the test itself would be less interesting.
+        EXPECT_TRUE(ImageBuffer_has_nonzero_pixel_values(DerefSmartPointer(expectedOutputImage)));
+
+        const itk::ImageBufferRange<const ImageType> fusedImageBufferRange(DerefSmartPointer(fusedOutputImage));
+        const itk::ImageBufferRange<const ImageType> expectedImageBufferRange(DerefSmartPointer(expectedOutputImage));
+        ASSERT_EQ(fusedImageBufferRange.size(), expectedImageBufferRange.size());
+
+        for (std::size_t i{}; i < fusedImageBufferRange.size(); ++i)
+        {
+          EXPECT_NEAR(fusedImageBufferRange[i], expectedImageBufferRange[i], 1e-3) << " i = " << i;
+        }
+      }
+    }
+  }
+}
+
+
 GTEST_TEST(itkTransformixFilter, CombineTranslationAndDefaultTransform)
 {
   const auto     imageSize = itk::MakeSize(5, 6);
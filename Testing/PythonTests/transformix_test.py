@@ -22,6 +22,7 @@ import os
 import filecmp
 import pathlib
 import random
+import re
 import subprocess
 import sys
 import unittest
@@ -537,6 +538,72 @@ class TransformixTestCase(unittest.TestCase):
         np.testing.assert_allclose(actual_pixel_data, expected_pixel_data, rtol=0)
 
 
+    def test_streamed_writing_of_result_image(self) -> None:
+        """Tests that resampling and writing the result image in pieces, when it needs more than
+        ResultImageMaximumMemoryMB, yields the same image as writing it in one piece"""
+
+        output_directory_path = self.create_test_function_output_directory()
+
+        number_of_columns = 40
+        number_of_rows = 30
+        input_image = self.create_image_with_sequence_of_natural_numbers(
+            number_of_columns, number_of_rows, sitk.sitkFloat32
+        )
+        sitk.WriteImage(input_image, str(output_directory_path / "input.mhd"))
+        parameter_file_path = output_directory_path / "TransformParameters.txt"
+
+        # "float" is the pixel type of the resampled image, "short" requires a cast.
+        for result_image_pixel_type in ["float", "short"]:
+            result_images = []
+            for maximum_memory_mb in [0, 0.001]:
+                parameter_file_path.write_text(
+                    "(Direction 1 0 0 1)\n"
+                    "(FixedImageDimension 2)\n"
+                    "(Index 0 0)\n"
+                    "(MovingImageDimension 2)\n"
+                    "(NumberOfParameters 2)\n"
+                    "(Origin 0 0)\n"
+                    '(ResultImageFormat "mhd")\n'
+                    f"(ResultImageMaximumMemoryMB {maximum_memory_mb})\n"
+                    f'(ResultImagePixelType "{result_image_pixel_type}")\n'
+                    f"(Size {number_of_columns} {number_of_rows})\n"
+                    "(Spacing 1 1)\n"
+                    '(Transform "TranslationTransform")\n'
+                    "(TransformParameters 0.4 -1.3)\n"
+                )
+                subprocess.run(
+                    [
+                        str(self.transformix_exe_file_path),
+                        "-in",
+                        str(output_directory_path / "input.mhd"),
+                        "-tp",
+                        str(parameter_file_path),
+                        "-out",
+                        str(output_directory_path),
+                    ],
+                    capture_output=True,
+                    check=True,
+                )
+
+                # Check that the image is really written in pieces, under the memory bound.
+                log = (output_directory_path / "transformix.log").read_text()
+                match = re.search(
+                    r"Resampled and wrote the result image in (\d+) piece", log
+                )
+                self.assertEqual(match is not None, maximum_memory_mb > 0)
+                if match is not None:
+                    self.assertGreater(int(match.group(1)), 1)
+                result_images.append(
+                    sitk.ReadImage(str(output_directory_path / "result.mhd"))
+                )
+
+            self.assert_equal_image_info(result_images[1], result_images[0])
+            np.testing.assert_array_equal(
+                sitk.GetArrayFromImage(result_images[1]),
+                sitk.GetArrayFromImage(result_images[0]),
+            )
+
+
 if __name__ == "__main__":
     # Specify argv to avoid sys.argv to be used directly by unittest.main
     # Note: Use '--verbose' option just as long as the output fits the screen!
@@ -0,0 +1,110 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkAdaptiveSampleSizeSchedule.h"
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+//-------------------------------------------------------------------------------------
+// This test simulates a stochastic optimizer, whose exact gradient decreases over the
+// iterations, and whose gradients have a noise with a variance that is inversely
+// proportional to the number of samples. It checks that the AdaptiveSampleSizeSchedule
+// starts with few samples, increases the number of samples towards the end, stays
+// within its range, and respects its budget.
+
+namespace
+{
+using ScheduleType = itk::AdaptiveSampleSizeSchedule;
+
+/** Run the simulated optimizer, and return the number of iterations. */
+unsigned int
+Simulate(ScheduleType & schedule, std::vector<itk::SizeValueType> & numberOfSamples)
+{
+  constexpr unsigned int           numberOfParameters = 50;
+  constexpr double                 sampleVariance = 4.0;
+  std::mt19937                     randomGenerator(1234);
+  std::normal_distribution<double> normal;
+
+  schedule.Initialize(1000);
+  numberOfSamples.clear();
+  ScheduleType::DerivativeType gradient(numberOfParameters);
+  for (unsigned int iteration = 0; iteration < 300; ++iteration)
+  {
+    numberOfSamples.push_back(schedule.GetNumberOfSamples());
+    const double exactGradient = 5.0 * std::pow(0.98, iteration);
+    const double noise = std::sqrt(sampleVariance / schedule.GetNumberOfSamples());
+    for (unsigned int i = 0; i < numberOfParameters; ++i)
+    {
+      gradient[i] = exactGradient + noise * normal(randomGenerator);
+    }
+    if (!schedule.Update(gradient))
+    {
+      return iteration + 1;
+    }
+  }
+  return 300;
+}
+
+} // end namespace
+
+
+int
+main()
+{
+  auto schedule = ScheduleType::New();
+  schedule->SetMinimumNumberOfSamples(1000);
+  schedule->SetMaximumNumberOfSamples(50000);
+
+  /** Without a budget: few samples at the start, many at the end. */
+  std::vector<itk::SizeValueType> numberOfSamples;
+  const unsigned int              numberOfIterations = Simulate(*schedule, numberOfSamples);
+  if (numberOfIterations != 300 || numberOfSamples[50] != 1000 || numberOfSamples.back() < 10000)
+  {
+    std::cerr << "ERROR: the number of samples does not follow the noise in the gradient. Start: "
+              << numberOfSamples[50] << ", end: " << numberOfSamples.back() << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (std::size_t i = 1; i < numberOfSamples.size(); ++i)
+  {
+    if (numberOfSamples[i] < 1000 || numberOfSamples[i] > 50000 ||
+        numberOfSamples[i] > 2 * numberOfSamples[i - 1] || 2 * numberOfSamples[i] < numberOfSamples[i - 1])
+    {
+      std::cerr << "ERROR: the number of samples of iteration " << i << " is out of range." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  const itk::SizeValueType totalNumberOfSamples = schedule->GetTotalNumberOfSamples();
+  std::cout << "Without budget: " << totalNumberOfSamples << " samples in total, instead of "
+            << 300 * numberOfSamples.back() << " with the final number of samples in every iteration." << std::endl;
+
+  /** With a budget, the optimization stops early, and the budget is not exceeded. */
+  schedule->SetMaximumTotalNumberOfSamples(totalNumberOfSamples / 2);
+  const unsigned int numberOfIterationsWithBudget = Simulate(*schedule, numberOfSamples);
+  if (numberOfIterationsWithBudget >= 300 || schedule->GetTotalNumberOfSamples() > totalNumberOfSamples / 2)
+  {
+    std::cerr << "ERROR: the budget is not respected." << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "With a budget of " << totalNumberOfSamples / 2 << " samples: " << numberOfIterationsWithBudget
+            << " iterations." << std::endl;
+
+  return EXIT_SUCCESS;
+
+} // end main
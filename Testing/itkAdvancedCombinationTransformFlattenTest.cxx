@@ -0,0 +1,211 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkAdvancedCombinationTransform.h"
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkAdvancedMatrixOffsetTransformBase.h"
+#include "itkAdvancedTranslationTransform.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+//-------------------------------------------------------------------------------------
+// This test checks that flattening a chain of linear combination transforms, and baking
+// a nonlinear chain into a displacement grid, keep the combination transform the same,
+// up to rounding and interpolation errors, and that they leave the stages of the chain,
+// which may be shared by other chains, untouched. The reference chains are built from
+// separate stage objects.
+
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using ScalarType = double;
+using CombinationTransformType = itk::AdvancedCombinationTransform<ScalarType, Dimension>;
+using TranslationTransformType = itk::AdvancedTranslationTransform<ScalarType, Dimension>;
+using MatrixOffsetTransformType = itk::AdvancedMatrixOffsetTransformBase<ScalarType, Dimension, Dimension>;
+using BSplineTransformType = itk::AdvancedBSplineDeformableTransform<ScalarType, Dimension, 3>;
+using PointType = CombinationTransformType::InputPointType;
+
+/** A stage of a multi-stage registration: a combination of the current transform with the previous stage. */
+CombinationTransformType::Pointer
+CreateStage(CombinationTransformType::CurrentTransformType * currentTransform,
+            CombinationTransformType::InitialTransformType * initialTransform)
+{
+  auto stage = CombinationTransformType::New();
+  stage->SetCurrentTransform(currentTransform);
+  stage->SetInitialTransform(initialTransform);
+  return stage;
+}
+
+TranslationTransformType::Pointer
+CreateTranslation(const double tx, const double ty)
+{
+  auto                                     translation = TranslationTransformType::New();
+  TranslationTransformType::ParametersType parameters(Dimension);
+  parameters[0] = tx;
+  parameters[1] = ty;
+  translation->SetParametersByValue(parameters);
+  return translation;
+}
+
+/** The linear stages of the chains: a translation, then an affine transform. */
+CombinationTransformType::Pointer
+CreateAffineStage()
+{
+  auto                                  matrixOffset = MatrixOffsetTransformType::New();
+  MatrixOffsetTransformType::MatrixType matrix;
+  matrix(0, 0) = 1.1;
+  matrix(0, 1) = 0.2;
+  matrix(1, 0) = -0.15;
+  matrix(1, 1) = 0.9;
+  matrixOffset->SetMatrix(matrix);
+  MatrixOffsetTransformType::OutputVectorType offset;
+  offset[0] = 12.0;
+  offset[1] = -7.5;
+  matrixOffset->SetTranslation(offset);
+  return CreateStage(matrixOffset, CreateStage(CreateTranslation(3.0, -2.0), nullptr));
+}
+
+double
+GetMaximumDistance(const CombinationTransformType & transform1,
+                   const CombinationTransformType & transform2,
+                   const double                     begin,
+                   const double                     end)
+{
+  double maximumDistance = 0.0;
+  for (double x = begin; x <= end; x += 3.7)
+  {
+    for (double y = begin; y <= end; y += 2.9)
+    {
+      PointType point;
+      point[0] = x;
+      point[1] = y;
+      const double distance = transform1.TransformPoint(point).EuclideanDistanceTo(transform2.TransformPoint(point));
+      maximumDistance = std::max(maximumDistance, distance);
+    }
+  }
+  return maximumDistance;
+}
+
+} // end namespace
+
+
+int
+main()
+{
+  /** A linear chain: the linear stages, then the current translation. */
+  const auto affineStage = CreateAffineStage();
+  const auto linearChain = CreateStage(CreateTranslation(-1.0, 0.5), affineStage);
+  const auto referenceLinearChain = CreateStage(CreateTranslation(-1.0, 0.5), CreateAffineStage());
+
+  linearChain->FlattenInitialTransform();
+  if (linearChain->GetFlattenedInitialTransform() == nullptr ||
+      linearChain->GetInitialTransform() != affineStage.GetPointer())
+  {
+    std::cerr << "ERROR: the linear initial transform was not flattened, or GetInitialTransform() changed."
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  const double linearDistance = GetMaximumDistance(*linearChain, *referenceLinearChain, -100.0, 100.0);
+  if (linearDistance > 1e-9)
+  {
+    std::cerr << "ERROR: the flattened linear chain differs by " << linearDistance << '.' << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** A nonlinear chain: a smooth B-spline stage on top of the linear stages. */
+  auto                           bspline = BSplineTransformType::New();
+  BSplineTransformType::SizeType gridSize;
+  gridSize.Fill(12);
+  bspline->SetGridRegion(BSplineTransformType::RegionType(gridSize));
+  BSplineTransformType::SpacingType gridSpacing;
+  gridSpacing.Fill(20.0);
+  bspline->SetGridSpacing(gridSpacing);
+  BSplineTransformType::OriginType gridOrigin;
+  gridOrigin.Fill(-100.0);
+  bspline->SetGridOrigin(gridOrigin);
+  BSplineTransformType::ParametersType coefficients(bspline->GetNumberOfParameters());
+  for (unsigned int i = 0; i < coefficients.GetSize(); ++i)
+  {
+    coefficients[i] = 2.0 * std::sin(0.37 * i);
+  }
+  bspline->SetParametersByValue(coefficients);
+  const auto bsplineStage = CreateStage(bspline, affineStage);
+
+  const auto nonlinearChain = CreateStage(CreateTranslation(-1.0, 0.5), bsplineStage);
+  const auto referenceNonlinearChain =
+    CreateStage(CreateTranslation(-1.0, 0.5), CreateStage(bspline, CreateAffineStage()));
+
+  /** Flattening collapses the linear stages below the B-spline stage only, in a copy of the B-spline stage. */
+  nonlinearChain->FlattenInitialTransform();
+  const auto flattenedBSplineStage =
+    dynamic_cast<const CombinationTransformType *>(nonlinearChain->GetFlattenedInitialTransform());
+  if (flattenedBSplineStage == nullptr || flattenedBSplineStage->GetFlattenedInitialTransform() == nullptr ||
+      nonlinearChain->GetInitialTransform() != bsplineStage.GetPointer())
+  {
+    std::cerr << "ERROR: the linear stages below the nonlinear stage were not flattened." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (bsplineStage->GetFlattenedInitialTransform() != nullptr || affineStage->GetFlattenedInitialTransform() != nullptr)
+  {
+    std::cerr << "ERROR: flattening the nonlinear chain modified its shared stages." << std::endl;
+    return EXIT_FAILURE;
+  }
+  const double flattenedDistance = GetMaximumDistance(*nonlinearChain, *referenceNonlinearChain, -100.0, 100.0);
+  if (flattenedDistance > 1e-9)
+  {
+    std::cerr << "ERROR: the flattened nonlinear chain differs by " << flattenedDistance << '.' << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** Bake the chain on a grid with spacing 1 over [-20, 20]^2. */
+  CombinationTransformType::GridOriginType bakeOrigin;
+  bakeOrigin.Fill(-20.0);
+  CombinationTransformType::GridSpacingType bakeSpacing;
+  bakeSpacing.Fill(1.0);
+  CombinationTransformType::GridSizeType bakeSize;
+  bakeSize.Fill(41);
+  nonlinearChain->BakeInitialTransform(
+    bakeOrigin, bakeSpacing, bakeSize, CombinationTransformType::GridDirectionType::GetIdentity());
+
+  const double insideDistance = GetMaximumDistance(*nonlinearChain, *referenceNonlinearChain, -19.0, 19.0);
+  if (insideDistance > 0.05)
+  {
+    std::cerr << "ERROR: the baked chain differs by " << insideDistance << " inside the grid." << std::endl;
+    return EXIT_FAILURE;
+  }
+  const double outsideDistance = GetMaximumDistance(*nonlinearChain, *referenceNonlinearChain, 25.0, 60.0);
+  if (outsideDistance > 1e-9)
+  {
+    std::cerr << "ERROR: the baked chain differs by " << outsideDistance << " outside the grid." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  nonlinearChain->RestoreInitialTransform();
+  if (nonlinearChain->GetFlattenedInitialTransform() != nullptr ||
+      GetMaximumDistance(*nonlinearChain, *referenceNonlinearChain, -100.0, 100.0) != 0.0)
+  {
+    std::cerr << "ERROR: RestoreInitialTransform() did not restore the initial transform." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "The flattened chain differs by " << linearDistance << ", the baked chain by " << insideDistance
+            << " inside the grid." << std::endl;
+  return EXIT_SUCCESS;
+
+} // end main
@@ -16,14 +16,18 @@
  *
  *=========================================================================*/
 #include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkRecursiveBSplineTransform.h"
 
 #include "itkImageRegionIterator.h"
 
 // Report timings
 #include "itkTimeProbe.h"
 
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iomanip>
+#include <vector>
 
 //-------------------------------------------------------------------------------------
 // Create a class that inherits from the B-spline transform,
@@ -293,6 +297,94 @@ main(int argc, char * argv[])
   std::cerr << "Time NEW = " << newTime << " " << timeProbeNEW.GetUnit() << std::endl;
   std::cerr << "Speedup factor = " << oldTime / newTime << std::endl;
 
+  /** Compare the TransformPoint of the recursive B-spline transform, called
+   * for one point at a time, with the batched TransformPoints, which evaluates
+   * groups of points together. The points are spread over the grid.
+   */
+  using RecursiveTransformType =
+    itk::RecursiveBSplineTransform<CoordinateRepresentationType, Dimension, SplineOrder>;
+  auto recursiveTransform = RecursiveTransformType::New();
+  recursiveTransform->SetGridOrigin(gridOrigin);
+  recursiveTransform->SetGridSpacing(gridSpacing);
+  recursiveTransform->SetGridRegion(gridRegion);
+  recursiveTransform->SetGridDirection(DirectionType::GetIdentity());
+  recursiveTransform->SetParameters(parameters);
+
+  std::vector<InputPointType> inputPoints(N);
+  for (unsigned int i = 0; i < N; ++i)
+  {
+    for (unsigned int j = 0; j < Dimension; ++j)
+    {
+      // A deterministic, scattered sequence within the valid region of the grid.
+      const double fraction = std::fmod((i + 1) * (0.6180339887 + 0.1 * j), 1.0);
+      inputPoints[i][j] = gridOrigin[j] + gridSpacing[j] * (2.0 + fraction * (gridSize[j] - 5.0));
+    }
+  }
+  std::vector<OutputPointType> outputPointsSingle(N);
+  std::vector<OutputPointType> outputPointsBatched(N);
+  itk::TimeProbe               timeProbeSingle, timeProbeBatched;
+
+  /** Time the TransformPoint, one point at a time. */
+  timeProbeSingle.Start();
+  for (unsigned int i = 0; i < N; ++i)
+  {
+    outputPointsSingle[i] = recursiveTransform->TransformPoint(inputPoints[i]);
+  }
+  timeProbeSingle.Stop();
+  const double singleTime = timeProbeSingle.GetMean();
+
+  /** Time the batched TransformPoints. */
+  timeProbeBatched.Start();
+  recursiveTransform->TransformPoints(inputPoints.data(), outputPointsBatched.data(), N);
+  timeProbeBatched.Stop();
+  const double batchedTime = timeProbeBatched.GetMean();
+
+  /** Check that both give the same result. */
+  double maxDifference = 0.0;
+  for (unsigned int i = 0; i < N; ++i)
+  {
+    maxDifference = std::max(maxDifference, outputPointsSingle[i].EuclideanDistanceTo(outputPointsBatched[i]));
+  }
+
+  std::cerr << "Time single  = " << singleTime << " " << timeProbeSingle.GetUnit() << std::endl;
+  std::cerr << "Time batched = " << batchedTime << " " << timeProbeBatched.GetUnit() << std::endl;
+  std::cerr << "Speedup factor = " << singleTime / batchedTime << std::endl;
+  std::cerr << "Maximum difference = " << maxDifference << std::endl;
+  if (maxDifference > 1e-10)
+  {
+    std::cerr << "ERROR: the batched TransformPoints differs from TransformPoint." << std::endl;
+    return 1;
+  }
+
+  /** Compare with the TransformPoint that uses the precomputed sample cache,
+   * as used by the metrics when the samples are fixed during a resolution.
+   */
+  const auto     sampleCache = recursiveTransform->CreateSampleCache(inputPoints.data(), N);
+  itk::TimeProbe timeProbeCached;
+  timeProbeCached.Start();
+  for (unsigned int i = 0; i < N; ++i)
+  {
+    outputPointsBatched[i] = recursiveTransform->TransformPointUsingSampleCache(*sampleCache, i);
+  }
+  timeProbeCached.Stop();
+  const double cachedTime = timeProbeCached.GetMean();
+
+  double maxCachedDifference = 0.0;
+  for (unsigned int i = 0; i < N; ++i)
+  {
+    maxCachedDifference =
+      std::max(maxCachedDifference, outputPointsSingle[i].EuclideanDistanceTo(outputPointsBatched[i]));
+  }
+
+  std::cerr << "Time cached  = " << cachedTime << " " << timeProbeCached.GetUnit() << std::endl;
+  std::cerr << "Speedup factor = " << singleTime / cachedTime << std::endl;
+  std::cerr << "Maximum difference = " << maxCachedDifference << std::endl;
+  if (maxCachedDifference > 1e-10)
+  {
+    std::cerr << "ERROR: the TransformPoint using the sample cache differs from TransformPoint." << std::endl;
+    return 1;
+  }
+
   /** Return a value. */
   return 0;
 
@@ -0,0 +1,85 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkCMAEvolutionStrategyOptimizer.h"
+#include "itkConcurrentOptimizerTestHelper.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+
+#include <iostream>
+
+//-------------------------------------------------------------------------------------
+// This test checks that the CMA evolution strategy with concurrent cost functions, which
+// evaluates the offspring of each generation in parallel, follows exactly the same path
+// as the serial CMA evolution strategy, for the same random seed.
+
+namespace
+{
+using namespace itk::ConcurrentOptimizerTest;
+using OptimizerType = itk::CMAEvolutionStrategyOptimizer;
+
+OptimizerType::Pointer
+RunOptimizer(const unsigned int numberOfConcurrentCostFunctions, TrajectoryType & trajectory)
+{
+  itk::Statistics::MersenneTwisterRandomVariateGenerator::GetInstance()->SetSeed(121212);
+
+  auto optimizer = OptimizerType::New();
+  SetCostFunctions(*optimizer, numberOfConcurrentCostFunctions, 4, IllConditionedQuadratic);
+  RecordTrajectory(*optimizer, trajectory);
+
+  OptimizerType::ScalesType scales(4);
+  scales.Fill(4.0);
+  optimizer->SetScales(scales);
+  optimizer->SetUseScales(true);
+  OptimizerType::ParametersType initialPosition(4);
+  initialPosition.Fill(0.0);
+  optimizer->SetInitialPosition(initialPosition);
+  optimizer->SetPopulationSize(12);
+  optimizer->SetInitialSigma(1.0);
+  optimizer->SetMaximumNumberOfIterations(60);
+
+  optimizer->StartOptimization();
+  return optimizer;
+}
+
+} // end namespace
+
+
+int
+main()
+{
+  TrajectoryType serialTrajectory;
+  const auto     serialOptimizer = RunOptimizer(0, serialTrajectory);
+
+  for (const unsigned int numberOfConcurrentCostFunctions : { 1u, 3u, 11u })
+  {
+    TrajectoryType trajectory;
+    const auto     optimizer = RunOptimizer(numberOfConcurrentCostFunctions, trajectory);
+    if (optimizer->GetCurrentIteration() != serialOptimizer->GetCurrentIteration() ||
+        optimizer->GetCurrentValue() != serialOptimizer->GetCurrentValue() || trajectory != serialTrajectory)
+    {
+      std::cerr << "ERROR: the CMA evolution strategy with " << numberOfConcurrentCostFunctions
+                << " concurrent cost functions differs from the serial CMA evolution strategy." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "The parallel CMA evolution strategy followed the same path as the serial one, to "
+            << serialOptimizer->GetCurrentPosition() << " with value " << serialOptimizer->GetCurrentValue()
+            << " after " << serialOptimizer->GetCurrentIteration() << " iterations." << std::endl;
+  return EXIT_SUCCESS;
+
+} // end main
@@ -0,0 +1,203 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkConcurrentOptimizerTestHelper_h
+#define itkConcurrentOptimizerTestHelper_h
+
+#include "itkSingleValuedCostFunction.h"
+
+#include <cmath>
+#include <functional>
+#include <set>
+#include <vector>
+
+namespace itk
+{
+namespace ConcurrentOptimizerTest
+{
+using ParametersType = SingleValuedCostFunction::ParametersType;
+using PositionType = std::vector<double>;
+using PositionSetType = std::set<PositionType>;
+using TrajectoryType = std::vector<ParametersType>;
+
+/** \class TestCostFunction
+ * \brief The cost function of the tests of the optimizers with concurrent cost functions.
+ *
+ * The value is computed by a function that is passed to SetFunction(). Each cost
+ * function records the positions at which it is evaluated. When a set of allowed
+ * positions is passed, an evaluation at any other position is rejected: it is
+ * counted, and an exception is thrown, as a metric would do for a position that
+ * maps too few samples.
+ *
+ * An object is only evaluated by one thread at a time, just as the concurrent
+ * cost functions of the optimizers.
+ */
+class TestCostFunction : public SingleValuedCostFunction
+{
+public:
+  ITK_DISALLOW_COPY_AND_MOVE(TestCostFunction);
+
+  using Self = TestCostFunction;
+  using Superclass = SingleValuedCostFunction;
+  using Pointer = SmartPointer<Self>;
+  itkNewMacro(Self);
+
+  using FunctionType = std::function<MeasureType(const ParametersType &)>;
+
+  void
+  SetFunction(const unsigned int numberOfParameters, const FunctionType & function)
+  {
+    m_NumberOfParameters = numberOfParameters;
+    m_Function = function;
+  }
+
+  /** The positions at which the cost function may be evaluated; nullptr allows all positions. */
+  void
+  SetAllowedPositions(const PositionSetType * allowedPositions)
+  {
+    m_AllowedPositions = allowedPositions;
+  }
+
+  const std::vector<PositionType> &
+  GetEvaluatedPositions() const
+  {
+    return m_EvaluatedPositions;
+  }
+
+  unsigned int
+  GetNumberOfRejectedPositions() const
+  {
+    return m_NumberOfRejectedPositions;
+  }
+
+  unsigned int
+  GetNumberOfParameters() const override
+  {
+    return m_NumberOfParameters;
+  }
+
+  MeasureType
+  GetValue(const ParametersType & parameters) const override
+  {
+    const PositionType position(parameters.begin(), parameters.end());
+    m_EvaluatedPositions.push_back(position);
+    if (m_AllowedPositions != nullptr && m_AllowedPositions->count(position) == 0)
+    {
+      ++m_NumberOfRejectedPositions;
+      itkExceptionMacro("The position " << parameters << " is not allowed.");
+    }
+    return m_Function(parameters);
+  }
+
+  void
+  GetDerivative(const ParametersType &, DerivativeType &) const override
+  {}
+
+protected:
+  TestCostFunction() = default;
+  ~TestCostFunction() override = default;
+
+private:
+  unsigned int                      m_NumberOfParameters{ 0 };
+  FunctionType                      m_Function{};
+  const PositionSetType *           m_AllowedPositions{ nullptr };
+  mutable std::vector<PositionType> m_EvaluatedPositions{};
+  mutable unsigned int              m_NumberOfRejectedPositions{ 0 };
+};
+
+
+/** An ill-conditioned quadratic function, with its minimum at x_i = 1 - 0.5 i. */
+inline double
+IllConditionedQuadratic(const ParametersType & parameters)
+{
+  double value = 0.0;
+  for (unsigned int i = 0; i < parameters.GetSize(); ++i)
+  {
+    value += std::pow(10.0, i) * std::pow(parameters[i] - 1.0 + 0.5 * i, 2);
+  }
+  return value;
+}
+
+
+/** Sets a cost function and the given number of concurrent copies of it on the optimizer.
+ * Returns all of them, the cost function of the optimizer first. */
+template <typename TOptimizer>
+std::vector<TestCostFunction::Pointer>
+SetCostFunctions(TOptimizer &                           optimizer,
+                 const unsigned int                     numberOfConcurrentCostFunctions,
+                 const unsigned int                     numberOfParameters,
+                 const TestCostFunction::FunctionType & function,
+                 const PositionSetType *                allowedPositions = nullptr)
+{
+  std::vector<TestCostFunction::Pointer> costFunctions;
+  for (unsigned int i = 0; i <= numberOfConcurrentCostFunctions; ++i)
+  {
+    auto costFunction = TestCostFunction::New();
+    costFunction->SetFunction(numberOfParameters, function);
+    costFunction->SetAllowedPositions(allowedPositions);
+    costFunctions.push_back(costFunction);
+  }
+
+  optimizer.SetCostFunction(costFunctions.front());
+  typename TOptimizer::CostFunctionContainerType concurrentCostFunctions(costFunctions.begin() + 1,
+                                                                         costFunctions.end());
+  optimizer.SetConcurrentCostFunctions(concurrentCostFunctions);
+  return costFunctions;
+}
+
+
+/** Returns all positions at which any of the cost functions was evaluated. */
+inline PositionSetType
+GetEvaluatedPositions(const std::vector<TestCostFunction::Pointer> & costFunctions)
+{
+  PositionSetType positions;
+  for (const auto & costFunction : costFunctions)
+  {
+    positions.insert(costFunction->GetEvaluatedPositions().begin(), costFunction->GetEvaluatedPositions().end());
+  }
+  return positions;
+}
+
+
+/** Returns the total number of rejected evaluations of the cost functions. */
+inline unsigned int
+GetNumberOfRejectedPositions(const std::vector<TestCostFunction::Pointer> & costFunctions)
+{
+  unsigned int numberOfRejectedPositions = 0;
+  for (const auto & costFunction : costFunctions)
+  {
+    numberOfRejectedPositions += costFunction->GetNumberOfRejectedPositions();
+  }
+  return numberOfRejectedPositions;
+}
+
+
+/** Records the current position of the optimizer at each iteration event. The optimizer
+ * and the trajectory must outlive the optimization. */
+template <typename TOptimizer>
+void
+RecordTrajectory(TOptimizer & optimizer, TrajectoryType & trajectory)
+{
+  optimizer.AddObserver(IterationEvent(), [&optimizer, &trajectory](const EventObject &) {
+    trajectory.push_back(optimizer.GetCurrentPosition());
+  });
+}
+
+} // end namespace ConcurrentOptimizerTest
+} // end namespace itk
+
+#endif // end #ifndef itkConcurrentOptimizerTestHelper_h
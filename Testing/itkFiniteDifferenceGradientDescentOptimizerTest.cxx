@@ -0,0 +1,96 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkFiniteDifferenceGradientDescentOptimizer.h"
+#include "itkConcurrentOptimizerTestHelper.h"
+
+#include <cmath>
+#include <iostream>
+
+//-------------------------------------------------------------------------------------
+// This test checks that the finite difference gradient descent with concurrent cost
+// functions, which evaluates the perturbed positions of each iteration in parallel,
+// follows exactly the same path as the serial finite difference gradient descent.
+
+namespace
+{
+using namespace itk::ConcurrentOptimizerTest;
+using OptimizerType = itk::FiniteDifferenceGradientDescentOptimizer;
+
+/** A smooth function, with a minimum near parameters[i] = 0.1 * i. */
+double
+SmoothFunction(const ParametersType & parameters)
+{
+  double value = 0.0;
+  for (unsigned int i = 0; i < 12; ++i)
+  {
+    value += (1.0 + 0.1 * i) * std::pow(parameters[i] - 0.1 * i, 2) + 0.01 * std::cos(parameters[i]);
+  }
+  return value;
+}
+
+
+OptimizerType::Pointer
+RunOptimizer(const unsigned int numberOfConcurrentCostFunctions, TrajectoryType & trajectory)
+{
+  auto optimizer = OptimizerType::New();
+  SetCostFunctions(*optimizer, numberOfConcurrentCostFunctions, 12, SmoothFunction);
+  RecordTrajectory(*optimizer, trajectory);
+
+  OptimizerType::ScalesType scales(12);
+  scales.Fill(2.0);
+  optimizer->SetScales(scales);
+  optimizer->SetUseScales(true);
+  OptimizerType::ParametersType initialPosition(12);
+  initialPosition.Fill(1.0);
+  optimizer->SetInitialPosition(initialPosition);
+  optimizer->SetParam_a(0.5);
+  optimizer->SetParam_c(0.1);
+  optimizer->SetNumberOfIterations(50);
+  optimizer->ComputeCurrentValueOn();
+
+  optimizer->StartOptimization();
+  return optimizer;
+}
+
+} // end namespace
+
+
+int
+main()
+{
+  TrajectoryType serialTrajectory;
+  const auto     serialOptimizer = RunOptimizer(0, serialTrajectory);
+
+  for (const unsigned int numberOfConcurrentCostFunctions : { 1u, 2u, 5u })
+  {
+    TrajectoryType trajectory;
+    const auto     optimizer = RunOptimizer(numberOfConcurrentCostFunctions, trajectory);
+    if (optimizer->GetValue() != serialOptimizer->GetValue() ||
+        optimizer->GetGradientMagnitude() != serialOptimizer->GetGradientMagnitude() || trajectory != serialTrajectory)
+    {
+      std::cerr << "ERROR: the finite difference gradient descent with " << numberOfConcurrentCostFunctions
+                << " concurrent cost functions differs from the serial one." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "The parallel finite difference gradient descent followed the same path as the serial one, to "
+            << serialOptimizer->GetCurrentPosition() << " with value " << serialOptimizer->GetValue() << std::endl;
+  return EXIT_SUCCESS;
+
+} // end main
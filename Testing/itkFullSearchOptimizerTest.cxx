@@ -0,0 +1,95 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkFullSearchOptimizer.h"
+#include "itkConcurrentOptimizerTestHelper.h"
+
+#include <cmath>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+//-------------------------------------------------------------------------------------
+// This test checks that the full search with concurrent cost functions visits the
+// same points, with the same values, in the same order, and finds the same optimum,
+// as the serial full search.
+
+namespace
+{
+using namespace itk::ConcurrentOptimizerTest;
+using OptimizerType = itk::FullSearchOptimizer;
+using VisitedPointsType = std::vector<std::pair<OptimizerType::SearchSpaceIndexType, double>>;
+
+/** A function with several local minima. */
+double
+MultiModalFunction(const ParametersType & parameters)
+{
+  return std::pow(parameters[0] - 0.7, 2) + std::pow(parameters[1] + 1.3, 2) + std::cos(3.0 * parameters[0]) +
+         parameters[2];
+}
+
+VisitedPointsType
+RunFullSearch(const unsigned int numberOfConcurrentCostFunctions, OptimizerType::SearchSpaceIndexType & bestIndex)
+{
+  auto optimizer = OptimizerType::New();
+  SetCostFunctions(*optimizer, numberOfConcurrentCostFunctions, 3, MultiModalFunction);
+  optimizer->SetBatchSize(7);
+
+  OptimizerType::ParametersType initialPosition(3);
+  initialPosition.Fill(0.0);
+  optimizer->SetInitialPosition(initialPosition);
+  optimizer->AddSearchDimension(0, -2.0, 2.0, 0.1);
+  optimizer->AddSearchDimension(1, -3.0, 1.0, 0.25);
+  optimizer->AddSearchDimension(2, 0.0, 0.5, 0.5);
+
+  /** Record the points and values that are reported in the iteration events. */
+  VisitedPointsType visitedPoints;
+  optimizer->AddObserver(itk::IterationEvent(), [&optimizer, &visitedPoints](const itk::EventObject &) {
+    visitedPoints.emplace_back(optimizer->GetCurrentIndexInSearchSpace(), optimizer->GetValue());
+  });
+
+  optimizer->StartOptimization();
+  bestIndex = optimizer->GetBestIndexInSearchSpace();
+  return visitedPoints;
+}
+
+} // end namespace
+
+
+int
+main()
+{
+  OptimizerType::SearchSpaceIndexType serialBestIndex;
+  const VisitedPointsType             serialPoints = RunFullSearch(0, serialBestIndex);
+
+  for (const unsigned int numberOfConcurrentCostFunctions : { 1u, 3u, 7u })
+  {
+    OptimizerType::SearchSpaceIndexType bestIndex;
+    const VisitedPointsType             points = RunFullSearch(numberOfConcurrentCostFunctions, bestIndex);
+    if (points != serialPoints || bestIndex != serialBestIndex)
+    {
+      std::cerr << "ERROR: the full search with " << numberOfConcurrentCostFunctions
+                << " concurrent cost functions differs from the serial full search." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "The parallel full search visited the same " << serialPoints.size()
+            << " points as the serial search, and found the same optimum " << serialBestIndex << "." << std::endl;
+  return EXIT_SUCCESS;
+
+} // end main
@@ -0,0 +1,147 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageQuasiRandomCoordinateSampler.h"
+#include "itkImageRandomCoordinateSampler.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+// Report timings
+#include "itkTimeProbe.h"
+
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+//-------------------------------------------------------------------------------------
+// This test is a convergence benchmark of the quasi-random coordinate sampler against
+// the random coordinate sampler. Each sampler estimates the mean intensity of a smooth
+// image, which is what a metric computes from its samples. The root mean square error
+// of the estimate, over repeated sets of new samples, is reported for an increasing
+// number of samples. For the quasi-random sampler the error should decrease faster.
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+
+/** Estimate the root mean square error of the sample mean, over a number of repetitions. */
+template <class TSampler>
+double
+ComputeRootMeanSquareError(const ImageType *   image,
+                           const double        exactMean,
+                           const unsigned long numberOfSamples,
+                           const unsigned int  numberOfRepetitions,
+                           double &            elapsedSeconds)
+{
+  itk::Statistics::MersenneTwisterRandomVariateGenerator::GetInstance()->SetSeed(5489);
+
+  auto sampler = TSampler::New();
+  sampler->SetInput(image);
+  sampler->SetInterpolator(itk::LinearInterpolateImageFunction<ImageType, double>::New());
+  sampler->SetNumberOfSamples(numberOfSamples);
+
+  itk::TimeProbe timer;
+  double         sumOfSquaredErrors = 0.0;
+  for (unsigned int r = 0; r < numberOfRepetitions; ++r)
+  {
+    /** Generate new samples, as with NewSamplesEveryIteration. */
+    timer.Start();
+    sampler->Modified();
+    sampler->Update();
+    timer.Stop();
+
+    double sum = 0.0;
+    for (const auto & sample : *sampler->GetOutput())
+    {
+      sum += sample.m_ImageValue;
+    }
+    const double error = sum / numberOfSamples - exactMean;
+    sumOfSquaredErrors += error * error;
+  }
+
+  elapsedSeconds = timer.GetTotal();
+  return std::sqrt(sumOfSquaredErrors / numberOfRepetitions);
+}
+
+} // end namespace
+
+
+int
+main()
+{
+  /** Create a smooth test image. */
+  auto                  image = ImageType::New();
+  ImageType::RegionType region;
+  region.SetSize({ { 48, 40, 32 } });
+  image->SetRegions(region);
+  image->Allocate();
+
+  /** The exact mean of the linearly interpolated image over the sample region
+   * [0, size - 1] is given by the trapezoidal rule. */
+  double                                         weightedSum = 0.0;
+  double                                         sumOfWeights = 0.0;
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+  for (; !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set(static_cast<float>(100.0 * std::sin(index[0] / 7.0) + 50.0 * std::cos(index[1] / 5.0) +
+                              0.1 * index[2] * index[2]));
+
+    double weight = 1.0;
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      if (index[d] == 0 || index[d] == static_cast<itk::IndexValueType>(region.GetSize(d)) - 1)
+      {
+        weight *= 0.5;
+      }
+    }
+    weightedSum += weight * it.Get();
+    sumOfWeights += weight;
+  }
+  const double exactMean = weightedSum / sumOfWeights;
+
+  /** Compare the convergence of both samplers. */
+  const unsigned int numberOfRepetitions = 50;
+  double             randomError = 0.0;
+  double             quasiRandomError = 0.0;
+  std::cout << std::setw(10) << "samples" << std::setw(16) << "RMSE random" << std::setw(16) << "RMSE quasi"
+            << std::setw(14) << "time random" << std::setw(14) << "time quasi" << std::endl;
+  for (const unsigned long numberOfSamples : { 256ul, 1024ul, 4096ul, 16384ul })
+  {
+    double randomTime = 0.0;
+    double quasiRandomTime = 0.0;
+    randomError = ComputeRootMeanSquareError<itk::ImageRandomCoordinateSampler<ImageType>>(
+      image, exactMean, numberOfSamples, numberOfRepetitions, randomTime);
+    quasiRandomError = ComputeRootMeanSquareError<itk::ImageQuasiRandomCoordinateSampler<ImageType>>(
+      image, exactMean, numberOfSamples, numberOfRepetitions, quasiRandomTime);
+
+    std::cout << std::setw(10) << numberOfSamples << std::setw(16) << randomError << std::setw(16)
+              << quasiRandomError << std::setw(14) << randomTime << std::setw(14) << quasiRandomTime << std::endl;
+  }
+
+  /** With many samples, the quasi-random estimate should be clearly more accurate. */
+  if (!(quasiRandomError < 0.5 * randomError))
+  {
+    std::cerr << "ERROR: the quasi-random sampler does not converge faster than the random sampler." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+
+} // end main
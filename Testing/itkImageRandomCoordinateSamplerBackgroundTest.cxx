@@ -0,0 +1,161 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageRandomCoordinateSampler.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkImageMaskSpatialObject.h"
+
+#include <iostream>
+
+//-------------------------------------------------------------------------------------
+// This test checks that the ImageRandomCoordinateSampler, when it generates its samples
+// in the background, produces the same sequence of sample sets as a sampler that
+// generates them in the foreground, using a global generator with the same seed as the
+// generator of the background sampler, with and without a mask. It also checks that
+// setting the same number of samples keeps the samples that were generated in the
+// background, and that a change of the settings discards them.
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+using SamplerType = itk::ImageRandomCoordinateSampler<ImageType>;
+using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+using MaskImageType = itk::Image<unsigned char, 3>;
+using MaskSpatialObjectType = itk::ImageMaskSpatialObject<3>;
+
+bool
+AreEqual(const SamplerType::ImageSampleContainerType & samples1,
+         const SamplerType::ImageSampleContainerType & samples2)
+{
+  if (samples1.size() != samples2.size())
+  {
+    return false;
+  }
+  for (std::size_t i = 0; i < samples1.size(); ++i)
+  {
+    if (samples1[i].m_ImageCoordinates != samples2[i].m_ImageCoordinates ||
+        samples1[i].m_ImageValue != samples2[i].m_ImageValue)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // end namespace
+
+
+int
+main()
+{
+  /** Create a test image. */
+  auto                  image = ImageType::New();
+  ImageType::RegionType region;
+  region.SetSize({ { 40, 36, 30 } });
+  image->SetRegions(region);
+  image->Allocate();
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+  for (; !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set(static_cast<float>(index[0] * index[1] - 3 * index[2]));
+  }
+
+  /** Create a mask that covers part of the image. */
+  auto maskImage = MaskImageType::New();
+  maskImage->SetRegions(region);
+  maskImage->Allocate(true);
+  itk::ImageRegionIteratorWithIndex<MaskImageType> maskIt(maskImage, region);
+  for (; !maskIt.IsAtEnd(); ++maskIt)
+  {
+    maskIt.Set(maskIt.GetIndex()[0] + maskIt.GetIndex()[2] < 40 ? 1 : 0);
+  }
+  auto mask = MaskSpatialObjectType::New();
+  mask->SetImage(maskImage);
+  mask->Update();
+
+  constexpr unsigned int numberOfIterations = 6;
+  for (const unsigned int configuration : { 0u, 1u, 2u, 3u })
+  {
+    const bool useMultiThread = configuration % 2 == 1;
+    const bool useMask = configuration >= 2;
+
+    /** The sampler that generates its samples in the background. */
+    auto backgroundSampler = SamplerType::New();
+    backgroundSampler->SetInput(image);
+    backgroundSampler->SetNumberOfSamples(1000);
+    backgroundSampler->SetUseMultiThread(useMultiThread);
+    backgroundSampler->UseBackgroundSampleGenerationOn();
+    if (useMask)
+    {
+      backgroundSampler->SetMask(mask);
+    }
+
+    /** The reference sampler. After the first set of samples, the global generator
+     * is reseeded, the way the background sampler seeds its own generator. */
+    auto sampler = SamplerType::New();
+    sampler->SetInput(image);
+    sampler->SetNumberOfSamples(1000);
+    sampler->SetUseMultiThread(useMultiThread);
+    if (useMask)
+    {
+      sampler->SetMask(mask);
+    }
+
+    const auto generator = GeneratorType::GetInstance();
+    generator->SetSeed(2023);
+    backgroundSampler->Update();
+    generator->SetSeed(2023);
+    sampler->Update();
+    generator->SetSeed(generator->GetIntegerVariate());
+
+    /** The output container must stay the same object, since metrics keep a pointer to it. */
+    const SamplerType::ImageSampleContainerType * const output = backgroundSampler->GetOutput();
+    for (unsigned int iteration = 0; iteration < numberOfIterations; ++iteration)
+    {
+      if (!AreEqual(*backgroundSampler->GetOutput(), *sampler->GetOutput()) ||
+          backgroundSampler->GetOutput() != output)
+      {
+        std::cerr << "ERROR: the samples generated in the background differ in iteration " << iteration
+                  << " (UseMultiThread: " << useMultiThread << ", mask: " << useMask << ")." << std::endl;
+        return EXIT_FAILURE;
+      }
+      /** As the adaptive number of samples of the optimizers does, every iteration. */
+      backgroundSampler->SetNumberOfSamples(1000);
+      backgroundSampler->SelectNewSamplesOnUpdate();
+      backgroundSampler->Update();
+      sampler->SelectNewSamplesOnUpdate();
+      sampler->Update();
+    }
+
+    /** A new number of samples must not be ignored, nor swapped in from the background. */
+    backgroundSampler->SetNumberOfSamples(500);
+    backgroundSampler->Update();
+    if (backgroundSampler->GetOutput()->size() != 500)
+    {
+      std::cerr << "ERROR: the new number of samples is ignored." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "The samples generated in the background are equal to the samples generated in the foreground."
+            << std::endl;
+  return EXIT_SUCCESS;
+
+} // end main
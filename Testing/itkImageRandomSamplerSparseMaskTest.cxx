@@ -0,0 +1,110 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageRandomSamplerSparseMask.h"
+#include "itkImageFullSampler.h"
+#include "itkImageMaskSpatialObject.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkImage.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+#include <cmath>
+#include <iostream>
+
+//-------------------------------------------------------------------------------------
+// This test checks that the ImageRandomSamplerSparseMask, which keeps a compact list of
+// the voxels inside the mask, draws exactly the samples that are obtained by drawing
+// random indices into the output of an ImageFullSampler with the same mask.
+
+int
+main()
+{
+  using ImageType = itk::Image<short, 3>;
+  using MaskImageType = itk::Image<unsigned char, 3>;
+  using MaskType = itk::ImageMaskSpatialObject<3>;
+
+  /** Create an image, and a mask with two separate spheres. */
+  ImageType::RegionType region;
+  region.SetSize({ { 41, 37, 29 } });
+  auto image = ImageType::New();
+  image->SetRegions(region);
+  image->SetSpacing(itk::MakeFilled<ImageType::SpacingType>(0.75));
+  image->Allocate();
+  auto maskImage = MaskImageType::New();
+  maskImage->CopyInformation(image);
+  maskImage->SetRegions(region);
+  maskImage->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+  for (; !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set(static_cast<short>(index[0] + 7 * index[1] - 3 * index[2]));
+
+    double distance1 = 0.0;
+    double distance2 = 0.0;
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      distance1 += std::pow(index[d] - 0.3 * region.GetSize(d), 2);
+      distance2 += std::pow(index[d] - 0.7 * region.GetSize(d), 2);
+    }
+    maskImage->SetPixel(index, (distance1 < 36.0 || distance2 < 49.0) ? 1 : 0);
+  }
+  auto mask = MaskType::New();
+  mask->SetImage(maskImage);
+  mask->Update();
+
+  /** Draw the samples with the sparse mask sampler. */
+  constexpr unsigned long numberOfSamples = 2000;
+  const auto              generator = itk::Statistics::MersenneTwisterRandomVariateGenerator::GetInstance();
+  generator->SetSeed(1234);
+  auto sampler = itk::ImageRandomSamplerSparseMask<ImageType>::New();
+  sampler->SetInput(image);
+  sampler->SetMask(mask);
+  sampler->SetNumberOfSamples(numberOfSamples);
+  sampler->Update();
+  const auto & samples = *sampler->GetOutput();
+
+  /** Draw the same random indices into all samples inside the mask. */
+  auto fullSampler = itk::ImageFullSampler<ImageType>::New();
+  fullSampler->SetInput(image);
+  fullSampler->SetMask(mask);
+  fullSampler->Update();
+  const auto & allValidSamples = *fullSampler->GetOutput();
+
+  generator->SetSeed(1234);
+  if (samples.size() != numberOfSamples)
+  {
+    std::cerr << "ERROR: " << samples.size() << " samples instead of " << numberOfSamples << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (unsigned long i = 0; i < numberOfSamples; ++i)
+  {
+    const auto & expected = allValidSamples[generator->GetIntegerVariate(allValidSamples.size() - 1)];
+    if (samples[i].m_ImageCoordinates != expected.m_ImageCoordinates ||
+        samples[i].m_ImageValue != expected.m_ImageValue)
+    {
+      std::cerr << "ERROR: sample " << i << " differs from the full sampler." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "Sparse mask sampler: " << numberOfSamples << " samples equal to those of the full sampler, out of "
+            << allValidSamples.size() << " voxels inside the mask." << std::endl;
+  return EXIT_SUCCESS;
+
+} // end main
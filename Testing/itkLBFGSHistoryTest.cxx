@@ -0,0 +1,135 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkLBFGSHistory.h"
+
+#include <cmath>
+#include <iostream>
+#include <random>
+
+//-------------------------------------------------------------------------------------
+// This test checks the operations of the LBFGSHistory, in double and single precision,
+// on vectors that are long enough to be processed by multiple threads.
+
+int
+main()
+{
+  using HistoryType = itk::LBFGSHistory;
+  using VectorType = HistoryType::VectorType;
+
+  constexpr unsigned int       memory = 3;
+  constexpr itk::SizeValueType numberOfParameters = 1000003;
+
+  std::mt19937                     randomGenerator(3);
+  std::normal_distribution<double> normal;
+
+  VectorType s(numberOfParameters);
+  VectorType y(numberOfParameters);
+  VectorType v(numberOfParameters);
+  for (itk::SizeValueType i = 0; i < numberOfParameters; ++i)
+  {
+    s[i] = normal(randomGenerator);
+    y[i] = normal(randomGenerator);
+    v[i] = normal(randomGenerator);
+  }
+
+  /** Reference values, computed in long double. */
+  long double exactSV = 0.0;
+  long double exactYV = 0.0;
+  long double exactSY = 0.0;
+  for (itk::SizeValueType i = 0; i < numberOfParameters; ++i)
+  {
+    exactSV += static_cast<long double>(s[i]) * v[i];
+    exactYV += static_cast<long double>(y[i]) * v[i];
+    exactSY += static_cast<long double>(s[i]) * y[i];
+  }
+
+  auto doubleHistory = HistoryType::New();
+  doubleHistory->Initialize(memory, numberOfParameters);
+  auto floatHistory = HistoryType::New();
+  floatHistory->UseSinglePrecisionOn();
+  floatHistory->Initialize(memory, numberOfParameters);
+
+  /** Single precision should halve the memory. */
+  if (2 * floatHistory->GetNumberOfBytes() != doubleHistory->GetNumberOfBytes())
+  {
+    std::cerr << "ERROR: single precision history takes " << floatHistory->GetNumberOfBytes()
+              << " bytes, double precision " << doubleHistory->GetNumberOfBytes() << " bytes." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** The double precision inner products should be accurate, the single precision ones
+   * accurate up to the rounding of the stored values. */
+  const double scale = std::sqrt(static_cast<double>(numberOfParameters));
+  const auto   check = [scale](const char * name, double value, long double exact, double tolerance) {
+    const double error = std::abs(value - static_cast<double>(exact)) / scale;
+    if (!(error < tolerance))
+    {
+      std::cerr << "ERROR: " << name << " = " << value << ", expected " << static_cast<double>(exact)
+                << " (relative error " << error << ")." << std::endl;
+      return false;
+    }
+    return true;
+  };
+
+  const bool success =
+    check("double s'y", doubleHistory->Store(1, s, y), exactSY, 1e-14) &&
+    check("double s'v", doubleHistory->InnerProductWithS(1, v), exactSV, 1e-14) &&
+    check("double y'v", doubleHistory->InnerProductWithY(1, v), exactYV, 1e-14) &&
+    check("InnerProduct", HistoryType::InnerProduct(s, v), exactSV, 1e-14) &&
+    check("float s'y", floatHistory->Store(1, s, y), exactSY, 1e-6) &&
+    check("float s'v", floatHistory->InnerProductWithS(1, v), exactSV, 1e-6) &&
+    check("float y'v", floatHistory->InnerProductWithY(1, v), exactYV, 1e-6);
+  if (!success)
+  {
+    return EXIT_FAILURE;
+  }
+
+  /** v + 2 s - 3 y, in both precisions. */
+  VectorType doubleV = v;
+  VectorType floatV = v;
+  doubleHistory->AddScaledS(1, 2.0, doubleV);
+  doubleHistory->AddScaledY(1, -3.0, doubleV);
+  floatHistory->AddScaledS(1, 2.0, floatV);
+  floatHistory->AddScaledY(1, -3.0, floatV);
+  for (itk::SizeValueType i = 0; i < numberOfParameters; ++i)
+  {
+    const double expected = v[i] + 2.0 * s[i] - 3.0 * y[i];
+    if (std::abs(doubleV[i] - expected) > 1e-12 || std::abs(floatV[i] - expected) > 1e-5)
+    {
+      std::cerr << "ERROR: AddScaled gives " << doubleV[i] << " and " << floatV[i] << " instead of " << expected
+                << " at index " << i << "." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  /** A sum with cancellation, that is lost in plain summation: 1e16 + 1 - 1e16. */
+  VectorType a(numberOfParameters, 0.0);
+  VectorType b(numberOfParameters, 1.0);
+  a[0] = 1e16;
+  a[numberOfParameters / 2] = 1.0;
+  a[numberOfParameters - 1] = -1e16;
+  if (HistoryType::InnerProduct(a, b) != 1.0)
+  {
+    std::cerr << "ERROR: compensated inner product gives " << HistoryType::InnerProduct(a, b) << " instead of 1."
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+
+} // end main
@@ -0,0 +1,150 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkPhiloxRandomNumberGenerator.h"
+#include "itkImageRandomCoordinateSampler.h"
+#include "itkImageRandomSampler.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkImage.h"
+
+#include <iostream>
+
+//-------------------------------------------------------------------------------------
+// This test checks the Philox4x32-10 generator against the known-answer tests of the
+// reference implementation (Random123), and checks that the multi-threaded random
+// samplers produce the same samples for any number of threads when they use the
+// counter-based random numbers.
+
+namespace
+{
+bool
+CheckKnownAnswer(const itk::PhiloxRandomNumberGenerator::CounterType & counter,
+                 const itk::PhiloxRandomNumberGenerator::KeyType &     key,
+                 const itk::PhiloxRandomNumberGenerator::CounterType & expected)
+{
+  const auto result = itk::PhiloxRandomNumberGenerator::Generate(counter, key);
+  if (result != expected)
+  {
+    std::cerr << "ERROR: Philox4x32-10 output differs from the known answer:" << std::hex;
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+      std::cerr << " " << result[i];
+    }
+    std::cerr << std::dec << std::endl;
+    return false;
+  }
+  return true;
+}
+
+
+/** Generate the samples of a new sampler, with the given number of work units. */
+template <class TSampler, class TImage>
+typename TSampler::ImageSampleContainerPointer
+GenerateSamples(const TImage * image, const unsigned int numberOfWorkUnits)
+{
+  itk::Statistics::MersenneTwisterRandomVariateGenerator::GetInstance()->SetSeed(121212);
+
+  auto sampler = TSampler::New();
+  sampler->SetInput(image);
+  sampler->SetNumberOfSamples(1001);
+  sampler->SetUseMultiThread(true);
+  sampler->SetUseCounterBasedRandomNumbers(true);
+  sampler->SetNumberOfWorkUnits(numberOfWorkUnits);
+  sampler->Update();
+
+  typename TSampler::ImageSampleContainerPointer samples = sampler->GetOutput();
+  samples->DisconnectPipeline();
+  return samples;
+}
+
+
+template <class TSampler, class TImage>
+bool
+CheckThreadCountIndependence(const TImage * image, const char * name)
+{
+  const auto reference = GenerateSamples<TSampler>(image, 1);
+  for (const unsigned int numberOfWorkUnits : { 2u, 3u, 8u })
+  {
+    const auto samples = GenerateSamples<TSampler>(image, numberOfWorkUnits);
+    if (samples->Size() != reference->Size())
+    {
+      std::cerr << "ERROR: " << name << " generated " << samples->Size() << " instead of " << reference->Size()
+                << " samples with " << numberOfWorkUnits << " work units." << std::endl;
+      return false;
+    }
+    for (unsigned long i = 0; i < reference->Size(); ++i)
+    {
+      if (samples->ElementAt(i).m_ImageCoordinates != reference->ElementAt(i).m_ImageCoordinates ||
+          samples->ElementAt(i).m_ImageValue != reference->ElementAt(i).m_ImageValue)
+      {
+        std::cerr << "ERROR: " << name << " sample " << i << " differs with " << numberOfWorkUnits
+                  << " work units." << std::endl;
+        return false;
+      }
+    }
+  }
+  std::cout << name << ": identical samples for 1, 2, 3 and 8 work units." << std::endl;
+  return true;
+}
+
+} // end namespace
+
+
+int
+main()
+{
+  /** Known-answer tests of Random123. */
+  bool passed = true;
+  passed &= CheckKnownAnswer({ { 0, 0, 0, 0 } }, { { 0, 0 } }, { { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 } });
+  passed &= CheckKnownAnswer({ { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff } },
+                             { { 0xffffffff, 0xffffffff } },
+                             { { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd } });
+  passed &= CheckKnownAnswer({ { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 } },
+                             { { 0xa4093822, 0x299f31d0 } },
+                             { { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 } });
+  if (!passed)
+  {
+    return EXIT_FAILURE;
+  }
+  std::cout << "Philox4x32-10 known-answer tests passed." << std::endl;
+
+  /** Create a small test image. */
+  using ImageType = itk::Image<float, 3>;
+  auto                  image = ImageType::New();
+  ImageType::RegionType region;
+  region.SetSize({ { 20, 17, 13 } });
+  image->SetRegions(region);
+  image->Allocate();
+  float value = 0.0f;
+  for (float * pixel = image->GetBufferPointer(); pixel != image->GetBufferPointer() + region.GetNumberOfPixels();
+       ++pixel)
+  {
+    *pixel = value;
+    value += 0.25f;
+  }
+
+  /** The samples should not depend on the number of threads. */
+  if (!CheckThreadCountIndependence<itk::ImageRandomSampler<ImageType>>(image, "ImageRandomSampler") ||
+      !CheckThreadCountIndependence<itk::ImageRandomCoordinateSampler<ImageType>>(image,
+                                                                                   "ImageRandomCoordinateSampler"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+
+} // end main
@@ -0,0 +1,135 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkSpeculativeSimplexOptimizer.h"
+#include "itkConcurrentOptimizerTestHelper.h"
+
+#include <cmath>
+#include <iostream>
+
+//-------------------------------------------------------------------------------------
+// This test checks that the speculative Nelder-Mead simplex optimizer with concurrent cost
+// functions, which evaluates the reflection, expansion and contraction candidates of each
+// iteration in parallel, follows exactly the same path as the serial one, and that it finds
+// the minimum. It also checks that the candidates that the serial optimizer would not have
+// evaluated are really speculative: when the cost functions reject them, the optimization
+// is not affected.
+
+namespace
+{
+using namespace itk::ConcurrentOptimizerTest;
+using OptimizerType = itk::SpeculativeSimplexOptimizer;
+
+OptimizerType::Pointer
+RunOptimizer(const unsigned int                       numberOfConcurrentCostFunctions,
+             const bool                               useSpeculativeEvaluation,
+             std::vector<TestCostFunction::Pointer> & costFunctions,
+             TrajectoryType &                         trajectory,
+             const PositionSetType *                  allowedPositions = nullptr)
+{
+  auto optimizer = OptimizerType::New();
+  costFunctions =
+    SetCostFunctions(*optimizer, numberOfConcurrentCostFunctions, 4, IllConditionedQuadratic, allowedPositions);
+  optimizer->SetUseSpeculativeEvaluation(useSpeculativeEvaluation);
+  RecordTrajectory(*optimizer, trajectory);
+
+  OptimizerType::ScalesType scales(4);
+  scales.Fill(4.0);
+  optimizer->SetScales(scales);
+  optimizer->SetUseScales(true);
+  OptimizerType::ParametersType initialPosition(4);
+  initialPosition.Fill(0.0);
+  optimizer->SetInitialPosition(initialPosition);
+  optimizer->SetMaximumNumberOfIterations(2000);
+  optimizer->SetFunctionConvergenceTolerance(1e-12);
+  optimizer->SetParametersConvergenceTolerance(1e-8);
+
+  optimizer->StartOptimization();
+  return optimizer;
+}
+
+} // end namespace
+
+
+int
+main()
+{
+  std::vector<TestCostFunction::Pointer> serialCostFunctions;
+  TrajectoryType                         serialTrajectory;
+  const auto                             serialOptimizer = RunOptimizer(0, true, serialCostFunctions, serialTrajectory);
+  const PositionSetType                  serialPositions = GetEvaluatedPositions(serialCostFunctions);
+
+  for (const unsigned int numberOfConcurrentCostFunctions : { 1u, 3u, 11u })
+  {
+    for (const bool useSpeculativeEvaluation : { false, true })
+    {
+      std::vector<TestCostFunction::Pointer> costFunctions;
+      TrajectoryType                         trajectory;
+      const auto                             optimizer =
+        RunOptimizer(numberOfConcurrentCostFunctions, useSpeculativeEvaluation, costFunctions, trajectory);
+      if (optimizer->GetCurrentIteration() != serialOptimizer->GetCurrentIteration() ||
+          optimizer->GetCurrentValue() != serialOptimizer->GetCurrentValue() || trajectory != serialTrajectory)
+      {
+        std::cerr << "ERROR: the speculative Nelder-Mead simplex optimizer with " << numberOfConcurrentCostFunctions
+                  << " concurrent cost functions (UseSpeculativeEvaluation = " << useSpeculativeEvaluation
+                  << ") differs from the serial one." << std::endl;
+        return EXIT_FAILURE;
+      }
+      if ((optimizer->GetNumberOfEvaluations() > serialOptimizer->GetNumberOfEvaluations()) !=
+          useSpeculativeEvaluation)
+      {
+        std::cerr << "ERROR: the Nelder-Mead simplex optimizer with " << numberOfConcurrentCostFunctions
+                  << " concurrent cost functions (UseSpeculativeEvaluation = " << useSpeculativeEvaluation << ") did "
+                  << optimizer->GetNumberOfEvaluations() << " evaluations, while the serial one did "
+                  << serialOptimizer->GetNumberOfEvaluations() << '.' << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    /** Reject all positions that the serial optimizer did not evaluate. */
+    std::vector<TestCostFunction::Pointer> costFunctions;
+    TrajectoryType                         trajectory;
+    const auto                             optimizer =
+      RunOptimizer(numberOfConcurrentCostFunctions, true, costFunctions, trajectory, &serialPositions);
+    if (GetNumberOfRejectedPositions(costFunctions) == 0 || trajectory != serialTrajectory ||
+        optimizer->GetCurrentValue() != serialOptimizer->GetCurrentValue())
+    {
+      std::cerr << "ERROR: the speculative Nelder-Mead simplex optimizer with " << numberOfConcurrentCostFunctions
+                << " concurrent cost functions depends on its " << GetNumberOfRejectedPositions(costFunctions)
+                << " rejected speculative candidates." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  const OptimizerType::ParametersType & position = serialOptimizer->GetCurrentPosition();
+  for (unsigned int i = 0; i < 4; ++i)
+  {
+    if (std::abs(position[i] - 1.0 + 0.5 * i) > 1e-3)
+    {
+      std::cerr << "ERROR: the Nelder-Mead simplex optimizer did not find the minimum, but stopped at " << position
+                << " with value " << serialOptimizer->GetCurrentValue() << '.' << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "The speculative Nelder-Mead simplex optimizer followed the same path as the serial one, to " << position
+            << " with value " << serialOptimizer->GetCurrentValue() << " after "
+            << serialOptimizer->GetCurrentIteration() << " iterations and "
+            << serialOptimizer->GetNumberOfEvaluations() << " evaluations." << std::endl;
+  return EXIT_SUCCESS;
+
+} // end main
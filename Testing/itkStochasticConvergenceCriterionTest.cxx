@@ -0,0 +1,81 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkStochasticConvergenceCriterion.h"
+
+#include <iostream>
+#include <random>
+#include <string>
+
+//-------------------------------------------------------------------------------------
+// This test simulates a stochastic gradient descent on a quadratic function, with noisy
+// gradients and values. It checks that the StochasticConvergenceCriterion does not
+// detect convergence while the value still decreases, and does detect it once the
+// optimizer fluctuates around the optimum.
+
+int
+main()
+{
+  constexpr unsigned int numberOfParameters = 10;
+  constexpr double       stepSize = 0.05;
+
+  auto criterion = itk::StochasticConvergenceCriterion::New();
+  criterion->SetWindowSize(50);
+  criterion->Initialize();
+
+  std::mt19937                     randomGenerator(5);
+  std::normal_distribution<double> normal;
+
+  itk::StochasticConvergenceCriterion::DerivativeType position(numberOfParameters);
+  itk::StochasticConvergenceCriterion::DerivativeType gradient(numberOfParameters);
+  position.Fill(10.0);
+  unsigned int iteration = 0;
+  for (; iteration < 1000; ++iteration)
+  {
+    /** Function: 0.5 |x|^2, with noisy values and gradients. */
+    const double value = 0.5 * position.squared_magnitude() + 0.1 * normal(randomGenerator);
+    for (unsigned int i = 0; i < numberOfParameters; ++i)
+    {
+      gradient[i] = position[i] + 0.5 * normal(randomGenerator);
+    }
+    if (criterion->Update(value, gradient))
+    {
+      break;
+    }
+    position -= stepSize * gradient;
+  }
+
+  /** The exact position decays as 0.95^k, to about the noise level after some 100 iterations. */
+  std::cout << "Stopped at iteration " << iteration << ". " << criterion->GetStopReason() << std::endl;
+  if (iteration < 80 || iteration > 300)
+  {
+    std::cerr << "ERROR: convergence detected at iteration " << iteration << ", expected between 80 and 300."
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** After Initialize(), the statistics of the previous run are forgotten. */
+  criterion->Initialize();
+  if (criterion->Update(0.0, gradient) || !std::string(criterion->GetStopReason()).empty())
+  {
+    std::cerr << "ERROR: Initialize() does not reset the criterion." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+
+} // end main
@@ -0,0 +1,222 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkTransformToDisplacementFieldSource.h"
+#include "itkAdvancedCombinationTransform.h"
+#include "itkAdvancedBSplineDeformableTransform.h"
+#include "itkAdvancedEuler3DTransform.h"
+#include "itkAdvancedMatrixOffsetTransformBase.h"
+#include "itkAdvancedTranslationTransform.h"
+#include "itkRecursiveBSplineTransform.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+//-------------------------------------------------------------------------------------
+// This test checks that the displacement field, which is generated per row of voxels
+// for B-spline transforms, equals T(x) - x evaluated per voxel, both on the fast path
+// and when the source falls back to TransformPoint().
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ScalarType = double;
+using FieldImageType = itk::Image<itk::Vector<float, Dimension>, Dimension>;
+using SourceType = itk::TransformToDisplacementFieldSource<FieldImageType, ScalarType>;
+using TransformType = SourceType::TransformType;
+using CombinationTransformType = itk::AdvancedCombinationTransform<ScalarType, Dimension>;
+using BSplineBaseType = itk::AdvancedBSplineDeformableTransformBase<ScalarType, Dimension>;
+using PointType = TransformType::InputPointType;
+
+/** A B-spline transform with smooth, varying coefficients on a grid that covers part of the field. */
+template <class TBSplineTransform>
+typename TBSplineTransform::Pointer
+CreateBSpline()
+{
+  auto                                    bspline = TBSplineTransform::New();
+  typename TBSplineTransform::SizeType    gridSize;
+  typename TBSplineTransform::SpacingType gridSpacing;
+  typename TBSplineTransform::OriginType  gridOrigin;
+  gridSize.Fill(10);
+  gridSpacing.Fill(8.0);
+  gridOrigin.Fill(-30.0);
+  bspline->SetGridRegion(typename TBSplineTransform::RegionType(gridSize));
+  bspline->SetGridSpacing(gridSpacing);
+  bspline->SetGridOrigin(gridOrigin);
+  typename TBSplineTransform::ParametersType coefficients(bspline->GetNumberOfParameters());
+  for (unsigned int i = 0; i < coefficients.GetSize(); ++i)
+  {
+    coefficients[i] = 2.0 * std::sin(0.37 * i) + std::cos(0.11 * i);
+  }
+  bspline->SetParametersByValue(coefficients);
+  return bspline;
+}
+
+CombinationTransformType::Pointer
+CreateCombination(CombinationTransformType::CurrentTransformType * currentTransform,
+                  CombinationTransformType::InitialTransformType * initialTransform,
+                  const bool                                       useAddition)
+{
+  auto combination = CombinationTransformType::New();
+  combination->SetCurrentTransform(currentTransform);
+  combination->SetInitialTransform(initialTransform);
+  combination->SetUseAddition(useAddition);
+  return combination;
+}
+
+/** Generate the field of the transform, and return the maximum difference with T(x) - x. */
+double
+GetMaximumFieldError(const TransformType & transform, const FieldImageType::DirectionType & direction)
+{
+  FieldImageType::SizeType    size;
+  FieldImageType::SpacingType spacing;
+  FieldImageType::PointType   origin;
+  FieldImageType::IndexType   index;
+  size[0] = 29;
+  size[1] = 19;
+  size[2] = 17;
+  spacing[0] = 1.7;
+  spacing[1] = 2.1;
+  spacing[2] = 1.3;
+  origin[0] = -25.0;
+  origin[1] = -15.0;
+  origin[2] = -10.0;
+  index[0] = 2;
+  index[1] = -1;
+  index[2] = 0;
+
+  const auto source = SourceType::New();
+  source->SetTransform(&transform);
+  source->SetOutputSize(size);
+  source->SetOutputIndex(index);
+  source->SetOutputSpacing(spacing);
+  source->SetOutputOrigin(origin);
+  source->SetOutputDirection(direction);
+  source->Update();
+
+  const FieldImageType * const field = source->GetOutput();
+  double                       maximumError = 0.0;
+  for (itk::ImageRegionConstIteratorWithIndex<FieldImageType> it(field, field->GetLargestPossibleRegion());
+       !it.IsAtEnd();
+       ++it)
+  {
+    PointType point;
+    field->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+    const auto expected = transform.TransformPoint(point) - point;
+    for (unsigned int d = 0; d < Dimension; ++d)
+    {
+      maximumError = std::max(maximumError, std::abs(expected[d] - it.Get()[d]));
+    }
+  }
+  return maximumError;
+}
+
+} // end namespace
+
+
+int
+main()
+{
+  const auto identityDirection = FieldImageType::DirectionType::GetIdentity();
+
+  /** Field directions that are not aligned with the B-spline grid are generated per voxel. */
+  auto rotation = itk::AdvancedEuler3DTransform<ScalarType>::New();
+  rotation->SetRotation(0.1, -0.2, 0.3);
+  FieldImageType::DirectionType rotatedDirection;
+  rotatedDirection = rotation->GetMatrix();
+
+  using MatrixOffsetTransformType = itk::AdvancedMatrixOffsetTransformBase<ScalarType, Dimension, Dimension>;
+  using TranslationTransformType = itk::AdvancedTranslationTransform<ScalarType, Dimension>;
+
+  auto                                  affine = MatrixOffsetTransformType::New();
+  MatrixOffsetTransformType::MatrixType matrix = rotation->GetMatrix();
+  matrix(0, 0) *= 1.1;
+  affine->SetMatrix(matrix);
+
+  auto                                     translation = TranslationTransformType::New();
+  TranslationTransformType::ParametersType translationParameters(Dimension);
+  translationParameters[0] = 3.0;
+  translationParameters[1] = -1.5;
+  translationParameters[2] = 0.5;
+  translation->SetParametersByValue(translationParameters);
+
+  const auto bspline1 = CreateBSpline<itk::AdvancedBSplineDeformableTransform<ScalarType, Dimension, 1>>();
+  const auto bspline2 = CreateBSpline<itk::AdvancedBSplineDeformableTransform<ScalarType, Dimension, 2>>();
+  const auto bspline3 = CreateBSpline<itk::AdvancedBSplineDeformableTransform<ScalarType, Dimension, 3>>();
+  const auto recursiveBSpline = CreateBSpline<itk::RecursiveBSplineTransform<ScalarType, Dimension, 3>>();
+
+  struct TestCase
+  {
+    std::string                   Name;
+    const TransformType *         Transform;
+    FieldImageType::DirectionType Direction;
+  };
+  const auto additionCombination = CreateCombination(bspline3, affine, true);
+  const auto translationCombination = CreateCombination(recursiveBSpline, translation, false);
+  const auto rotationCombination = CreateCombination(bspline3, rotation, false);
+  const auto noInitialCombination = CreateCombination(bspline2, nullptr, false);
+
+  const std::vector<TestCase> testCases{
+    { "first order B-spline", bspline1, identityDirection },
+    { "second order B-spline", bspline2, identityDirection },
+    { "third order B-spline", bspline3, identityDirection },
+    { "recursive B-spline", recursiveBSpline, identityDirection },
+    { "rotated field", bspline3, rotatedDirection },
+    { "combination without initial transform", noInitialCombination, identityDirection },
+    { "addition of an affine transform", additionCombination, identityDirection },
+    { "composition with a translation", translationCombination, identityDirection },
+    { "composition with a rotation", rotationCombination, identityDirection }
+  };
+
+  for (const auto & testCase : testCases)
+  {
+    const double error = GetMaximumFieldError(*testCase.Transform, testCase.Direction);
+    std::cout << testCase.Name << ": maximum error " << error << std::endl;
+    if (!(error < 1e-4))
+    {
+      std::cerr << "ERROR: the field of the " << testCase.Name << " differs from T(x) - x." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  /** Rows along a grid axis are swept at once; oblique rows are left to TransformPoint(). */
+  const BSplineBaseType &                      bsplineBase = *bspline3;
+  std::vector<TransformType::OutputVectorType> displacements(20);
+  PointType                                    firstPoint;
+  firstPoint.Fill(-5.0);
+  TransformType::InputVectorType step;
+  step.Fill(0.0);
+  step[1] = 1.5;
+  if (!bsplineBase.ComputeDisplacementsAlongLine(firstPoint, step, displacements.size(), displacements.data()))
+  {
+    std::cerr << "ERROR: a row along a grid axis was not swept." << std::endl;
+    return EXIT_FAILURE;
+  }
+  step[2] = 0.5;
+  if (bsplineBase.ComputeDisplacementsAlongLine(firstPoint, step, displacements.size(), displacements.data()))
+  {
+    std::cerr << "ERROR: an oblique row was swept." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+
+} // end main
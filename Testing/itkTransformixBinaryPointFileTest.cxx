@@ -0,0 +1,113 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkTransformixBinaryPointFile.h"
+
+#include "itkPoint.h"
+
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+//-------------------------------------------------------------------------------------
+// This test writes a point set to a binary point file, as float and as double, maps it
+// again, and checks that the header and the coordinates are read back. It also checks
+// that text files and truncated files are rejected.
+
+int
+main()
+{
+  using PointType = itk::Point<double, 3>;
+  const std::string fileName = "itkTransformixBinaryPointFileTest.bin";
+
+  /** More points than fit in one block of the writer. */
+  std::vector<PointType> points(100003);
+  for (std::size_t j = 0; j < points.size(); ++j)
+  {
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      points[j][i] = 0.25 * static_cast<double>(j) - static_cast<double>(i);
+    }
+  }
+
+  for (const unsigned int componentSize : { 4u, 8u })
+  {
+    itk::TransformixBinaryPointFile::Write(fileName, points.data(), points.size(), true, componentSize);
+    if (!itk::TransformixBinaryPointFile::IsBinaryPointFile(fileName))
+    {
+      std::cerr << "ERROR: the written file is not recognized as a binary point file." << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    const auto pointFile = itk::TransformixBinaryPointFile::New();
+    pointFile->Open(fileName);
+    if (pointFile->GetDimension() != 3 || pointFile->GetComponentSize() != componentSize ||
+        !pointFile->GetPointsAreIndices() || pointFile->GetNumberOfPoints() != points.size())
+    {
+      std::cerr << "ERROR: wrong header for component size " << componentSize << '.' << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    /** The coordinates are multiples of 0.25, which are exact in float as well. */
+    for (std::size_t j = 0; j < points.size(); ++j)
+    {
+      PointType point;
+      pointFile->GetPoint(j, point);
+      if (point != points[j])
+      {
+        std::cerr << "ERROR: point " << j << " is read as " << point << " instead of " << points[j] << '.'
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    pointFile->Close();
+  }
+
+  /** A text input point file is not a binary point file. */
+  {
+    std::ofstream textFile(fileName);
+    textFile << "point\n1\n1.0 2.0 3.0\n";
+  }
+  if (itk::TransformixBinaryPointFile::IsBinaryPointFile(fileName))
+  {
+    std::cerr << "ERROR: a text file is recognized as a binary point file." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /** A file that holds fewer points than its header specifies is rejected. */
+  itk::TransformixBinaryPointFile::Write(fileName, points.data(), 10, false, 8);
+  {
+    std::vector<char> bytes(itk::TransformixBinaryPointFile::HeaderSize + 5 * 3 * sizeof(double));
+    std::ifstream     file(fileName, std::ios::binary);
+    file.read(bytes.data(), bytes.size());
+    file.close();
+    std::ofstream truncatedFile(fileName, std::ios::binary);
+    truncatedFile.write(bytes.data(), bytes.size());
+  }
+  try
+  {
+    itk::TransformixBinaryPointFile::New()->Open(fileName);
+    std::cerr << "ERROR: a truncated binary point file is accepted." << std::endl;
+    return EXIT_FAILURE;
+  }
+  catch (const itk::ExceptionObject & excp)
+  {
+    std::cout << "Expected exception: " << excp.GetDescription() << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,151 @@
+/*=========================================================================
+ *
+ *  Copyright UMC Utrecht and contributors
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkWorkStealingThreadPool.h"
+#include "itkPlatformMultiThreader.h"
+
+// Report timings
+#include "itkTimeProbesCollectorBase.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+//-------------------------------------------------------------------------------------
+// This test compares the per-iteration overhead of the itk::PlatformMultiThreader,
+// which starts new threads on every call, with the persistent work-stealing thread
+// pool. The work per iteration mimics a metric evaluation on a small sample set:
+// each work unit processes a part of the samples into its own accumulator.
+
+namespace
+{
+struct WorkType
+{
+  unsigned int          m_NumberOfSamples;
+  unsigned int          m_NumberOfWorkUnits;
+  std::vector<double> * m_PerWorkUnitValues;
+};
+
+
+void
+ProcessWorkUnit(const WorkType & work, const unsigned int workUnit)
+{
+  const unsigned int samplesPerWorkUnit =
+    (work.m_NumberOfSamples + work.m_NumberOfWorkUnits - 1) / work.m_NumberOfWorkUnits;
+  const unsigned int begin = std::min(workUnit * samplesPerWorkUnit, work.m_NumberOfSamples);
+  const unsigned int end = std::min(begin + samplesPerWorkUnit, work.m_NumberOfSamples);
+
+  double value = 0.0;
+  for (unsigned int i = begin; i < end; ++i)
+  {
+    value += std::sqrt(static_cast<double>(i));
+  }
+  (*work.m_PerWorkUnitValues)[workUnit] = value;
+}
+
+
+ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
+ThreaderCallback(void * arg)
+{
+  const auto * infoStruct = static_cast<itk::PlatformMultiThreader::WorkUnitInfo *>(arg);
+  ProcessWorkUnit(*static_cast<const WorkType *>(infoStruct->UserData), infoStruct->WorkUnitID);
+  return itk::ITK_THREAD_RETURN_DEFAULT_VALUE;
+}
+
+
+double
+SumOfValues(const std::vector<double> & values)
+{
+  double sum = 0.0;
+  for (const double value : values)
+  {
+    sum += value;
+  }
+  return sum;
+}
+
+} // namespace
+
+//-------------------------------------------------------------------------------------
+
+int
+main()
+{
+  std::cout << std::fixed << std::showpoint << std::setprecision(8);
+
+  auto               threader = itk::PlatformMultiThreader::New();
+  auto               pool = itk::WorkStealingThreadPool::GetInstance();
+  const unsigned int numberOfWorkUnits = threader->GetNumberOfWorkUnits();
+  std::cout << "Number of work units: " << numberOfWorkUnits << '\n'
+            << "Number of pool threads: " << pool->GetNumberOfThreads() << '\n'
+            << std::endl;
+
+  const unsigned int  numberOfIterations = 1000;
+  std::vector<double> perWorkUnitValues(numberOfWorkUnits);
+
+  for (const unsigned int numberOfSamples : { 256u, 2048u, 16384u })
+  {
+    std::cout << "Number of samples = " << numberOfSamples << std::endl;
+    WorkType work{ numberOfSamples, numberOfWorkUnits, &perWorkUnitValues };
+
+    itk::TimeProbesCollectorBase timeCollector;
+
+    /** Time the itk::PlatformMultiThreader. */
+    threader->SetSingleMethod(ThreaderCallback, &work);
+    for (unsigned int iteration = 0; iteration < numberOfIterations; ++iteration)
+    {
+      timeCollector.Start("PlatformMultiThreader");
+      threader->SingleMethodExecute();
+      timeCollector.Stop("PlatformMultiThreader");
+    }
+    const double threaderSum = SumOfValues(perWorkUnitValues);
+
+    /** Time the work-stealing thread pool. */
+    for (unsigned int iteration = 0; iteration < numberOfIterations; ++iteration)
+    {
+      timeCollector.Start("WorkStealingThreadPool");
+      pool->ParallelFor(0,
+                        numberOfWorkUnits,
+                        1,
+                        numberOfWorkUnits,
+                        [&work](itk::SizeValueType first, itk::SizeValueType last, itk::ThreadIdType) {
+                          for (itk::SizeValueType workUnit = first; workUnit < last; ++workUnit)
+                          {
+                            ProcessWorkUnit(work, static_cast<unsigned int>(workUnit));
+                          }
+                        });
+      timeCollector.Stop("WorkStealingThreadPool");
+    }
+    const double poolSum = SumOfValues(perWorkUnitValues);
+
+    /** Both must compute exactly the same, since the work units are identical. */
+    if (threaderSum != poolSum)
+    {
+      std::cerr << "ERROR: results differ: " << threaderSum << " != " << poolSum << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    /** Report timings per iteration. */
+    timeCollector.Report();
+    std::cout << std::endl;
+  }
+
+  return EXIT_SUCCESS;
+
+} // end main